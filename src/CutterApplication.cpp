@@ -19,6 +19,7 @@
 #include <QTranslator>
 #include <QLibraryInfo>
 #include <QFontDatabase>
+#include <QTimer>
 #ifdef Q_OS_WIN
 #    include <QtNetwork/QtNetwork>
 #endif // Q_OS_WIN
@@ -53,6 +54,7 @@ CutterApplication::CutterApplication(int &argc, char **argv) : QApplication(argc
     setLayoutDirection(Qt::LeftToRight);
     // WARN!!! Put initialization code below this line. Code above this line is mandatory to be run
     // First
+    startupTimer.start();
 
 #ifdef Q_OS_WIN
     // Hack to force Cutter load internet connection related DLL's
@@ -86,6 +88,7 @@ CutterApplication::CutterApplication(int &argc, char **argv) : QApplication(argc
     if (!parseCommandLineOptions()) {
         std::exit(1);
     }
+    startupPhase("Translations and command line");
 
     // Check rizin version
     QString rzversion = rz_core_version();
@@ -105,18 +108,11 @@ CutterApplication::CutterApplication(int &argc, char **argv) : QApplication(argc
         }
     }
 
-#ifdef CUTTER_ENABLE_PYTHON
-    // Init python
-    if (!clOptions.pythonHome.isEmpty()) {
-        Python()->setPythonHome(clOptions.pythonHome);
-    }
-    Python()->initialize();
-#endif
-
     Core()->initialize(clOptions.enableRizinPlugins);
     Core()->setSettings();
     Config()->loadInitial();
     Core()->loadCutterRC();
+    startupPhase("Core initialization");
 
     Config()->setOutputRedirectionEnabled(clOptions.outputRedirectionEnabled);
 
@@ -124,14 +120,13 @@ CutterApplication::CutterApplication(int &argc, char **argv) : QApplication(argc
     Core()->registerDecompiler(new RzGhidraDecompiler(Core()));
 #endif
 
-    Plugins()->loadPlugins(clOptions.enableCutterPlugins);
-
-    for (auto &plugin : Plugins()->getPlugins()) {
-        plugin->registerDecompilers();
-    }
+    // Python and the plugins are initialized once the first window got painted, see
+    // initDeferred()
+    QTimer::singleShot(deferredInitTimeout, this, &CutterApplication::initDeferred);
 
     mainWindow = new MainWindow();
     installEventFilter(mainWindow);
+    startupPhase("Main window");
 
     // set up context menu shortcut display fix
 #if QT_VERSION_CHECK(5, 10, 0) < QT_VERSION
@@ -151,6 +146,7 @@ CutterApplication::CutterApplication(int &argc, char **argv) : QApplication(argc
                 || !clOptions.fileOpenOptions.projectFile.isEmpty();
         mainWindow->openNewFile(clOptions.fileOpenOptions, askOptions);
     }
+    startupPhase("Initial dialogs");
 
 #ifdef APPIMAGE
     {
@@ -191,7 +187,9 @@ CutterApplication::~CutterApplication()
     Plugins()->destroyPlugins();
     delete mainWindow;
 #ifdef CUTTER_ENABLE_PYTHON
-    Python()->shutdown();
+    if (!deferredInitPending) {
+        Python()->shutdown();
+    }
 #endif
 }
 
@@ -210,6 +208,116 @@ void CutterApplication::launchNewInstance(const QStringList &args)
     process.startDetached(qApp->applicationFilePath(), allArgs);
 }
 
+MainWindow *CutterApplication::createSession()
+{
+    CutterCore *session = new CutterCore(this);
+    SessionScope scope(session);
+    session->initialize(clOptions.enableRizinPlugins);
+    session->setSettings();
+    Config()->applySavedAsmOptions();
+    session->loadCutterRC();
+
+#if CUTTER_RZGHIDRA_STATIC
+    session->registerDecompiler(new RzGhidraDecompiler(session));
+#endif
+    if (Plugins()->isLoaded()) {
+        for (auto &plugin : Plugins()->getPlugins()) {
+            plugin->registerDecompilers();
+        }
+    }
+
+    MainWindow *window = new MainWindow();
+    window->setAttribute(Qt::WA_DeleteOnClose);
+    connect(window, &QObject::destroyed, session, &QObject::deleteLater);
+    CutterCore::setActiveSession(session);
+    window->displayNewFileDialog();
+    return window;
+}
+
+void CutterApplication::startupPhase(const char *phase)
+{
+    if (!clOptions.startupProfile) {
+        return;
+    }
+    qint64 now = startupTimer.elapsed();
+    fprintf(stderr, "startup: %-32s %6lld ms\n", phase, static_cast<long long>(now - lastPhase));
+    lastPhase = now;
+}
+
+void CutterApplication::initDeferred()
+{
+    if (!deferredInitPending) {
+        return;
+    }
+    deferredInitPending = false;
+    startupPhase("First paint");
+
+#ifdef CUTTER_ENABLE_PYTHON
+    if (!clOptions.pythonHome.isEmpty()) {
+        Python()->setPythonHome(clOptions.pythonHome);
+    }
+    Python()->initialize();
+    startupPhase("Python initialization");
+#endif
+
+    Plugins()->loadPlugins(clOptions.enableCutterPlugins);
+    for (CutterCore *session : CutterCore::getSessions()) {
+        SessionScope scope(session);
+        for (auto &plugin : Plugins()->getPlugins()) {
+            plugin->registerDecompilers();
+        }
+    }
+    for (QWidget *widget : topLevelWidgets()) {
+        if (auto window = qobject_cast<MainWindow *>(widget)) {
+            SessionScope scope(window->getSession());
+            window->setupPluginInterfaces();
+        }
+    }
+    startupPhase("Plugins");
+
+    if (clOptions.startupProfile) {
+        fprintf(stderr, "startup: %-32s %6lld ms\n", "Total",
+                static_cast<long long>(startupTimer.elapsed()));
+    }
+}
+
+static CutterCore *sessionOf(QObject *object)
+{
+    for (; object; object = object->parent()) {
+        // Widgets showing another session than their window, see HexWidget::setSession()
+        QVariant scoped = object->property("cutterSession");
+        if (scoped.isValid()) {
+            if (auto session = qobject_cast<CutterCore *>(scoped.value<QObject *>())) {
+                return session;
+            }
+        }
+        if (auto window = qobject_cast<MainWindow *>(object)) {
+            return window->getSession();
+        }
+        if (auto session = qobject_cast<CutterCore *>(object)) {
+            return session;
+        }
+    }
+    return nullptr;
+}
+
+bool CutterApplication::notify(QObject *receiver, QEvent *event)
+{
+    if (deferredInitPending && event->type() == QEvent::Paint) {
+        QTimer::singleShot(0, this, &CutterApplication::initDeferred);
+    }
+
+    // Widgets of a window, its dialogs and queued signals to them all work on the session of the
+    // window. Only needed once there is more than one session.
+    if (CutterCore::getSessionCount() > 1) {
+        if (CutterCore *session = sessionOf(receiver)) {
+            SessionScope scope(session);
+            return QApplication::notify(receiver, event);
+        }
+    }
+    return QApplication::notify(receiver, event);
+}
+
 bool CutterApplication::event(QEvent *e)
 {
     if (e->type() == QEvent::FileOpen) {
@@ -469,6 +577,10 @@ bool CutterApplication::parseCommandLineOptions()
                                            QObject::tr("Do not load rizin plugins"));
     cmd_parser.addOption(disableRizinPlugins);
 
+    QCommandLineOption startupProfileOption(
+            "startup-profile", QObject::tr("Print the time taken by each phase of the startup"));
+    cmd_parser.addOption(startupProfileOption);
+
     cmd_parser.process(*this);
 
     CutterCommandLineOptions opts;
@@ -589,6 +701,8 @@ bool CutterApplication::parseCommandLineOptions()
         opts.enableRizinPlugins = false;
     }
 
+    opts.startupProfile = cmd_parser.isSet(startupProfileOption);
+
     this->clOptions = opts;
     return true;
 }
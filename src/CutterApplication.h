@@ -5,6 +5,7 @@
 #include <QApplication>
 #include <QList>
 #include <QProxyStyle>
+#include <QElapsedTimer>
 
 #include "core/MainWindow.h"
 
@@ -19,6 +20,7 @@ struct CutterCommandLineOptions
     bool outputRedirectionEnabled = true;
     bool enableCutterPlugins = true;
     bool enableRizinPlugins = true;
+    bool startupProfile = false;
 };
 
 class CutterApplication : public QApplication
@@ -33,12 +35,23 @@ public:
 
     void launchNewInstance(const QStringList &args = {});
 
+    /**
+     * @brief Open a new window with its own session in this process.
+     *
+     * The session is destroyed together with its window.
+     */
+    MainWindow *createSession();
+
     InitialOptions getInitialOptions() const { return clOptions.fileOpenOptions; }
     void setInitialOptions(const InitialOptions &options) { clOptions.fileOpenOptions = options; }
     QStringList getArgs() const;
 
 protected:
     bool event(QEvent *e);
+    /**
+     * @brief Delivers events with Core() resolving to the session of the receiver's window
+     */
+    bool notify(QObject *receiver, QEvent *event) override;
 
 private:
     /**
@@ -51,12 +64,26 @@ private:
      * @return false if options have error
      */
     bool parseCommandLineOptions();
+    /**
+     * @brief Print the time since the previous phase if --startup-profile is given.
+     */
+    void startupPhase(const char *phase);
+    /**
+     * @brief Initialize Python and load the plugins, deferred until the first window got painted
+     * to get it on screen sooner.
+     */
+    void initDeferred();
 
 private:
     bool m_FileAlreadyDropped;
     CutterCore core;
     MainWindow *mainWindow;
     CutterCommandLineOptions clOptions;
+
+    static const int deferredInitTimeout = 2000;
+    bool deferredInitPending = true;
+    QElapsedTimer startupTimer;
+    qint64 lastPhase = 0;
 };
 
 /**
@@ -4,6 +4,9 @@
 #include "common/UpdateWorker.h"
 #include "CutterConfig.h"
 #include "common/SettingsUpgrade.h"
+#include "common/SelectionHashTask.h"
+#include "common/NavigationIndex.h"
+#include "common/BinaryDiff.h"
 
 #include <QJsonObject>
 #include <QJsonArray>
@@ -60,6 +63,9 @@ int main(int argc, char *argv[])
 
     qRegisterMetaType<QList<StringDescription>>();
     qRegisterMetaType<QList<FunctionDescription>>();
+    qRegisterMetaType<SelectionHashTask::Result>();
+    qRegisterMetaType<QVector<NavigationIndex::Match>>();
+    qRegisterMetaType<QVector<BinaryDiff::Match>>();
 
     QCoreApplication::setOrganizationName("rizin");
 #ifndef Q_OS_MACOS // don't set on macOS so that it doesn't affect config path there
@@ -0,0 +1,362 @@
+/**
+ * @file CutterBench.cpp
+ * @brief Headless benchmark driver for Cutter hot paths.
+ *
+ * Every fixture binary is loaded into its own CutterCore instance, analyzed and then the core
+ * queries and widget code paths which dominate interactive use are timed. The results are printed
+ * as JSON so that they can be compared between revisions.
+ */
+
+#include "core/Basefind.h"
+#include "core/Cutter.h"
+#include "core/CutterQuery.h"
+#include "common/Configuration.h"
+#include "common/CutterSeekable.h"
+#include "common/TempConfig.h"
+#include "widgets/DisassemblerGraphView.h"
+#include "widgets/GraphGridLayout.h"
+#include "widgets/HexWidget.h"
+#include "CutterConfig.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPainter>
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+struct BenchOptions
+{
+    QStringList fixtures;
+    QString analysisCmd = QStringLiteral("aaa");
+    int iterations = 5;
+    int graphFunctions = 10;
+    int xrefFunctions = 500;
+    bool loadRizinPlugins = true;
+};
+
+/**
+ * @brief Run \p fn once for warm-up and then \p iterations times, recording wall clock time.
+ * @return JSON object with the benchmark name and min/median/mean/max in nanoseconds
+ */
+QJsonObject measure(const QString &name, int iterations, const std::function<void()> &fn)
+{
+    fn();
+
+    std::vector<qint64> samples;
+    samples.reserve(iterations);
+    QElapsedTimer timer;
+    for (int i = 0; i < iterations; i++) {
+        timer.start();
+        fn();
+        samples.push_back(timer.nsecsElapsed());
+    }
+    std::sort(samples.begin(), samples.end());
+
+    qint64 total = 0;
+    for (qint64 sample : samples) {
+        total += sample;
+    }
+
+    QJsonObject result;
+    result["name"] = name;
+    result["iterations"] = iterations;
+    if (!samples.empty()) {
+        result["min_ns"] = samples.front();
+        result["median_ns"] = samples[samples.size() / 2];
+        result["mean_ns"] = total / static_cast<qint64>(samples.size());
+        result["max_ns"] = samples.back();
+    }
+    return result;
+}
+
+/**
+ * @brief Pick the functions with the most basic blocks, those are the interesting ones for the
+ * graph benchmarks.
+ */
+QList<FunctionDescription> largestFunctions(QList<FunctionDescription> functions, int count)
+{
+    std::sort(functions.begin(), functions.end(),
+              [](const FunctionDescription &a, const FunctionDescription &b) {
+                  return a.nbbs > b.nbbs;
+              });
+    return functions.mid(0, count);
+}
+
+QJsonObject benchFixture(const QString &path, const BenchOptions &options)
+{
+    QJsonObject fixture;
+    fixture["path"] = path;
+    fixture["size"] = QFileInfo(path).size();
+
+    CutterCore core;
+    core.initialize(options.loadRizinPlugins);
+    Core()->setSettings();
+    Config()->loadInitial();
+
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+    if (!Core()->loadFile(path, RVA_INVALID, RVA_INVALID, RZ_PERM_RX, 1, true)) {
+        fixture["error"] = QStringLiteral("Failed to load file");
+        return fixture;
+    }
+    fixture["load_ns"] = loadTimer.nsecsElapsed();
+
+    loadTimer.start();
+    if (!options.analysisCmd.isEmpty()) {
+        Core()->cmd(options.analysisCmd);
+    }
+    fixture["analysis_ns"] = loadTimer.nsecsElapsed();
+
+    const int iterations = options.iterations;
+    QJsonArray benchmarks;
+
+    QList<FunctionDescription> functions = Core()->getAllFunctions();
+    fixture["functions"] = functions.size();
+    fixture["strings"] = Core()->getAllStrings().size();
+    fixture["flags"] = Core()->getAllFlags().size();
+
+    RVA start = functions.isEmpty() ? Core()->getOffset() : functions.first().offset;
+
+    benchmarks.append(measure("CutterCore::disassembleLines", iterations,
+                              [start]() { Core()->disassembleLines(start, 200); }));
+    benchmarks.append(measure("CutterCore::getAllFunctions", iterations,
+                              []() { Core()->getAllFunctions(); }));
+    benchmarks.append(measure("CutterCore::getAllStrings", iterations,
+                              []() { Core()->getAllStrings(); }));
+    benchmarks.append(
+            measure("CutterCore::getAllFlags", iterations, []() { Core()->getAllFlags(); }));
+
+    // Native byte search against the JSON round trip it replaced
+    benchmarks.append(measure("SearchQuery::run (string)", iterations, []() {
+        SearchQuery(SearchQuery::Kind::String, QStringLiteral("lib")).within("io.maps").run();
+    }));
+    benchmarks.append(measure("CutterCore::cmdj (/j string)", iterations, []() {
+        TempConfig cfg;
+        cfg.set("search.in", "io.maps");
+        Core()->cmdj("/j lib");
+    }));
+
+    // Global graphs of the rizin graph widget, read natively and through the json output
+    benchmarks.append(measure("CutterCore::getGraphNodes (agR)", iterations, []() {
+        Core()->getGraphNodes(RZ_CORE_GRAPH_TYPE_REF, RVA_INVALID);
+    }));
+    benchmarks.append(measure("CutterCore::cmdj (agR json)", iterations, []() {
+        CutterJson graph = Core()->cmdj("agR json");
+        for (CutterJson node : graph["nodes"]) {
+            node["title"].toString();
+        }
+    }));
+    benchmarks.append(measure("CutterCore::getGraphNodes (agA)", iterations, []() {
+        Core()->getGraphNodes(RZ_CORE_GRAPH_TYPE_DATAREF, RVA_INVALID);
+    }));
+    benchmarks.append(measure("CutterCore::cmdj (agA json)", iterations, []() {
+        CutterJson graph = Core()->cmdj("agA json");
+        for (CutterJson node : graph["nodes"]) {
+            node["title"].toString();
+        }
+    }));
+
+    const QList<FunctionDescription> xrefFunctions = functions.mid(0, options.xrefFunctions);
+    benchmarks.append(measure("CutterCore::getXRefs", iterations, [&xrefFunctions]() {
+        for (const FunctionDescription &function : xrefFunctions) {
+            Core()->getXRefs(function.offset, true, false);
+        }
+    }));
+
+    // Graph benchmarks work on the largest functions, layout is measured on the blocks produced
+    // by the graph view so that both use the same input.
+    const QList<FunctionDescription> graphFunctions =
+            largestFunctions(functions, options.graphFunctions);
+    std::vector<GraphLayout::Graph> graphs;
+    std::vector<ut64> graphEntries;
+    {
+        CutterSeekable seekable;
+        DisassemblerGraphView graphView(nullptr, &seekable, nullptr, {});
+        graphView.resize(1280, 1024);
+
+        benchmarks.append(
+                measure("DisassemblerGraphView::loadCurrentGraph", iterations, [&]() {
+                    for (const FunctionDescription &function : graphFunctions) {
+                        seekable.seek(function.offset);
+                        graphView.loadCurrentGraph();
+                    }
+                }));
+
+        for (const FunctionDescription &function : graphFunctions) {
+            seekable.seek(function.offset);
+            graphView.loadCurrentGraph();
+            graphs.push_back(graphView.getBlocks());
+            graphEntries.push_back(function.offset);
+        }
+    }
+
+    GraphGridLayout gridLayout(GraphGridLayout::LayoutType::Medium);
+    benchmarks.append(measure("GraphGridLayout::CalculateLayout", iterations, [&]() {
+        for (size_t i = 0; i < graphs.size(); i++) {
+            GraphLayout::Graph graph = graphs[i];
+            int width = 0;
+            int height = 0;
+            gridLayout.CalculateLayout(graph, graphEntries[i], width, height);
+        }
+    }));
+
+    {
+        HexWidget hexWidget;
+        hexWidget.setMonospaceFont(Config()->getFont());
+        hexWidget.resize(1280, 1024);
+        hexWidget.seek(start);
+        QImage image(hexWidget.size(), QImage::Format_ARGB32);
+        benchmarks.append(measure("HexWidget::paintEvent", iterations, [&]() {
+            QPainter painter(&image);
+            hexWidget.render(&painter);
+        }));
+    }
+
+    // Base address search with the indexed parallel scoring against rizin's implementation
+    {
+        RzBaseFindOpt basefindOptions = {};
+        basefindOptions.max_threads = std::max(1u, std::thread::hardware_concurrency());
+        basefindOptions.pointer_size = Core()->getConfigi("asm.bits") == 64 ? 64 : 32;
+        basefindOptions.start_address =
+                Core()->getConfig("basefind.search.start").toULongLong(nullptr, 0);
+        basefindOptions.end_address =
+                Core()->getConfig("basefind.search.end").toULongLong(nullptr, 0);
+        basefindOptions.alignment = Core()->getConfig("basefind.alignment").toULongLong(nullptr, 0);
+        basefindOptions.min_score = Core()->getConfigut64("basefind.min.score");
+        basefindOptions.min_string_len = Core()->getConfigut64("basefind.min.string");
+
+        Basefind basefind(Core());
+        if (basefind.setOptions(&basefindOptions)) {
+            benchmarks.append(measure("Basefind::run", iterations, [&basefind]() {
+                basefind.setStopEarly(false);
+                basefind.run();
+            }));
+            benchmarks.append(measure("Basefind::run (stop early)", iterations, [&basefind]() {
+                basefind.setStopEarly(true);
+                basefind.run();
+            }));
+            QList<BasefindResultDescription> best = basefind.topResults(1);
+            if (!best.isEmpty()) {
+                fixture["basefind_candidate"] = QString::number(best.first().candidate, 16);
+                fixture["basefind_score"] = static_cast<qint64>(best.first().score);
+            }
+            benchmarks.append(measure("rz_basefind", iterations, [&basefindOptions]() {
+                RzCoreLocked core(Core());
+                rz_list_free(rz_basefind(core, &basefindOptions));
+            }));
+        }
+    }
+
+    fixture["benchmarks"] = benchmarks;
+    return fixture;
+}
+
+bool parseOptions(QApplication &app, BenchOptions &options)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+            QObject::tr("Benchmark Cutter core queries and views on fixture binaries"));
+    parser.addHelpOption();
+    parser.addPositionalArgument("fixtures", QObject::tr("Binaries to benchmark."),
+                                 QObject::tr("[fixture...]"));
+
+    QCommandLineOption iterationsOption({ "n", "iterations" },
+                                        QObject::tr("Number of timed iterations per benchmark"),
+                                        QObject::tr("count"), QString::number(options.iterations));
+    parser.addOption(iterationsOption);
+
+    QCommandLineOption analysisOption({ "A", "analysis" },
+                                      QObject::tr("Analysis command to run after loading a fixture"),
+                                      QObject::tr("command"), options.analysisCmd);
+    parser.addOption(analysisOption);
+
+    QCommandLineOption outputOption({ "o", "output" },
+                                    QObject::tr("Write JSON results to file instead of stdout"),
+                                    QObject::tr("file"));
+    parser.addOption(outputOption);
+
+    QCommandLineOption noRizinPluginsOption("no-rizin-plugins",
+                                            QObject::tr("Do not load rizin plugins"));
+    parser.addOption(noRizinPluginsOption);
+
+    parser.process(app);
+
+    options.fixtures = parser.positionalArguments();
+    if (options.fixtures.isEmpty()) {
+        // Without explicit fixtures benchmark the bench executable itself, it is always available
+        // and big enough to produce meaningful numbers.
+        options.fixtures << QCoreApplication::applicationFilePath();
+    }
+    bool ok = false;
+    options.iterations = parser.value(iterationsOption).toInt(&ok);
+    if (!ok || options.iterations <= 0) {
+        std::cerr << "Invalid iteration count" << std::endl;
+        return false;
+    }
+    options.analysisCmd = parser.value(analysisOption);
+    options.loadRizinPlugins = !parser.isSet(noRizinPluginsOption);
+    if (parser.isSet(outputOption)) {
+        app.setProperty("benchOutput", parser.value(outputOption));
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    qRegisterMetaType<QList<StringDescription>>();
+    qRegisterMetaType<QList<FunctionDescription>>();
+
+    QCoreApplication::setOrganizationName("rizin");
+    QCoreApplication::setApplicationName("cutter-bench");
+
+    QApplication app(argc, argv);
+
+    BenchOptions options;
+    if (!parseOptions(app, options)) {
+        return 1;
+    }
+
+    QJsonArray fixtures;
+    for (const QString &fixture : options.fixtures) {
+        fixtures.append(benchFixture(fixture, options));
+    }
+
+    QJsonObject result;
+    result["cutter_version"] = CUTTER_VERSION_FULL;
+    result["rizin_version"] = rz_core_version();
+    result["qt_version"] = qVersion();
+    result["iterations"] = options.iterations;
+    result["fixtures"] = fixtures;
+
+    QByteArray json = QJsonDocument(result).toJson(QJsonDocument::Indented);
+    QString outputPath = app.property("benchOutput").toString();
+    if (outputPath.isEmpty()) {
+        std::cout << json.constData();
+        return 0;
+    }
+    QFile output(outputPath);
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        std::cerr << "Cannot open " << outputPath.toStdString() << std::endl;
+        return 1;
+    }
+    output.write(json);
+    return 0;
+}
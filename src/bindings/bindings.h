@@ -5,6 +5,7 @@
 #define QT_ANNOTATE_ACCESS_SPECIFIER(a) __attribute__((annotate(#a)))
 
 #include "../core/Cutter.h"
+#include "../core/CutterQuery.h"
 #include "../common/Configuration.h"
 #include "../core/MainWindow.h"
 #include "../widgets/CutterDockWidget.h"
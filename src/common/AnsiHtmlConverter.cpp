@@ -0,0 +1,45 @@
+#include "AnsiHtmlConverter.h"
+
+#include "core/Cutter.h"
+
+// Sequences without a reset in between only accumulate up to this length, after that only the
+// most recent one is kept. Output doing that is rare and the latest color is what matters most.
+static constexpr int MaxActiveSgrLength = 128;
+
+QString AnsiHtmlConverter::lineToHtml(const QString &line)
+{
+    QString html = CutterCore::ansiEscapeToHtml(activeSgr.isEmpty() ? line : activeSgr + line);
+    skipLine(line);
+    return html;
+}
+
+void AnsiHtmlConverter::skipLine(const QString &line)
+{
+    int pos = 0;
+    while ((pos = line.indexOf(QLatin1String("\x1b["), pos)) >= 0) {
+        // Parameter and intermediate bytes, up to the final byte in 0x40-0x7e
+        int end = pos + 2;
+        while (end < line.size() && (line[end].unicode() < 0x40 || line[end].unicode() > 0x7e)) {
+            end++;
+        }
+        if (end >= line.size()) {
+            break;
+        }
+        if (line[end] == QLatin1Char('m')) {
+            const QString params = line.mid(pos + 2, end - pos - 2);
+            if (params.isEmpty() || params == QLatin1String("0")) {
+                activeSgr.clear();
+            } else if (params.startsWith(QLatin1String("0;"))) {
+                activeSgr = QStringLiteral("\x1b[") + params.mid(2) + QLatin1Char('m');
+            } else {
+                const QString sequence = line.mid(pos, end - pos + 1);
+                if (activeSgr.size() + sequence.size() > MaxActiveSgrLength) {
+                    activeSgr = sequence;
+                } else {
+                    activeSgr += sequence;
+                }
+            }
+        }
+        pos = end + 1;
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef ANSIHTMLCONVERTER_H
+#define ANSIHTMLCONVERTER_H
+
+#include "core/CutterCommon.h"
+
+#include <QString>
+
+/**
+ * @brief Converts output with ANSI escape sequences to html line by line.
+ *
+ * CutterCore::ansiEscapeToHtml() only sees the text it is given, so a color set on one line and
+ * reset on a later one would be lost for all lines in between. The converter remembers the SGR
+ * (color and style) sequences still active at the end of each line and prepends them to the next.
+ */
+class CUTTER_EXPORT AnsiHtmlConverter
+{
+public:
+    /**
+     * @param line single line without the line break
+     */
+    QString lineToHtml(const QString &line);
+
+    /**
+     * @brief Take over the attributes of a line which isn't shown
+     */
+    void skipLine(const QString &line);
+
+    /**
+     * @brief Forget the active attributes, the next line starts with the default style.
+     */
+    void reset() { activeSgr.clear(); }
+
+private:
+    /// SGR sequences set since the last reset, in the order they appeared
+    QString activeSgr;
+};
+
+#endif // ANSIHTMLCONVERTER_H
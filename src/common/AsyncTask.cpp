@@ -1,5 +1,8 @@
 
 #include "AsyncTask.h"
+#include "core/Cutter.h"
+
+static thread_local AsyncTask *currentTask = nullptr;
 
 AsyncTask::AsyncTask() : QObject(nullptr), QRunnable()
 {
@@ -32,22 +35,40 @@ void AsyncTask::interrupt()
     interrupted = true;
 }
 
+bool AsyncTask::isCurrentTaskInterrupted()
+{
+    return currentTask && currentTask->isInterrupted();
+}
+
 void AsyncTask::prepareRun()
 {
     interrupted = false;
     wait();
+    queueWaitTime = -1;
     timer.start();
 }
 
+void AsyncTask::cancelQueued()
+{
+    interrupted = true;
+    emit finished();
+}
+
 void AsyncTask::run()
 {
     runningMutex.lock();
 
     running = true;
+    queueWaitTime = timer.elapsed();
 
     logBuffer.clear();
     emit logChanged(logBuffer);
-    runTask();
+    if (!interrupted) {
+        SessionScope scope(session);
+        currentTask = this;
+        runTask();
+        currentTask = nullptr;
+    }
 
     running = false;
 
@@ -71,19 +92,58 @@ AsyncTaskManager::~AsyncTaskManager() {}
 
 void AsyncTaskManager::start(AsyncTask::Ptr task)
 {
+    if (!task->getKey().isEmpty()) {
+        // A newer task of the same kind supersedes the old ones. Queued ones are dropped right
+        // away and still emit finished() so their owners can let go of them, running ones are
+        // asked to stop and will be removed once they finish.
+        const auto currentTasks = tasks;
+        for (const AsyncTask::Ptr &other : currentTasks) {
+            if (other == task || other->getKey() != task->getKey()) {
+                continue;
+            }
+            other->interrupt();
+            if (threadPool->tryTake(other.data())) {
+                // Also removes the task from the list
+                other->cancelQueued();
+            }
+        }
+    }
+
     tasks.append(task);
+    task->session = qobject_cast<CutterCore *>(parent());
     task->prepareRun();
 
-    QWeakPointer<AsyncTask> weakPtr = task;
-    connect(task.data(), &AsyncTask::finished, this, [this, weakPtr]() {
-        tasks.removeOne(weakPtr);
-        emit tasksChanged();
-    });
-    threadPool->start(task.data());
+    AsyncTask *taskPtr = task.data();
+    connect(taskPtr, &AsyncTask::finished, this, [this, taskPtr]() { removeTask(taskPtr); });
+    threadPool->start(taskPtr, task->getPriority() == AsyncTask::Priority::Interactive ? 1 : 0);
     emit tasksChanged();
 }
 
+void AsyncTaskManager::removeTask(AsyncTask *task)
+{
+    for (int i = 0; i < tasks.size(); i++) {
+        if (tasks[i].data() == task) {
+            tasks.removeAt(i);
+            emit tasksChanged();
+            return;
+        }
+    }
+}
+
 bool AsyncTaskManager::getTasksRunning()
 {
     return !tasks.isEmpty();
 }
+
+void AsyncTaskManager::interruptAndWait()
+{
+    // Queued tasks are finished like superseded ones, so their owners and the list hear of it
+    const auto currentTasks = tasks;
+    for (const AsyncTask::Ptr &task : currentTasks) {
+        task->interrupt();
+        if (threadPool->tryTake(task.data())) {
+            task->cancelQueued();
+        }
+    }
+    threadPool->waitForDone();
+}
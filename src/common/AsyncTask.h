@@ -11,7 +11,10 @@
 #include <QSharedPointer>
 #include <QList>
 
+#include <atomic>
+
 class AsyncTaskManager;
+class CutterCore;
 
 class CUTTER_EXPORT AsyncTask : public QObject, public QRunnable
 {
@@ -22,6 +25,11 @@ class CUTTER_EXPORT AsyncTask : public QObject, public QRunnable
 public:
     using Ptr = QSharedPointer<AsyncTask>;
 
+    /**
+     * @brief Scheduling priority, interactive tasks are started before queued background tasks
+     */
+    enum class Priority { Background, Interactive };
+
     AsyncTask();
     ~AsyncTask();
 
@@ -35,10 +43,45 @@ public:
 
     const QString &getLog() { return logBuffer; }
     const QElapsedTimer &getTimer() { return timer; }
+    /**
+     * @return milliseconds since the task was started, including the time spent in the queue
+     */
     qint64 getElapsedTime() { return timer.isValid() ? timer.elapsed() : 0; }
+    /**
+     * @return milliseconds the task waited in the queue before running, or -1 if still queued
+     */
+    qint64 getQueueWaitTime() { return queueWaitTime; }
+    /**
+     * @return milliseconds the task has been running, or 0 if it is still queued
+     */
+    qint64 getRunTime()
+    {
+        qint64 waitTime = queueWaitTime;
+        return waitTime < 0 ? 0 : getElapsedTime() - waitTime;
+    }
 
     virtual QString getTitle() { return QString(); }
 
+    Priority getPriority() const { return priority; }
+    void setPriority(Priority priority) { this->priority = priority; }
+
+    /**
+     * @brief Tasks with the same non-empty key compute the same thing for the same consumer.
+     * Starting a task interrupts all unfinished tasks with the same key. Queued ones never run,
+     * they emit finished() right away.
+     */
+    const QString &getKey() const { return key; }
+    void setKey(const QString &key) { this->key = key; }
+
+    /**
+     * @brief Check whether the task running on the current thread has been interrupted.
+     *
+     * Allows long running functions like the CutterCore::get* producers to stop early when they
+     * are called from an AsyncTask whose result is not needed anymore. Always false outside of
+     * tasks.
+     */
+    static bool isCurrentTaskInterrupted();
+
 protected:
     virtual void runTask() = 0;
 
@@ -54,9 +97,24 @@ private:
     QMutex runningMutex;
 
     QElapsedTimer timer;
+    /**
+     * Written by the worker thread, read by the task list on the GUI thread
+     */
+    std::atomic<qint64> queueWaitTime { -1 };
     QString logBuffer;
 
+    Priority priority = Priority::Interactive;
+    QString key;
+    /**
+     * Session of the manager that started the task, Core() resolves to it while the task runs
+     */
+    CutterCore *session = nullptr;
+
     void prepareRun();
+    /**
+     * @brief Finish a task which was taken back from the queue before it ran
+     */
+    void cancelQueued();
 };
 
 class AsyncTaskManager : public QObject
@@ -67,12 +125,24 @@ private:
     QThreadPool *threadPool;
     QList<AsyncTask::Ptr> tasks;
 
+    void removeTask(AsyncTask *task);
+
 public:
     explicit AsyncTaskManager(QObject *parent = nullptr);
     ~AsyncTaskManager();
 
     void start(AsyncTask::Ptr task);
     bool getTasksRunning();
+    /**
+     * @brief Interrupt all tasks, drop the queued ones and wait for the running ones to finish
+     *
+     * Must be called before the session of the tasks is freed.
+     */
+    void interruptAndWait();
+    /**
+     * @return all tasks that are queued or running
+     */
+    const QList<AsyncTask::Ptr> &getTasks() const { return tasks; }
 
 signals:
     void tasksChanged();
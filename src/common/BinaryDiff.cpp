@@ -0,0 +1,532 @@
+#include "BinaryDiff.h"
+
+#include "core/Cutter.h"
+#include "common/ParallelFor.h"
+#include "common/XrefIndex.h"
+
+#include <QHash>
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+/**
+ * Basic blocks larger than this are the result of broken analysis, their bytes are not hashed.
+ */
+constexpr ut64 MaxBlockSize = 0x10000;
+constexpr double MinSimilarity = 0.5;
+constexpr int MaxCalleeRounds = 8;
+
+struct Fnv64
+{
+    quint64 value = 0xcbf29ce484222325ULL;
+
+    void add(const void *data, size_t len)
+    {
+        const ut8 *bytes = static_cast<const ut8 *>(data);
+        for (size_t i = 0; i < len; i++) {
+            value = (value ^ bytes[i]) * 0x100000001b3ULL;
+        }
+    }
+
+    void add(quint64 word) { add(&word, sizeof(word)); }
+};
+
+/**
+ * @brief Map from key to the index of the only function with that key, or -1 if several
+ * functions share it.
+ */
+using UniqueKeys = QHash<quint64, int>;
+
+void addUnique(UniqueKeys &keys, quint64 key, int index)
+{
+    auto it = keys.find(key);
+    if (it == keys.end()) {
+        keys.insert(key, index);
+    } else {
+        it.value() = -1;
+    }
+}
+
+class Matcher
+{
+public:
+    using Fingerprint = BinaryDiff::Fingerprint;
+
+    Matcher(const std::vector<Fingerprint> &primary, const std::vector<Fingerprint> &secondary)
+        : a(primary), b(secondary), matchA(primary.size(), -1), matchB(secondary.size(), -1)
+    {
+        for (size_t i = 0; i < a.size(); i++) {
+            indexA.insert(a[i].offset, static_cast<int>(i));
+        }
+        for (size_t i = 0; i < b.size(); i++) {
+            indexB.insert(b[i].offset, static_cast<int>(i));
+        }
+    }
+
+    /**
+     * @brief Pair unmatched functions whose key is unique on both sides, a key of 0 means the
+     * function has no usable key.
+     */
+    template<typename Key>
+    int matchUniqueKeys(Key key)
+    {
+        UniqueKeys keysA;
+        UniqueKeys keysB;
+        for (size_t i = 0; i < a.size(); i++) {
+            quint64 k = key(a[i]);
+            if (matchA[i] < 0 && k) {
+                addUnique(keysA, k, static_cast<int>(i));
+            }
+        }
+        for (size_t i = 0; i < b.size(); i++) {
+            quint64 k = key(b[i]);
+            if (matchB[i] < 0 && k) {
+                addUnique(keysB, k, static_cast<int>(i));
+            }
+        }
+        return pairKeys(keysA, keysB);
+    }
+
+    /**
+     * @brief Pair unmatched callees of already paired functions which have a unique structure
+     * among the callees on both sides. Repeats as long as new pairs are found.
+     */
+    int matchCallees()
+    {
+        int total = 0;
+        for (int round = 0; round < MaxCalleeRounds; round++) {
+            int matched = 0;
+            for (size_t i = 0; i < a.size(); i++) {
+                int j = matchA[i];
+                if (j < 0) {
+                    continue;
+                }
+                UniqueKeys keysA;
+                UniqueKeys keysB;
+                collectCallees(a[i], a, indexA, matchA, keysA);
+                collectCallees(b[j], b, indexB, matchB, keysB);
+                matched += pairKeys(keysA, keysB);
+            }
+            total += matched;
+            if (!matched) {
+                break;
+            }
+        }
+        return total;
+    }
+
+    /**
+     * @brief Pair the remaining functions by similarity, best scores first.
+     * @return false if interrupted
+     */
+    bool matchSimilar(const std::function<bool()> &interrupted)
+    {
+        std::vector<int> restA;
+        std::vector<int> restB;
+        for (size_t i = 0; i < a.size(); i++) {
+            if (matchA[i] < 0) {
+                restA.push_back(static_cast<int>(i));
+            }
+        }
+        for (size_t i = 0; i < b.size(); i++) {
+            if (matchB[i] < 0) {
+                restB.push_back(static_cast<int>(i));
+            }
+        }
+        if (restA.empty() || restB.empty()) {
+            return true;
+        }
+        // Candidates are limited to functions with at most twice or half the number of blocks
+        std::sort(restB.begin(), restB.end(),
+                  [this](int x, int y) { return b[x].blocks < b[y].blocks; });
+
+        struct Candidate
+        {
+            double score;
+            int i;
+            int j;
+        };
+        const size_t maxCandidates = 3;
+        std::vector<std::vector<Candidate>> candidates(restA.size());
+        parallelFor(static_cast<int>(restA.size()), [&](int k) {
+            if (interrupted()) {
+                return;
+            }
+            const Fingerprint &fa = a[restA[k]];
+            auto fewerBlocks = [this](int x, int blocks) { return b[x].blocks < blocks; };
+            auto first = std::lower_bound(restB.begin(), restB.end(), fa.blocks / 2, fewerBlocks);
+            std::vector<Candidate> &best = candidates[k];
+            for (auto it = first; it != restB.end() && b[*it].blocks <= fa.blocks * 2 + 1; ++it) {
+                double score = BinaryDiff::similarity(fa, b[*it]);
+                if (score < MinSimilarity) {
+                    continue;
+                }
+                best.push_back({ score, restA[k], *it });
+                std::sort(best.begin(), best.end(), [](const Candidate &x, const Candidate &y) {
+                    return x.score > y.score;
+                });
+                if (best.size() > maxCandidates) {
+                    best.pop_back();
+                }
+            }
+        });
+        if (interrupted()) {
+            return false;
+        }
+
+        std::vector<Candidate> all;
+        for (const auto &best : candidates) {
+            all.insert(all.end(), best.begin(), best.end());
+        }
+        std::sort(all.begin(), all.end(), [](const Candidate &x, const Candidate &y) {
+            if (x.score != y.score) {
+                return x.score > y.score;
+            }
+            return x.i != y.i ? x.i < y.i : x.j < y.j;
+        });
+        for (const Candidate &candidate : all) {
+            if (matchA[candidate.i] < 0 && matchB[candidate.j] < 0) {
+                pair(candidate.i, candidate.j);
+            }
+        }
+        return true;
+    }
+
+    QVector<BinaryDiff::Match> result() const
+    {
+        QVector<BinaryDiff::Match> matches;
+        matches.reserve(static_cast<int>(a.size() + b.size()));
+        for (size_t i = 0; i < a.size(); i++) {
+            BinaryDiff::Match match;
+            match.primary = a[i].offset;
+            match.primaryName = a[i].name;
+            int j = matchA[i];
+            if (j >= 0) {
+                match.secondary = b[j].offset;
+                match.secondaryName = b[j].name;
+                if (a[i].bytesHash == b[j].bytesHash) {
+                    match.status = BinaryDiff::Status::Identical;
+                    match.similarity = 1.0;
+                } else {
+                    match.status = BinaryDiff::Status::Changed;
+                    match.similarity = BinaryDiff::similarity(a[i], b[j]);
+                }
+            }
+            matches.append(match);
+        }
+        for (size_t j = 0; j < b.size(); j++) {
+            if (matchB[j] >= 0) {
+                continue;
+            }
+            BinaryDiff::Match match;
+            match.secondary = b[j].offset;
+            match.secondaryName = b[j].name;
+            match.status = BinaryDiff::Status::Added;
+            matches.append(match);
+        }
+        return matches;
+    }
+
+private:
+    const std::vector<Fingerprint> &a;
+    const std::vector<Fingerprint> &b;
+    std::vector<int> matchA;
+    std::vector<int> matchB;
+    QHash<RVA, int> indexA;
+    QHash<RVA, int> indexB;
+
+    void pair(int i, int j)
+    {
+        matchA[i] = j;
+        matchB[j] = i;
+    }
+
+    int pairKeys(const UniqueKeys &keysA, const UniqueKeys &keysB)
+    {
+        int matched = 0;
+        for (auto it = keysA.constBegin(); it != keysA.constEnd(); ++it) {
+            int j = keysB.value(it.key(), -1);
+            if (it.value() < 0 || j < 0) {
+                continue;
+            }
+            pair(it.value(), j);
+            matched++;
+        }
+        return matched;
+    }
+
+    static void collectCallees(const Fingerprint &function,
+                               const std::vector<Fingerprint> &functions,
+                               const QHash<RVA, int> &index, const std::vector<int> &matches,
+                               UniqueKeys &keys)
+    {
+        for (RVA callee : function.callees) {
+            int k = index.value(callee, -1);
+            if (k >= 0 && matches[k] < 0) {
+                addUnique(keys, functions[k].structureHash, k);
+            }
+        }
+    }
+};
+
+}
+
+bool BinaryDiff::isGeneratedName(const QString &name)
+{
+    static const char *const prefixes[] = { "fcn.", "sub.", "loc.", "case." };
+    for (const char *prefix : prefixes) {
+        if (name.startsWith(QLatin1String(prefix))) {
+            return true;
+        }
+    }
+    return name.isEmpty();
+}
+
+bool BinaryDiff::fingerprintFunction(RVA offset, Fingerprint &fingerprint)
+{
+    RzCoreLocked core(Core());
+    RzAnalysisFunction *fcn = rz_analysis_get_function_at(core->analysis, offset);
+    if (!fcn) {
+        return false;
+    }
+    fingerprint.offset = fcn->addr;
+    fingerprint.name = QString::fromUtf8(fcn->name);
+
+    std::vector<RzAnalysisBlock *> blocks;
+    for (const auto &bb : CutterPVector<RzAnalysisBlock>(fcn->bbs)) {
+        blocks.push_back(bb);
+    }
+    std::sort(blocks.begin(), blocks.end(),
+              [](const RzAnalysisBlock *x, const RzAnalysisBlock *y) { return x->addr < y->addr; });
+
+    Fnv64 bytesHash;
+    Fnv64 mnemonicHash;
+    std::vector<quint64> shape;
+    std::vector<ut8> buf;
+    std::vector<ut8> normalized;
+    for (RzAnalysisBlock *bb : blocks) {
+        int outDegree = (bb->jump != UT64_MAX) + (bb->fail != UT64_MAX);
+        fingerprint.edges += outDegree;
+        shape.push_back((static_cast<quint64>(bb->ninstr) << 32) | static_cast<quint32>(outDegree));
+
+        Fnv64 blockHash;
+        if (bb->size && bb->size <= MaxBlockSize) {
+            buf.resize(bb->size);
+            rz_io_read_at(core->io, bb->addr, buf.data(), static_cast<int>(bb->size));
+            // Branch targets, pointers and displacements differ as soon as code moves, they are
+            // masked out so a relocated function still has the same bytes
+            normalized = buf;
+            if (ut8 *mask = rz_analysis_mask(core->analysis, static_cast<ut32>(bb->size),
+                                             buf.data(), bb->addr)) {
+                for (size_t i = 0; i < normalized.size(); i++) {
+                    normalized[i] &= mask[i];
+                }
+                free(mask);
+            }
+            bytesHash.add(normalized.data(), normalized.size());
+
+            // Only the mnemonics are hashed, operands change with every relocation
+            for (ut64 pos = 0; pos < bb->size;) {
+                RzAsmOp op;
+                rz_asm_op_init(&op);
+                rz_asm_set_pc(core->rasm, bb->addr + pos);
+                int len = rz_asm_disassemble(core->rasm, &op, buf.data() + pos,
+                                             static_cast<int>(bb->size - pos));
+                const char *text = rz_asm_op_get_asm(&op);
+                if (text) {
+                    blockHash.add(text, strcspn(text, " "));
+                }
+                blockHash.add("\n", 1);
+                rz_asm_op_fini(&op);
+                if (len <= 0) {
+                    break;
+                }
+                pos += static_cast<ut64>(len);
+                fingerprint.instructions++;
+            }
+        }
+        mnemonicHash.add(blockHash.value);
+        fingerprint.blockHashes.push_back(blockHash.value);
+    }
+    fingerprint.blocks = static_cast<int>(blocks.size());
+    fingerprint.bytesHash = bytesHash.value;
+    fingerprint.mnemonicHash = mnemonicHash.value;
+    std::sort(fingerprint.blockHashes.begin(), fingerprint.blockHashes.end());
+
+    // The shape of the block graph without its layout in memory
+    std::sort(shape.begin(), shape.end());
+    Fnv64 structureHash;
+    structureHash.add(static_cast<quint64>(fingerprint.edges));
+    for (quint64 block : shape) {
+        structureHash.add(block);
+    }
+    fingerprint.structureHash = structureHash.value;
+    return true;
+}
+
+void BinaryDiff::computeNeighbourhoods(std::vector<Fingerprint> &functions)
+{
+    XrefIndex *xrefs = Core()->getXrefIndex();
+    QHash<RVA, int> index;
+    for (size_t i = 0; i < functions.size(); i++) {
+        index.insert(functions[i].offset, static_cast<int>(i));
+    }
+    for (Fingerprint &function : functions) {
+        const QVector<RVA> callees = xrefs->callees(function.offset);
+        function.callees.assign(callees.begin(), callees.end());
+    }
+    for (Fingerprint &function : functions) {
+        std::vector<quint64> calleeHashes;
+        for (RVA callee : function.callees) {
+            int k = index.value(callee, -1);
+            if (k >= 0) {
+                calleeHashes.push_back(functions[k].structureHash);
+            }
+        }
+        std::sort(calleeHashes.begin(), calleeHashes.end());
+        Fnv64 hash;
+        hash.add(function.structureHash);
+        for (quint64 calleeHash : calleeHashes) {
+            hash.add(calleeHash);
+        }
+        function.neighbourhoodHash = hash.value;
+    }
+}
+
+std::vector<BinaryDiff::Fingerprint>
+BinaryDiff::fingerprintFunctions(const std::function<bool()> &interrupted)
+{
+    std::vector<RVA> offsets;
+    {
+        RzCoreLocked core(Core());
+        for (const auto &fcn : CutterRzList<RzAnalysisFunction>(core->analysis->fcns)) {
+            offsets.push_back(fcn->addr);
+        }
+    }
+
+    // Every function takes the core lock separately, so the session stays responsive
+    std::vector<Fingerprint> functions;
+    functions.reserve(offsets.size());
+    for (RVA offset : offsets) {
+        if (interrupted()) {
+            return {};
+        }
+        Fingerprint fingerprint;
+        if (fingerprintFunction(offset, fingerprint)) {
+            functions.push_back(std::move(fingerprint));
+        }
+    }
+    computeNeighbourhoods(functions);
+    return functions;
+}
+
+double BinaryDiff::similarity(const Fingerprint &a, const Fingerprint &b)
+{
+    if (!a.blocks || !b.blocks) {
+        return a.blocks == b.blocks && a.bytesHash == b.bytesHash ? 1.0 : 0.0;
+    }
+    // Size of the intersection of the multisets of block hashes
+    size_t common = 0;
+    for (size_t i = 0, j = 0; i < a.blockHashes.size() && j < b.blockHashes.size();) {
+        if (a.blockHashes[i] == b.blockHashes[j]) {
+            common++;
+            i++;
+            j++;
+        } else if (a.blockHashes[i] < b.blockHashes[j]) {
+            i++;
+        } else {
+            j++;
+        }
+    }
+    double blockScore = 2.0 * common / (a.blockHashes.size() + b.blockHashes.size());
+    auto ratio = [](int x, int y) {
+        return x == y ? 1.0 : static_cast<double>(std::min(x, y)) / std::max(x, y);
+    };
+    return 0.5 * blockScore + 0.2 * ratio(a.blocks, b.blocks) + 0.15 * ratio(a.edges, b.edges)
+            + 0.15 * ratio(a.instructions, b.instructions);
+}
+
+QVector<BinaryDiff::Match> BinaryDiff::match(const std::vector<Fingerprint> &primary,
+                                             const std::vector<Fingerprint> &secondary,
+                                             const std::function<bool()> &interrupted)
+{
+    Matcher matcher(primary, secondary);
+    matcher.matchUniqueKeys([](const Fingerprint &f) { return f.instructions ? f.bytesHash : 0; });
+    matcher.matchUniqueKeys([](const Fingerprint &f) {
+        return f.instructions ? f.mnemonicHash ^ (f.structureHash * 31) : 0;
+    });
+    matcher.matchUniqueKeys([](const Fingerprint &f) { return f.neighbourhoodHash; });
+    matcher.matchUniqueKeys([](const Fingerprint &f) -> quint64 {
+        if (isGeneratedName(f.name)) {
+            return 0;
+        }
+        Fnv64 hash;
+        hash.add(f.name.constData(), f.name.size() * sizeof(QChar));
+        return hash.value;
+    });
+    if (interrupted()) {
+        return {};
+    }
+    matcher.matchCallees();
+    if (!matcher.matchSimilar(interrupted)) {
+        return {};
+    }
+    return matcher.result();
+}
+
+BinaryDiffTask::BinaryDiffTask(CutterCore *secondary, const QString &path)
+    : secondary(secondary), path(path)
+{
+}
+
+BinaryDiffTask::~BinaryDiffTask()
+{
+    if (ownsSecondary) {
+        // Free the session on the thread it belongs to, whichever thread releases the task
+        secondary->deleteLater();
+    }
+}
+
+void BinaryDiffTask::runTask()
+{
+    auto interrupted = [this]() { return isInterrupted(); };
+
+    if (!path.isEmpty()) {
+        SessionScope scope(secondary);
+        log(tr("Loading %1...").arg(path));
+        if (!Core()->loadFile(path, 0, 0, RZ_PERM_R, 1, true)) {
+            emit failed(tr("Could not load %1").arg(path));
+            return;
+        }
+        log(tr("Analyzing..."));
+        Core()->performAutoAnalysis();
+    }
+    if (isInterrupted()) {
+        return;
+    }
+
+    log(tr("Fingerprinting functions..."));
+    std::vector<BinaryDiff::Fingerprint> secondaryFunctions;
+    std::thread secondaryThread([&]() {
+        SessionScope scope(secondary);
+        secondaryFunctions = BinaryDiff::fingerprintFunctions(interrupted);
+    });
+    std::vector<BinaryDiff::Fingerprint> primaryFunctions =
+            BinaryDiff::fingerprintFunctions(interrupted);
+    secondaryThread.join();
+    if (isInterrupted()) {
+        return;
+    }
+
+    log(tr("Matching %1 and %2 functions...")
+                .arg(primaryFunctions.size())
+                .arg(secondaryFunctions.size()));
+    QVector<BinaryDiff::Match> matches =
+            BinaryDiff::match(primaryFunctions, secondaryFunctions, interrupted);
+    if (!isInterrupted()) {
+        emit resultReady(matches);
+    }
+}
@@ -0,0 +1,130 @@
+#ifndef BINARYDIFF_H
+#define BINARYDIFF_H
+
+#include "common/AsyncTask.h"
+#include "core/CutterCommon.h"
+
+#include <QVector>
+
+#include <functional>
+#include <vector>
+
+class CutterCore;
+
+/**
+ * @brief Function level comparison of two analyzed binaries
+ *
+ * Every function is reduced to a fingerprint of hashes over its basic block structure, the
+ * mnemonics of its instructions, its bytes without address dependent operands and the structure
+ * of the functions it calls. Functions are paired by hashes which are unique on both sides first,
+ * then by names given in the binaries, then by walking the callees of already paired functions.
+ * The remaining functions are paired by a similarity score, which is computed on all threads.
+ */
+class CUTTER_EXPORT BinaryDiff
+{
+public:
+    enum class Status { Identical, Changed, Removed, Added };
+
+    struct Fingerprint
+    {
+        RVA offset = RVA_INVALID;
+        QString name;
+        int blocks = 0;
+        int edges = 0;
+        int instructions = 0;
+        quint64 structureHash = 0;
+        quint64 mnemonicHash = 0;
+        /**
+         * Hash of the bytes with branch targets, pointers and displacements masked out, equal for
+         * identical functions loaded at different addresses
+         */
+        quint64 bytesHash = 0;
+        quint64 neighbourhoodHash = 0;
+        /**
+         * Mnemonic hashes of the single basic blocks, sorted
+         */
+        std::vector<quint64> blockHashes;
+        std::vector<RVA> callees;
+    };
+
+    struct Match
+    {
+        RVA primary = RVA_INVALID;
+        RVA secondary = RVA_INVALID;
+        QString primaryName;
+        QString secondaryName;
+        Status status = Status::Removed;
+        double similarity = 0.0;
+    };
+
+    /**
+     * @brief Fingerprint all functions of the session Core() currently resolves to.
+     * @param interrupted checked between functions, an empty result is returned once it is true
+     */
+    static std::vector<Fingerprint> fingerprintFunctions(const std::function<bool()> &interrupted);
+
+    /**
+     * @brief Pair the functions of two binaries.
+     * @return one entry per pair and per function without counterpart, empty if interrupted
+     */
+    static QVector<Match> match(const std::vector<Fingerprint> &primary,
+                                const std::vector<Fingerprint> &secondary,
+                                const std::function<bool()> &interrupted);
+
+    /**
+     * @brief Similarity of two functions in [0, 1], 1 for the same block structure and mnemonics.
+     */
+    static double similarity(const Fingerprint &a, const Fingerprint &b);
+
+private:
+    static bool fingerprintFunction(RVA offset, Fingerprint &fingerprint);
+    static void computeNeighbourhoods(std::vector<Fingerprint> &functions);
+    static bool isGeneratedName(const QString &name);
+};
+
+Q_DECLARE_METATYPE(BinaryDiff::Match)
+
+/**
+ * @brief Loads and analyzes a second binary in its own session and diffs it against the session
+ * the task was started in
+ *
+ * Both binaries are fingerprinted at the same time, each on its own thread and under the lock of
+ * its own core.
+ */
+class CUTTER_EXPORT BinaryDiffTask : public AsyncTask
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @param secondary initialized session to load the second binary into, it must stay alive
+     * until the task finished
+     * @param path file to load, empty if the binary is already loaded and analyzed in secondary
+     */
+    BinaryDiffTask(CutterCore *secondary, const QString &path);
+
+    QString getTitle() override { return tr("Diffing binaries"); }
+    ~BinaryDiffTask() override;
+
+    /**
+     * @brief Free the secondary session together with the task
+     *
+     * The analysis of the second binary can't be interrupted. Owners which stop waiting for the
+     * task hand the session over instead of blocking until the analysis is done.
+     */
+    void adoptSecondary() { ownsSecondary = true; }
+
+signals:
+    void resultReady(const QVector<BinaryDiff::Match> &matches);
+    void failed(const QString &message);
+
+protected:
+    void runTask() override;
+
+private:
+    CutterCore *secondary;
+    QString path;
+    bool ownsSecondary = false;
+};
+
+#endif // BINARYDIFF_H
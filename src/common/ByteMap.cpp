@@ -0,0 +1,470 @@
+#include "ByteMap.h"
+
+#include "core/Cutter.h"
+#include "common/ParallelFor.h"
+#include "common/ResourcePaths.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+using ByteClass = ByteMap::ByteClass;
+
+constexpr quint32 CacheMagic = 0x43424d50;
+constexpr quint32 CacheVersion = 1;
+/**
+ * Bytes read from the core at once, rounded up to whole blocks
+ */
+constexpr ut64 ChunkSize = 1 << 20;
+constexpr size_t HashChunkSize = 1 << 20;
+/**
+ * Regions above this size are left out, they are usually bogus segment sizes or sparse maps of
+ * core files rather than contents worth classifying
+ */
+constexpr ut64 MaxRegionSize = 1ULL << 30;
+/**
+ * Regions are left out once this much is scanned in total. Together with MaxBlocks this keeps
+ * blocks, and so the buffers of the chunks, below ChunkSize.
+ */
+constexpr ut64 MaxScanSize = 4ULL << 30;
+/**
+ * Thresholds of the classification, fractions of the block size and bits per byte
+ */
+constexpr double PaddingRatio = 0.9;
+constexpr double TextRatio = 0.85;
+constexpr double RandomEntropy = 7.2;
+
+using Histogram = std::array<ut32, 256>;
+
+/**
+ * @brief Count the bytes of data
+ *
+ * Eight bytes are loaded at once and spread over four tables, so consecutive equal bytes, which
+ * are common in padding and tables, don't all wait on the same counter. The tables are summed at
+ * the end.
+ */
+void histogram(const ut8 *data, size_t size, Histogram &result)
+{
+    ut32 tables[4][256] = {};
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        ut64 word;
+        memcpy(&word, data + i, sizeof(word));
+        tables[0][word & 0xff]++;
+        tables[1][(word >> 8) & 0xff]++;
+        tables[2][(word >> 16) & 0xff]++;
+        tables[3][(word >> 24) & 0xff]++;
+        tables[0][(word >> 32) & 0xff]++;
+        tables[1][(word >> 40) & 0xff]++;
+        tables[2][(word >> 48) & 0xff]++;
+        tables[3][word >> 56]++;
+    }
+    for (; i < size; i++) {
+        tables[0][data[i]]++;
+    }
+    for (int b = 0; b < 256; b++) {
+        result[b] = tables[0][b] + tables[1][b] + tables[2][b] + tables[3][b];
+    }
+}
+
+bool isText(int byte)
+{
+    return (byte >= 0x20 && byte < 0x7f) || byte == '\t' || byte == '\n' || byte == '\r';
+}
+
+void classify(const Histogram &counts, size_t size, ut8 &entropy, ByteClass &byteClass)
+{
+    double bits = 0.0;
+    ut64 text = 0;
+    for (int b = 0; b < 256; b++) {
+        if (!counts[b]) {
+            continue;
+        }
+        double p = static_cast<double>(counts[b]) / size;
+        bits -= p * std::log2(p);
+        if (isText(b)) {
+            text += counts[b];
+        }
+    }
+    entropy = static_cast<ut8>(std::lround(std::min(bits, 8.0) * 255 / 8));
+    if (counts[0x00] + counts[0xff] >= PaddingRatio * size) {
+        byteClass = ByteClass::Padding;
+    } else if (bits >= RandomEntropy) {
+        byteClass = ByteClass::Random;
+    } else if (text >= TextRatio * size) {
+        byteClass = ByteClass::Text;
+    } else {
+        byteClass = ByteClass::Mixed;
+    }
+}
+
+ut64 blockCount(ut64 size, ut64 blockSize)
+{
+    return size / blockSize + (size % blockSize != 0);
+}
+
+/**
+ * @return SHA-1 of the contents of the opened file, empty if there is none or when interrupted
+ */
+QByteArray hashOpenedFile(CutterCore *core, const std::function<bool()> &interrupted)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    std::vector<ut8> buffer(HashChunkSize);
+    for (ut64 offset = 0;; offset += buffer.size()) {
+        if (interrupted && interrupted()) {
+            return {};
+        }
+        st64 read;
+        {
+            RzCoreLocked locked(core);
+            RzBinFile *bf = rz_bin_cur(locked->bin);
+            if (!bf || !bf->buf) {
+                return {};
+            }
+            read = rz_buf_read_at(bf->buf, offset, buffer.data(), buffer.size());
+        }
+        if (read <= 0) {
+            break;
+        }
+        hash.addData(reinterpret_cast<const char *>(buffer.data()), static_cast<int>(read));
+        if (static_cast<ut64>(read) < buffer.size()) {
+            break;
+        }
+    }
+    return hash.result();
+}
+
+QString cacheDirectory()
+{
+    return Cutter::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/bytemap");
+}
+
+} // namespace
+
+ByteMap::ByteClass ByteMap::Summary::dominantClass() const
+{
+    auto it = std::max_element(classBytes.begin(), classBytes.end());
+    return static_cast<ByteClass>(it - classBytes.begin());
+}
+
+std::shared_ptr<ByteMap> ByteMap::compute(CutterCore *core,
+                                          const std::function<bool()> &interrupted)
+{
+    auto map = std::make_shared<ByteMap>();
+    {
+        RzCoreLocked locked(core);
+        auto list = fromOwned(rz_core_get_boundaries_prot(locked, -1, NULL, "search"));
+        if (list) {
+            RzListIter *iter;
+            RzIOMap *ioMap;
+            CutterRzListForeach (list.get(), iter, RzIOMap, ioMap) {
+                ut64 from = rz_itv_begin(ioMap->itv);
+                ut64 to = rz_itv_end(ioMap->itv);
+                if (to > from) {
+                    map->regions.push_back({ from, to, 0 });
+                }
+            }
+        }
+    }
+    // Patches and the memory of a debuggee aren't part of the file, so the hash doesn't tell
+    // whether a cached map is current
+    const bool cacheable = !core->currentlyDebugging && !core->isIOCacheEnabled()
+            && !core->isWriteModeEnabled();
+    if (map->regions.empty()) {
+        return map;
+    }
+
+    std::sort(map->regions.begin(), map->regions.end(),
+              [](const Region &a, const Region &b) { return a.from < b.from; });
+    std::vector<Region> merged;
+    for (const Region &region : map->regions) {
+        if (!merged.empty() && region.from <= merged.back().to) {
+            merged.back().to = std::max(merged.back().to, region.to);
+        } else {
+            merged.push_back(region);
+        }
+    }
+    std::vector<Region> regions;
+    ut64 scanSize = 0;
+    for (const Region &region : merged) {
+        const ut64 size = region.to - region.from;
+        if (size > MaxRegionSize || size > MaxScanSize - scanSize) {
+            continue;
+        }
+        scanSize += size;
+        regions.push_back(region);
+    }
+    if (regions.empty()) {
+        map->regions.clear();
+        return map;
+    }
+    ut64 blocks;
+    for (;;) {
+        blocks = 0;
+        for (const Region &region : regions) {
+            blocks += blockCount(region.to - region.from, map->blockSize);
+        }
+        if (blocks <= MaxBlocks) {
+            break;
+        }
+        map->blockSize *= 2;
+    }
+    blocks = 0;
+    for (Region &region : regions) {
+        region.firstBlock = blocks;
+        blocks += blockCount(region.to - region.from, map->blockSize);
+    }
+    map->regions = std::move(regions);
+
+    QString cachePath;
+    if (cacheable) {
+        QByteArray fileHash = hashOpenedFile(core, interrupted);
+        if (!fileHash.isEmpty()) {
+            cachePath = cacheDirectory() + QLatin1Char('/')
+                    + QString::fromLatin1(map->cacheKey(fileHash)) + QStringLiteral(".bin");
+            if (map->loadCache(cachePath)) {
+                return map;
+            }
+        }
+    }
+
+    struct Chunk
+    {
+        RVA from;
+        ut64 size;
+        size_t firstBlock;
+    };
+    const ut64 blockSize = map->blockSize;
+    const ut64 chunkSize = std::max<ut64>(1, ChunkSize / blockSize) * blockSize;
+    std::vector<Chunk> chunks;
+    for (const Region &region : map->regions) {
+        const ut64 regionSize = region.to - region.from;
+        for (ut64 offset = 0; offset < regionSize; offset += chunkSize) {
+            ut64 size = std::min(chunkSize, regionSize - offset);
+            size_t firstBlock = region.firstBlock + offset / blockSize;
+            chunks.push_back({ region.from + offset, size, firstBlock });
+        }
+    }
+
+    map->entropy.resize(blocks);
+    map->classes.resize(blocks);
+    // Only reading takes the core lock, the histograms of a chunk are counted without it
+    std::atomic<bool> stop(false);
+    parallelFor(
+            static_cast<int>(chunks.size()),
+            [&](int i) {
+                if (stop || (interrupted && interrupted())) {
+                    stop = true;
+                    return;
+                }
+                const Chunk &chunk = chunks[i];
+                std::vector<ut8> buffer(chunk.size);
+                {
+                    RzCoreLocked locked(core);
+                    rz_io_read_at(locked->io, chunk.from, buffer.data(), chunk.size);
+                }
+                Histogram counts;
+                size_t block = chunk.firstBlock;
+                for (ut64 offset = 0; offset < chunk.size; offset += blockSize, block++) {
+                    size_t size = std::min(blockSize, chunk.size - offset);
+                    histogram(buffer.data() + offset, size, counts);
+                    classify(counts, size, map->entropy[block], map->classes[block]);
+                }
+            },
+            1);
+    if (stop) {
+        return nullptr;
+    }
+
+    if (!cachePath.isEmpty()) {
+        map->saveCache(cachePath);
+    }
+    return map;
+}
+
+std::shared_ptr<ByteMap> ByteMap::rescanned(CutterCore *core, RVA from, RVA to) const
+{
+    auto map = std::make_shared<ByteMap>(*this);
+    if (to <= from || isEmpty()) {
+        return map;
+    }
+    auto it = std::upper_bound(regions.begin(), regions.end(), from,
+                               [](RVA address, const Region &region) {
+                                   return address < region.from;
+                               });
+    if (it != regions.begin()) {
+        --it;
+    }
+    std::vector<ut8> buffer;
+    Histogram counts;
+    RzCoreLocked locked(core);
+    for (; it != regions.end() && it->from < to; ++it) {
+        RVA start = std::max(from, it->from);
+        RVA end = std::min(to, it->to);
+        if (start >= end) {
+            continue;
+        }
+        for (ut64 block = (start - it->from) / blockSize;; block++) {
+            RVA blockFrom = it->from + block * blockSize;
+            if (blockFrom >= end) {
+                break;
+            }
+            ut64 size = std::min(blockSize, it->to - blockFrom);
+            buffer.resize(size);
+            rz_io_read_at(locked->io, blockFrom, buffer.data(), size);
+            histogram(buffer.data(), size, counts);
+            size_t index = it->firstBlock + block;
+            classify(counts, size, map->entropy[index], map->classes[index]);
+        }
+    }
+    return map;
+}
+
+ByteMap::Summary ByteMap::summarize(RVA from, RVA to) const
+{
+    Summary summary;
+    if (to <= from || isEmpty()) {
+        return summary;
+    }
+    auto it = std::upper_bound(regions.begin(), regions.end(), from,
+                               [](RVA address, const Region &region) {
+                                   return address < region.from;
+                               });
+    if (it != regions.begin()) {
+        --it;
+    }
+    double weightedEntropy = 0.0;
+    for (; it != regions.end() && it->from < to; ++it) {
+        RVA start = std::max(from, it->from);
+        RVA end = std::min(to, it->to);
+        if (start >= end) {
+            continue;
+        }
+        for (ut64 block = (start - it->from) / blockSize;; block++) {
+            RVA blockFrom = it->from + block * blockSize;
+            if (blockFrom >= end) {
+                break;
+            }
+            RVA blockTo = it->to - blockFrom > blockSize ? blockFrom + blockSize : it->to;
+            ut64 overlap = std::min(blockTo, end) - std::max(blockFrom, start);
+            size_t index = it->firstBlock + block;
+            weightedEntropy += overlap * (entropy[index] * 8.0 / 255);
+            summary.classBytes[static_cast<int>(classes[index])] += overlap;
+            summary.size += overlap;
+        }
+    }
+    if (summary.size) {
+        summary.entropy = weightedEntropy / summary.size;
+    }
+    return summary;
+}
+
+QString ByteMap::className(ByteClass byteClass)
+{
+    switch (byteClass) {
+    case ByteClass::Padding:
+        return QObject::tr("Padding");
+    case ByteClass::Text:
+        return QObject::tr("Text");
+    case ByteClass::Mixed:
+        return QObject::tr("Code or data");
+    case ByteClass::Random:
+        return QObject::tr("Compressed or encrypted");
+    case ByteClass::Count:
+        break;
+    }
+    return QString();
+}
+
+QColor ByteMap::color(ByteClass byteClass, double entropy)
+{
+    switch (byteClass) {
+    case ByteClass::Text:
+        return QColor::fromHsvF(0.33, 0.6, 0.9);
+    case ByteClass::Mixed:
+        return QColor::fromHsvF(0.6, 0.7, 0.4 + 0.6 * std::min(entropy, 8.0) / 8);
+    case ByteClass::Random:
+        return QColor::fromHsvF(0.0, 0.85, 1.0);
+    case ByteClass::Padding:
+    case ByteClass::Count:
+        break;
+    }
+    return QColor();
+}
+
+QByteArray ByteMap::cacheKey(const QByteArray &fileHash) const
+{
+    QByteArray layout;
+    QDataStream stream(&layout, QIODevice::WriteOnly);
+    stream << quint64(blockSize);
+    for (const Region &region : regions) {
+        stream << quint64(region.from) << quint64(region.to);
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(fileHash);
+    hash.addData(layout);
+    return hash.result().toHex();
+}
+
+bool ByteMap::loadCache(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    QDataStream stream(&file);
+    quint32 magic, version;
+    quint64 count;
+    QByteArray entropyData, classData;
+    stream >> magic >> version >> count >> entropyData >> classData;
+    size_t blocks = regions.back().firstBlock
+            + blockCount(regions.back().to - regions.back().from, blockSize);
+    if (stream.status() != QDataStream::Ok || magic != CacheMagic || version != CacheVersion
+        || count != blocks || static_cast<size_t>(entropyData.size()) != blocks
+        || static_cast<size_t>(classData.size()) != blocks) {
+        return false;
+    }
+    std::vector<ByteClass> loadedClasses(blocks);
+    for (size_t i = 0; i < blocks; i++) {
+        ut8 value = static_cast<ut8>(classData[static_cast<int>(i)]);
+        if (value >= static_cast<ut8>(ByteClass::Count)) {
+            return false;
+        }
+        loadedClasses[i] = static_cast<ByteClass>(value);
+    }
+    entropy.assign(entropyData.begin(), entropyData.end());
+    classes = std::move(loadedClasses);
+    return true;
+}
+
+void ByteMap::saveCache(const QString &path) const
+{
+    if (!QDir().mkpath(cacheDirectory())) {
+        return;
+    }
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+    QDataStream stream(&file);
+    stream << CacheMagic << CacheVersion << quint64(classes.size())
+           << QByteArray(reinterpret_cast<const char *>(entropy.data()),
+                         static_cast<int>(entropy.size()))
+           << QByteArray(reinterpret_cast<const char *>(classes.data()),
+                         static_cast<int>(classes.size()));
+    file.commit();
+}
+
+void ByteMapTask::runTask()
+{
+    byteMap = ByteMap::compute(Core(), [this]() { return isInterrupted(); });
+}
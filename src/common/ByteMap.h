@@ -0,0 +1,129 @@
+#ifndef BYTEMAP_H
+#define BYTEMAP_H
+
+#include "core/CutterCommon.h"
+#include "common/AsyncTask.h"
+
+#include <QByteArray>
+#include <QColor>
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <vector>
+
+class CutterCore;
+
+/**
+ * @brief Entropy and byte class of every block of the mapped memory
+ *
+ * Blocks are at least MinBlockSize bytes, larger for big address spaces so there are no more than
+ * MaxBlocks of them. Regions too big to scan in reasonable time, like bogus segment sizes, are
+ * left out and treated as unmapped. Every block keeps its entropy quantized to a byte and a class
+ * telling apart padding, text, code or data, and compressed or encrypted contents, which is
+ * enough to spot packed regions in a firmware at a glance. Maps of files opened read only are
+ * cached on disk by the hash of the file, so opening the same file again doesn't read all of its
+ * memory.
+ */
+class CUTTER_EXPORT ByteMap
+{
+public:
+    enum class ByteClass : ut8 {
+        /// Almost only 0x00 or 0xff bytes
+        Padding,
+        /// Mostly printable characters
+        Text,
+        /// Anything in between, usually code or structured data
+        Mixed,
+        /// Entropy close to the maximum, compressed or encrypted
+        Random,
+        Count
+    };
+
+    struct Region
+    {
+        RVA from;
+        RVA to;
+        size_t firstBlock;
+    };
+
+    struct Summary
+    {
+        /// Average entropy in bits per byte, weighted by size
+        double entropy = 0.0;
+        /// Bytes of every class
+        std::array<ut64, static_cast<int>(ByteClass::Count)> classBytes = {};
+        ut64 size = 0;
+
+        ByteClass dominantClass() const;
+    };
+
+    static constexpr ut64 MinBlockSize = 0x1000;
+    static constexpr size_t MaxBlocks = 1 << 18;
+    /**
+     * Edits up to this size are applied with rescanned(), larger ones recompute the whole map
+     */
+    static constexpr ut64 MaxRescanSize = 1 << 20;
+
+    /**
+     * @brief Read all of the mapped memory of core and classify its blocks, or load them from the
+     * disk cache
+     * @param interrupted polled while reading, returning true stops
+     * @return nullptr if interrupted
+     */
+    static std::shared_ptr<ByteMap> compute(CutterCore *core,
+                                            const std::function<bool()> &interrupted = nullptr);
+
+    /**
+     * @brief Copy of the map with the blocks overlapping [from, to) read again from core, for
+     * edits of a few bytes. Takes the core lock.
+     */
+    std::shared_ptr<ByteMap> rescanned(CutterCore *core, RVA from, RVA to) const;
+
+    const std::vector<Region> &getRegions() const { return regions; }
+    ut64 getBlockSize() const { return blockSize; }
+    bool isEmpty() const { return classes.empty(); }
+
+    /**
+     * @brief Combine the blocks overlapping [from, to), unmapped parts are left out
+     */
+    Summary summarize(RVA from, RVA to) const;
+
+    static QString className(ByteClass byteClass);
+    /**
+     * @return color of blocks of the class with the given entropy, invalid for padding
+     */
+    static QColor color(ByteClass byteClass, double entropy);
+
+private:
+    std::vector<Region> regions;
+    ut64 blockSize = MinBlockSize;
+    /// Entropy of every block scaled from [0, 8] bits to [0, 255]
+    std::vector<ut8> entropy;
+    std::vector<ByteClass> classes;
+
+    QByteArray cacheKey(const QByteArray &fileHash) const;
+    bool loadCache(const QString &path);
+    void saveCache(const QString &path) const;
+};
+
+/**
+ * @brief Computes the ByteMap of the current session in the background
+ */
+class CUTTER_EXPORT ByteMapTask : public AsyncTask
+{
+    Q_OBJECT
+
+public:
+    QString getTitle() override { return tr("Computing entropy map"); }
+
+    std::shared_ptr<ByteMap> getByteMap() const { return byteMap; }
+
+protected:
+    void runTask() override;
+
+private:
+    std::shared_ptr<ByteMap> byteMap;
+};
+
+#endif // BYTEMAP_H
@@ -0,0 +1,214 @@
+#include "ChangeTracker.h"
+
+#include "core/Cutter.h"
+
+static const ChangeTracker::Domain allDomainsList[] = {
+    ChangeTracker::Functions, ChangeTracker::Flags,  ChangeTracker::Types,
+    ChangeTracker::Classes,   ChangeTracker::Memory, ChangeTracker::Registers,
+    ChangeTracker::Xrefs
+};
+
+static inline quint64 combineHash(quint64 seed, quint64 value)
+{
+    return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+static quint64 combineHash(quint64 seed, const char *str)
+{
+    // FNV-1a, only needs to detect differences between two states of the same analysis
+    quint64 h = 0xcbf29ce484222325ULL;
+    for (; str && *str; str++) {
+        h = (h ^ static_cast<unsigned char>(*str)) * 0x100000001b3ULL;
+    }
+    return combineHash(seed, h);
+}
+
+ChangeTracker::ChangeTracker(CutterCore *core) : QObject(core)
+{
+    // Generation 1 is the initial state, watchers start at 0 so that the first refresh happens.
+    counter = 1;
+    for (quint64 &generation : generations) {
+        generation = counter;
+    }
+
+    connect(core, &CutterCore::refreshAll, this, &ChangeTracker::refreshAllTriggered);
+
+    connect(core, &CutterCore::functionsChanged, this, [this]() { notifyChanged(Functions); });
+    // Consumers of renames update in place from CutterCore::functionRenamed, only advance the
+    // generations so that deferred widgets still reload once they become visible.
+    connect(core, &CutterCore::functionRenamed, this, [this]() { advance(Functions | Flags); });
+    connect(core, &CutterCore::flagsChanged, this, [this]() { notifyChanged(Flags); });
+
+    // Same for classes, the classes model applies these signals itself
+    connect(core, &CutterCore::classNew, this, [this]() { advance(Classes); });
+    connect(core, &CutterCore::classDeleted, this, [this]() { advance(Classes); });
+    connect(core, &CutterCore::classRenamed, this, [this]() { advance(Classes); });
+    connect(core, &CutterCore::classAttrsChanged, this, [this]() { advance(Classes); });
+
+    // Rebasing moves everything which is address based
+    connect(core, &CutterCore::codeRebased, this,
+            [this]() { notifyChanged(Functions | Flags | Classes | Memory | Xrefs); });
+
+    connect(core, &CutterCore::registersChanged, this, &ChangeTracker::debugStateChanged);
+    connect(core, &CutterCore::switchedThread, this, &ChangeTracker::debugStateChanged);
+    connect(core, &CutterCore::switchedProcess, this, &ChangeTracker::debugStateChanged);
+    connect(core, &CutterCore::debugProcessFinished, this, &ChangeTracker::debugStateChanged);
+    connect(core, &CutterCore::attachedRemote, this, &ChangeTracker::debugStateChanged);
+}
+
+quint64 ChangeTracker::generation(Domains domains) const
+{
+    quint64 result = 0;
+    for (int i = 0; i < DomainCount; i++) {
+        if (domains.testFlag(allDomainsList[i])) {
+            result = qMax(result, generations[i]);
+        }
+    }
+    return result;
+}
+
+void ChangeTracker::notifyChanged(Domains domains)
+{
+    if (!domains) {
+        return;
+    }
+    advance(domains);
+    emit changed(domains);
+}
+
+void ChangeTracker::advance(Domains domains)
+{
+    counter++;
+    for (int i = 0; i < DomainCount; i++) {
+        if (domains.testFlag(allDomainsList[i])) {
+            generations[i] = counter;
+        }
+    }
+}
+
+void ChangeTracker::refreshAllTriggered()
+{
+    // Types, classes, registers and xrefs have no cheap way of detecting changes, refreshAll may
+    // be the result of arbitrary commands so they are always considered changed.
+    notifyChanged(filterUnchanged(AllDomains));
+}
+
+void ChangeTracker::debugStateChanged()
+{
+    // Memory maps are only re-read by rizin when the debuggee stops, compare them here instead of
+    // making every memory layout widget refresh on each step.
+    notifyChanged(Registers | filterUnchanged(Memory));
+}
+
+ChangeTracker::Domains ChangeTracker::filterUnchanged(Domains domains)
+{
+    if (domains.testFlag(Functions)) {
+        quint64 fingerprint = functionsFingerprint();
+        if (fingerprint == lastFunctionsFingerprint) {
+            domains &= ~Domains(Functions);
+        }
+        lastFunctionsFingerprint = fingerprint;
+    }
+    if (domains.testFlag(Flags)) {
+        quint64 fingerprint = flagsFingerprint();
+        if (fingerprint == lastFlagsFingerprint) {
+            domains &= ~Domains(Flags);
+        }
+        lastFlagsFingerprint = fingerprint;
+    }
+    if (domains.testFlag(Memory)) {
+        quint64 fingerprint = memoryFingerprint();
+        if (fingerprint == lastMemoryFingerprint) {
+            domains &= ~Domains(Memory);
+        }
+        lastMemoryFingerprint = fingerprint;
+    }
+    return domains;
+}
+
+quint64 ChangeTracker::functionsFingerprint()
+{
+    RzCoreLocked core = Core()->core();
+    quint64 h = rz_list_length(core->analysis->fcns);
+    RzListIter *iter;
+    RzAnalysisFunction *fcn;
+    CutterRzListForeach (core->analysis->fcns, iter, RzAnalysisFunction, fcn) {
+        h = combineHash(h, fcn->addr);
+        h = combineHash(h, rz_analysis_function_linear_size(fcn));
+        h = combineHash(h, rz_pvector_len(fcn->bbs));
+        h = combineHash(h, static_cast<quint64>(rz_analysis_arg_count(fcn)));
+        h = combineHash(h, static_cast<quint64>(rz_analysis_var_local_count(fcn)));
+        h = combineHash(h, static_cast<quint64>(fcn->maxstack));
+        h = combineHash(h, fcn->name);
+        h = combineHash(h, fcn->cc);
+    }
+    return h;
+}
+
+quint64 ChangeTracker::flagsFingerprint()
+{
+    RzCoreLocked core = Core()->core();
+    quint64 h = 0;
+    // Flagspaces without flags still show up in the flagspace selection of the flags widget
+    RzSpaceIter it;
+    RzSpace *space;
+    rz_flag_space_foreach(core->flags, it, space)
+    {
+        h = combineHash(h, space->name);
+    }
+    rz_flag_foreach_space(
+            core->flags, nullptr,
+            [](RzFlagItem *item, void *user) {
+                quint64 &h = *reinterpret_cast<quint64 *>(user);
+                h = combineHash(h, item->offset);
+                h = combineHash(h, item->size);
+                h = combineHash(h, item->name);
+                h = combineHash(h, item->space ? item->space->name : nullptr);
+                return true;
+            },
+            &h);
+    return h;
+}
+
+quint64 ChangeTracker::memoryFingerprint()
+{
+    RzCoreLocked core = Core()->core();
+    quint64 h = 0;
+
+    RzList *maps[] = { rz_debug_map_list(core->dbg, false), rz_debug_map_list(core->dbg, true) };
+    for (RzList *list : maps) {
+        RzListIter *it;
+        RzDebugMap *map;
+        CutterRzListForeach (list, it, RzDebugMap, map) {
+            h = combineHash(h, map->addr);
+            h = combineHash(h, map->addr_end);
+            h = combineHash(h, static_cast<quint64>(map->perm));
+            h = combineHash(h, map->name);
+        }
+    }
+
+    RzBinObject *o = rz_bin_cur_object(core->bin);
+    RzPVector *sects = o ? rz_bin_object_get_sections(o) : nullptr;
+    if (sects) {
+        for (const auto &sect : CutterPVector<RzBinSection>(sects)) {
+            h = combineHash(h, sect->vaddr);
+            h = combineHash(h, sect->vsize);
+            h = combineHash(h, sect->paddr);
+            h = combineHash(h, sect->size);
+            h = combineHash(h, static_cast<quint64>(sect->perm));
+            h = combineHash(h, sect->name);
+        }
+        rz_pvector_free(sects);
+    }
+    return h;
+}
+
+bool ChangeWatcher::isOutdated() const
+{
+    return Core()->getChangeTracker()->generation(domains) > seen;
+}
+
+void ChangeWatcher::markSeen()
+{
+    seen = Core()->getChangeTracker()->generation(domains);
+}
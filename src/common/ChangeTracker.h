@@ -0,0 +1,122 @@
+#ifndef CHANGETRACKER_H
+#define CHANGETRACKER_H
+
+#include "core/CutterCommon.h"
+
+#include <QObject>
+
+class CutterCore;
+
+/**
+ * @brief Typed change notifications with per-domain generation counters
+ *
+ * CutterCore emits many fine grained signals but also the coarse CutterCore::refreshAll, after
+ * which every widget used to reload its data. ChangeTracker translates all of them into changes
+ * of a few domains. Each domain keeps the generation at which it was last modified, so widgets
+ * can use a ChangeWatcher to skip a refresh when the data they show didn't change.
+ *
+ * For refreshAll and debug events the cheap to fingerprint domains (functions, flags and memory
+ * layout) are compared against their previous state and only reported if they really differ.
+ */
+class CUTTER_EXPORT ChangeTracker : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Domain {
+        Functions = 1 << 0,
+        Flags = 1 << 1,
+        Types = 1 << 2,
+        Classes = 1 << 3,
+        /// Layout of memory: sections, segments and memory maps
+        Memory = 1 << 4,
+        Registers = 1 << 5,
+        /// All xrefs, including ones that don't belong to a function. Analysis of single functions
+        /// only reports Functions, consumers compare the functions themselves.
+        Xrefs = 1 << 6,
+        AllDomains = Functions | Flags | Types | Classes | Memory | Registers | Xrefs
+    };
+    Q_DECLARE_FLAGS(Domains, Domain)
+
+    explicit ChangeTracker(CutterCore *core);
+
+    /**
+     * @return the most recent generation of any of the given domains
+     */
+    quint64 generation(Domains domains) const;
+
+    /**
+     * @brief Mark domains as changed, for modifications that don't have a dedicated core signal.
+     */
+    void notifyChanged(Domains domains);
+
+signals:
+    void changed(ChangeTracker::Domains domains);
+
+private:
+    static constexpr int DomainCount = 7;
+
+    void advance(Domains domains);
+    void refreshAllTriggered();
+    void debugStateChanged();
+
+    /**
+     * @brief Remove domains from the set whose fingerprint is unchanged and update fingerprints
+     */
+    Domains filterUnchanged(Domains domains);
+
+    quint64 functionsFingerprint();
+    quint64 flagsFingerprint();
+    quint64 memoryFingerprint();
+
+    quint64 counter = 0;
+    quint64 generations[DomainCount] = {};
+    quint64 lastFunctionsFingerprint = 0;
+    quint64 lastFlagsFingerprint = 0;
+    quint64 lastMemoryFingerprint = 0;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(ChangeTracker::Domains)
+
+/**
+ * @brief Remembers which generation of a set of domains a consumer has last seen
+ *
+ * Example:
+ * ```
+ * void MyWidget::refresh()
+ * {
+ *      if (!watcher.isOutdated() || !refreshDeferrer->attemptRefresh(nullptr)) {
+ *          return;
+ *      }
+ *      watcher.markSeen();
+ *      // reload data
+ * }
+ * ```
+ */
+class CUTTER_EXPORT ChangeWatcher
+{
+public:
+    explicit ChangeWatcher(ChangeTracker::Domains domains) : domains(domains) {}
+
+    /**
+     * @return true if any of the watched domains changed since markSeen() was last called
+     */
+    bool isOutdated() const;
+
+    /**
+     * @brief Record the current generation as seen. Call it before querying the data, so that
+     * changes during the query make the watcher outdated again.
+     */
+    void markSeen();
+
+    /**
+     * @brief Force the next isOutdated() to return true, e.g. if display settings changed.
+     */
+    void invalidate() { seen = 0; }
+
+private:
+    ChangeTracker::Domains domains;
+    quint64 seen = 0;
+};
+
+#endif // CHANGETRACKER_H
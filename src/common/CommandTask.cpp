@@ -1,15 +1,241 @@
-
 #include "CommandTask.h"
+#include "RizinTask.h"
 #include "TempConfig.h"
 
+#include <QElapsedTimer>
+
+#include <cstring>
+
+/**
+ * @brief Takes the output of a command from the cons buffer while the command runs.
+ *
+ * rizin has no callback for printed output, but long running commands regularly check
+ * rz_cons_is_breaked(), which calls the break callback of the cons. While the stream is active
+ * that callback is replaced, so complete lines can be passed to the CommandTask from there. The
+ * stream only lives on the thread of the rizin task, which holds the cons of the session.
+ */
+class CommandOutputStream
+{
+public:
+    CommandOutputStream(CommandTask *task) : task(task) {}
+
+    void begin()
+    {
+        RzCons *cons = rz_cons_singleton();
+        depth = rz_stack_size(cons->context->cons_stack);
+        chainedBreakCallback = cons->cb_break;
+        cons->cb_break = &CommandOutputStream::breakCallback;
+        current = this;
+        sinceDrain.start();
+    }
+
+    void end()
+    {
+        current = nullptr;
+        rz_cons_singleton()->cb_break = chainedBreakCallback;
+    }
+
+private:
+    using BreakCallback = decltype(RzCons::cb_break);
+
+    static constexpr qint64 DrainIntervalMs = 50;
+
+    static thread_local CommandOutputStream *current;
+    static BreakCallback chainedBreakCallback;
+
+    CommandTask *task;
+    size_t depth = 0;
+    QElapsedTimer sinceDrain;
+
+    static void breakCallback(void *user)
+    {
+        if (current) {
+            current->drain();
+        }
+        if (chainedBreakCallback) {
+            chainedBreakCallback(user);
+        }
+    }
+
+    void drain()
+    {
+        if (!sinceDrain.hasExpired(DrainIntervalMs)) {
+            return;
+        }
+        sinceDrain.restart();
+        RzConsContext *context = rz_cons_singleton()->context;
+        // Nested commands capture their output themselves
+        if (rz_stack_size(context->cons_stack) != depth || !context->buffer) {
+            return;
+        }
+        // Commands may still drop or rewrite the line they are printing, so it stays
+        size_t end = context->buffer_len;
+        while (end > 0 && context->buffer[end - 1] != '\n') {
+            end--;
+        }
+        if (!end) {
+            return;
+        }
+        task->appendOutput(context->buffer, end, false);
+        memmove(context->buffer, context->buffer + end, context->buffer_len - end);
+        context->buffer_len -= end;
+        context->buffer[context->buffer_len] = '\0';
+    }
+};
+
+thread_local CommandOutputStream *CommandOutputStream::current = nullptr;
+CommandOutputStream::BreakCallback CommandOutputStream::chainedBreakCallback = nullptr;
+
+/**
+ * @return whether output may be taken before the command finished, which isn't the case if rizin
+ * filters or redirects it at the end
+ */
+static bool isStreamable(const QString &cmd)
+{
+    for (QChar c : cmd) {
+        switch (c.unicode()) {
+        case '~':
+        case '|':
+        case '>':
+            return false;
+        default:
+            break;
+        }
+    }
+    return true;
+}
+
 CommandTask::CommandTask(const QString &cmd, ColorMode colorMode) : cmd(cmd), colorMode(colorMode)
 {
 }
 
+void CommandTask::setChunkedOutput(int chunkLines, int maxLines)
+{
+    this->chunkLines = chunkLines;
+    this->maxLines = maxLines;
+}
+
+void CommandTask::interrupt()
+{
+    AsyncTask::interrupt();
+    QMutexLocker locker(&rzTaskMutex);
+    if (rzTask) {
+        rzTask->breakTask();
+    }
+}
+
+bool CommandTask::startRizinTask(RizinTask *task)
+{
+    QMutexLocker locker(&rzTaskMutex);
+    if (isInterrupted()) {
+        return false;
+    }
+    rzTask = task;
+    task->startTask();
+    return true;
+}
+
+void CommandTask::finishRizinTask()
+{
+    rzTask->joinTask();
+    QMutexLocker locker(&rzTaskMutex);
+    rzTask = nullptr;
+}
+
 void CommandTask::runTask()
 {
     TempConfig tempConfig;
     tempConfig.set("scr.color", colorMode);
-    auto res = Core()->cmdTask(cmd);
-    emit finished(res);
+
+    if (chunkLines > 0) {
+        runChunked();
+        emit finished(QString());
+        return;
+    }
+
+    RizinCmdTask task(cmd);
+    if (!startRizinTask(&task)) {
+        emit finished(QString());
+        return;
+    }
+    finishRizinTask();
+    emit finished(task.getResult());
+}
+
+void CommandTask::runChunked()
+{
+    const QByteArray cmdUtf8 = cmd.toUtf8();
+    const bool streamable = isStreamable(cmd);
+    partialLine.clear();
+    htmlConverter.reset();
+
+    // Same as rz_core_cmd_str(), except that the output is passed on while the command runs
+    RizinFunctionTask task([this, &cmdUtf8, streamable](RzCore *core) -> void * {
+        CommandOutputStream stream(this);
+        rz_cons_push();
+        if (streamable) {
+            stream.begin();
+        }
+        rz_core_cmd0(core, cmdUtf8.constData());
+        if (streamable) {
+            stream.end();
+        }
+        rz_cons_filter();
+        const char *rest = rz_cons_get_buffer();
+        if (rest) {
+            appendOutput(rest, strlen(rest), true);
+        }
+        rz_cons_pop();
+        return nullptr;
+    });
+    if (startRizinTask(&task)) {
+        finishRizinTask();
+    }
+}
+
+void CommandTask::appendOutput(const char *data, size_t size, bool last)
+{
+    // Only complete lines are converted, so that neither lines nor multi-byte characters are
+    // split between two pieces of output
+    partialLine.append(data, static_cast<int>(size));
+    int end = last ? partialLine.size() : partialLine.lastIndexOf('\n') + 1;
+    if (end <= 0) {
+        return;
+    }
+    QString text = QString::fromUtf8(partialLine.constData(), end);
+    partialLine.remove(0, end);
+    emitChunks(text);
+}
+
+void CommandTask::emitChunks(QString text)
+{
+    // Converting and laying out everything at once blocks the UI thread for commands printing
+    // megabytes, so the receiver gets small pieces it can append between other events. Lines
+    // which wouldn't fit into the receiver's scrollback anyway are skipped here.
+    if (text.endsWith(QLatin1Char('\n'))) {
+        text.chop(1);
+    }
+    if (text.isEmpty()) {
+        return;
+    }
+
+    const QStringList lines = text.split(QLatin1Char('\n'));
+    int first = 0;
+    if (maxLines > 0 && lines.size() > maxLines) {
+        first = lines.size() - maxLines;
+        emit outputChunk({ tr("[%1 lines omitted]").arg(first) });
+        // Colors set in the skipped lines may still apply to the shown ones
+        for (int i = 0; i < first; i++) {
+            htmlConverter.skipLine(lines[i]);
+        }
+    }
+    for (int i = first; i < lines.size() && !isInterrupted(); i += chunkLines) {
+        int end = qMin(i + chunkLines, lines.size());
+        QStringList chunk;
+        chunk.reserve(end - i);
+        for (int j = i; j < end; j++) {
+            chunk.append(htmlConverter.lineToHtml(lines[j]));
+        }
+        emit outputChunk(chunk);
+    }
 }
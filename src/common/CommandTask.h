@@ -1,10 +1,14 @@
-
 #ifndef COMMANDTASK_H
 #define COMMANDTASK_H
 
 #include "common/AsyncTask.h"
+#include "common/AnsiHtmlConverter.h"
 #include "core/Cutter.h"
 
+#include <QMutex>
+
+class RizinTask;
+
 class CUTTER_EXPORT CommandTask : public AsyncTask
 {
     Q_OBJECT
@@ -21,7 +25,24 @@ public:
 
     QString getTitle() override { return tr("Running Command"); }
 
+    /**
+     * @brief Deliver the output through outputChunk() as html lines in pieces of at most
+     * chunkLines lines while the command runs, finished() is then emitted with an empty result.
+     *
+     * Output is taken from rizin whenever the command checks for breaks. Commands whose output
+     * is post-processed by rizin, like greps or pipes, are delivered once they finished.
+     * @param maxLines only the last maxLines lines of each delivered piece of output are kept,
+     * 0 for all
+     */
+    void setChunkedOutput(int chunkLines, int maxLines = 0);
+
+    /**
+     * @brief Also breaks the rizin command, which stops at its next check of the break flag.
+     */
+    void interrupt() override;
+
 signals:
+    void outputChunk(const QStringList &htmlLines);
     void finished(const QString &result);
 
 protected:
@@ -30,6 +51,23 @@ protected:
 private:
     QString cmd;
     ColorMode colorMode;
+    int chunkLines = 0;
+    int maxLines = 0;
+
+    QMutex rzTaskMutex;
+    RizinTask *rzTask = nullptr;
+
+    /// Received output after the last line break, completed by the next piece
+    QByteArray partialLine;
+    AnsiHtmlConverter htmlConverter;
+
+    friend class CommandOutputStream;
+
+    bool startRizinTask(RizinTask *task);
+    void finishRizinTask();
+    void runChunked();
+    void appendOutput(const char *data, size_t size, bool last);
+    void emitChunks(QString text);
 };
 
 #endif // COMMANDTASK_H
@@ -773,6 +773,16 @@ bool Configuration::getOutputRedirectionEnabled() const
     return outputRedirectEnabled;
 }
 
+int Configuration::getConsoleScrollback() const
+{
+    return s.value("console.scrollback", 10000).toInt();
+}
+
+void Configuration::setConsoleScrollback(int lines)
+{
+    s.setValue("console.scrollback", lines);
+}
+
 void Configuration::setPreviewValue(bool checked)
 {
     s.setValue("asm.preview", checked);
@@ -793,6 +803,17 @@ bool Configuration::getShowVarTooltips() const
     return s.value("showVarTooltips").toBool();
 }
 
+void Configuration::setNavbarEntropy(bool enabled)
+{
+    s.setValue("navbar.entropy", enabled);
+    emit navbarEntropyChanged();
+}
+
+bool Configuration::getNavbarEntropy() const
+{
+    return s.value("navbar.entropy").toBool();
+}
+
 bool Configuration::getGraphBlockEntryOffset()
 {
     return s.value("graphBlockEntryOffset", true).value<bool>();
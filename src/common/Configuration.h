@@ -51,9 +51,6 @@ private:
     void loadDarkStylesheet();
     void loadMidnightStylesheet();
 
-    // Asm Options
-    void applySavedAsmOptions();
-
 public:
     static const QList<CutterInterfaceTheme> &cutterInterfaceThemesList();
     static const QHash<QString, ColorFlags> relevantThemes;
@@ -64,6 +61,12 @@ public:
 
     void loadInitial();
 
+    /**
+     * @brief Apply the saved asm options to the session Core() resolves to. Done by
+     * loadInitial() for the first session, later sessions need it when they are created.
+     */
+    void applySavedAsmOptions();
+
     void resetAll();
 
     // Auto update
@@ -212,6 +215,12 @@ public:
     void setOutputRedirectionEnabled(bool enabled);
     bool getOutputRedirectionEnabled() const;
 
+    /**
+     * @brief Number of lines kept in the console output, older lines are dropped. 0 for no limit.
+     */
+    int getConsoleScrollback() const;
+    void setConsoleScrollback(int lines);
+
     void setPreviewValue(bool checked);
     bool getPreviewValue() const;
 
@@ -221,6 +230,12 @@ public:
     void setShowVarTooltips(bool enabled);
     bool getShowVarTooltips() const;
 
+    /**
+     * @brief Show the entropy and byte classes of the memory as a strip in the navigation bar
+     */
+    void setNavbarEntropy(bool enabled);
+    bool getNavbarEntropy() const;
+
     /**
      * @brief Recently opened binaries, as shown in NewFileDialog.
      */
@@ -253,6 +268,7 @@ signals:
     void fontsUpdated();
     void colorsUpdated();
     void interfaceThemeChanged();
+    void navbarEntropyChanged();
 #ifdef CUTTER_ENABLE_KSYNTAXHIGHLIGHTING
     void kSyntaxHighlightingThemeChanged();
 #endif
@@ -0,0 +1,500 @@
+#include "Coverage.h"
+
+#include "common/ParallelFor.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QFileInfo>
+#include <QStringList>
+#include <QtEndian>
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+using Entries = std::vector<Coverage::Entry>;
+
+/**
+ * Raw entries collected by a chunk before they are sorted and folded into its aggregate
+ */
+constexpr size_t FlushSize = 1 << 20;
+/**
+ * Bytes looked at when guessing the format
+ */
+constexpr qint64 SniffSize = 4096;
+/**
+ * Size of a drcov basic block entry: 32 bit offset, 16 bit size and 16 bit module id
+ */
+constexpr size_t DrcovEntrySize = 8;
+
+bool lessAddress(const Coverage::Entry &a, const Coverage::Entry &b)
+{
+    return a.address < b.address;
+}
+
+Entries mergeEntries(const Entries &a, const Entries &b)
+{
+    Entries result;
+    result.reserve(a.size() + b.size());
+    size_t i = 0;
+    size_t j = 0;
+    while (i < a.size() || j < b.size()) {
+        if (j == b.size() || (i < a.size() && a[i].address < b[j].address)) {
+            result.push_back(a[i++]);
+        } else if (i == a.size() || b[j].address < a[i].address) {
+            result.push_back(b[j++]);
+        } else {
+            Coverage::Entry entry = a[i++];
+            entry.size = std::max(entry.size, b[j].size);
+            entry.hits += b[j++].hits;
+            result.push_back(entry);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Sums the hits per address of one chunk of the file
+ *
+ * Raw entries are buffered and periodically sorted and merged into the aggregate, so memory use
+ * depends on the number of distinct addresses rather than on the size of the file.
+ */
+class Aggregator
+{
+public:
+    void add(RVA address, ut32 size, ut64 hits)
+    {
+        pending.push_back({ address, size, hits });
+        if (pending.size() >= FlushSize) {
+            flush();
+        }
+    }
+
+    Entries take()
+    {
+        flush();
+        return std::move(result);
+    }
+
+private:
+    Entries pending;
+    Entries result;
+
+    void flush()
+    {
+        if (pending.empty()) {
+            return;
+        }
+        std::sort(pending.begin(), pending.end(), lessAddress);
+        size_t last = 0;
+        for (size_t i = 1; i < pending.size(); i++) {
+            if (pending[i].address == pending[last].address) {
+                pending[last].size = std::max(pending[last].size, pending[i].size);
+                pending[last].hits += pending[i].hits;
+            } else {
+                pending[++last] = pending[i];
+            }
+        }
+        pending.resize(last + 1);
+        if (result.empty()) {
+            result.swap(pending);
+        } else {
+            result = mergeEntries(result, pending);
+        }
+        pending.clear();
+    }
+};
+
+int hexDigit(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == ',' || c == ':';
+}
+
+void parseAddressLines(const char *p, const char *end, Aggregator &aggregator)
+{
+    while (p < end) {
+        auto lineEnd = static_cast<const char *>(memchr(p, '\n', end - p));
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+        while (p < lineEnd && isBlank(*p)) {
+            p++;
+        }
+        if (lineEnd - p >= 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+            p += 2;
+        }
+        const char *digits = p;
+        ut64 address = 0;
+        for (int digit; p < lineEnd && (digit = hexDigit(*p)) >= 0; p++) {
+            address = (address << 4) | static_cast<ut64>(digit);
+        }
+        if (p != digits && (p == lineEnd || isBlank(*p))) {
+            // Optional hit count after the address
+            while (p < lineEnd && isBlank(*p)) {
+                p++;
+            }
+            ut64 hits = 0;
+            const char *count = p;
+            for (; p < lineEnd && *p >= '0' && *p <= '9'; p++) {
+                hits = hits * 10 + static_cast<ut64>(*p - '0');
+            }
+            if (p == count) {
+                hits = 1;
+            }
+            if (hits) {
+                aggregator.add(address, 1, hits);
+            }
+        }
+        p = lineEnd + 1;
+    }
+}
+
+/**
+ * @brief Parse chunks on all cores and merge their aggregates
+ * @param parseChunk called with the chunk index and the aggregator of the chunk
+ */
+Entries aggregateChunks(int count,
+                        const std::function<void(int, Aggregator &)> &parseChunk,
+                        const std::function<bool()> &interrupted)
+{
+    std::vector<Entries> chunks(count);
+    std::atomic<bool> stop(false);
+    parallelFor(
+            count,
+            [&](int i) {
+                if (stop || (interrupted && interrupted())) {
+                    stop = true;
+                    return;
+                }
+                Aggregator aggregator;
+                parseChunk(i, aggregator);
+                chunks[i] = aggregator.take();
+            },
+            1);
+    if (stop) {
+        return {};
+    }
+
+    // Merge pairwise, every round halves the number of arrays
+    while (chunks.size() > 1) {
+        const int pairs = static_cast<int>(chunks.size() / 2);
+        std::vector<Entries> merged((chunks.size() + 1) / 2);
+        parallelFor(
+                pairs, [&](int i) { merged[i] = mergeEntries(chunks[2 * i], chunks[2 * i + 1]); },
+                1);
+        if (chunks.size() % 2) {
+            merged.back() = std::move(chunks.back());
+        }
+        chunks = std::move(merged);
+    }
+    return chunks.empty() ? Entries() : std::move(chunks.front());
+}
+
+/**
+ * @brief A few chunks per core, so threads finishing early pick up more work
+ */
+int chunkCount(qint64 itemCount)
+{
+    const qint64 threads = std::max(1u, std::thread::hardware_concurrency());
+    return static_cast<int>(std::max<qint64>(1, std::min(threads * 4, itemCount)));
+}
+
+Entries parseAddressList(const char *data, qint64 size, const std::function<bool()> &interrupted)
+{
+    // Chunks start after the first line break past their nominal start, a line belongs to the
+    // chunk it starts in
+    const int chunks = chunkCount(size);
+    std::vector<qint64> bounds(chunks + 1, size);
+    bounds[0] = 0;
+    for (int i = 1; i < chunks; i++) {
+        qint64 start = std::max(bounds[i - 1], size * i / chunks - 1);
+        auto lineBreak = static_cast<const char *>(memchr(data + start, '\n', size - start));
+        bounds[i] = lineBreak ? lineBreak - data + 1 : size;
+    }
+    return aggregateChunks(
+            chunks,
+            [&](int i, Aggregator &aggregator) {
+                parseAddressLines(data + bounds[i], data + bounds[i + 1], aggregator);
+            },
+            interrupted);
+}
+
+Entries parseBinary(const char *data, qint64 size, const std::function<bool()> &interrupted)
+{
+    const qint64 count = size / 8;
+    const int chunks = chunkCount(count);
+    return aggregateChunks(
+            chunks,
+            [&](int i, Aggregator &aggregator) {
+                const qint64 end = count * (i + 1) / chunks;
+                for (qint64 j = count * i / chunks; j < end; j++) {
+                    aggregator.add(qFromLittleEndian<quint64>(data + j * 8), 1, 1);
+                }
+            },
+            interrupted);
+}
+
+/**
+ * @brief Split a drcov module table line into its columns, the path is last and may contain
+ * commas itself
+ */
+QStringList drcovColumns(const QString &line, int columnCount)
+{
+    QStringList columns;
+    int start = 0;
+    while (columns.size() + 1 < columnCount) {
+        int comma = line.indexOf(',', start);
+        if (comma < 0) {
+            break;
+        }
+        columns << line.mid(start, comma - start).trimmed();
+        start = comma + 1;
+    }
+    columns << line.mid(start).trimmed();
+    return columns;
+}
+
+Entries parseDrcov(const char *data, qint64 size, RVA moduleBase, const QString &moduleName,
+                   QString *error, const std::function<bool()> &interrupted)
+{
+    // Version 1 module tables have no Columns: header and only an id, a size and the path
+    QStringList columnNames = { "id", "size", "path" };
+    bool inModules = false;
+    int moduleId = -1;
+    int moduleCount = 0;
+    int onlyModuleId = -1;
+    qint64 bbCount = -1;
+
+    qint64 pos = 0;
+    while (pos < size && bbCount < 0) {
+        auto lineBreak = static_cast<const char *>(memchr(data + pos, '\n', size - pos));
+        qint64 lineEnd = lineBreak ? lineBreak - data : size;
+        const QString line = QString::fromUtf8(data + pos, static_cast<int>(lineEnd - pos));
+        pos = lineEnd + 1;
+
+        if (line.startsWith("Module Table:")) {
+            inModules = true;
+        } else if (line.startsWith("Columns:")) {
+            columnNames = drcovColumns(line.mid(8), INT_MAX);
+        } else if (line.startsWith("BB Table:")) {
+            bool ok = false;
+            bbCount = line.mid(9).trimmed().section(' ', 0, 0).toLongLong(&ok);
+            if (!ok) {
+                *error = QObject::tr("Unsupported drcov basic block table");
+                return {};
+            }
+        } else if (inModules && !line.trimmed().isEmpty()) {
+            const QStringList columns = drcovColumns(line, columnNames.size());
+            const int idColumn = columnNames.indexOf("id");
+            const int pathColumn = columnNames.indexOf("path");
+            if (idColumn < 0 || pathColumn < 0 || columns.size() <= pathColumn) {
+                continue;
+            }
+            const int id = columns[idColumn].toInt();
+            moduleCount++;
+            onlyModuleId = id;
+            if (QFileInfo(columns[pathColumn]).fileName().compare(moduleName, Qt::CaseInsensitive)
+                == 0) {
+                moduleId = id;
+            }
+        }
+    }
+    if (bbCount < 0) {
+        *error = QObject::tr("No basic block table found in the drcov file");
+        return {};
+    }
+    if (moduleId < 0 && moduleCount == 1) {
+        moduleId = onlyModuleId;
+    }
+    if (moduleId < 0) {
+        *error = QObject::tr("The drcov file contains no module named %1").arg(moduleName);
+        return {};
+    }
+
+    const char *table = data + std::min(pos, size);
+    const qint64 count = std::min<qint64>(bbCount, (size - (table - data)) / DrcovEntrySize);
+    const int chunks = chunkCount(count);
+    return aggregateChunks(
+            chunks,
+            [&](int i, Aggregator &aggregator) {
+                const qint64 end = count * (i + 1) / chunks;
+                for (qint64 j = count * i / chunks; j < end; j++) {
+                    const char *entry = table + j * DrcovEntrySize;
+                    if (qFromLittleEndian<quint16>(entry + 6) != moduleId) {
+                        continue;
+                    }
+                    aggregator.add(moduleBase + qFromLittleEndian<quint32>(entry),
+                                   qFromLittleEndian<quint16>(entry + 4), 1);
+                }
+            },
+            interrupted);
+}
+
+Coverage::Format guessFormat(const char *data, qint64 size)
+{
+    static const char drcovMagic[] = "DRCOV VERSION:";
+    if (size >= qint64(sizeof(drcovMagic) - 1)
+        && memcmp(data, drcovMagic, sizeof(drcovMagic) - 1) == 0) {
+        return Coverage::Format::Drcov;
+    }
+    for (qint64 i = 0; i < std::min(size, SniffSize); i++) {
+        auto c = static_cast<unsigned char>(data[i]);
+        if (c < 0x20 && c != '\n' && c != '\r' && c != '\t') {
+            return Coverage::Format::Binary;
+        }
+    }
+    return Coverage::Format::AddressList;
+}
+
+}
+
+std::shared_ptr<Coverage> Coverage::load(const QString &path, Format format, RVA moduleBase,
+                                         const QString &moduleName, QString *error,
+                                         const std::function<bool()> &interrupted)
+{
+    QString ignoredError;
+    if (!error) {
+        error = &ignoredError;
+    }
+    error->clear();
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *error = QObject::tr("Cannot open %1: %2").arg(path, file.errorString());
+        return nullptr;
+    }
+    const qint64 size = file.size();
+    if (size <= 0) {
+        *error = QObject::tr("%1 is empty").arg(path);
+        return nullptr;
+    }
+
+    // Mapping avoids copying the whole file, reading it is the fallback for files that can't be
+    // mapped
+    QByteArray contents;
+    auto data = reinterpret_cast<const char *>(file.map(0, size));
+    if (!data) {
+        contents = file.readAll();
+        if (contents.size() != size) {
+            *error = QObject::tr("Cannot read %1: %2").arg(path, file.errorString());
+            return nullptr;
+        }
+        data = contents.constData();
+    }
+
+    if (format == Format::Auto) {
+        format = guessFormat(data, size);
+    }
+    auto coverage = std::make_shared<Coverage>();
+    switch (format) {
+    case Format::Drcov:
+        coverage->entries = parseDrcov(data, size, moduleBase, moduleName, error, interrupted);
+        break;
+    case Format::Binary:
+        coverage->entries = parseBinary(data, size, interrupted);
+        break;
+    case Format::AddressList:
+    case Format::Auto:
+        coverage->entries = parseAddressList(data, size, interrupted);
+        break;
+    }
+    if (!error->isEmpty()) {
+        return nullptr;
+    }
+    if (interrupted && interrupted()) {
+        *error = QObject::tr("Loading coverage was canceled");
+        return nullptr;
+    }
+
+    coverage->reach.reserve(coverage->entries.size());
+    RVA reach = 0;
+    for (const Entry &entry : coverage->entries) {
+        coverage->maxHits = std::max(coverage->maxHits, entry.hits);
+        coverage->totalHits += entry.hits;
+        reach = std::max(reach, entry.address + std::max<ut32>(entry.size, 1));
+        coverage->reach.push_back(reach);
+    }
+    return coverage;
+}
+
+ut64 Coverage::hitsAt(RVA addr) const
+{
+    auto it = std::upper_bound(entries.begin(), entries.end(), addr,
+                               [](RVA addr, const Entry &entry) { return addr < entry.address; });
+    ut64 hits = 0;
+    for (size_t i = it - entries.begin(); i > 0 && reach[i - 1] > addr; i--) {
+        const Entry &entry = entries[i - 1];
+        if (addr - entry.address < std::max<ut32>(entry.size, 1)) {
+            hits = std::max(hits, entry.hits);
+        }
+    }
+    return hits;
+}
+
+ut64 Coverage::maxHitsIn(RVA from, RVA to) const
+{
+    auto it = std::lower_bound(entries.begin(), entries.end(), from,
+                               [](const Entry &entry, RVA addr) { return entry.address < addr; });
+    ut64 hits = 0;
+    // Entries starting before from which still reach into the range
+    for (size_t i = it - entries.begin(); i > 0 && reach[i - 1] > from; i--) {
+        const Entry &entry = entries[i - 1];
+        if (entry.address + std::max<ut32>(entry.size, 1) > from) {
+            hits = std::max(hits, entry.hits);
+        }
+    }
+    for (; it != entries.end() && it->address < to; ++it) {
+        hits = std::max(hits, it->hits);
+    }
+    return hits;
+}
+
+QColor Coverage::heatColor(ut64 hits) const
+{
+    if (!hits || !maxHits) {
+        return QColor();
+    }
+    // Hit counts of traces span many orders of magnitude
+    qreal heat = maxHits > 1 ? std::log1p(static_cast<qreal>(hits))
+                    / std::log1p(static_cast<qreal>(maxHits))
+                             : 1.0;
+    QColor color = QColor::fromHsvF((1.0 - std::min<qreal>(heat, 1.0)) * 240.0 / 360.0, 0.85, 1.0);
+    color.setAlpha(110);
+    return color;
+}
+
+CoverageLoadTask::CoverageLoadTask(const QString &path, Coverage::Format format, RVA moduleBase,
+                                   const QString &moduleName)
+    : path(path), format(format), moduleBase(moduleBase), moduleName(moduleName)
+{
+}
+
+QString CoverageLoadTask::getTitle()
+{
+    return tr("Loading coverage from %1").arg(QFileInfo(path).fileName());
+}
+
+void CoverageLoadTask::runTask()
+{
+    coverage = Coverage::load(path, format, moduleBase, moduleName, &error,
+                              [this]() { return isInterrupted(); });
+    canceled = !coverage && isInterrupted();
+}
@@ -0,0 +1,123 @@
+#ifndef COVERAGE_H
+#define COVERAGE_H
+
+#include "core/CutterCommon.h"
+#include "common/AsyncTask.h"
+
+#include <QColor>
+#include <QString>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Hit counts of executed code, aggregated from a coverage or trace file
+ *
+ * Hits are kept per start address in a single sorted array, together with the largest size seen
+ * for that address. That is the basic block size for drcov files and 1 for address lists. A
+ * lookup is a binary search followed by a scan back, which stops as soon as no earlier entry
+ * reaches the address.
+ */
+class CUTTER_EXPORT Coverage
+{
+public:
+    enum class Format {
+        /// Guess from the contents of the file
+        Auto,
+        /// DynamoRIO drcov log with a binary basic block table
+        Drcov,
+        /// Text with one hexadecimal address per line, optionally followed by a hit count
+        AddressList,
+        /// Little endian 64 bit addresses without any header
+        Binary
+    };
+
+    struct Entry
+    {
+        RVA address;
+        ut32 size;
+        ut64 hits;
+    };
+
+    /**
+     * @brief Read a coverage file and aggregate the hits per address
+     *
+     * The file is mapped into memory and split into chunks which are parsed and aggregated on all
+     * cores, so files with hundreds of millions of entries only need memory for the distinct
+     * addresses.
+     * @param moduleBase address the opened file is loaded at, drcov offsets are relative to it
+     * @param moduleName file name of the opened file, to find its module in a drcov file
+     * @param interrupted polled while parsing, returning true stops loading
+     * @return nullptr on error, with a description in error
+     */
+    static std::shared_ptr<Coverage> load(const QString &path, Format format, RVA moduleBase,
+                                          const QString &moduleName, QString *error,
+                                          const std::function<bool()> &interrupted = nullptr);
+
+    const std::vector<Entry> &getEntries() const { return entries; }
+    bool isEmpty() const { return entries.empty(); }
+    ut64 getMaxHits() const { return maxHits; }
+    ut64 getTotalHits() const { return totalHits; }
+
+    /**
+     * @return hits of the entry covering addr, 0 if it was never executed
+     */
+    ut64 hitsAt(RVA addr) const;
+    /**
+     * @return largest hit count of the entries overlapping [from, to)
+     */
+    ut64 maxHitsIn(RVA from, RVA to) const;
+
+    /**
+     * @brief Translucent color for hits on a logarithmic scale from cold to hot
+     * @return invalid color for 0 hits
+     */
+    QColor heatColor(ut64 hits) const;
+
+private:
+    std::vector<Entry> entries;
+    ut64 maxHits = 0;
+    ut64 totalHits = 0;
+    /**
+     * Largest end address of entries[0] to entries[i], for every i
+     */
+    std::vector<RVA> reach;
+};
+
+/**
+ * @brief Loads a coverage file in the background, see Coverage::load()
+ */
+class CUTTER_EXPORT CoverageLoadTask : public AsyncTask
+{
+    Q_OBJECT
+
+public:
+    CoverageLoadTask(const QString &path, Coverage::Format format, RVA moduleBase,
+                     const QString &moduleName);
+
+    QString getTitle() override;
+
+    std::shared_ptr<Coverage> getCoverage() const { return coverage; }
+    const QString &getError() const { return error; }
+    /**
+     * @return true if loading stopped because the task was interrupted while running, unlike
+     * isInterrupted() this isn't affected by closing a dialog after the task finished
+     */
+    bool wasCanceled() const { return canceled; }
+
+protected:
+    void runTask() override;
+
+private:
+    QString path;
+    Coverage::Format format;
+    RVA moduleBase;
+    QString moduleName;
+
+    std::shared_ptr<Coverage> coverage;
+    QString error;
+    bool canceled = false;
+};
+
+#endif // COVERAGE_H
@@ -19,7 +19,9 @@ protected:
     void runTask() override
     {
         auto functions = Core()->getAllFunctions();
-        emit fetchFinished(functions);
+        if (!isInterrupted()) {
+            emit fetchFinished(functions);
+        }
     }
 };
 
@@ -0,0 +1,240 @@
+#include "HeapSnapshot.h"
+
+#include "core/Cutter.h"
+
+#include <QHash>
+
+#include <algorithm>
+
+namespace {
+
+bool isInUse(const HeapSnapshot::Chunk &chunk)
+{
+    return !(chunk.flags & (HeapSnapshot::Free | HeapSnapshot::Top));
+}
+
+/**
+ * Larger ranges between the first chunk and the top chunk are not a heap we understand
+ */
+constexpr ut64 MaxHeapSize = 0x100000000ULL;
+
+}
+
+int HeapSnapshot::indexOf(RVA offset) const
+{
+    auto before = [](const Chunk &chunk, RVA offset) { return chunk.offset < offset; };
+    auto it = std::lower_bound(chunks.begin(), chunks.end(), offset, before);
+    return it != chunks.end() && it->offset == offset ? static_cast<int>(it - chunks.begin()) : -1;
+}
+
+std::vector<HeapDiffEntry> diffHeapSnapshots(const HeapSnapshot &older, const HeapSnapshot &newer)
+{
+    std::vector<HeapDiffEntry> result;
+    const auto &a = older.chunks;
+    const auto &b = newer.chunks;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < a.size() || j < b.size()) {
+        if (j == b.size() || (i < a.size() && a[i].offset < b[j].offset)) {
+            // Chunk got merged into its neighbour
+            if (isInUse(a[i])) {
+                result.push_back({ a[i].offset, a[i].size, 0, HeapDiffEntry::Freed });
+            }
+            i++;
+        } else if (i == a.size() || b[j].offset < a[i].offset) {
+            // Chunk got split off another one
+            if (isInUse(b[j])) {
+                result.push_back({ b[j].offset, 0, b[j].size, HeapDiffEntry::Allocated });
+            }
+            j++;
+        } else {
+            bool wasUsed = isInUse(a[i]);
+            bool isUsed = isInUse(b[j]);
+            if (!wasUsed && isUsed) {
+                result.push_back({ b[j].offset, a[i].size, b[j].size, HeapDiffEntry::Allocated });
+            } else if (wasUsed && !isUsed) {
+                result.push_back({ b[j].offset, a[i].size, b[j].size, HeapDiffEntry::Freed });
+            } else if (isUsed && a[i].size != b[j].size) {
+                result.push_back({ b[j].offset, a[i].size, b[j].size, HeapDiffEntry::Resized });
+            }
+            i++;
+            j++;
+        }
+    }
+    return result;
+}
+
+void HeapWalker::reset()
+{
+    last.reset();
+    pageHashes.clear();
+    heapBase = 0;
+}
+
+std::shared_ptr<const HeapSnapshot> HeapWalker::walk(RVA arena, bool contiguous)
+{
+    RVA arenaAddr = RVA_INVALID;
+    RVA top = RVA_INVALID;
+    for (const Arena &candidate : Core()->getArenas()) {
+        if (!arena || candidate.offset == arena) {
+            arenaAddr = candidate.offset;
+            top = candidate.top;
+            break;
+        }
+    }
+    if (arenaAddr == RVA_INVALID) {
+        reset();
+        auto empty = std::make_shared<HeapSnapshot>();
+        empty->id = nextId++;
+        empty->time = QDateTime::currentDateTime();
+        empty->arena = arena;
+        return empty;
+    }
+
+    std::shared_ptr<HeapSnapshot> snapshot;
+    if (contiguous && last && last->arena == arenaAddr && !last->chunks.empty()
+        && !pageHashes.empty()) {
+        snapshot = walkIncremental(top);
+    }
+    if (!snapshot) {
+        snapshot = walkFull(arenaAddr);
+        pageHashes.clear();
+        if (contiguous && !snapshot->chunks.empty()) {
+            heapBase = snapshot->chunks.front().offset;
+            hashPages(top + 2 * Core()->getArchBits());
+        }
+    }
+
+    const QSet<RVA> freed = freeChunks(arenaAddr);
+    for (HeapSnapshot::Chunk &chunk : snapshot->chunks) {
+        chunk.flags = 0;
+        if (freed.contains(chunk.offset)) {
+            chunk.flags |= HeapSnapshot::Free;
+        }
+        if (chunk.offset == top) {
+            chunk.flags |= HeapSnapshot::Top;
+        }
+    }
+    snapshot->id = nextId++;
+    snapshot->time = QDateTime::currentDateTime();
+    snapshot->arena = arenaAddr;
+    last = snapshot;
+    return snapshot;
+}
+
+std::shared_ptr<HeapSnapshot> HeapWalker::walkFull(RVA arena)
+{
+    auto snapshot = std::make_shared<HeapSnapshot>();
+    RzCoreLocked core(Core());
+    RzList *chunks = rz_heap_chunks_list(core, arena);
+    snapshot->chunks.reserve(rz_list_length(chunks));
+    for (const auto &item : CutterRzList<RzHeapChunkListItem>(chunks)) {
+        snapshot->chunks.push_back({ item->addr, item->size, 0 });
+    }
+    rz_list_free(chunks);
+    std::sort(snapshot->chunks.begin(), snapshot->chunks.end(),
+              [](const HeapSnapshot::Chunk &a, const HeapSnapshot::Chunk &b) {
+                  return a.offset < b.offset;
+              });
+    return snapshot;
+}
+
+void HeapWalker::hashPages(RVA end)
+{
+    const RVA pageBase = heapBase & ~(PageSize - 1);
+    if (end <= pageBase || end - pageBase > MaxHeapSize) {
+        return;
+    }
+    std::vector<ut8> block(ReadBlockSize);
+    for (RVA blockStart = pageBase; blockStart < end; blockStart += ReadBlockSize) {
+        ut64 len = qMin(ReadBlockSize, end - blockStart);
+        {
+            RzCoreLocked core(Core());
+            rz_io_read_at(core->io, blockStart, block.data(), len);
+        }
+        for (ut64 page = 0; page < len; page += PageSize) {
+            pageHashes.push_back(qHashBits(block.data() + page, qMin(PageSize, len - page)));
+        }
+    }
+}
+
+std::shared_ptr<HeapSnapshot> HeapWalker::walkIncremental(RVA top)
+{
+    const int ptrSize = Core()->getArchBits();
+    const bool bigEndian = Core()->getConfigb("cfg.bigendian");
+    const RVA end = top + 2 * ptrSize;
+    const RVA pageBase = heapBase & ~(PageSize - 1);
+    if (ptrSize <= 0 || top < heapBase || end - pageBase > MaxHeapSize) {
+        return nullptr;
+    }
+
+    auto snapshot = std::make_shared<HeapSnapshot>();
+    snapshot->chunks.reserve(last->chunks.size());
+    const auto &previous = last->chunks;
+    size_t previousIndex = 0;
+    std::vector<quint64> hashes;
+    std::vector<ut8> block(ReadBlockSize);
+
+    // Chunk headers are aligned to twice the pointer size and never cross a page
+    RVA addr = heapBase;
+    bool reachedTop = false;
+    for (RVA blockStart = pageBase; blockStart < end && !reachedTop;
+         blockStart += ReadBlockSize) {
+        ut64 len = qMin(ReadBlockSize, end - blockStart);
+        {
+            RzCoreLocked core(Core());
+            rz_io_read_at(core->io, blockStart, block.data(), len);
+        }
+        for (ut64 page = 0; page < len; page += PageSize) {
+            hashes.push_back(qHashBits(block.data() + page, qMin(PageSize, len - page)));
+        }
+
+        while (addr < blockStart + len) {
+            ut64 page = (addr - pageBase) / PageSize;
+            ut64 size = 0;
+            bool reuse =
+                    addr != top && page < pageHashes.size() && pageHashes[page] == hashes[page];
+            if (reuse) {
+                while (previousIndex < previous.size() && previous[previousIndex].offset < addr) {
+                    previousIndex++;
+                }
+                reuse = previousIndex < previous.size() && previous[previousIndex].offset == addr;
+            }
+            if (reuse) {
+                size = previous[previousIndex].size;
+            } else {
+                size = rz_read_ble(block.data() + (addr - blockStart) + ptrSize, bigEndian,
+                                   ptrSize * 8)
+                        & ~static_cast<ut64>(7);
+            }
+            if (addr == top) {
+                snapshot->chunks.push_back({ addr, size, 0 });
+                reachedTop = true;
+                break;
+            }
+            if (size < static_cast<ut64>(2 * ptrSize) || addr + size > top) {
+                // Corrupted or not laid out like we expect, let rizin deal with it
+                return nullptr;
+            }
+            snapshot->chunks.push_back({ addr, size, 0 });
+            addr += size;
+        }
+    }
+    if (!reachedTop) {
+        return nullptr;
+    }
+    pageHashes = std::move(hashes);
+    return snapshot;
+}
+
+QSet<RVA> HeapWalker::freeChunks(RVA arena)
+{
+    QSet<RVA> result;
+    for (RzHeapBin *bin : Core()->getHeapBins(arena)) {
+        for (const auto &item : CutterRzList<RzHeapChunkListItem>(bin->chunks)) {
+            result.insert(item->addr);
+        }
+        rz_heap_bin_free_64(bin);
+    }
+    return result;
+}
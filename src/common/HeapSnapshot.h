@@ -0,0 +1,133 @@
+#ifndef HEAPSNAPSHOT_H
+#define HEAPSNAPSHOT_H
+
+#include "core/CutterCommon.h"
+#include "common/AsyncTask.h"
+
+#include <QDateTime>
+#include <QSet>
+
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Chunks of a glibc heap arena at one debugger stop
+ *
+ * Chunks are stored as plain structs sorted by address instead of Chunk descriptions, so that
+ * heaps with millions of chunks stay cheap to keep around and to compare.
+ */
+struct CUTTER_EXPORT HeapSnapshot
+{
+    /// Derived from the bins and the arena
+    enum Flag : quint8 { Free = 1 << 0, Top = 1 << 1 };
+
+    struct Chunk
+    {
+        RVA offset;
+        ut64 size;
+        quint8 flags;
+    };
+
+    int id = 0;
+    QDateTime time;
+    RVA arena = 0;
+    std::vector<Chunk> chunks;
+
+    /**
+     * @return index of the chunk starting at offset, -1 if there is none
+     */
+    int indexOf(RVA offset) const;
+    /**
+     * @return bytes of memory taken by the chunks
+     */
+    size_t memoryUsage() const { return chunks.capacity() * sizeof(Chunk); }
+};
+
+struct HeapDiffEntry
+{
+    enum Kind : quint8 { Allocated, Freed, Resized };
+
+    RVA offset;
+    ut64 oldSize;
+    ut64 newSize;
+    Kind kind;
+};
+
+/**
+ * @brief Chunks allocated, freed or resized between two snapshots of the same arena
+ * @return entries sorted by address
+ */
+CUTTER_EXPORT std::vector<HeapDiffEntry> diffHeapSnapshots(const HeapSnapshot &older,
+                                                           const HeapSnapshot &newer);
+
+/**
+ * @brief Walks the chunks of an arena, reusing the previous walk where memory did not change
+ *
+ * The first walk of an arena goes through rizin. Afterwards the heap of the main arena, which is
+ * one contiguous range, is read in large blocks and hashed per page. Chunks whose header lies
+ * on a page with the same hash as at the previous stop are taken over from the previous
+ * snapshot, only the headers on changed pages are parsed again. Which chunks are free is
+ * recomputed from the bins at every stop, there are usually few of them compared to all chunks.
+ *
+ * Other arenas can consist of several separate heaps and are always walked through rizin.
+ */
+class CUTTER_EXPORT HeapWalker
+{
+public:
+    /**
+     * @param arena address of the arena, 0 for the main arena
+     * @param contiguous whether the heap of the arena is a single range, only true for the main
+     * arena
+     */
+    std::shared_ptr<const HeapSnapshot> walk(RVA arena, bool contiguous);
+
+    /**
+     * @brief Forget the previous walk, the next one goes through rizin again.
+     */
+    void reset();
+
+private:
+    static constexpr ut64 PageSize = 0x1000;
+    static constexpr ut64 ReadBlockSize = 0x100000;
+
+    std::shared_ptr<const HeapSnapshot> last;
+    RVA heapBase = 0;
+    std::vector<quint64> pageHashes;
+    int nextId = 1;
+
+    std::shared_ptr<HeapSnapshot> walkFull(RVA arena);
+    std::shared_ptr<HeapSnapshot> walkIncremental(RVA top);
+    QSet<RVA> freeChunks(RVA arena);
+    void hashPages(RVA end);
+};
+
+/**
+ * @brief Walks an arena with a HeapWalker in the background
+ *
+ * The walker is shared with the task, only one task may use it at a time.
+ */
+class CUTTER_EXPORT HeapWalkTask : public AsyncTask
+{
+    Q_OBJECT
+
+public:
+    HeapWalkTask(std::shared_ptr<HeapWalker> walker, RVA arena, bool contiguous)
+        : walker(std::move(walker)), arena(arena), contiguous(contiguous)
+    {
+    }
+
+    QString getTitle() override { return tr("Walking heap"); }
+
+    std::shared_ptr<const HeapSnapshot> getSnapshot() const { return snapshot; }
+
+protected:
+    void runTask() override { snapshot = walker->walk(arena, contiguous); }
+
+private:
+    std::shared_ptr<HeapWalker> walker;
+    RVA arena;
+    bool contiguous;
+    std::shared_ptr<const HeapSnapshot> snapshot;
+};
+
+#endif // HEAPSNAPSHOT_H
@@ -0,0 +1,297 @@
+#include "NavigationIndex.h"
+
+#include "core/Cutter.h"
+
+#include <algorithm>
+
+namespace {
+
+inline quint32 trigramAt(const QByteArray &folded, int i)
+{
+    return (static_cast<quint32>(static_cast<uchar>(folded[i])) << 16)
+            | (static_cast<quint32>(static_cast<uchar>(folded[i + 1])) << 8)
+            | static_cast<uchar>(folded[i + 2]);
+}
+
+inline bool isSeparator(char c)
+{
+    return c == '.' || c == '_' || c == ':' || c == '@';
+}
+
+bool isSubsequence(const QByteArray &needle, const QByteArray &haystack)
+{
+    int n = 0;
+    for (int h = 0; h < haystack.size() && n < needle.size(); h++) {
+        if (haystack[h] == needle[n]) {
+            n++;
+        }
+    }
+    return n == needle.size();
+}
+
+/**
+ * Match quality, lower is better
+ */
+enum Quality { Exact, Prefix, WordStart, Substring, Subsequence };
+
+}
+
+int NavigationIndex::kindSlot(Kind kind)
+{
+    switch (kind) {
+    case Function:
+        return 2;
+    case Symbol:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+NavigationIndex::Kind NavigationIndex::bestKind(quint8 kinds)
+{
+    if (kinds & Function) {
+        return Function;
+    }
+    return kinds & Symbol ? Symbol : Flag;
+}
+
+quint32 NavigationIndex::intern(const QString &name)
+{
+    auto it = entryByName.constFind(name);
+    if (it != entryByName.constEnd()) {
+        return it.value();
+    }
+    quint32 id = static_cast<quint32>(entries.size());
+    Entry entry;
+    entry.name = name;
+    entry.folded = name.toLower().toUtf8();
+    std::fill(std::begin(entry.offsets), std::end(entry.offsets), RVA_INVALID);
+    entry.kinds = 0;
+    for (int i = 0; i + 2 < entry.folded.size(); i++) {
+        auto &postings = trigrams[trigramAt(entry.folded, i)];
+        if (postings.empty() || postings.back() != id) {
+            postings.push_back(id);
+        }
+    }
+    entries.push_back(std::move(entry));
+    entryByName.insert(name, id);
+    return id;
+}
+
+void NavigationIndex::apply(Kind kind, const QVector<QPair<QString, RVA>> &names)
+{
+    // Names which disappear keep their interned entry and postings, so that renaming back and
+    // forth or reloading flags doesn't grow the index.
+    const int slot = kindSlot(kind);
+    std::vector<bool> present(entries.size() + names.size(), false);
+    if (kind == Function) {
+        functionEntries.clear();
+    }
+    for (const auto &name : names) {
+        quint32 id = intern(name.first);
+        present[id] = true;
+        entries[id].kinds |= kind;
+        entries[id].offsets[slot] = name.second;
+        if (kind == Function) {
+            functionEntries.insert(name.second, id);
+        }
+    }
+    for (size_t id = 0; id < entries.size(); id++) {
+        if (!present[id]) {
+            entries[id].kinds &= ~kind;
+        }
+    }
+}
+
+void NavigationIndex::sync(quint8 kinds)
+{
+    static const Kind allKinds[] = { Function, Symbol, Flag };
+    for (Kind kind : allKinds) {
+        if (!(kinds & kind)) {
+            continue;
+        }
+        QVector<QPair<QString, RVA>> names;
+        if (kind == Function) {
+            RzCoreLocked core(Core());
+            for (const auto &fcn : CutterRzList<RzAnalysisFunction>(core->analysis->fcns)) {
+                names.append({ QString::fromUtf8(fcn->name), fcn->addr });
+            }
+        } else if (kind == Symbol) {
+            for (const SymbolDescription &symbol : Core()->getAllSymbols()) {
+                names.append({ symbol.name, symbol.vaddr });
+            }
+        } else {
+            RzCoreLocked core(Core());
+            rz_flag_foreach_space(
+                    core->flags, nullptr,
+                    [](RzFlagItem *item, void *user) {
+                        if (AsyncTask::isCurrentTaskInterrupted()) {
+                            return false;
+                        }
+                        auto names = reinterpret_cast<QVector<QPair<QString, RVA>> *>(user);
+                        names->append({ QString::fromUtf8(item->name), item->offset });
+                        return true;
+                    },
+                    &names);
+        }
+        if (AsyncTask::isCurrentTaskInterrupted()) {
+            return;
+        }
+        QWriteLocker locker(&lock);
+        apply(kind, names);
+    }
+}
+
+void NavigationIndex::renameFunction(RVA offset, const QString &newName)
+{
+    QWriteLocker locker(&lock);
+    auto it = functionEntries.find(offset);
+    if (it != functionEntries.end()) {
+        entries[it.value()].kinds &= ~Function;
+    }
+    quint32 id = intern(newName);
+    entries[id].kinds |= Function;
+    entries[id].offsets[kindSlot(Function)] = offset;
+    functionEntries.insert(offset, id);
+}
+
+void NavigationIndex::noteVisited(const QString &name)
+{
+    QWriteLocker locker(&lock);
+    auto it = entryByName.constFind(name);
+    if (it != entryByName.constEnd()) {
+        visits.insert(it.value(), ++visitClock);
+    }
+}
+
+QVector<NavigationIndex::Match> NavigationIndex::query(const QString &text, int limit,
+                                                       bool fuzzy) const
+{
+    const QByteArray needle = text.toLower().toUtf8();
+    if (needle.isEmpty() || limit <= 0) {
+        return {};
+    }
+
+    struct Candidate
+    {
+        int quality;
+        Kind kind;
+        quint64 visit;
+        quint32 id;
+    };
+
+    QReadLocker locker(&lock);
+    std::vector<Candidate> candidates;
+    std::vector<bool> matched(fuzzy ? entries.size() : 0, false);
+
+    auto addCandidate = [&](quint32 id, int quality) {
+        const Entry &entry = entries[id];
+        candidates.push_back({ quality, bestKind(entry.kinds), visits.value(id, 0), id });
+    };
+    auto matchSubstring = [&](quint32 id) {
+        const Entry &entry = entries[id];
+        if (!entry.kinds) {
+            return;
+        }
+        int pos = entry.folded.indexOf(needle);
+        if (pos < 0) {
+            return;
+        }
+        int quality;
+        if (pos == 0) {
+            quality = entry.folded.size() == needle.size() ? Exact : Prefix;
+        } else {
+            quality = isSeparator(entry.folded[pos - 1]) ? WordStart : Substring;
+        }
+        addCandidate(id, quality);
+        if (fuzzy) {
+            matched[id] = true;
+        }
+    };
+
+    if (needle.size() < 3) {
+        for (quint32 id = 0; id < entries.size(); id++) {
+            if ((id & 0xfff) == 0 && AsyncTask::isCurrentTaskInterrupted()) {
+                return {};
+            }
+            matchSubstring(id);
+        }
+    } else {
+        // Every substring match contains all trigrams of the needle, the rarest one is enough
+        // to find the candidates.
+        const std::vector<quint32> *postings = nullptr;
+        for (int i = 0; i + 2 < needle.size(); i++) {
+            auto it = trigrams.find(trigramAt(needle, i));
+            if (it == trigrams.end()) {
+                postings = nullptr;
+                break;
+            }
+            if (!postings || it->second.size() < postings->size()) {
+                postings = &it->second;
+            }
+        }
+        if (postings) {
+            for (quint32 id : *postings) {
+                matchSubstring(id);
+            }
+        }
+    }
+
+    if (fuzzy) {
+        for (quint32 id = 0; id < entries.size(); id++) {
+            if ((id & 0xfff) == 0 && AsyncTask::isCurrentTaskInterrupted()) {
+                return {};
+            }
+            if (!matched[id] && entries[id].kinds && isSubsequence(needle, entries[id].folded)) {
+                addCandidate(id, Subsequence);
+            }
+        }
+    }
+
+    auto better = [this](const Candidate &a, const Candidate &b) {
+        if (a.quality != b.quality) {
+            return a.quality < b.quality;
+        }
+        if (a.kind != b.kind) {
+            return a.kind > b.kind;
+        }
+        if (a.visit != b.visit) {
+            return a.visit > b.visit;
+        }
+        const QString &nameA = entries[a.id].name;
+        const QString &nameB = entries[b.id].name;
+        if (nameA.size() != nameB.size()) {
+            return nameA.size() < nameB.size();
+        }
+        return nameA < nameB;
+    };
+    size_t count = std::min(candidates.size(), static_cast<size_t>(limit));
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(), better);
+
+    QVector<Match> result;
+    result.reserve(static_cast<int>(count));
+    for (size_t i = 0; i < count; i++) {
+        const Entry &entry = entries[candidates[i].id];
+        Kind kind = candidates[i].kind;
+        result.append({ entry.name, entry.offsets[kindSlot(kind)], kind });
+    }
+    return result;
+}
+
+void NavigationQueryTask::runTask()
+{
+    QVector<NavigationIndex::Match> matches = index->query(text, limit, false);
+    if (isInterrupted()) {
+        return;
+    }
+    bool complete = matches.size() >= limit;
+    emit matchesReady(text, matches, complete);
+    if (complete) {
+        return;
+    }
+    matches = index->query(text, limit, true);
+    if (!isInterrupted()) {
+        emit matchesReady(text, matches, true);
+    }
+}
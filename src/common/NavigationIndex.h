@@ -0,0 +1,148 @@
+#ifndef NAVIGATIONINDEX_H
+#define NAVIGATIONINDEX_H
+
+#include "common/AsyncTask.h"
+#include "core/CutterCommon.h"
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <QVector>
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Searchable table of all names the Omnibar can navigate to
+ *
+ * Every distinct name of a flag, symbol or function is interned once. Lowercased trigrams of
+ * the names point to the entries containing them, so substring queries only have to look at the
+ * entries of the rarest trigram of the query. Queries that are not substrings of any name fall
+ * back to a subsequence match over all entries.
+ *
+ * Results are ranked by match quality, then by kind (function > symbol > flag), then by how
+ * recently the name was navigated to.
+ *
+ * All methods are thread safe, queries and synchronization with the core are meant to run in
+ * an AsyncTask.
+ */
+class CUTTER_EXPORT NavigationIndex
+{
+public:
+    enum Kind : quint8 {
+        Flag = 1 << 0,
+        Symbol = 1 << 1,
+        Function = 1 << 2,
+        AllKinds = Flag | Symbol | Function
+    };
+
+    struct Match
+    {
+        QString name;
+        RVA offset;
+        Kind kind;
+    };
+
+    /**
+     * @brief Re-read the names of the given kinds from the core and update the index with the
+     * differences.
+     */
+    void sync(quint8 kinds);
+
+    /**
+     * @brief Move the function at offset to its new name, without re-reading all functions.
+     */
+    void renameFunction(RVA offset, const QString &newName);
+
+    /**
+     * @brief Record that the user navigated to name, recent names are ranked higher.
+     */
+    void noteVisited(const QString &name);
+
+    /**
+     * @param fuzzy also match names containing the characters of text in order but not
+     * contiguously
+     * @return at most limit best matches, empty if the current task got interrupted
+     */
+    QVector<Match> query(const QString &text, int limit, bool fuzzy) const;
+
+private:
+    struct Entry
+    {
+        QString name;
+        QByteArray folded;
+        RVA offsets[3];
+        quint8 kinds;
+    };
+
+    mutable QReadWriteLock lock;
+    std::vector<Entry> entries;
+    QHash<QString, quint32> entryByName;
+    std::unordered_map<quint32, std::vector<quint32>> trigrams;
+    QHash<RVA, quint32> functionEntries;
+    QHash<quint32, quint64> visits;
+    quint64 visitClock = 0;
+
+    quint32 intern(const QString &name);
+    void apply(Kind kind, const QVector<QPair<QString, RVA>> &names);
+    static int kindSlot(Kind kind);
+    static Kind bestKind(quint8 kinds);
+};
+
+Q_DECLARE_METATYPE(NavigationIndex::Match)
+
+/**
+ * @brief Updates a NavigationIndex from the core on a worker thread
+ */
+class CUTTER_EXPORT NavigationIndexSyncTask : public AsyncTask
+{
+    Q_OBJECT
+
+public:
+    NavigationIndexSyncTask(std::shared_ptr<NavigationIndex> index, quint8 kinds)
+        : index(std::move(index)), kinds(kinds)
+    {
+    }
+
+    QString getTitle() override { return tr("Indexing names"); }
+
+protected:
+    void runTask() override { index->sync(kinds); }
+
+private:
+    std::shared_ptr<NavigationIndex> index;
+    quint8 kinds;
+};
+
+/**
+ * @brief Queries a NavigationIndex on a worker thread
+ *
+ * Substring matches are reported first since they are cheap to find, the complete result
+ * including subsequence matches follows.
+ */
+class CUTTER_EXPORT NavigationQueryTask : public AsyncTask
+{
+    Q_OBJECT
+
+public:
+    NavigationQueryTask(std::shared_ptr<NavigationIndex> index, const QString &text, int limit)
+        : index(std::move(index)), text(text), limit(limit)
+    {
+    }
+
+    QString getTitle() override { return tr("Searching names"); }
+
+signals:
+    void matchesReady(const QString &text, const QVector<NavigationIndex::Match> &matches,
+                      bool complete);
+
+protected:
+    void runTask() override;
+
+private:
+    std::shared_ptr<NavigationIndex> index;
+    QString text;
+    int limit;
+};
+
+#endif // NAVIGATIONINDEX_H
@@ -0,0 +1,65 @@
+#ifndef PARALLELFOR_H
+#define PARALLELFOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Call body(i) for every i in [0, count) on all hardware threads
+ *
+ * Indices are handed out in chunks from a shared counter, so uneven work per index is balanced
+ * between the threads. The calling thread takes part in the work and the function returns once
+ * every index has been processed. body must be safe to call concurrently for different indices
+ * and must not touch the core unless it takes the core lock.
+ *
+ * @param chunkSize number of consecutive indices a thread takes at once
+ * @param maxThreads upper limit of threads used including the calling one, 0 for all hardware
+ * threads
+ */
+template<typename Body>
+void parallelFor(int count, Body body, int chunkSize, int maxThreads)
+{
+    if (count <= 0) {
+        return;
+    }
+    chunkSize = std::max(chunkSize, 1);
+    int threadCount = static_cast<int>(std::thread::hardware_concurrency());
+    if (maxThreads > 0) {
+        threadCount = std::min(threadCount, maxThreads);
+    }
+    threadCount = std::max(1, std::min(threadCount, (count + chunkSize - 1) / chunkSize));
+
+    std::atomic<int> next(0);
+    auto worker = [&]() {
+        for (;;) {
+            int begin = next.fetch_add(chunkSize);
+            if (begin >= count) {
+                return;
+            }
+            int end = std::min(begin + chunkSize, count);
+            for (int i = begin; i < end; i++) {
+                body(i);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (int i = 1; i < threadCount; i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+template<typename Body>
+void parallelFor(int count, Body body, int chunkSize = 16)
+{
+    parallelFor(count, body, chunkSize, 0);
+}
+
+#endif // PARALLELFOR_H
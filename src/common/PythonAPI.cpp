@@ -5,6 +5,120 @@
 
 #include <QFile>
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// Records of the bulk accessors. They are packed so that they can be read with the struct
+// module or numpy using the *_FORMAT constants of the module.
+#pragma pack(push, 1)
+struct PackedFunction
+{
+    ut64 addr;
+    ut64 size;
+    ut32 nbbs;
+    ut32 ninstr;
+};
+struct PackedBlock
+{
+    ut64 function;
+    ut64 addr;
+    ut64 size;
+    ut64 jump;
+    ut64 fail;
+};
+struct PackedXref
+{
+    ut64 from;
+    ut64 to;
+    ut32 type;
+};
+struct PackedFlag
+{
+    ut64 offset;
+    ut64 size;
+};
+#pragma pack(pop)
+
+const char *const functionFormat = "=QQII";
+const char *const blockFormat = "=QQQQQ";
+const char *const xrefFormat = "=QQI";
+const char *const flagFormat = "=QQ";
+
+template<typename T>
+PyObject *packedBytes(const std::vector<T> &records)
+{
+    return PyBytes_FromStringAndSize(reinterpret_cast<const char *>(records.data()),
+                                     static_cast<Py_ssize_t>(records.size() * sizeof(T)));
+}
+
+PyObject *nameList(const std::vector<QByteArray> &names)
+{
+    PyObject *list = PyList_New(static_cast<Py_ssize_t>(names.size()));
+    if (!list) {
+        return nullptr;
+    }
+    for (size_t i = 0; i < names.size(); i++) {
+        PyObject *name = PyUnicode_DecodeUTF8(names[i].constData(), names[i].size(), "replace");
+        if (!name) {
+            Py_DECREF(list);
+            return nullptr;
+        }
+        PyList_SetItem(list, static_cast<Py_ssize_t>(i), name);
+    }
+    return list;
+}
+
+/**
+ * @brief Tuple of packed records and names in the same order, steals both references
+ */
+PyObject *recordsWithNames(PyObject *records, PyObject *names)
+{
+    if (!records || !names) {
+        Py_XDECREF(records);
+        Py_XDECREF(names);
+        return nullptr;
+    }
+    PyObject *result = PyTuple_Pack(2, records, names);
+    Py_DECREF(records);
+    Py_DECREF(names);
+    return result;
+}
+
+/**
+ * @brief Releases the GIL for its lifetime, so that other Python threads can run while the core
+ * is busy. Declare it before taking the core lock so that the lock is dropped first.
+ */
+class GilRelease
+{
+public:
+    GilRelease() : state(PyEval_SaveThread()) {}
+    ~GilRelease() { PyEval_RestoreThread(state); }
+
+private:
+    PyThreadState *state;
+};
+
+void readMemory(ut64 addr, ut8 *buf, ut64 size)
+{
+    GilRelease nogil;
+    RzCoreLocked core(Core());
+    if (!rz_io_read_at(core->io, addr, buf, size)) {
+        memset(buf, 0xff, size);
+    }
+}
+
+void collectBlocks(RzAnalysisFunction *fcn, std::vector<PackedBlock> &blocks)
+{
+    for (const auto &bb : CutterPVector<RzAnalysisBlock>(fcn->bbs)) {
+        blocks.push_back({ fcn->addr, bb->addr, bb->size, bb->jump, bb->fail });
+    }
+}
+
+}
+
 PyObject *api_version(PyObject *self, PyObject *null)
 {
     Q_UNUSED(self)
@@ -49,12 +163,160 @@ PyObject *api_message(PyObject *self, PyObject *args, PyObject *kwargs)
     Py_RETURN_NONE;
 }
 
+// The functions below do the work with the GIL released and only create Python objects after
+// the core lock has been dropped again.
+
+PyObject *api_read(PyObject *self, PyObject *args)
+{
+    Q_UNUSED(self);
+    unsigned long long addr;
+    Py_ssize_t size;
+    if (!PyArg_ParseTuple(args, "Kn:read", &addr, &size)) {
+        return NULL;
+    }
+    if (size < 0) {
+        PyErr_SetString(PyExc_ValueError, "size must not be negative");
+        return NULL;
+    }
+    // The bytes object is filled in place and the memoryview shares its storage
+    PyObject *bytes = PyBytes_FromStringAndSize(NULL, size);
+    if (!bytes) {
+        return NULL;
+    }
+    ut8 *buf = reinterpret_cast<ut8 *>(PyBytes_AsString(bytes));
+    readMemory(addr, buf, static_cast<ut64>(size));
+    PyObject *view = PyMemoryView_FromObject(bytes);
+    Py_DECREF(bytes);
+    return view;
+}
+
+PyObject *api_read_into(PyObject *self, PyObject *args)
+{
+    Q_UNUSED(self);
+    unsigned long long addr;
+    PyObject *target;
+    if (!PyArg_ParseTuple(args, "KO!:read_into", &addr, &PyByteArray_Type, &target)) {
+        return NULL;
+    }
+    // Other Python threads may resize the bytearray while the GIL is released, so the memory is
+    // read into a buffer of our own and only copied once the GIL is held again
+    ut64 size = static_cast<ut64>(PyByteArray_Size(target));
+    std::vector<ut8> buf(size);
+    readMemory(addr, buf.data(), size);
+    size = std::min<ut64>(size, static_cast<ut64>(PyByteArray_Size(target)));
+    if (size) {
+        memcpy(PyByteArray_AsString(target), buf.data(), size);
+    }
+    Py_RETURN_NONE;
+}
+
+PyObject *api_functions(PyObject *self, PyObject *null)
+{
+    Q_UNUSED(self)
+    Q_UNUSED(null)
+    std::vector<PackedFunction> records;
+    std::vector<QByteArray> names;
+    {
+        GilRelease nogil;
+        RzCoreLocked core(Core());
+        records.reserve(rz_list_length(core->analysis->fcns));
+        names.reserve(records.capacity());
+        for (const auto &fcn : CutterRzList<RzAnalysisFunction>(core->analysis->fcns)) {
+            ut32 ninstr = 0;
+            for (const auto &bb : CutterPVector<RzAnalysisBlock>(fcn->bbs)) {
+                ninstr += bb->ninstr;
+            }
+            records.push_back({ fcn->addr, rz_analysis_function_linear_size(fcn),
+                                static_cast<ut32>(rz_pvector_len(fcn->bbs)), ninstr });
+            names.push_back(QByteArray(fcn->name));
+        }
+    }
+    return recordsWithNames(packedBytes(records), nameList(names));
+}
+
+PyObject *api_basic_blocks(PyObject *self, PyObject *args)
+{
+    Q_UNUSED(self);
+    unsigned long long addr = RVA_INVALID;
+    if (!PyArg_ParseTuple(args, "|K:basic_blocks", &addr)) {
+        return NULL;
+    }
+    std::vector<PackedBlock> records;
+    {
+        GilRelease nogil;
+        RzCoreLocked core(Core());
+        if (addr != RVA_INVALID) {
+            if (RzAnalysisFunction *fcn = rz_analysis_get_function_at(core->analysis, addr)) {
+                collectBlocks(fcn, records);
+            }
+        } else {
+            for (const auto &fcn : CutterRzList<RzAnalysisFunction>(core->analysis->fcns)) {
+                collectBlocks(fcn, records);
+            }
+        }
+    }
+    return packedBytes(records);
+}
+
+PyObject *api_xrefs(PyObject *self, PyObject *null)
+{
+    Q_UNUSED(self)
+    Q_UNUSED(null)
+    std::vector<PackedXref> records;
+    {
+        GilRelease nogil;
+        RzCoreLocked core(Core());
+        auto xrefs = fromOwned(rz_analysis_xrefs_list(core->analysis));
+        records.reserve(rz_list_length(xrefs.get()));
+        for (const auto &xref : CutterRzList<RzAnalysisXRef>(xrefs.get())) {
+            records.push_back({ xref->from, xref->to, static_cast<ut32>(xref->type) });
+        }
+    }
+    return packedBytes(records);
+}
+
+PyObject *api_flags(PyObject *self, PyObject *null)
+{
+    Q_UNUSED(self)
+    Q_UNUSED(null)
+    struct Collected
+    {
+        std::vector<PackedFlag> records;
+        std::vector<QByteArray> names;
+    } collected;
+    {
+        GilRelease nogil;
+        RzCoreLocked core(Core());
+        rz_flag_foreach_space(
+                core->flags, nullptr,
+                [](RzFlagItem *item, void *user) {
+                    auto collected = reinterpret_cast<Collected *>(user);
+                    collected->records.push_back({ item->offset, item->size });
+                    collected->names.push_back(QByteArray(item->name));
+                    return true;
+                },
+                &collected);
+    }
+    return recordsWithNames(packedBytes(collected.records), nameList(collected.names));
+}
+
 PyMethodDef CutterMethods[] = {
     { "version", api_version, METH_NOARGS, "Returns Cutter current version" },
     { "cmd", api_cmd, METH_VARARGS, "Execute a command inside Cutter" },
     { "refresh", api_refresh, METH_NOARGS, "Refresh Cutter widgets" },
     { "message", (PyCFunction)(void *)/* don't remove this double cast! */ api_message,
       METH_VARARGS | METH_KEYWORDS, "Print message" },
+    { "read", api_read, METH_VARARGS,
+      "read(addr, size) -> memoryview of size bytes of memory at addr" },
+    { "read_into", api_read_into, METH_VARARGS,
+      "read_into(addr, buffer) fills the bytearray buffer with memory at addr" },
+    { "functions", api_functions, METH_NOARGS,
+      "Returns (records, names) of all functions, records packed as FUNCTION_FORMAT" },
+    { "basic_blocks", api_basic_blocks, METH_VARARGS,
+      "basic_blocks([function]) -> basic blocks of one or all functions packed as BLOCK_FORMAT" },
+    { "xrefs", api_xrefs, METH_NOARGS, "Returns all xrefs packed as XREF_FORMAT" },
+    { "flags", api_flags, METH_NOARGS,
+      "Returns (records, names) of all flags, records packed as FLAG_FORMAT" },
     { NULL, NULL, 0, NULL }
 };
 
@@ -64,5 +326,13 @@ PyModuleDef CutterModule = {
 
 PyObject *PyInit_api()
 {
-    return PyModule_Create(&CutterModule);
+    PyObject *module = PyModule_Create(&CutterModule);
+    if (!module) {
+        return NULL;
+    }
+    PyModule_AddStringConstant(module, "FUNCTION_FORMAT", functionFormat);
+    PyModule_AddStringConstant(module, "BLOCK_FORMAT", blockFormat);
+    PyModule_AddStringConstant(module, "XREF_FORMAT", xrefFormat);
+    PyModule_AddStringConstant(module, "FLAG_FORMAT", flagFormat);
+    return module;
 }
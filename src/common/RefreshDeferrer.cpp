@@ -1,6 +1,7 @@
 
 #include "RefreshDeferrer.h"
 #include "widgets/CutterDockWidget.h"
+#include "core/Cutter.h"
 
 RefreshDeferrer::RefreshDeferrer(RefreshDeferrerAccumulator *acc, QObject *parent)
     : QObject(parent), acc(acc)
@@ -41,3 +42,95 @@ void RefreshDeferrer::registerFor(CutterDockWidget *dockWidget)
         }
     });
 }
+
+namespace {
+
+class AsyncRefreshTask : public AsyncTask
+{
+public:
+    explicit AsyncRefreshTask(const AsyncRefreshDeferrer::ComputeFunction &compute)
+        : compute(compute)
+    {
+    }
+
+    QString getTitle() override { return tr("Refreshing"); }
+
+    AsyncRefreshDeferrer::ApplyFunction takeResult()
+    {
+        AsyncRefreshDeferrer::ApplyFunction result;
+        std::swap(result, apply);
+        return result;
+    }
+
+protected:
+    void runTask() override
+    {
+        if (!isInterrupted()) {
+            apply = compute();
+        }
+    }
+
+private:
+    AsyncRefreshDeferrer::ComputeFunction compute;
+    AsyncRefreshDeferrer::ApplyFunction apply;
+};
+
+}
+
+AsyncRefreshDeferrer::AsyncRefreshDeferrer(ComputeFunction compute, QObject *parent)
+    : RefreshDeferrer(nullptr, parent), compute(std::move(compute))
+{
+    connect(this, &RefreshDeferrer::refreshNow, this, &AsyncRefreshDeferrer::requestRefresh);
+}
+
+AsyncRefreshDeferrer::~AsyncRefreshDeferrer()
+{
+    if (task) {
+        // The compute function may reference the widget, it must not outlive it.
+        task->interrupt();
+        task->wait();
+    }
+}
+
+void AsyncRefreshDeferrer::requestRefresh()
+{
+    requestGeneration++;
+    if (!attemptRefresh(nullptr)) {
+        return;
+    }
+    if (task) {
+        // Picked up by computationFinished(), which discards the running result as stale.
+        task->interrupt();
+        return;
+    }
+    startComputation();
+}
+
+void AsyncRefreshDeferrer::startComputation()
+{
+    taskGeneration = requestGeneration;
+    task = AsyncTask::Ptr(new AsyncRefreshTask(compute));
+    connect(task.data(), &AsyncTask::finished, this, &AsyncRefreshDeferrer::computationFinished,
+            Qt::QueuedConnection);
+    Core()->getAsyncTaskManager()->start(task);
+}
+
+void AsyncRefreshDeferrer::computationFinished()
+{
+    if (!task) {
+        return;
+    }
+    ApplyFunction apply = static_cast<AsyncRefreshTask *>(task.data())->takeResult();
+    task.clear();
+
+    if (taskGeneration != requestGeneration) {
+        if (attemptRefresh(nullptr)) {
+            startComputation();
+        }
+        return;
+    }
+    if (apply) {
+        apply();
+    }
+    emit refreshed();
+}
@@ -2,8 +2,12 @@
 #ifndef REFRESHDEFERRER_H
 #define REFRESHDEFERRER_H
 
+#include "common/AsyncTask.h"
+
 #include <QObject>
 
+#include <functional>
+
 class CutterDockWidget;
 class RefreshDeferrer;
 
@@ -145,4 +149,53 @@ signals:
     void refreshNow(const RefreshDeferrerParamsResult paramsResult);
 };
 
+/**
+ * @brief RefreshDeferrer which computes the data for a refresh on a worker thread
+ *
+ * The compute function runs in the thread pool of the AsyncTaskManager and returns a function
+ * which is then called on the GUI thread to swap the result into the widget. Refreshes requested
+ * while a computation is running are coalesced into a single follow-up computation and results
+ * overtaken by a newer request are discarded without being applied.
+ *
+ * Use CutterDockWidget::createAsyncRefreshDeferrer() instead of creating it directly.
+ */
+class AsyncRefreshDeferrer : public RefreshDeferrer
+{
+    Q_OBJECT
+
+public:
+    using ApplyFunction = std::function<void()>;
+    using ComputeFunction = std::function<ApplyFunction()>;
+
+    explicit AsyncRefreshDeferrer(ComputeFunction compute, QObject *parent = nullptr);
+    ~AsyncRefreshDeferrer() override;
+
+    /**
+     * @brief Request a refresh. It is deferred while the widget is not visible, otherwise the
+     * data is computed in the background.
+     */
+    void requestRefresh();
+
+    bool isComputing() const { return !task.isNull(); }
+
+signals:
+    /**
+     * @brief Emitted after a computed result has been applied
+     */
+    void refreshed();
+
+private:
+    void startComputation();
+    void computationFinished();
+
+    ComputeFunction compute;
+    AsyncTask::Ptr task;
+    /**
+     * Incremented for every request, a finished computation is stale if it was started for an
+     * older generation.
+     */
+    quint64 requestGeneration = 0;
+    quint64 taskGeneration = 0;
+};
+
 #endif // REFRESHDEFERRER_H
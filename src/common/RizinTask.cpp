@@ -7,34 +7,45 @@ RizinTask::~RizinTask()
     if (task) {
         rz_core_task_decref(task);
     }
+    releaseCons();
 }
 
 void RizinTask::startTask()
 {
-    rz_core_task_enqueue(&Core()->core_->tasks, task);
+    session->lockCons();
+    holdsCons = true;
+    rz_core_task_enqueue(&session->core_->tasks, task);
 }
 
 void RizinTask::breakTask()
 {
-    rz_core_task_break(&Core()->core_->tasks, task->id);
+    rz_core_task_break(&session->core_->tasks, task->id);
 }
 
 void RizinTask::joinTask()
 {
-    rz_core_task_join(&Core()->core_->tasks, nullptr, task->id);
+    rz_core_task_join(&session->core_->tasks, nullptr, task->id);
 }
 
 void RizinTask::taskFinished()
 {
+    releaseCons();
     emit finished();
 }
 
+void RizinTask::releaseCons()
+{
+    if (holdsCons.exchange(false)) {
+        session->unlockCons();
+    }
+}
+
 // RizinCmdTask
 
 RizinCmdTask::RizinCmdTask(const QString &cmd, bool transient)
 {
     task = rz_core_cmd_task_new(
-            Core()->core(), cmd.toLocal8Bit().constData(),
+            session->core(), cmd.toLocal8Bit().constData(),
             static_cast<RzCoreCmdTaskFinished>(&RizinCmdTask::taskFinishedCallback), this);
     task->transient = transient;
     rz_core_task_incref(task);
@@ -62,7 +73,7 @@ CutterJson RizinCmdTask::getResultJson()
     }
     char *copy = static_cast<char *>(rz_mem_alloc(strlen(res) + 1));
     strcpy(copy, res);
-    return Core()->parseJson("task", copy, nullptr);
+    return session->parseJson("task", copy, nullptr);
 }
 
 const char *RizinCmdTask::getResultRaw()
@@ -76,7 +87,7 @@ RizinFunctionTask::RizinFunctionTask(std::function<void *(RzCore *)> fcn, bool t
     : fcn(fcn), res(nullptr)
 {
     task = rz_core_function_task_new(
-            Core()->core(), static_cast<RzCoreTaskFunction>(&RizinFunctionTask::runner), this);
+            session->core(), static_cast<RzCoreTaskFunction>(&RizinFunctionTask::runner), this);
     task->transient = transient;
     rz_core_task_incref(task);
 }
@@ -4,16 +4,28 @@
 
 #include "core/Cutter.h"
 
+#include <atomic>
+
 class CUTTER_EXPORT RizinTask : public QObject
 {
     Q_OBJECT
 
 protected:
     RzCoreTask *task;
+    CutterCore *session;
 
-    RizinTask() {}
+    RizinTask() : session(Core()) {}
     void taskFinished();
 
+private:
+    /**
+     * The task switches the cons context of rizin while it runs, so it holds the cons of its
+     * session from startTask() until it finished
+     */
+    std::atomic<bool> holdsCons { false };
+
+    void releaseCons();
+
 public:
     using Ptr = QSharedPointer<RizinTask>;
 
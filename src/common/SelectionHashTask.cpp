@@ -0,0 +1,267 @@
+#include "SelectionHashTask.h"
+
+#include "core/Cutter.h"
+
+#include <cmath>
+
+namespace {
+
+constexpr ut64 ChunkSize = 256 * SelectionHashCache::BlockSize;
+
+/**
+ * Table driven CRC-32 (IEEE 802.3, reflected), the same variant as the crc32 plugin of rz_hash.
+ */
+struct Crc32Tables
+{
+    quint32 table[256];
+    /**
+     * Linear operator appending BlockSize zero bytes to a crc register. Entry i is the image of
+     * bit i, see crc32Combine().
+     */
+    quint32 blockShift[32];
+
+    Crc32Tables()
+    {
+        for (quint32 i = 0; i < 256; i++) {
+            quint32 c = i;
+            for (int k = 0; k < 8; k++) {
+                c = c & 1 ? 0xedb88320U ^ (c >> 1) : c >> 1;
+            }
+            table[i] = c;
+        }
+        for (int bit = 0; bit < 32; bit++) {
+            quint32 c = 1U << bit;
+            for (ut64 i = 0; i < SelectionHashCache::BlockSize; i++) {
+                c = table[c & 0xff] ^ (c >> 8);
+            }
+            blockShift[bit] = c;
+        }
+    }
+};
+
+const Crc32Tables &crcTables()
+{
+    static const Crc32Tables tables;
+    return tables;
+}
+
+quint32 crc32Update(quint32 crc, const ut8 *data, ut64 len)
+{
+    const quint32 *table = crcTables().table;
+    crc = ~crc;
+    for (ut64 i = 0; i < len; i++) {
+        crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+/**
+ * @brief CRC of the concatenation of a and a following block, given crc1 of a and crc2 of the
+ * block. Same as crc32_combine() of zlib with the operator for the block length precomputed.
+ */
+quint32 crc32CombineBlock(quint32 crc1, quint32 crc2)
+{
+    const quint32 *shift = crcTables().blockShift;
+    quint32 sum = 0;
+    for (int bit = 0; crc1; bit++, crc1 >>= 1) {
+        if (crc1 & 1) {
+            sum ^= shift[bit];
+        }
+    }
+    return sum ^ crc2;
+}
+
+}
+
+struct SelectionHashTask::Accumulator
+{
+    quint32 crc32 = 0;
+    std::array<ut64, 256> histogram = {};
+
+    QString crc32String() const { return QString("%1").arg(crc32, 8, 16, QLatin1Char('0')); }
+
+    QString entropyString(ut64 total) const
+    {
+        double entropy = 0.0;
+        if (total) {
+            for (ut64 count : histogram) {
+                if (count) {
+                    double p = static_cast<double>(count) / total;
+                    entropy -= p * std::log2(p);
+                }
+            }
+        }
+        return QString::number(entropy, 'f', 8);
+    }
+};
+
+SelectionHashCache::SelectionHashCache(int maxBlocks) : blocks(maxBlocks) {}
+
+bool SelectionHashCache::lookup(ut64 blockIndex, Block &block)
+{
+    QMutexLocker locker(&mutex);
+    Block *cached = blocks.object(blockIndex);
+    if (!cached) {
+        return false;
+    }
+    block = *cached;
+    return true;
+}
+
+void SelectionHashCache::insert(ut64 blockIndex, const Block &block)
+{
+    QMutexLocker locker(&mutex);
+    blocks.insert(blockIndex, new Block(block));
+}
+
+void SelectionHashCache::clear()
+{
+    QMutexLocker locker(&mutex);
+    blocks.clear();
+}
+
+SelectionHashTask::SelectionHashTask(RVA start, ut64 size,
+                                     std::shared_ptr<SelectionHashCache> cache)
+    : start(start), size(size), cache(std::move(cache))
+{
+}
+
+void SelectionHashTask::accumulateBytes(Accumulator &acc, RVA addr, const ut8 *data, ut64 len)
+{
+    const ut64 blockSize = SelectionHashCache::BlockSize;
+    ut64 pos = 0;
+    while (pos < len) {
+        RVA blockStart = (addr + pos) & ~(blockSize - 1);
+        ut64 pieceLen = qMin(blockStart + blockSize - (addr + pos), len - pos);
+        const ut8 *piece = data + pos;
+        if (pieceLen == blockSize) {
+            SelectionHashCache::Block block;
+            if (!cache->lookup(blockStart / blockSize, block)) {
+                block.crc32 = crc32Update(0, piece, blockSize);
+                block.histogram.fill(0);
+                for (ut64 i = 0; i < blockSize; i++) {
+                    block.histogram[piece[i]]++;
+                }
+                cache->insert(blockStart / blockSize, block);
+            }
+            acc.crc32 = crc32CombineBlock(acc.crc32, block.crc32);
+            for (int i = 0; i < 256; i++) {
+                acc.histogram[i] += block.histogram[i];
+            }
+        } else {
+            // Partial blocks at the edges of the range are cheap, they are never cached
+            acc.crc32 = crc32Update(acc.crc32, piece, pieceLen);
+            for (ut64 i = 0; i < pieceLen; i++) {
+                acc.histogram[piece[i]]++;
+            }
+        }
+        pos += pieceLen;
+    }
+}
+
+bool SelectionHashTask::accumulateFromCache(Accumulator &acc)
+{
+    const ut64 blockSize = SelectionHashCache::BlockSize;
+    RVA end = start + size;
+    RVA firstBlock = (start + blockSize - 1) & ~(blockSize - 1);
+    RVA blocksEnd = end & ~(blockSize - 1);
+    if (firstBlock >= blocksEnd || end < start) {
+        return false;
+    }
+
+    if (firstBlock > start) {
+        QByteArray head = Core()->ioRead(start, static_cast<int>(firstBlock - start));
+        accumulateBytes(acc, start, reinterpret_cast<const ut8 *>(head.constData()), head.size());
+    }
+    for (RVA block = firstBlock; block < blocksEnd; block += blockSize) {
+        SelectionHashCache::Block cached;
+        if (isInterrupted() || !cache->lookup(block / blockSize, cached)) {
+            return false;
+        }
+        acc.crc32 = crc32CombineBlock(acc.crc32, cached.crc32);
+        for (int i = 0; i < 256; i++) {
+            acc.histogram[i] += cached.histogram[i];
+        }
+    }
+    if (end > blocksEnd) {
+        QByteArray tail = Core()->ioRead(blocksEnd, static_cast<int>(end - blocksEnd));
+        accumulateBytes(acc, blocksEnd, reinterpret_cast<const ut8 *>(tail.constData()),
+                        tail.size());
+    }
+    return true;
+}
+
+void SelectionHashTask::runTask()
+{
+    if (!size) {
+        return;
+    }
+
+    Accumulator acc;
+    bool fromCache = accumulateFromCache(acc);
+    if (isInterrupted()) {
+        return;
+    }
+    if (fromCache) {
+        emit partialResultReady(acc.crc32String(), acc.entropyString(size));
+    } else {
+        acc = Accumulator();
+    }
+
+    RzHashCfg *md;
+    {
+        RzCoreLocked core(Core());
+        md = rz_hash_cfg_new(core->hash);
+    }
+    if (!md) {
+        return;
+    }
+    static const char *const digests[] = { "md5", "sha1", "sha256" };
+    for (const char *digest : digests) {
+        rz_hash_cfg_configure(md, digest);
+    }
+    rz_hash_cfg_init(md);
+
+    // Every chunk is read with a separate short lock, so the core stays usable while large
+    // selections are hashed.
+    int lastPercent = -1;
+    for (ut64 done = 0; done < size;) {
+        if (isInterrupted()) {
+            rz_hash_cfg_free(md);
+            return;
+        }
+        ut64 len = qMin(ChunkSize, size - done);
+        QByteArray chunk = Core()->ioRead(start + done, static_cast<int>(len));
+        const ut8 *data = reinterpret_cast<const ut8 *>(chunk.constData());
+        rz_hash_cfg_update(md, data, len);
+        if (!fromCache) {
+            accumulateBytes(acc, start + done, data, len);
+        }
+        done += len;
+
+        int percent = static_cast<int>(done * 100 / size);
+        if (percent != lastPercent) {
+            lastPercent = percent;
+            emit progress(percent);
+        }
+    }
+    rz_hash_cfg_final(md);
+
+    auto digestString = [md](const char *name) {
+        char *digest = rz_hash_cfg_get_result_string(md, name, nullptr, false);
+        QString result(digest);
+        free(digest);
+        return result;
+    };
+    Result result;
+    result.md5 = digestString("md5");
+    result.sha1 = digestString("sha1");
+    result.sha256 = digestString("sha256");
+    result.crc32 = acc.crc32String();
+    result.entropy = acc.entropyString(size);
+    rz_hash_cfg_free(md);
+
+    if (!isInterrupted()) {
+        emit resultReady(result);
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef SELECTIONHASHTASK_H
+#define SELECTIONHASHTASK_H
+
+#include "common/AsyncTask.h"
+#include "core/CutterCommon.h"
+
+#include <QCache>
+#include <QMutex>
+
+#include <array>
+#include <memory>
+
+/**
+ * @brief Per-block partial results which can be combined for any range of whole blocks
+ *
+ * Cryptographic digests can't be split, but CRC32 values of consecutive blocks can be combined
+ * and the byte histograms used for the entropy simply add up. Caching them makes growing or
+ * moving a selection over already hashed memory cheap for these two values.
+ */
+class CUTTER_EXPORT SelectionHashCache
+{
+public:
+    static constexpr ut64 BlockSize = 0x1000;
+
+    struct Block
+    {
+        quint32 crc32;
+        std::array<quint16, 256> histogram;
+    };
+
+    explicit SelectionHashCache(int maxBlocks = 8192);
+
+    bool lookup(ut64 blockIndex, Block &block);
+    void insert(ut64 blockIndex, const Block &block);
+    /**
+     * @brief Drop everything, needs to be called whenever memory contents may have changed.
+     */
+    void clear();
+
+private:
+    QMutex mutex;
+    QCache<ut64, Block> blocks;
+};
+
+/**
+ * @brief Computes md5, sha1, sha256, crc32 and entropy of a memory range in one streaming pass
+ *
+ * The range is read in chunks so that the core lock is only held for short periods and the size
+ * of the range is not limited by the core block size.
+ */
+class CUTTER_EXPORT SelectionHashTask : public AsyncTask
+{
+    Q_OBJECT
+
+public:
+    struct Result
+    {
+        QString md5;
+        QString sha1;
+        QString sha256;
+        QString crc32;
+        QString entropy;
+    };
+
+    SelectionHashTask(RVA start, ut64 size, std::shared_ptr<SelectionHashCache> cache);
+
+    QString getTitle() override { return tr("Hashing selection"); }
+
+    RVA getStart() const { return start; }
+    ut64 getSize() const { return size; }
+
+signals:
+    /**
+     * @brief Emitted before the full pass if crc32 and entropy could be computed from the cache.
+     */
+    void partialResultReady(const QString &crc32, const QString &entropy);
+    void progress(int percent);
+    void resultReady(const SelectionHashTask::Result &result);
+
+protected:
+    void runTask() override;
+
+private:
+    struct Accumulator;
+
+    RVA start;
+    ut64 size;
+    std::shared_ptr<SelectionHashCache> cache;
+
+    bool accumulateFromCache(Accumulator &acc);
+    void accumulateBytes(Accumulator &acc, RVA addr, const ut8 *data, ut64 len);
+};
+
+Q_DECLARE_METATYPE(SelectionHashTask::Result)
+
+#endif // SELECTIONHASHTASK_H
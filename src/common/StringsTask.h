@@ -19,7 +19,9 @@ protected:
     void runTask() override
     {
         auto strings = Core()->getAllStrings();
-        emit stringSearchFinished(strings);
+        if (!isInterrupted()) {
+            emit stringSearchFinished(strings);
+        }
     }
 };
 
@@ -0,0 +1,398 @@
+#include "XrefIndex.h"
+
+#include "common/AsyncTask.h"
+#include "common/ChangeTracker.h"
+#include "core/Cutter.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+void XrefIndex::Adjacency::assign(std::vector<std::pair<RVA, Entry>> &edges)
+{
+    std::stable_sort(
+            edges.begin(), edges.end(),
+            [](const std::pair<RVA, Entry> &a, const std::pair<RVA, Entry> &b) {
+                return a.first < b.first;
+            });
+    nodes.clear();
+    offsets.clear();
+    entries.clear();
+    entries.reserve(edges.size());
+    for (size_t i = 0; i < edges.size(); i++) {
+        if (nodes.empty() || nodes.back() != edges[i].first) {
+            nodes.push_back(edges[i].first);
+            offsets.push_back(static_cast<quint32>(i));
+        }
+        entries.push_back(edges[i].second);
+    }
+    offsets.push_back(static_cast<quint32>(edges.size()));
+}
+
+ptrdiff_t XrefIndex::Adjacency::row(RVA node) const
+{
+    auto it = std::lower_bound(nodes.begin(), nodes.end(), node);
+    if (it == nodes.end() || *it != node) {
+        return -1;
+    }
+    return it - nodes.begin();
+}
+
+static XrefIndex::FunctionShape functionShape(RzAnalysisFunction *fcn)
+{
+    return { fcn->addr, rz_analysis_function_min_addr(fcn), rz_analysis_function_max_addr(fcn),
+             rz_pvector_len(fcn->bbs), rz_analysis_function_linear_size(fcn) };
+}
+
+static const XrefIndex::FunctionShape *findShape(const std::vector<XrefIndex::FunctionShape> &shapes,
+                                                 RVA addr)
+{
+    auto it = std::lower_bound(
+            shapes.begin(), shapes.end(), addr,
+            [](const XrefIndex::FunctionShape &shape, RVA addr) { return shape.addr < addr; });
+    return it != shapes.end() && it->addr == addr ? &*it : nullptr;
+}
+
+namespace {
+
+/**
+ * @brief Builds a snapshot of the index. Only copying the xrefs and blocks out of rizin holds the
+ * core lock, sorting them doesn't.
+ */
+class XrefIndexBuildTask : public AsyncTask
+{
+public:
+    XrefIndexBuildTask(quint64 xrefsGeneration, quint64 functionsGeneration)
+    {
+        result = std::make_shared<XrefIndex::Snapshot>();
+        result->xrefsGeneration = xrefsGeneration;
+        result->functionsGeneration = functionsGeneration;
+    }
+
+    QString getTitle() override { return tr("Indexing xrefs"); }
+
+    std::shared_ptr<XrefIndex::Snapshot> result;
+
+protected:
+    void runTask() override
+    {
+        using Entry = XrefIndex::Adjacency::Entry;
+        std::vector<std::pair<RVA, Entry>> outgoing;
+        std::vector<std::pair<RVA, Entry>> incoming;
+        std::vector<std::pair<RVA, std::pair<RVA, RVA>>> blocks;
+        {
+            RzCoreLocked core(Core());
+            auto xrefs = fromOwned(rz_analysis_xrefs_list(core->analysis));
+            size_t count = rz_list_length(xrefs.get());
+            outgoing.reserve(count);
+            incoming.reserve(count);
+            for (const auto &xref : CutterRzList<RzAnalysisXRef>(xrefs.get())) {
+                outgoing.push_back({ xref->from, { xref->to, xref->type } });
+                incoming.push_back({ xref->to, { xref->from, xref->type } });
+            }
+            for (const auto &fcn : CutterRzList<RzAnalysisFunction>(core->analysis->fcns)) {
+                result->functions.push_back(functionShape(fcn));
+                for (const auto &bb : CutterPVector<RzAnalysisBlock>(fcn->bbs)) {
+                    blocks.push_back({ fcn->addr, { bb->addr, bb->addr + bb->size } });
+                }
+            }
+        }
+        if (isInterrupted()) {
+            return;
+        }
+        std::sort(result->functions.begin(), result->functions.end(),
+                  [](const XrefIndex::FunctionShape &a, const XrefIndex::FunctionShape &b) {
+                      return a.addr < b.addr;
+                  });
+        const XrefIndex::Adjacency &from = result->from;
+        result->from.assign(outgoing);
+        result->to.assign(incoming);
+
+        // Call edges of each function are the call xrefs originating anywhere in its basic
+        // blocks. The source sorted rows make this a range scan per block instead of a query
+        // per address.
+        std::vector<std::pair<RVA, Entry>> callEdges;
+        std::unordered_set<RVA> seen;
+        for (size_t b = 0; b < blocks.size(); b++) {
+            RVA function = blocks[b].first;
+            if (b == 0 || blocks[b - 1].first != function) {
+                seen.clear();
+            }
+            RVA begin = blocks[b].second.first;
+            RVA end = blocks[b].second.second;
+            auto first = std::lower_bound(from.nodes.begin(), from.nodes.end(), begin);
+            for (auto node = first; node != from.nodes.end() && *node < end; ++node) {
+                size_t row = node - from.nodes.begin();
+                for (quint32 i = from.offsets[row]; i < from.offsets[row + 1]; i++) {
+                    const Entry &entry = from.entries[i];
+                    if (entry.type == RZ_ANALYSIS_XREF_TYPE_CALL
+                        && seen.insert(entry.addr).second) {
+                        callEdges.push_back({ function, entry });
+                    }
+                }
+            }
+        }
+        result->calls.assign(callEdges);
+    }
+};
+
+}
+
+XrefIndex::XrefIndex(CutterCore *core) : core(core) {}
+
+XrefIndex::~XrefIndex()
+{
+    if (rebuildTask) {
+        // Only touches its own data, finishes in the background
+        rebuildTask->interrupt();
+    }
+}
+
+void XrefIndex::invalidate()
+{
+    RzCoreLocked locked = core->core();
+    snapshot.reset();
+    dirtyRanges.clear();
+    if (rebuildTask) {
+        // Its result may predate the invalidation
+        rebuildTask->interrupt();
+        rebuildTask.clear();
+        rebuildRequested = false;
+    }
+    requestRebuild();
+}
+
+const XrefIndex::Snapshot *XrefIndex::currentSnapshot()
+{
+    ChangeTracker *tracker = core->getChangeTracker();
+    if (!snapshot || snapshot->xrefsGeneration < tracker->generation(ChangeTracker::Xrefs)) {
+        requestRebuild();
+        return nullptr;
+    }
+    quint64 functionsGeneration = tracker->generation(ChangeTracker::Functions);
+    if (comparedFunctionsGeneration != functionsGeneration) {
+        comparedFunctionsGeneration = functionsGeneration;
+        compareFunctions(*snapshot);
+    }
+    return snapshot.get();
+}
+
+void XrefIndex::compareFunctions(const Snapshot &base)
+{
+    // Always against the snapshot, so the ranges stay correct however many changes came since
+    dirtyRanges.clear();
+    std::vector<bool> found(base.functions.size());
+    RzCoreLocked locked = core->core();
+    for (const auto &fcn : CutterRzList<RzAnalysisFunction>(locked->analysis->fcns)) {
+        FunctionShape shape = functionShape(fcn);
+        const FunctionShape *old = findShape(base.functions, fcn->addr);
+        if (old) {
+            found[old - base.functions.data()] = true;
+            if (*old == shape) {
+                continue;
+            }
+            dirtyRanges.push_back({ old->min, old->max });
+        }
+        dirtyRanges.push_back({ shape.min, shape.max });
+    }
+    for (size_t i = 0; i < found.size(); i++) {
+        if (!found[i]) {
+            dirtyRanges.push_back({ base.functions[i].min, base.functions[i].max });
+        }
+    }
+
+    std::sort(dirtyRanges.begin(), dirtyRanges.end());
+    size_t merged = 0;
+    for (size_t i = 0; i < dirtyRanges.size(); i++) {
+        if (merged && dirtyRanges[i].first <= dirtyRanges[merged - 1].second) {
+            dirtyRanges[merged - 1].second =
+                    std::max(dirtyRanges[merged - 1].second, dirtyRanges[i].second);
+        } else {
+            dirtyRanges[merged++] = dirtyRanges[i];
+        }
+    }
+    dirtyRanges.resize(merged);
+
+    // Queries stay correct, but every one of them would mostly go to rizin
+    if (dirtyRanges.size() > MaxDirtyRanges) {
+        requestRebuild();
+    }
+}
+
+void XrefIndex::requestRebuild()
+{
+    if (rebuildRequested) {
+        return;
+    }
+    rebuildRequested = true;
+    // Queries come from any thread, tasks are started on the thread of the session
+    QMetaObject::invokeMethod(
+            core, [this]() { startRebuild(); }, Qt::QueuedConnection);
+}
+
+void XrefIndex::startRebuild()
+{
+    RzCoreLocked locked = core->core();
+    if (rebuildTask) {
+        return;
+    }
+    ChangeTracker *tracker = core->getChangeTracker();
+    auto task = QSharedPointer<XrefIndexBuildTask>::create(
+            tracker->generation(ChangeTracker::Xrefs),
+            tracker->generation(ChangeTracker::Functions));
+    task->setPriority(AsyncTask::Priority::Background);
+    task->setKey(QStringLiteral("XrefIndex"));
+    XrefIndexBuildTask *taskPtr = task.data();
+    rebuildTask = task;
+    QObject::connect(
+            taskPtr, &AsyncTask::finished, core,
+            [this, taskPtr]() {
+                RzCoreLocked locked = core->core();
+                if (rebuildTask.data() != taskPtr) {
+                    return;
+                }
+                if (!taskPtr->isInterrupted()) {
+                    snapshot = std::move(taskPtr->result);
+                    dirtyRanges.clear();
+                    comparedFunctionsGeneration = snapshot->functionsGeneration;
+                }
+                rebuildRequested = false;
+                rebuildTask.clear();
+            },
+            Qt::QueuedConnection);
+    core->getAsyncTaskManager()->start(task);
+}
+
+bool XrefIndex::isDirty(RVA addr) const
+{
+    return overlapsDirty(addr, addr + 1);
+}
+
+bool XrefIndex::overlapsDirty(RVA from, RVA to) const
+{
+    auto it = std::upper_bound(
+            dirtyRanges.begin(), dirtyRanges.end(), from,
+            [](RVA addr, const std::pair<RVA, RVA> &range) { return addr < range.second; });
+    return it != dirtyRanges.end() && it->first < to;
+}
+
+QVector<XrefIndex::Xref> XrefIndex::rowXrefs(const Adjacency &adjacency, RVA node, bool outgoing)
+{
+    QVector<Xref> result;
+    ptrdiff_t row = adjacency.row(node);
+    if (row < 0) {
+        return result;
+    }
+    quint32 begin = adjacency.offsets[row];
+    quint32 end = adjacency.offsets[row + 1];
+    result.reserve(static_cast<int>(end - begin));
+    for (quint32 i = begin; i < end; i++) {
+        const auto &entry = adjacency.entries[i];
+        if (outgoing) {
+            result.append({ node, entry.addr, entry.type });
+        } else {
+            result.append({ entry.addr, node, entry.type });
+        }
+    }
+    return result;
+}
+
+QVector<XrefIndex::Xref> XrefIndex::rizinXrefs(RVA addr, bool outgoing)
+{
+    RzCoreLocked locked = core->core();
+    auto xrefs = fromOwned(outgoing ? rz_analysis_xrefs_get_from(locked->analysis, addr)
+                                    : rz_analysis_xrefs_get_to(locked->analysis, addr));
+    QVector<Xref> result;
+    for (const auto &xref : CutterRzList<RzAnalysisXRef>(xrefs.get())) {
+        result.append({ xref->from, xref->to, xref->type });
+    }
+    return result;
+}
+
+QVector<RVA> XrefIndex::rizinCallees(RVA functionAddr)
+{
+    RzCoreLocked locked = core->core();
+    RzAnalysisFunction *fcn = rz_analysis_get_function_at(locked->analysis, functionAddr);
+    if (!fcn) {
+        return {};
+    }
+    auto xrefs = fromOwned(rz_analysis_function_get_xrefs_from(fcn));
+    std::vector<Xref> calls;
+    for (const auto &xref : CutterRzList<RzAnalysisXRef>(xrefs.get())) {
+        if (xref->type == RZ_ANALYSIS_XREF_TYPE_CALL) {
+            calls.push_back({ xref->from, xref->to, xref->type });
+        }
+    }
+    std::stable_sort(calls.begin(), calls.end(),
+                     [](const Xref &a, const Xref &b) { return a.from < b.from; });
+    QVector<RVA> result;
+    std::unordered_set<RVA> seen;
+    for (const Xref &call : calls) {
+        if (seen.insert(call.to).second) {
+            result.append(call.to);
+        }
+    }
+    return result;
+}
+
+QVector<XrefIndex::Xref> XrefIndex::xrefsFrom(RVA addr)
+{
+    RzCoreLocked locked = core->core();
+    const Snapshot *base = currentSnapshot();
+    if (!base || isDirty(addr)) {
+        return rizinXrefs(addr, true);
+    }
+    return rowXrefs(base->from, addr, true);
+}
+
+QVector<XrefIndex::Xref> XrefIndex::xrefsTo(RVA addr)
+{
+    RzCoreLocked locked = core->core();
+    const Snapshot *base = currentSnapshot();
+    if (!base) {
+        return rizinXrefs(addr, false);
+    }
+    QVector<Xref> result = rowXrefs(base->to, addr, false);
+    if (!dirtyRanges.empty()) {
+        // Sources in changed functions are taken from rizin instead
+        result.erase(std::remove_if(result.begin(), result.end(),
+                                    [this](const Xref &xref) { return isDirty(xref.from); }),
+                     result.end());
+        for (const Xref &xref : rizinXrefs(addr, false)) {
+            if (isDirty(xref.from)) {
+                result.append(xref);
+            }
+        }
+    }
+    return result;
+}
+
+QVector<RVA> XrefIndex::functions()
+{
+    RzCoreLocked locked = core->core();
+    QVector<RVA> result;
+    result.reserve(static_cast<int>(rz_list_length(locked->analysis->fcns)));
+    for (const auto &fcn : CutterRzList<RzAnalysisFunction>(locked->analysis->fcns)) {
+        result.append(fcn->addr);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+QVector<RVA> XrefIndex::callees(RVA functionAddr)
+{
+    RzCoreLocked locked = core->core();
+    const Snapshot *base = currentSnapshot();
+    const FunctionShape *shape = base ? findShape(base->functions, functionAddr) : nullptr;
+    if (!shape || overlapsDirty(shape->min, shape->max)) {
+        return rizinCallees(functionAddr);
+    }
+    QVector<RVA> result;
+    ptrdiff_t row = base->calls.row(functionAddr);
+    if (row < 0) {
+        return result;
+    }
+    for (quint32 i = base->calls.offsets[row]; i < base->calls.offsets[row + 1]; i++) {
+        result.append(base->calls.entries[i].addr);
+    }
+    return result;
+}
@@ -0,0 +1,158 @@
+#ifndef XREFINDEX_H
+#define XREFINDEX_H
+
+#include "core/CutterCommon.h"
+
+#include <QSharedPointer>
+#include <QVector>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+class AsyncTask;
+class CutterCore;
+
+/**
+ * @brief Compact adjacency index of all xrefs and of the call graph between functions
+ *
+ * Querying rizin for the xrefs of every function separately is slow on big binaries, the global
+ * call graph did that for each function and every target. This index stores all xrefs once in
+ * compressed sparse row form, sorted by source and by target, so lookups are a binary search
+ * followed by a contiguous scan. Call edges between functions are derived from the source sorted
+ * rows using the basic block ranges of each function.
+ *
+ * The rows are an immutable snapshot built by a background task. Analysis of single functions
+ * doesn't rebuild it: functions whose blocks changed since the snapshot are compared on the next
+ * query, and xrefs originating in them are read from rizin instead of the snapshot. A full
+ * rebuild only follows changes of the Xrefs domain of ChangeTracker, like arbitrary commands,
+ * and until it is done all queries go to rizin directly. Renames don't touch the index at all.
+ * Names are not part of the index, resolve them in batches with CutterCore::flagsAt().
+ *
+ * Queries may come from background tasks too, every query holds the core lock.
+ */
+class CUTTER_EXPORT XrefIndex
+{
+public:
+    struct Xref
+    {
+        RVA from;
+        RVA to;
+        RzAnalysisXRefType type;
+    };
+
+    explicit XrefIndex(CutterCore *core);
+    ~XrefIndex();
+
+    /**
+     * @return xrefs originating at exactly addr
+     */
+    QVector<Xref> xrefsFrom(RVA addr);
+    /**
+     * @return xrefs pointing to addr
+     */
+    QVector<Xref> xrefsTo(RVA addr);
+
+    /**
+     * @return entry points of all functions, sorted by address
+     */
+    QVector<RVA> functions();
+    /**
+     * @return distinct targets of call xrefs from the basic blocks of the function starting at
+     * functionAddr, in order of their first appearance
+     */
+    QVector<RVA> callees(RVA functionAddr);
+
+    /**
+     * @brief Drop the snapshot and build a new one in the background
+     */
+    void invalidate();
+
+    /**
+     * Rows of adjacent addresses. Row i belongs to nodes[i] and spans
+     * entries[offsets[i]] to entries[offsets[i + 1]].
+     */
+    struct Adjacency
+    {
+        struct Entry
+        {
+            RVA addr;
+            RzAnalysisXRefType type;
+        };
+
+        std::vector<RVA> nodes;
+        std::vector<quint32> offsets;
+        std::vector<Entry> entries;
+
+        /**
+         * @brief Replace the contents with edges given as (node, entry) pairs. The pairs are
+         * sorted by node in place, keeping the order of entries within a node.
+         */
+        void assign(std::vector<std::pair<RVA, Entry>> &edges);
+        /**
+         * @return index of the row of node or -1
+         */
+        ptrdiff_t row(RVA node) const;
+    };
+
+    /**
+     * @brief Extent and block layout of a function, compared to find functions whose xrefs may
+     * have changed
+     */
+    struct FunctionShape
+    {
+        RVA addr;
+        RVA min;
+        RVA max;
+        ut64 blocks;
+        ut64 size;
+
+        bool operator==(const FunctionShape &other) const
+        {
+            return addr == other.addr && min == other.min && max == other.max
+                    && blocks == other.blocks && size == other.size;
+        }
+    };
+
+    struct Snapshot
+    {
+        Adjacency from;
+        Adjacency to;
+        Adjacency calls;
+        /// Sorted by address
+        std::vector<FunctionShape> functions;
+        /// Generations of the Xrefs and Functions domains the snapshot was taken at
+        quint64 xrefsGeneration = 0;
+        quint64 functionsGeneration = 0;
+    };
+
+private:
+    CutterCore *core;
+    std::shared_ptr<const Snapshot> snapshot;
+    /// A rebuild is queued or running, cleared when its task finishes
+    bool rebuildRequested = false;
+    QSharedPointer<AsyncTask> rebuildTask;
+
+    /// Functions generation the dirty ranges were last compared at
+    quint64 comparedFunctionsGeneration = 0;
+    /// Sorted, disjoint ranges of code whose xrefs may differ from the snapshot
+    std::vector<std::pair<RVA, RVA>> dirtyRanges;
+
+    static constexpr size_t MaxDirtyRanges = 256;
+
+    /**
+     * @return the snapshot if it is current, otherwise nullptr and queries go to rizin
+     */
+    const Snapshot *currentSnapshot();
+    void compareFunctions(const Snapshot &base);
+    void requestRebuild();
+    void startRebuild();
+    bool isDirty(RVA addr) const;
+    bool overlapsDirty(RVA from, RVA to) const;
+
+    static QVector<Xref> rowXrefs(const Adjacency &adjacency, RVA node, bool outgoing);
+    QVector<Xref> rizinXrefs(RVA addr, bool outgoing);
+    QVector<RVA> rizinCallees(RVA functionAddr);
+};
+
+#endif // XREFINDEX_H
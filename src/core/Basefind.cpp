@@ -1,14 +1,42 @@
 #include "Basefind.h"
 
-bool Basefind::threadCallback(const RzBaseFindThreadInfo *info, void *user)
+#include "common/ParallelFor.h"
+
+#include <algorithm>
+
+namespace {
+
+/**
+ * Minimum time between two progress reports, results are reported along with the progress
+ */
+constexpr qint64 ProgressInterval = 100;
+
+/**
+ * Number of candidates which share an upper bound, the block count is limited to keep the
+ * bounds cheap for large ranges
+ */
+constexpr ut64 BlockSize = 64;
+constexpr ut64 MaxBlocks = 1 << 20;
+
+ut64 saturatingAdd(ut64 a, ut64 b)
+{
+    return a > UT64_MAX - b ? UT64_MAX : a + b;
+}
+
+bool isStringChar(ut8 c)
 {
-    auto th = reinterpret_cast<Basefind *>(user);
-    return th->updateProgress(info);
+    return (c >= 0x20 && c < 0x7f) || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool betterResult(const BasefindResultDescription &a, const BasefindResultDescription &b)
+{
+    return a.score != b.score ? a.score > b.score : a.candidate < b.candidate;
+}
+
 }
 
 Basefind::Basefind(CutterCore *core)
     : core(core),
-      scores(nullptr),
       continue_run(true)
 #if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
       ,
@@ -22,7 +50,6 @@ Basefind::~Basefind()
 {
     cancel();
     wait();
-    rz_list_free(scores);
 }
 
 bool Basefind::setOptions(const RzBaseFindOpt *opts)
@@ -50,60 +77,254 @@ bool Basefind::setOptions(const RzBaseFindOpt *opts)
     } else if (options.min_string_len < 1) {
         qWarning() << tr("Min string length must be at least 1");
         return false;
+    } else if (options.pointer_size != 32 && options.pointer_size != 64) {
+        qWarning() << tr("Pointer size must be 32 or 64 bits");
+        return false;
     }
     return true;
 }
 
+void Basefind::setStopEarly(bool stopEarly)
+{
+    this->stopEarly = stopEarly;
+}
+
 void Basefind::run()
 {
     qRegisterMetaType<BasefindCoreStatusDescription>();
 
     mutex.lock();
-    rz_list_free(scores);
-    scores = nullptr;
+    found.clear();
+    progressTimer.invalidate();
     continue_run = true;
     mutex.unlock();
 
-    core->coreMutex.lock();
-    options.callback = threadCallback;
-    options.user = this;
-    scores = rz_basefind(core->core_, &options);
-    core->coreMutex.unlock();
+    if (indexFile() && continue_run) {
+        scoreCandidates();
+    }
+    strings = std::vector<ut64>();
+    pointers = std::vector<ut64>();
 
     emit complete();
 }
 
 void Basefind::cancel()
 {
-    mutex.lock();
     continue_run = false;
-    mutex.unlock();
 }
 
 QList<BasefindResultDescription> Basefind::results()
 {
+    mutex.lock();
+    QList<BasefindResultDescription> pairs = found;
+    mutex.unlock();
+    std::sort(pairs.begin(), pairs.end(), betterResult);
+    return pairs;
+}
+
+QList<BasefindResultDescription> Basefind::topResults(int count)
+{
+    mutex.lock();
+    std::vector<BasefindResultDescription> best(std::max(0, std::min<int>(count, found.size())));
+    std::partial_sort_copy(found.begin(), found.end(), best.begin(), best.end(), betterResult);
+    mutex.unlock();
+
     QList<BasefindResultDescription> pairs;
-    RzListIter *it;
-    RzBaseFindScore *pair;
-    CutterRzListForeach (scores, it, RzBaseFindScore, pair) {
-        BasefindResultDescription desc;
-        desc.candidate = pair->candidate;
-        desc.score = pair->score;
-        pairs.push_back(desc);
+    pairs.reserve(static_cast<int>(best.size()));
+    for (const BasefindResultDescription &pair : best) {
+        pairs.push_back(pair);
     }
     return pairs;
 }
 
-bool Basefind::updateProgress(const RzBaseFindThreadInfo *info)
+bool Basefind::indexFile()
+{
+    std::vector<ut8> data;
+    bool bigEndian = false;
+    core->coreMutex.lock();
+    RzBinFile *bf = rz_bin_cur(core->core_->bin);
+    if (bf && bf->buf) {
+        data.resize(rz_buf_size(bf->buf));
+        if (rz_buf_read_at(bf->buf, 0, data.data(), data.size()) < 0) {
+            data.clear();
+        }
+    }
+    bigEndian = rz_config_get_b(core->core_->config, "cfg.bigendian");
+    core->coreMutex.unlock();
+    if (data.empty()) {
+        qWarning() << tr("No file opened to search the base address of");
+        return false;
+    }
+
+    // Runs of printable characters, the offset of a string is that of its first character
+    strings.clear();
+    ut64 runStart = 0;
+    ut64 runLength = 0;
+    for (ut64 i = 0; i < data.size(); i++) {
+        if (isStringChar(data[i])) {
+            if (!runLength) {
+                runStart = i;
+            }
+            runLength++;
+            continue;
+        }
+        if (runLength >= options.min_string_len) {
+            strings.push_back(runStart);
+        }
+        runLength = 0;
+    }
+    if (runLength >= options.min_string_len) {
+        strings.push_back(runStart);
+    }
+    updateProgress(IndexStage, 50);
+    if (strings.empty() || !continue_run) {
+        updateProgress(IndexStage, 100);
+        return false;
+    }
+
+    // Only values which can point to a string for a base in the searched range are kept
+    const ut64 lowest = saturatingAdd(options.start_address, strings.front());
+    const ut64 highest = saturatingAdd(options.end_address, strings.back());
+    const ut64 step = options.pointer_size / 8;
+    pointers.clear();
+    for (ut64 i = 0; i + step <= data.size(); i += step) {
+        ut64 value = rz_read_ble(data.data() + i, bigEndian, options.pointer_size);
+        if (value >= lowest && value <= highest) {
+            pointers.push_back(value);
+        }
+    }
+    std::sort(pointers.begin(), pointers.end());
+    pointers.erase(std::unique(pointers.begin(), pointers.end()), pointers.end());
+    updateProgress(IndexStage, 100);
+    return !pointers.empty();
+}
+
+ut32 Basefind::upperBound(RVA firstBase, RVA lastBase) const
+{
+    auto begin = std::lower_bound(pointers.begin(), pointers.end(),
+                                  saturatingAdd(firstBase, strings.front()));
+    auto end = std::upper_bound(begin, pointers.end(), saturatingAdd(lastBase, strings.back()));
+    return static_cast<ut32>(
+            std::min<size_t>(std::min<size_t>(end - begin, strings.size()), UT32_MAX));
+}
+
+ut32 Basefind::score(RVA base, ut32 threshold) const
+{
+    auto begin = std::lower_bound(pointers.begin(), pointers.end(),
+                                  saturatingAdd(base, strings.front()));
+    auto end = std::upper_bound(begin, pointers.end(), saturatingAdd(base, strings.back()));
+    size_t count = end - begin;
+    if (std::min(count, strings.size()) < threshold) {
+        return 0;
+    }
+
+    // Every pointer in the range is at least base, compare the offsets they imply
+    ut32 score = 0;
+    if (count * 16 < strings.size()) {
+        for (auto it = begin; it != end; ++it) {
+            if (std::binary_search(strings.begin(), strings.end(), *it - base)) {
+                score++;
+            }
+        }
+        return score;
+    }
+    auto string = strings.begin();
+    for (auto it = begin; it != end && string != strings.end();) {
+        ut64 offset = *it - base;
+        if (*string < offset) {
+            ++string;
+        } else if (offset < *string) {
+            ++it;
+        } else {
+            score++;
+            ++string;
+            ++it;
+        }
+    }
+    return score;
+}
+
+void Basefind::scoreCandidates()
+{
+    const ut64 alignment = options.alignment;
+    const RVA first = options.start_address % alignment
+            ? saturatingAdd(options.start_address, alignment - options.start_address % alignment)
+            : options.start_address;
+    if (first > options.end_address) {
+        updateProgress(ScoreStage, 100);
+        return;
+    }
+    const ut64 candidates = (options.end_address - first) / alignment + 1;
+    const ut64 blockSize = std::max(BlockSize, (candidates + MaxBlocks - 1) / MaxBlocks);
+
+    std::vector<Block> blocks;
+    for (ut64 i = 0; i < candidates; i += blockSize) {
+        Block block;
+        block.first = first + i * alignment;
+        block.count = std::min(blockSize, candidates - i);
+        block.bound = upperBound(block.first, block.first + (block.count - 1) * alignment);
+        if (block.bound >= options.min_score) {
+            blocks.push_back(block);
+        }
+    }
+    std::sort(blocks.begin(), blocks.end(),
+              [](const Block &a, const Block &b) { return a.bound > b.bound; });
+
+    std::atomic<ut32> best(0);
+    std::atomic<int> done(0);
+    const int blockCount = static_cast<int>(blocks.size());
+    parallelFor(
+            blockCount,
+            [&](int index) {
+                const Block &block = blocks[index];
+                if (!continue_run || (stopEarly && block.bound < best.load())) {
+                    done++;
+                    return;
+                }
+                QList<BasefindResultDescription> scored;
+                for (ut64 i = 0; i < block.count; i++) {
+                    ut32 threshold = options.min_score;
+                    if (stopEarly) {
+                        threshold = std::max(threshold, best.load());
+                    }
+                    BasefindResultDescription pair;
+                    pair.candidate = block.first + i * alignment;
+                    pair.score = score(pair.candidate, threshold);
+                    if (pair.score < options.min_score) {
+                        continue;
+                    }
+                    scored.push_back(pair);
+                    ut32 previous = best.load();
+                    while (pair.score > previous
+                           && !best.compare_exchange_weak(previous, pair.score)) {
+                    }
+                }
+                if (!scored.isEmpty()) {
+                    mutex.lock();
+                    found.append(scored);
+                    mutex.unlock();
+                }
+                updateProgress(ScoreStage, static_cast<ut32>(++done * 100LL / blockCount));
+            },
+            1, static_cast<int>(options.max_threads));
+    updateProgress(ScoreStage, 100);
+}
+
+void Basefind::updateProgress(Stage stage, ut32 percentage)
 {
     mutex.lock();
+    if (percentage < 100 && progressTimer.isValid()
+        && progressTimer.elapsed() < ProgressInterval) {
+        mutex.unlock();
+        return;
+    }
+    progressTimer.start();
 
     BasefindCoreStatusDescription status;
-    status.index = info->thread_idx;
-    status.percentage = info->percentage;
+    status.index = stage;
+    status.percentage = percentage;
 
     emit progress(status);
-    bool ret = continue_run;
+    emit resultsChanged();
     mutex.unlock();
-    return ret;
 }
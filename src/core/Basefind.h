@@ -3,45 +3,103 @@
 
 #include <QThread>
 #include <QMutex>
+#include <QElapsedTimer>
 
 #include "Cutter.h"
 #include "CutterDescriptions.h"
 #include <rz_basefind.h>
 
+#include <atomic>
+#include <vector>
+
 class CutterCore;
 
+/**
+ * @brief Searches the base address at which the current file was meant to be loaded
+ *
+ * A candidate base scores one point for every string in the file whose address, relative to the
+ * candidate, is stored somewhere in the file as an aligned pointer. The string offsets and the
+ * pointer values are extracted once into sorted arrays, after which the candidates are scored in
+ * parallel by intersecting both sets.
+ *
+ * Candidates are grouped into blocks and every block gets an upper bound for its score from the
+ * number of pointers which can possibly reference a string for any base of the block. Blocks
+ * which cannot reach the minimum score are never scored and the rest is scored from the highest
+ * bound down, so that the likely winners are found first.
+ */
 class Basefind : public QThread
 {
     Q_OBJECT
 
 public:
+    enum Stage { IndexStage = 0, ScoreStage, StageCount };
+
     explicit Basefind(CutterCore *core);
     virtual ~Basefind();
 
     void run();
     bool setOptions(const RzBaseFindOpt *opts);
+
+    /**
+     * @brief Stop once no remaining candidate can score higher than the best one found so far
+     *
+     * The best candidate is the same as with a full search, but candidates with lower scores may
+     * be missing from the results.
+     */
+    void setStopEarly(bool stopEarly);
+
+    /**
+     * @return all candidates found, best first
+     */
     QList<BasefindResultDescription> results();
 
+    /**
+     * @return the count best candidates found so far, can be called while the search runs
+     */
+    QList<BasefindResultDescription> topResults(int count);
+
 public slots:
     void cancel();
 
 signals:
+    /**
+     * @brief Progress of one of the stages, status.index is the Stage
+     */
     void progress(BasefindCoreStatusDescription status);
+    void resultsChanged();
     void complete();
 
 private:
+    struct Block
+    {
+        RVA first;
+        ut64 count;
+        ut32 bound;
+    };
+
     CutterCore *const core;
-    RzList *scores;
-    bool continue_run;
+    QList<BasefindResultDescription> found;
+    std::atomic<bool> continue_run;
+    bool stopEarly = true;
     RzBaseFindOpt options;
 #if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
     QMutex mutex;
 #else
     QRecursiveMutex mutex;
 #endif
+    QElapsedTimer progressTimer;
+
+    /**
+     * Sorted file offsets of the strings and sorted unique values of the pointers
+     */
+    std::vector<ut64> strings;
+    std::vector<ut64> pointers;
 
-    bool updateProgress(const RzBaseFindThreadInfo *info);
-    static bool threadCallback(const RzBaseFindThreadInfo *info, void *user);
+    bool indexFile();
+    void scoreCandidates();
+    ut32 upperBound(RVA firstBase, RVA lastBase) const;
+    ut32 score(RVA base, ut32 threshold) const;
+    void updateProgress(Stage stage, ut32 percentage);
 };
 
 #endif // CUTTER_BASEFIND_CORE_H
@@ -4,8 +4,12 @@
 #include <QDir>
 #include <QCoreApplication>
 #include <QVector>
+#include <QSet>
 #include <QStringList>
 #include <QStandardPaths>
+#include <QAtomicPointer>
+#include <QWaitCondition>
+#include <QTimer>
 
 #include <cassert>
 #include <memory>
@@ -14,6 +18,11 @@
 #include "common/BasicInstructionHighlighter.h"
 #include "common/Configuration.h"
 #include "common/AsyncTask.h"
+#include "common/ChangeTracker.h"
+#include "common/Coverage.h"
+#include "common/ByteMap.h"
+#include "common/XrefIndex.h"
+#include "core/CutterQuery.h"
 #include "common/RizinTask.h"
 #include "dialogs/RizinTaskDialog.h"
 #include "common/Json.h"
@@ -24,7 +33,54 @@
 #include <rz_cmd.h>
 #include <sdb.h>
 
-static CutterCore *uniqueInstance;
+// All sessions are created and destroyed on the UI thread, but they are listed from any thread
+static QList<CutterCore *> sessions;
+static QMutex sessionsMutex;
+static QAtomicInt sessionCount;
+static QAtomicPointer<CutterCore> activeSession;
+static thread_local CutterCore *scopedSession = nullptr;
+
+/**
+ * The cons of rizin is shared by all RzCore instances in the process. Commands capture their
+ * output with it and the task scheduler of a core switches its context, so only one session may
+ * use it at a time. Inside a session the core lock and the task scheduler already keep its users
+ * apart, even though they run on different threads, so the cons is owned by a session and not by
+ * a thread.
+ */
+static QMutex consOwnerMutex;
+static QWaitCondition consOwnerReleased;
+static CutterCore *consOwner = nullptr;
+static int consOwnerDepth = 0;
+
+void CutterCore::lockCons()
+{
+    QMutexLocker locker(&consOwnerMutex);
+    while (consOwner && consOwner != this) {
+        consOwnerReleased.wait(&consOwnerMutex);
+    }
+    consOwner = this;
+    consOwnerDepth++;
+}
+
+void CutterCore::unlockCons()
+{
+    QMutexLocker locker(&consOwnerMutex);
+    assert(consOwner == this && consOwnerDepth > 0);
+    if (--consOwnerDepth == 0) {
+        consOwner = nullptr;
+        consOwnerReleased.wakeAll();
+    }
+}
+
+class ConsLocker
+{
+public:
+    explicit ConsLocker(CutterCore *session) : session(session) { session->lockCons(); }
+    ~ConsLocker() { session->unlockCons(); }
+
+private:
+    CutterCore *session;
+};
 
 #define RZ_JSON_KEY(name) static const QString name = QStringLiteral(#name)
 
@@ -128,6 +184,36 @@ static bool reg_sync(RzCore *core, RzRegisterType type, bool write)
     return true;
 }
 
+/**
+ * The cons sleep callbacks always go to the RzCore created last, so the task scheduler of the
+ * right core is told directly.
+ */
+static void *coreSleepBegin(RzCore *core)
+{
+    RzCoreTask *task = rz_core_task_self(&core->tasks);
+    if (task) {
+        rz_core_task_sleep_begin(task);
+    }
+    return task;
+}
+
+static void coreSleepEnd(void *bed)
+{
+    if (bed) {
+        rz_core_task_sleep_end(reinterpret_cast<RzCoreTask *>(bed));
+    }
+}
+
+SessionScope::SessionScope(CutterCore *session) : previous(scopedSession)
+{
+    scopedSession = session;
+}
+
+SessionScope::~SessionScope()
+{
+    scopedSession = previous;
+}
+
 RzCoreLocked::RzCoreLocked(CutterCore *core) : core(core)
 {
     core->coreMutex.lock();
@@ -135,7 +221,7 @@ RzCoreLocked::RzCoreLocked(CutterCore *core) : core(core)
     core->coreLockDepth++;
     if (core->coreLockDepth == 1) {
         assert(core->coreBed);
-        rz_cons_sleep_end(core->coreBed);
+        coreSleepEnd(core->coreBed);
         core->coreBed = nullptr;
     }
 }
@@ -145,7 +231,7 @@ RzCoreLocked::~RzCoreLocked()
     assert(core->coreLockDepth > 0);
     core->coreLockDepth--;
     if (core->coreLockDepth == 0) {
-        core->coreBed = rz_cons_sleep_begin();
+        core->coreBed = coreSleepBegin(core->core_);
     }
     core->coreMutex.unlock();
 }
@@ -175,15 +261,32 @@ CutterCore::CutterCore(QObject *parent)
       coreMutex(QMutex::Recursive)
 #endif
 {
-    if (uniqueInstance) {
-        throw std::logic_error("Only one instance of CutterCore must exist");
-    }
-    uniqueInstance = this;
+    QMutexLocker locker(&sessionsMutex);
+    sessions.append(this);
+    sessionCount.storeRelease(sessions.size());
+    activeSession.testAndSetOrdered(nullptr, this);
 }
 
 CutterCore *CutterCore::instance()
 {
-    return uniqueInstance;
+    return scopedSession ? scopedSession : activeSession.loadAcquire();
+}
+
+QList<CutterCore *> CutterCore::getSessions()
+{
+    QMutexLocker locker(&sessionsMutex);
+    return sessions;
+}
+
+int CutterCore::getSessionCount()
+{
+    return sessionCount.loadAcquire();
+}
+
+void CutterCore::setActiveSession(CutterCore *session)
+{
+    assert(getSessions().contains(session));
+    activeSession.storeRelease(session);
 }
 
 void CutterCore::initialize(bool loadPlugins)
@@ -200,7 +303,7 @@ void CutterCore::initialize(bool loadPlugins)
     rz_cons_new(); // initialize console
     core_ = rz_core_new();
     rz_core_task_sync_begin(&core_->tasks);
-    coreBed = rz_cons_sleep_begin();
+    coreBed = coreSleepBegin(core_);
     CORE_LOCK();
 
     rz_event_hook(core_->analysis->ev, RZ_EVENT_ALL, cutterREventCallback, this);
@@ -226,17 +329,43 @@ void CutterCore::initialize(bool loadPlugins)
 
     // Initialize Async tasks manager
     asyncTaskManager = new AsyncTaskManager(this);
+
+    changeTracker = new ChangeTracker(this);
+    xrefIndex.reset(new XrefIndex(this));
+
+    connect(changeTracker, &ChangeTracker::changed, this, [this](ChangeTracker::Domains domains) {
+        if (domains & ChangeTracker::Memory) {
+            invalidateByteMap();
+        }
+    });
+    connect(this, &CutterCore::instructionChanged, this, &CutterCore::updateByteMap);
+    // Memory domain changes only cover the layout. Writes from commands and scripts end in
+    // refreshAll, they are only possible in write or cache mode. A debuggee may change its memory
+    // with every step. Rescanning all of it after each command or step would be too slow, so the
+    // previous map stays and is refreshed once they pause.
+    connect(this, &CutterCore::refreshAll, this, [this]() {
+        if (currentlyDebugging || isIOCacheEnabled() || isWriteModeEnabled()) {
+            markByteMapStale();
+        }
+    });
+    connect(this, &CutterCore::registersChanged, this, &CutterCore::markByteMapStale);
 }
 
 CutterCore::~CutterCore()
 {
+    // Tasks of this session, including ones which were superseded and are no longer referenced
+    // by their owners, use the core through Core() and must be done before it is freed
+    asyncTaskManager->interruptAndWait();
     delete bbHighlighter;
-    rz_cons_sleep_end(coreBed);
+    coreSleepEnd(coreBed);
     rz_core_task_sync_end(&core_->tasks);
     rz_core_free(this->core_);
+    // Balances rz_cons_new() in initialize(), the cons is freed with the last session
     rz_cons_free();
-    assert(uniqueInstance == this);
-    uniqueInstance = nullptr;
+    QMutexLocker locker(&sessionsMutex);
+    sessions.removeOne(this);
+    sessionCount.storeRelease(sessions.size());
+    activeSession.testAndSetOrdered(this, sessions.isEmpty() ? nullptr : sessions.first());
 }
 
 RzCoreLocked CutterCore::core()
@@ -359,7 +488,11 @@ QString CutterCore::cmd(const char *str)
     CORE_LOCK();
 
     RVA offset = core->offset;
-    char *res = rz_core_cmd_str(core, str);
+    char *res;
+    {
+        ConsLocker consLocker(this);
+        res = rz_core_cmd_str(core, str);
+    }
     QString o = fromOwnedCharPtr(res);
 
     if (offset != core->offset) {
@@ -375,6 +508,7 @@ QString CutterCore::getFunctionExecOut(const std::function<bool(RzCore *)> &fcn,
     RVA offset = core->offset;
     seekSilent(addr);
     QString o = {};
+    ConsLocker consLocker(this);
     rz_cons_push();
     bool is_pipe = core->is_pipe;
     core->is_pipe = true;
@@ -471,6 +605,7 @@ QString CutterCore::cmdRaw(const char *cmd)
 {
     QString res;
     CORE_LOCK();
+    ConsLocker consLocker(this);
     return rz_core_cmd_str(core, cmd);
 }
 
@@ -479,6 +614,7 @@ CutterJson CutterCore::cmdj(const char *str)
     char *res;
     {
         CORE_LOCK();
+        ConsLocker consLocker(this);
         res = rz_core_cmd_str(core, str);
     }
 
@@ -603,6 +739,12 @@ bool CutterCore::loadFile(QString path, ut64 baddr, ut64 mapaddr, int perms, int
     return true;
 }
 
+void CutterCore::performAutoAnalysis()
+{
+    CORE_LOCK();
+    rz_core_perform_auto_analysis(core, RZ_CORE_ANALYSIS_DEEP);
+}
+
 bool CutterCore::tryFile(QString path, bool rw)
 {
     if (path.isEmpty()) {
@@ -725,7 +867,8 @@ void CutterCore::editInstruction(RVA addr, const QString &inst, bool fillWithNop
     } else {
         rz_core_write_assembly(core, addr, inst.trimmed().toStdString().c_str());
     }
-    emit instructionChanged(addr);
+    // Several instructions separated by ; may overwrite more than the edited one
+    emit instructionChanged(addr, inst.contains(QLatin1Char(';')) ? UT64_MAX : 0);
 }
 
 void CutterCore::nopInstruction(RVA addr)
@@ -751,8 +894,8 @@ void CutterCore::jmpReverse(RVA addr)
 void CutterCore::editBytes(RVA addr, const QString &bytes)
 {
     CORE_LOCK();
-    rz_core_write_hexpair(core, addr, bytes.toUtf8().constData());
-    emit instructionChanged(addr);
+    int written = rz_core_write_hexpair(core, addr, bytes.toUtf8().constData());
+    emit instructionChanged(addr, written > 0 ? static_cast<ut64>(written) : UT64_MAX);
 }
 
 void CutterCore::editBytesEndian(RVA addr, const QString &bytes)
@@ -801,7 +944,8 @@ void CutterCore::setAsString(RVA addr, int size, StringTypeFormats type)
     CORE_LOCK();
     seekAndShow(addr);
     rz_core_meta_string_add(core, addr, size, encoding, nullptr);
-    emit instructionChanged(addr);
+    // A size of 0 lets rizin find the end of the string
+    emit instructionChanged(addr, size > 0 ? static_cast<ut64>(size) : UT64_MAX);
 }
 
 void CutterCore::removeString(RVA addr)
@@ -847,7 +991,7 @@ void CutterCore::setToData(RVA addr, int size, int repeat)
     for (int i = 0; i < repeat; ++i, address += size) {
         rz_meta_set(core->analysis, RZ_META_TYPE_DATA, address, size, nullptr);
     }
-    emit instructionChanged(addr);
+    emit instructionChanged(addr, static_cast<ut64>(size) * static_cast<ut64>(repeat));
 }
 
 int CutterCore::sizeofDataMeta(RVA addr)
@@ -1305,6 +1449,24 @@ QString CutterCore::flagAt(RVA addr)
     return core->flags->realnames && f->realname ? f->realname : f->name;
 }
 
+QHash<RVA, QString> CutterCore::flagsAt(const QVector<RVA> &addresses)
+{
+    CORE_LOCK();
+    QHash<RVA, QString> result;
+    QSet<RVA> resolved;
+    for (RVA addr : addresses) {
+        if (resolved.contains(addr)) {
+            continue;
+        }
+        resolved.insert(addr);
+        RzFlagItem *f = rz_flag_get_at(core->flags, addr, true);
+        if (f) {
+            result.insert(addr, core->flags->realnames && f->realname ? f->realname : f->name);
+        }
+    }
+    return result;
+}
+
 void CutterCore::createFunctionAt(RVA addr)
 {
     createFunctionAt(addr, "");
@@ -1351,6 +1513,7 @@ bool CutterCore::registerDecompiler(Decompiler *decompiler)
     }
     decompiler->setParent(this);
     decompilers.push_back(decompiler);
+    emit decompilersChanged();
     return true;
 }
 
@@ -3032,28 +3195,7 @@ QList<RzAsmPluginDescription> CutterCore::getRAsmPluginDescriptions()
 
 QList<FunctionDescription> CutterCore::getAllFunctions()
 {
-    CORE_LOCK();
-
-    QList<FunctionDescription> funcList;
-    funcList.reserve(rz_list_length(core->analysis->fcns));
-
-    RzListIter *iter;
-    RzAnalysisFunction *fcn;
-    CutterRzListForeach (core->analysis->fcns, iter, RzAnalysisFunction, fcn) {
-        FunctionDescription function;
-        function.offset = fcn->addr;
-        function.linearSize = rz_analysis_function_linear_size(fcn);
-        function.nargs = rz_analysis_arg_count(fcn);
-        function.nlocals = rz_analysis_var_local_count(fcn);
-        function.nbbs = rz_pvector_len(fcn->bbs);
-        function.calltype = fcn->cc ? QString::fromUtf8(fcn->cc) : QString();
-        function.name = fcn->name ? QString::fromUtf8(fcn->name) : QString();
-        function.edges = rz_analysis_function_count_edges(fcn, nullptr);
-        function.stackframe = fcn->maxstack;
-        funcList.append(function);
-    }
-
-    return funcList;
+    return FunctionQuery().run();
 }
 
 static inline uint64_t rva(RzBinObject *o, uint64_t paddr, uint64_t vaddr, int va)
@@ -3319,6 +3461,9 @@ QList<StringDescription> CutterCore::getAllStrings()
 
     QList<StringDescription> ret;
     for (const auto &str : CutterPVector<RzBinString>(strings)) {
+        if (AsyncTask::isCurrentTaskInterrupted()) {
+            return {};
+        }
         auto section = obj ? rz_bin_get_section_at(obj, str->paddr, 0) : NULL;
 
         StringDescription string;
@@ -3359,6 +3504,9 @@ QList<FlagDescription> CutterCore::getAllFlags(QString flagspace)
     rz_flag_foreach_space(
             core->flags, space,
             [](RzFlagItem *item, void *user) {
+                if (AsyncTask::isCurrentTaskInterrupted()) {
+                    return false;
+                }
                 FlagDescription flag;
                 flag.offset = item->offset;
                 flag.size = item->size;
@@ -3391,6 +3539,9 @@ QList<SectionDescription> CutterCore::getAllSections()
     }
     rz_list_push(hashnames, rz_str_dup("entropy"));
     for (const auto &sect : CutterPVector<RzBinSection>(sects)) {
+        if (AsyncTask::isCurrentTaskInterrupted()) {
+            break;
+        }
         if (RZ_STR_ISEMPTY(sect->name))
             continue;
 
@@ -3884,41 +4035,37 @@ bool CutterCore::isAddressMapped(RVA addr)
 
 QList<SearchDescription> CutterCore::getAllSearch(QString searchFor, QString space, QString in)
 {
+    static const QMap<QString, SearchQuery::Kind> kinds = {
+        { "/j", SearchQuery::Kind::String },
+        { "/ij", SearchQuery::Kind::CaseInsensitiveString },
+        { "/xj", SearchQuery::Kind::Hex },
+        { "/vj", SearchQuery::Kind::Value32 },
+        { "/acj", SearchQuery::Kind::Code },
+        { "/Rj", SearchQuery::Kind::RopGadgets },
+    };
+    auto kind = kinds.constFind(space);
+    if (kind != kinds.constEnd()) {
+        return SearchQuery(kind.value(), searchFor).within(in).run();
+    }
+
+    // Scripts and plugins may pass any search command, run those as before
     CORE_LOCK();
     QList<SearchDescription> searchRef;
-
     CutterJson searchArray;
     {
         TempConfig cfg;
         cfg.set("search.in", in);
         searchArray = cmdj(QString("%1 %2").arg(space, searchFor));
     }
+    for (CutterJson searchObject : searchArray) {
+        SearchDescription exp;
 
-    if (space == "/Rj") {
-        for (CutterJson searchObject : searchArray) {
-            SearchDescription exp;
+        exp.offset = searchObject[RJsonKey::offset].toRVA();
+        exp.size = searchObject[RJsonKey::len].toUt64();
+        exp.code = searchObject[RJsonKey::code].toString();
+        exp.data = searchObject[RJsonKey::data].toString();
 
-            exp.code.clear();
-            for (CutterJson gadget : searchObject[RJsonKey::opcodes]) {
-                exp.code += gadget[RJsonKey::opcode].toString() + ";  ";
-            }
-
-            exp.offset = searchObject[RJsonKey::opcodes].first()[RJsonKey::offset].toRVA();
-            exp.size = searchObject[RJsonKey::size].toUt64();
-
-            searchRef << exp;
-        }
-    } else {
-        for (CutterJson searchObject : searchArray) {
-            SearchDescription exp;
-
-            exp.offset = searchObject[RJsonKey::offset].toRVA();
-            exp.size = searchObject[RJsonKey::len].toUt64();
-            exp.code = searchObject[RJsonKey::code].toString();
-            exp.data = searchObject[RJsonKey::data].toString();
-
-            searchRef << exp;
-        }
+        searchRef << exp;
     }
     return searchRef;
 }
@@ -3989,11 +4136,20 @@ QList<XrefDescription> CutterCore::getXRefs(RVA addr, bool to, bool whole_functi
         }
 
         xd.from_str = RzAddressString(xd.from);
-        xd.to_str = Core()->flagAt(xd.to);
 
         xrefList << xd;
     }
     rz_list_free(xrefs);
+
+    QVector<RVA> targets;
+    targets.reserve(xrefList.size());
+    for (const XrefDescription &xd : xrefList) {
+        targets.append(xd.to);
+    }
+    QHash<RVA, QString> names = flagsAt(targets);
+    for (XrefDescription &xd : xrefList) {
+        xd.to_str = names.value(xd.to);
+    }
     return xrefList;
 }
 
@@ -4416,6 +4572,112 @@ BasicInstructionHighlighter *CutterCore::getBIHighlighter()
     return &biHighlighter;
 }
 
+std::shared_ptr<const Coverage> CutterCore::getCoverage() const
+{
+    return coverage;
+}
+
+void CutterCore::setCoverage(std::shared_ptr<const Coverage> coverage)
+{
+    this->coverage = std::move(coverage);
+    emit coverageChanged();
+}
+
+std::shared_ptr<const ByteMap> CutterCore::getByteMap()
+{
+    if (!byteMap && !byteMapTask) {
+        startByteMapTask();
+    }
+    return byteMap;
+}
+
+void CutterCore::startByteMapTask()
+{
+    byteMapStale = false;
+    byteMapTask = QSharedPointer<ByteMapTask>::create();
+    ByteMapTask *task = byteMapTask.data();
+    connect(
+            task, &AsyncTask::finished, this,
+            [this, task]() {
+                if (byteMapTask.data() != task) {
+                    return;
+                }
+                // An empty map instead of nullptr, so that failing isn't retried on every call
+                std::shared_ptr<ByteMap> result = task->getByteMap();
+                byteMap = result ? std::move(result) : std::make_shared<ByteMap>();
+                byteMapTask.clear();
+                emit byteMapChanged();
+            },
+            Qt::QueuedConnection);
+    asyncTaskManager->start(byteMapTask);
+}
+
+void CutterCore::invalidateByteMap()
+{
+    byteMapStale = false;
+    if (byteMapRefreshTimer) {
+        byteMapRefreshTimer->stop();
+    }
+    if (!byteMap && !byteMapTask) {
+        return;
+    }
+    if (byteMapTask) {
+        // Finishes in the background, its result is dropped
+        byteMapTask->interrupt();
+        byteMapTask.clear();
+    }
+    byteMap.reset();
+    emit byteMapChanged();
+}
+
+void CutterCore::updateByteMap(RVA offset, ut64 size)
+{
+    if (size == UT64_MAX || size > ByteMap::MaxRescanSize || !byteMap || byteMapTask) {
+        // A running scan may have read the memory before the edit
+        markByteMapStale();
+        return;
+    }
+    // Edits within an instruction don't say how many bytes changed, blocks are much larger anyway
+    constexpr ut64 MaxInstructionSize = 16;
+    ut64 length = size ? size : MaxInstructionSize;
+    RVA end = offset > UT64_MAX - length ? UT64_MAX : offset + length;
+    byteMap = byteMap->rescanned(this, offset, end);
+    emit byteMapChanged();
+}
+
+void CutterCore::markByteMapStale()
+{
+    if (!byteMap && !byteMapTask) {
+        return;
+    }
+    byteMapStale = true;
+    if (byteMap && byteMapTask) {
+        // A refresh started before this step, keep showing the previous map instead
+        byteMapTask->interrupt();
+        byteMapTask.clear();
+    }
+    if (!byteMapRefreshTimer) {
+        byteMapRefreshTimer = new QTimer(this);
+        byteMapRefreshTimer->setSingleShot(true);
+        byteMapRefreshTimer->setInterval(ByteMapRefreshDelay);
+        connect(byteMapRefreshTimer, &QTimer::timeout, this, &CutterCore::refreshStaleByteMap);
+    }
+    byteMapRefreshTimer->start();
+}
+
+void CutterCore::refreshStaleByteMap()
+{
+    if (!byteMapStale) {
+        return;
+    }
+    if (byteMapTask) {
+        // The first map is still being computed, refresh once it is there
+        byteMapRefreshTimer->start();
+        return;
+    }
+    startByteMapTask();
+}
+
 void CutterCore::setIOCache(bool enabled)
 {
     if (enabled) {
@@ -4642,6 +4904,43 @@ char *CutterCore::getTextualGraphAt(RzCoreGraphType type, RzCoreGraphFormat form
     return string;
 }
 
+QList<GraphNodeDescription> CutterCore::getGraphNodes(RzCoreGraphType type, RVA address)
+{
+    CORE_LOCK();
+    QList<GraphNodeDescription> result;
+    RzGraph *graph = rz_core_graph(core, type, address);
+    if (!graph) {
+        if (address == RVA_INVALID) {
+            qWarning() << tr("Cannot get global graph");
+        } else {
+            qWarning() << tr("Cannot get graph at ") << RzAddressString(address);
+        }
+        return result;
+    }
+
+    const RzList *nodes = rz_graph_get_nodes(graph);
+    result.reserve(rz_list_length(nodes));
+    for (const auto &node : CutterRzList<RzGraphNode>(nodes)) {
+        GraphNodeDescription description;
+        description.id = node->idx;
+        description.offset = RVA_INVALID;
+        auto info = static_cast<RzGraphNodeInfo *>(node->data);
+        if (info && info->type == RZ_GRAPH_NODE_TYPE_DEFAULT) {
+            description.offset = info->def.offset;
+            description.title = QString::fromUtf8(info->def.title);
+            description.body = QString::fromUtf8(info->def.body);
+        }
+        const RzList *neighbours = rz_graph_get_neighbours(graph, node);
+        description.edges.reserve(rz_list_length(neighbours));
+        for (const auto &target : CutterRzList<RzGraphNode>(neighbours)) {
+            description.edges.push_back(target->idx);
+        }
+        result.push_back(std::move(description));
+    }
+    rz_graph_free(graph);
+    return result;
+}
+
 void CutterCore::writeGraphvizGraphToFile(QString path, QString format, RzCoreGraphType type,
                                           RVA address)
 {
@@ -22,12 +22,18 @@
 
 class AsyncTaskManager;
 class BasicInstructionHighlighter;
+class ByteMap;
+class ByteMapTask;
+class ChangeTracker;
+class Coverage;
 class CutterCore;
 class Decompiler;
 class RizinTask;
 class RizinCmdTask;
 class RizinFunctionTask;
 class RizinTaskDialog;
+class XrefIndex;
+class QTimer;
 
 #include "common/BasicBlockHighlighter.h"
 #include "common/Helpers.h"
@@ -68,12 +74,28 @@ class CUTTER_EXPORT CutterCore : public QObject
 
     friend class RzCoreLocked;
     friend class RizinTask;
+    friend class ConsLocker;
     friend class Basefind;
 
 public:
     explicit CutterCore(QObject *parent = nullptr);
     ~CutterCore();
+
+    /**
+     * @brief The session Core() resolves to.
+     *
+     * Every CutterCore is a session owning its own RzCore, lock and task manager. On threads
+     * inside a SessionScope this is the scoped session, which is how AsyncTasks and events
+     * delivered to a window operate on the session they belong to. Otherwise it is the session
+     * of the most recently activated window.
+     */
     static CutterCore *instance();
+    static QList<CutterCore *> getSessions();
+    /**
+     * @brief Number of sessions, cheaper than getSessions() for code running on every event
+     */
+    static int getSessionCount();
+    static void setActiveSession(CutterCore *session);
 
     void initialize(bool loadPlugins = true);
     void loadCutterRC();
@@ -81,6 +103,8 @@ public:
     QDir getCutterRCDefaultDirectory() const;
 
     AsyncTaskManager *getAsyncTaskManager() { return asyncTaskManager; }
+    ChangeTracker *getChangeTracker() { return changeTracker; }
+    XrefIndex *getXrefIndex() { return xrefIndex.get(); }
 
     RVA getOffset() const { return core_->offset; }
 
@@ -219,6 +243,11 @@ public:
     RVA getFunctionEnd(RVA addr);
     RVA getLastFunctionInstruction(RVA addr);
     QString flagAt(RVA addr);
+    /**
+     * @brief Resolve the flag names of many addresses at once, like flagAt() for each of them.
+     * @return name for every address which has a flag
+     */
+    QHash<RVA, QString> flagsAt(const QVector<RVA> &addresses);
     void createFunctionAt(RVA addr);
     void createFunctionAt(RVA addr, QString name);
     QStringList getDisassemblyPreview(RVA address, int num_of_lines);
@@ -326,6 +355,13 @@ public:
     bool tryFile(QString path, bool rw);
     bool mapFile(QString path, RVA mapaddr);
     void loadScript(const QString &scriptname);
+    /**
+     * @brief Run the deep auto analysis of rizin, like aaa, without going through a command
+     *
+     * Only holds the lock of this session. The console shared by all sessions is left alone, so
+     * the analysis neither blocks the commands of other sessions nor can it be broken.
+     */
+    void performAutoAnalysis();
 
     /* Seek functions */
     void seek(QString thing);
@@ -698,6 +734,27 @@ public:
     BasicBlockHighlighter *getBBHighlighter();
     BasicInstructionHighlighter *getBIHighlighter();
 
+    /**
+     * @brief Coverage loaded for the opened file, shown as a heatmap by the code views
+     * @return nullptr if no coverage is loaded
+     */
+    std::shared_ptr<const Coverage> getCoverage() const;
+    /**
+     * @brief Replace the loaded coverage, nullptr clears it
+     */
+    void setCoverage(std::shared_ptr<const Coverage> coverage);
+
+    /**
+     * @brief Entropy and byte classes of the mapped memory
+     *
+     * The map is computed in the background on first use and again after the memory layout
+     * changed, byteMapChanged() is emitted once it is available. Small edits only rescan the
+     * blocks they touch. After larger writes and while debugging, the previous map stays
+     * available and is recomputed once commands or stepping pause.
+     * @return nullptr while it is being computed
+     */
+    std::shared_ptr<const ByteMap> getByteMap();
+
     /**
      * @brief Enable or dsiable Cache mode. Cache mode is used to imagine writing to the opened file
      * without committing the changes to the disk.
@@ -742,6 +799,14 @@ public:
      */
     char *getTextualGraphAt(RzCoreGraphType type, RzCoreGraphFormat format, RVA address);
 
+    /**
+     * @brief   Returns the nodes of a global or specific graph, read directly from the RzGraph.
+     * @param   type     Graph type, example RZ_CORE_GRAPH_TYPE_DATAREF or RZ_CORE_GRAPH_TYPE_IMPORT
+     * @param   address  The object address (if global set it to RVA_INVALID)
+     * @return  The nodes with their outgoing edges, empty if the graph could not be created.
+     */
+    QList<GraphNodeDescription> getGraphNodes(RzCoreGraphType type, RVA address);
+
     /**
      * @brief   Writes a graphviz graph to a file.
      * @param   path     The file output path
@@ -762,7 +827,12 @@ signals:
     void flagsChanged();
     void commentsChanged(RVA addr);
     void registersChanged();
-    void instructionChanged(RVA offset);
+    /**
+     * @brief emitted when code or data at offset was edited
+     * @param size number of bytes affected, 0 if the edit stays within the instruction at offset
+     * and UT64_MAX if it is unknown
+     */
+    void instructionChanged(RVA offset, ut64 size = 0);
     void breakpointsChanged(RVA offset);
     void refreshCodeViews();
     void stackChanged();
@@ -805,6 +875,21 @@ signals:
      */
     void graphOptionsChanged();
 
+    /**
+     * emitted when a decompiler was registered, plugins may do that after the widgets exist
+     */
+    void decompilersChanged();
+
+    /**
+     * emitted when coverage was loaded or cleared
+     */
+    void coverageChanged();
+
+    /**
+     * emitted when the byte map was computed or became outdated
+     */
+    void byteMapChanged();
+
     /**
      * @brief seekChanged is emitted each time Rizin's seek value is modified
      * @param offset
@@ -833,7 +918,17 @@ private:
     int coreLockDepth = 0;
     void *coreBed = nullptr;
 
+    /**
+     * @brief Wait until no other session uses the cons of rizin and take it for this one
+     *
+     * Recursive and not tied to a thread, a rizin task of the session holds it until it finished.
+     */
+    void lockCons();
+    void unlockCons();
+
     AsyncTaskManager *asyncTaskManager;
+    ChangeTracker *changeTracker;
+    std::unique_ptr<XrefIndex> xrefIndex;
     RVA offsetPriorDebugging = RVA_INVALID;
     QErrorMessage msgBox;
 
@@ -843,14 +938,42 @@ private:
     BasicBlockHighlighter *bbHighlighter;
     bool iocache = false;
     BasicInstructionHighlighter biHighlighter;
+    std::shared_ptr<const Coverage> coverage;
+    std::shared_ptr<const ByteMap> byteMap;
+    QSharedPointer<ByteMapTask> byteMapTask;
+    /**
+     * Time without debugger steps after which a stale byte map is recomputed
+     */
+    static constexpr int ByteMapRefreshDelay = 2000;
+    QTimer *byteMapRefreshTimer = nullptr;
+    bool byteMapStale = false;
 
     QSharedPointer<RizinTask> debugTask;
     RizinTaskDialog *debugTaskDialog;
 
+    void startByteMapTask();
+    void invalidateByteMap();
+    void updateByteMap(RVA offset, ut64 size);
+    void markByteMapStale();
+    void refreshStaleByteMap();
     QVector<QString> getCutterRCFilePaths() const;
     QList<TypeDescription> getBaseType(RzBaseTypeKind kind, const char *category);
 };
 
+/**
+ * @brief Makes Core() resolve to the given session on the current thread while the object lives
+ */
+class CUTTER_EXPORT SessionScope
+{
+    CutterCore *const previous;
+
+public:
+    explicit SessionScope(CutterCore *session);
+    SessionScope(const SessionScope &) = delete;
+    SessionScope &operator=(const SessionScope &) = delete;
+    ~SessionScope();
+};
+
 class CUTTER_EXPORT RzCoreLocked
 {
     CutterCore *const core;
@@ -7,6 +7,7 @@
 
 #include <QString>
 #include <QList>
+#include <QVector>
 #include <QStringList>
 #include <QMetaType>
 #include <QColor>
@@ -295,6 +296,15 @@ struct BlockDescription
     ut8 rwx;
 };
 
+struct BasicBlockDescription
+{
+    RVA addr;
+    RVA size;
+    RVA jump;
+    RVA fail;
+    int ninstr;
+};
+
 struct BlockStatistics
 {
     RVA from;
@@ -405,6 +415,15 @@ struct BasefindResultDescription
     ut32 score;
 };
 
+struct GraphNodeDescription
+{
+    ut64 id;
+    RVA offset;
+    QString title;
+    QString body;
+    QVector<ut64> edges;
+};
+
 Q_DECLARE_METATYPE(FunctionDescription)
 Q_DECLARE_METATYPE(ImportDescription)
 Q_DECLARE_METATYPE(ExportDescription)
@@ -436,6 +455,7 @@ Q_DECLARE_METATYPE(TypeDescription)
 Q_DECLARE_METATYPE(HeaderDescription)
 Q_DECLARE_METATYPE(FlirtDescription)
 Q_DECLARE_METATYPE(SearchDescription)
+Q_DECLARE_METATYPE(BasicBlockDescription)
 Q_DECLARE_METATYPE(SectionDescription)
 Q_DECLARE_METATYPE(SegmentDescription)
 Q_DECLARE_METATYPE(MemoryMapDescription)
@@ -446,5 +466,6 @@ Q_DECLARE_METATYPE(RefDescription)
 Q_DECLARE_METATYPE(VariableDescription)
 Q_DECLARE_METATYPE(BasefindCoreStatusDescription)
 Q_DECLARE_METATYPE(BasefindResultDescription)
+Q_DECLARE_METATYPE(GraphNodeDescription)
 
 #endif // DESCRIPTIONS_H
@@ -0,0 +1,393 @@
+#include "CutterQuery.h"
+
+#include "core/Cutter.h"
+#include "common/AsyncTask.h"
+#include "common/TempConfig.h"
+
+#include <QRegularExpression>
+
+#include <vector>
+
+FunctionQuery &FunctionQuery::inRange(RVA from, RVA to)
+{
+    this->from = from;
+    this->to = to;
+    return *this;
+}
+
+FunctionQuery &FunctionQuery::containing(RVA addr)
+{
+    address = addr;
+    return *this;
+}
+
+FunctionQuery &FunctionQuery::nameContains(const QString &text)
+{
+    name = text;
+    return *this;
+}
+
+QList<FunctionDescription> FunctionQuery::run() const
+{
+    RzCoreLocked core(Core());
+
+    QList<FunctionDescription> funcList;
+    funcList.reserve(rz_list_length(core->analysis->fcns));
+
+    RzListIter *iter;
+    RzAnalysisFunction *fcn;
+    CutterRzListForeach (core->analysis->fcns, iter, RzAnalysisFunction, fcn) {
+        if (AsyncTask::isCurrentTaskInterrupted()) {
+            return {};
+        }
+        if (fcn->addr < from || fcn->addr > to) {
+            continue;
+        }
+        if (address != RVA_INVALID && !rz_analysis_function_contains(fcn, address)) {
+            continue;
+        }
+        QString fcnName = fcn->name ? QString::fromUtf8(fcn->name) : QString();
+        if (!name.isEmpty() && !fcnName.contains(name, Qt::CaseInsensitive)) {
+            continue;
+        }
+        FunctionDescription function;
+        function.offset = fcn->addr;
+        function.linearSize = rz_analysis_function_linear_size(fcn);
+        function.nargs = rz_analysis_arg_count(fcn);
+        function.nlocals = rz_analysis_var_local_count(fcn);
+        function.nbbs = rz_pvector_len(fcn->bbs);
+        function.calltype = fcn->cc ? QString::fromUtf8(fcn->cc) : QString();
+        function.name = fcnName;
+        function.edges = rz_analysis_function_count_edges(fcn, nullptr);
+        function.stackframe = fcn->maxstack;
+        funcList.append(function);
+    }
+
+    return funcList;
+}
+
+QList<BasicBlockDescription> BasicBlockQuery::run() const
+{
+    RzCoreLocked core(Core());
+    RzAnalysisFunction *fcn = rz_analysis_get_function_at(core->analysis, function);
+    if (!fcn) {
+        return {};
+    }
+    QList<BasicBlockDescription> blocks;
+    blocks.reserve(static_cast<int>(rz_pvector_len(fcn->bbs)));
+    for (const auto &bb : CutterPVector<RzAnalysisBlock>(fcn->bbs)) {
+        blocks.append({ bb->addr, bb->size, bb->jump, bb->fail, bb->ninstr });
+    }
+    return blocks;
+}
+
+QList<DisassemblyLine> InstructionQuery::run() const
+{
+    return Core()->disassembleLines(offset, count);
+}
+
+XrefQuery &XrefQuery::incoming()
+{
+    to = true;
+    return *this;
+}
+
+XrefQuery &XrefQuery::outgoing()
+{
+    to = false;
+    return *this;
+}
+
+XrefQuery &XrefQuery::ofType(const QString &type)
+{
+    this->type = type;
+    return *this;
+}
+
+QList<XrefDescription> XrefQuery::run() const
+{
+    return Core()->getXRefs(addr, to, false, type);
+}
+
+SearchQuery &SearchQuery::within(const QString &boundaries)
+{
+    this->boundaries = boundaries;
+    return *this;
+}
+
+QList<SearchDescription> SearchQuery::run() const
+{
+    if (needsCommand()) {
+        return searchCommand();
+    }
+    return searchBytes();
+}
+
+bool SearchQuery::needsCommand() const
+{
+    if (kind == Kind::Code || kind == Kind::RopGadgets) {
+        return true;
+    }
+    {
+        RzCoreLocked core(Core());
+        if (rz_config_get_i(core->config, "search.align") > 1
+            || rz_config_get_i(core->config, "search.distance") != 0) {
+            return true;
+        }
+    }
+    if (kind == Kind::Hex) {
+        // Wildcards (..) and masks (:ff00) are only understood by /x
+        QString hex = pattern;
+        hex.remove(QRegularExpression(QStringLiteral("\\s")));
+        static const QRegularExpression plainHex(QStringLiteral("^([0-9a-fA-F]{2})+$"));
+        return !plainHex.match(hex).hasMatch();
+    }
+    return false;
+}
+
+/**
+ * @brief Printable characters of data, the search command leaves out all others in its output
+ */
+static QString printableString(const ut8 *data, size_t size)
+{
+    QString result;
+    for (size_t i = 0; i < size; i++) {
+        if (IS_PRINTABLE(data[i])) {
+            result.append(QLatin1Char(static_cast<char>(data[i])));
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Data column of a hit as the search command shows it: for strings the matched text with
+ * up to 16 printable bytes of context on each side, otherwise up to 40 bytes in hex.
+ */
+static QString searchHitData(RzCore *core, RVA addr, const ut8 *hit, ut64 size, bool isString)
+{
+    if (!isString) {
+        const ut64 shown = qMin<ut64>(size, 40);
+        QString data = QString::fromLatin1(
+                QByteArray(reinterpret_cast<const char *>(hit), static_cast<int>(shown)).toHex());
+        if (shown != size) {
+            data += QStringLiteral("...");
+        }
+        return data;
+    }
+    const ut64 context = 16;
+    const ut64 before = qMin(addr, context);
+    std::vector<ut8> buf(before + size + context);
+    rz_io_read_at(core->io, addr - before, buf.data(), static_cast<int>(buf.size()));
+    return printableString(buf.data(), before) + printableString(hit, size)
+            + printableString(buf.data() + before + size, context);
+}
+
+QList<SearchDescription> SearchQuery::searchBytes() const
+{
+    QByteArray needle;
+    bool foldCase = false;
+    const bool isString = kind == Kind::String || kind == Kind::CaseInsensitiveString;
+    switch (kind) {
+    case Kind::String:
+        needle = pattern.toUtf8();
+        break;
+    case Kind::CaseInsensitiveString:
+        needle = pattern.toUtf8().toLower();
+        foldCase = true;
+        break;
+    case Kind::Hex:
+        needle = QByteArray::fromHex(pattern.toLatin1());
+        break;
+    case Kind::Value32: {
+        ut32 value = static_cast<ut32>(Core()->math(pattern));
+        needle.resize(sizeof(value));
+        rz_write_ble32(needle.data(), value, Core()->getConfigb("cfg.bigendian"));
+        break;
+    }
+    default:
+        break;
+    }
+    if (needle.isEmpty()) {
+        return {};
+    }
+    const ut64 needleSize = static_cast<ut64>(needle.size());
+    const ut64 chunkSize = 1024 * 1024;
+
+    // Hits are flagged like the search command does, as prefix<index>_<count> in the search
+    // flagspace with a new index for every search
+    std::vector<std::pair<RVA, RVA>> ranges;
+    ut64 maxHits;
+    bool createFlags;
+    QByteArray flagPrefix;
+    ut64 keywordIndex;
+    {
+        RzCoreLocked core(Core());
+        TempConfig cfg;
+        cfg.set("search.in", boundaries);
+        maxHits = rz_config_get_i(core->config, "search.maxhits");
+        createFlags = rz_config_get_b(core->config, "search.flags");
+        flagPrefix = QByteArray(rz_config_get(core->config, "search.prefix"));
+        keywordIndex = rz_config_get_i(core->config, "search.kwidx");
+        auto maps = fromOwned(
+                rz_core_get_boundaries_select(core, "search.from", "search.to", "search.in"));
+        for (const auto &map : CutterRzList<RzIOMap>(maps.get())) {
+            ranges.push_back({ map->itv.addr, map->itv.addr + map->itv.size });
+        }
+        if (createFlags) {
+            rz_config_set_i(core->config, "search.kwidx", keywordIndex + 1);
+        }
+    }
+
+    QList<SearchDescription> hits;
+    auto full = [&hits, maxHits]() {
+        return maxHits && static_cast<ut64>(hits.size()) >= maxHits;
+    };
+    bool interrupted = false;
+    std::vector<ut8> buf;
+    std::vector<int> positions;
+    QByteArray folded;
+    // The core lock is only held while reading a chunk and while describing its hits, so other
+    // users of the core aren't blocked for the whole scan
+    for (size_t r = 0; r < ranges.size() && !interrupted && !full(); r++) {
+        const ut64 end = ranges[r].second;
+        // Consecutive chunks overlap by needleSize - 1 bytes, every start position is checked
+        // exactly once.
+        for (ut64 addr = ranges[r].first; addr < end && end - addr >= needleSize && !full();) {
+            if (AsyncTask::isCurrentTaskInterrupted()) {
+                interrupted = true;
+                break;
+            }
+            ut64 len = qMin(chunkSize + needleSize - 1, end - addr);
+            buf.resize(len);
+            {
+                RzCoreLocked core(Core());
+                rz_io_read_at(core->io, addr, buf.data(), len);
+            }
+
+            QByteArray haystack =
+                    QByteArray::fromRawData(reinterpret_cast<const char *>(buf.data()), len);
+            if (foldCase) {
+                folded = haystack.toLower();
+                haystack = folded;
+            }
+            positions.clear();
+            for (int pos = haystack.indexOf(needle); pos >= 0;
+                 pos = haystack.indexOf(needle, pos + 1)) {
+                positions.push_back(pos);
+                if (maxHits && static_cast<ut64>(hits.size()) + positions.size() >= maxHits) {
+                    break;
+                }
+            }
+            if (!positions.empty()) {
+                RzCoreLocked core(Core());
+                if (createFlags) {
+                    rz_flag_space_push(core->flags, RZ_FLAGS_FS_SEARCH);
+                }
+                for (int pos : positions) {
+                    SearchDescription exp;
+                    exp.offset = addr + pos;
+                    exp.size = static_cast<int>(needleSize);
+                    exp.data = searchHitData(core, exp.offset, buf.data() + pos, needleSize,
+                                             isString);
+                    if (createFlags) {
+                        QByteArray name = flagPrefix + QByteArray::number(keywordIndex) + '_'
+                                + QByteArray::number(hits.size());
+                        rz_flag_set(core->flags, name.constData(), exp.offset, needleSize);
+                    }
+                    hits << exp;
+                }
+                if (createFlags) {
+                    rz_flag_space_pop(core->flags);
+                }
+            }
+            addr += len - needleSize + 1;
+        }
+    }
+    if (createFlags && !hits.isEmpty()) {
+        Core()->triggerFlagsChanged();
+    }
+    return hits;
+}
+
+QList<SearchDescription> SearchQuery::searchCommand() const
+{
+    // Assembly and gadget searches have no C API in rizin, they still go through the JSON output
+    // of the search commands. So do byte searches which need features of the commands, see
+    // needsCommand().
+    QList<SearchDescription> searchRef;
+
+    CutterJson searchArray;
+    {
+        TempConfig cfg;
+        cfg.set("search.in", boundaries);
+        const char *command;
+        switch (kind) {
+        case Kind::String:
+            command = "/j";
+            break;
+        case Kind::CaseInsensitiveString:
+            command = "/ij";
+            break;
+        case Kind::Hex:
+            command = "/xj";
+            break;
+        case Kind::Value32:
+            command = "/vj";
+            break;
+        case Kind::RopGadgets:
+            command = "/Rj";
+            break;
+        case Kind::Code:
+        default:
+            command = "/acj";
+            break;
+        }
+        searchArray = Core()->cmdj(QString("%1 %2").arg(command, pattern));
+    }
+
+    if (kind == Kind::RopGadgets) {
+        for (CutterJson searchObject : searchArray) {
+            SearchDescription exp;
+
+            exp.code.clear();
+            for (CutterJson gadget : searchObject[RJsonKey::opcodes]) {
+                exp.code += gadget[RJsonKey::opcode].toString() + ";  ";
+            }
+
+            exp.offset = searchObject[RJsonKey::opcodes].first()[RJsonKey::offset].toRVA();
+            exp.size = searchObject[RJsonKey::size].toUt64();
+
+            searchRef << exp;
+        }
+    } else {
+        for (CutterJson searchObject : searchArray) {
+            SearchDescription exp;
+
+            exp.offset = searchObject[RJsonKey::offset].toRVA();
+            exp.size = searchObject[RJsonKey::len].toUt64();
+            exp.code = searchObject[RJsonKey::code].toString();
+            exp.data = searchObject[RJsonKey::data].toString();
+
+            searchRef << exp;
+        }
+    }
+    return searchRef;
+}
+
+QList<TypeDescription> TypeQuery::run() const
+{
+    switch (category) {
+    case Category::Primitive:
+        return Core()->getAllPrimitiveTypes();
+    case Category::Struct:
+        return Core()->getAllStructs();
+    case Category::Union:
+        return Core()->getAllUnions();
+    case Category::Enum:
+        return Core()->getAllEnums();
+    case Category::Typedef:
+        return Core()->getAllTypedefs();
+    default:
+        return Core()->getAllTypes();
+    }
+}
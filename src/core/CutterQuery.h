@@ -0,0 +1,127 @@
+#ifndef CUTTERQUERY_H
+#define CUTTERQUERY_H
+
+#include "core/CutterCommon.h"
+#include "core/CutterDescriptions.h"
+
+#include <QList>
+#include <QString>
+
+/**
+ * @file CutterQuery.h
+ * @brief Typed queries for C++ and Python plugins
+ *
+ * Each query is configured with chainable setters and returns the description structs used
+ * throughout Cutter. They are filled directly from rizin structures, so plugins don't need to go
+ * through cmdj() and the JSON serialization and parsing it implies.
+ *
+ * \code
+ * auto functions = FunctionQuery().inRange(0x1000, 0x2000).nameContains("main").run();
+ * auto hits = SearchQuery(SearchQuery::Kind::String, "password").within("io.maps").run();
+ * \endcode
+ */
+
+class CUTTER_EXPORT FunctionQuery
+{
+public:
+    FunctionQuery &inRange(RVA from, RVA to);
+    FunctionQuery &containing(RVA addr);
+    FunctionQuery &nameContains(const QString &text);
+
+    QList<FunctionDescription> run() const;
+
+private:
+    RVA from = 0;
+    RVA to = RVA_MAX;
+    RVA address = RVA_INVALID;
+    QString name;
+};
+
+class CUTTER_EXPORT BasicBlockQuery
+{
+public:
+    explicit BasicBlockQuery(RVA function) : function(function) {}
+
+    QList<BasicBlockDescription> run() const;
+
+private:
+    RVA function;
+};
+
+class CUTTER_EXPORT InstructionQuery
+{
+public:
+    InstructionQuery(RVA offset, int count) : offset(offset), count(count) {}
+
+    QList<DisassemblyLine> run() const;
+
+private:
+    RVA offset;
+    int count;
+};
+
+class CUTTER_EXPORT XrefQuery
+{
+public:
+    explicit XrefQuery(RVA addr) : addr(addr) {}
+
+    /**
+     * @brief Query xrefs pointing to the address, this is the default.
+     */
+    XrefQuery &incoming();
+    /**
+     * @brief Query xrefs originating at the address.
+     */
+    XrefQuery &outgoing();
+    XrefQuery &ofType(const QString &type);
+
+    QList<XrefDescription> run() const;
+
+private:
+    RVA addr;
+    bool to = true;
+    QString type;
+};
+
+class CUTTER_EXPORT SearchQuery
+{
+public:
+    enum class Kind { String, CaseInsensitiveString, Hex, Value32, Code, RopGadgets };
+
+    SearchQuery(Kind kind, const QString &pattern) : kind(kind), pattern(pattern) {}
+
+    /**
+     * @brief Restrict the search to the boundaries given as a value of the search.in variable.
+     */
+    SearchQuery &within(const QString &boundaries);
+
+    QList<SearchDescription> run() const;
+
+private:
+    Kind kind;
+    QString pattern;
+    QString boundaries = QStringLiteral("io.maps");
+
+    /**
+     * @return true if the native scan can't reproduce the search command, because of wildcards
+     * or masks in a hex pattern or search options it doesn't implement
+     */
+    bool needsCommand() const;
+    QList<SearchDescription> searchBytes() const;
+    QList<SearchDescription> searchCommand() const;
+};
+
+class CUTTER_EXPORT TypeQuery
+{
+public:
+    enum class Category { All, Primitive, Struct, Union, Enum, Typedef };
+
+    explicit TypeQuery(Category category = Category::All) : category(category) {}
+
+    QList<TypeDescription> run() const;
+
+private:
+    Category category;
+};
+
+#endif // CUTTERQUERY_H
@@ -4,6 +4,7 @@
 // Common Headers
 #include "common/AnalysisTask.h"
 #include "common/BugReporting.h"
+#include "common/Coverage.h"
 #include "common/Highlighter.h"
 #include "common/Helpers.h"
 #include "common/SvgIconEngine.h"
@@ -56,6 +57,7 @@
 #include "widgets/ResourcesWidget.h"
 #include "widgets/VTablesWidget.h"
 #include "widgets/HeadersWidget.h"
+#include "widgets/BinaryDiffWidget.h"
 #include "widgets/FlirtWidget.h"
 #include "widgets/DebugActions.h"
 #include "widgets/MemoryMapWidget.h"
@@ -243,23 +245,11 @@ void MainWindow::initUI()
     connect(ui->actionManageLayouts, &QAction::triggered, this, &MainWindow::manageLayouts);
     connect(ui->actionDocumentation, &QAction::triggered, this, &MainWindow::documentationClicked);
 
-    /* Setup plugins interfaces */
-    const auto &plugins = Plugins()->getPlugins();
-    for (auto &plugin : plugins) {
-        plugin->setupInterface(this);
-    }
-
-    // Check if plugins are loaded and display tooltips accordingly
     ui->menuWindows->setToolTipsVisible(true);
-    if (plugins.empty()) {
-        ui->menuPlugins->menuAction()->setToolTip(
-                tr("No plugins are installed. Check the plugins section on Cutter documentation to "
-                   "learn more."));
-        ui->menuPlugins->setEnabled(false);
-    } else if (ui->menuPlugins->isEmpty()) {
-        ui->menuPlugins->menuAction()->setToolTip(
-                tr("The installed plugins didn't add entries to this menu."));
-        ui->menuPlugins->setEnabled(false);
+    // On startup the plugins are only loaded after the first window got painted, the application
+    // sets up their interfaces then
+    if (Plugins()->isLoaded()) {
+        setupPluginInterfaces();
     }
 
     connect(ui->actionUnlock, &QAction::toggled, this, [this](bool unlock) { lockDocks(!unlock); });
@@ -355,7 +345,7 @@ void MainWindow::initToolBar()
     addToolBarBreak(Qt::TopToolBarArea);
     addToolBar(visualNavbar);
     QObject::connect(configuration, &Configuration::colorsUpdated, this,
-                     [this]() { this->visualNavbar->updateGraphicsScene(); });
+                     [this]() { this->visualNavbar->updateImage(); });
     QObject::connect(configuration, &Configuration::interfaceThemeChanged, this,
                      &MainWindow::chooseThemeIcons);
 }
@@ -380,35 +370,70 @@ void MainWindow::initDocks()
     commentsDock = new CommentsWidget(this);
     stringsDock = new StringsWidget(this);
 
-    QList<CutterDockWidget *> debugDocks = { stackDock = new StackWidget(this),
-                                             threadsDock = new ThreadsWidget(this),
-                                             processesDock = new ProcessesWidget(this),
-                                             backtraceDock = new BacktraceWidget(this),
-                                             registersDock = new RegistersWidget(this),
-                                             memoryMapDock = new MemoryMapWidget(this),
-                                             breakpointDock = new BreakpointWidget(this),
-                                             registerRefsDock = new RegisterRefsWidget(this),
-                                             heapDock = new HeapDockWidget(this) };
+    // Debug and info docks are only constructed once they are shown, most sessions never open
+    // most of them
+    QList<CutterDockWidget *> debugDocks = {
+        addLazyDock(stackDock, "StackWidget", StackWidget::getDockTitle(),
+                    [this]() { return new StackWidget(this); }),
+        addLazyDock(threadsDock, "ThreadsWidget", ThreadsWidget::getDockTitle(),
+                    [this]() { return new ThreadsWidget(this); }),
+        addLazyDock(processesDock, "ProcessesWidget", ProcessesWidget::getDockTitle(),
+                    [this]() { return new ProcessesWidget(this); }),
+        addLazyDock(backtraceDock, "BacktraceWidget", BacktraceWidget::getDockTitle(),
+                    [this]() { return new BacktraceWidget(this); }),
+        addLazyDock(registersDock, "RegistersWidget", RegistersWidget::getDockTitle(),
+                    [this]() { return new RegistersWidget(this); }),
+        addLazyDock(memoryMapDock, "MemoryMapWidget", MemoryMapWidget::getDockTitle(),
+                    [this]() { return new MemoryMapWidget(this); }),
+        addLazyDock(breakpointDock, "BreakpointWidget", BreakpointWidget::getDockTitle(),
+                    [this]() { return new BreakpointWidget(this); }),
+        addLazyDock(registerRefsDock, "RegisterRefsWidget", RegisterRefsWidget::getDockTitle(),
+                    [this]() { return new RegisterRefsWidget(this); }),
+        addLazyDock(heapDock, "HeapDockWidget", HeapDockWidget::getDockTitle(),
+                    [this]() { return new HeapDockWidget(this); }),
+    };
 
     QList<CutterDockWidget *> infoDocks = {
-        classesDock = new ClassesWidget(this),
-        entrypointDock = new EntrypointWidget(this),
-        exportsDock = new ExportsWidget(this),
-        flagsDock = new FlagsWidget(this),
-        headersDock = new HeadersWidget(this),
-        importsDock = new ImportsWidget(this),
-        relocsDock = new RelocsWidget(this),
-        resourcesDock = new ResourcesWidget(this),
-        sdbDock = new SdbWidget(this),
-        sectionsDock = new SectionsWidget(this),
-        segmentsDock = new SegmentsWidget(this),
-        symbolsDock = new SymbolsWidget(this),
-        globalsDock = new GlobalsWidget(this),
-        vTablesDock = new VTablesWidget(this),
-        flirtDock = new FlirtWidget(this),
-        rzGraphDock = new RizinGraphWidget(this),
-        callGraphDock = new CallGraphWidget(this, false),
-        globalCallGraphDock = new CallGraphWidget(this, true),
+        addLazyDock(classesDock, "ClassesWidget", ClassesWidget::getDockTitle(),
+                    [this]() { return new ClassesWidget(this); }),
+        addLazyDock(entrypointDock, "EntrypointWidget", EntrypointWidget::getDockTitle(),
+                    [this]() { return new EntrypointWidget(this); }),
+        addLazyDock(exportsDock, "ExportsWidget", ExportsWidget::getDockTitle(),
+                    [this]() { return new ExportsWidget(this); }),
+        addLazyDock(flagsDock, "FlagsWidget", FlagsWidget::getDockTitle(),
+                    [this]() { return new FlagsWidget(this); }),
+        addLazyDock(headersDock, "HeadersWidget", HeadersWidget::getDockTitle(),
+                    [this]() { return new HeadersWidget(this); }),
+        addLazyDock(importsDock, "ImportsWidget", ImportsWidget::getDockTitle(),
+                    [this]() { return new ImportsWidget(this); }),
+        addLazyDock(relocsDock, "RelocsWidget", RelocsWidget::getDockTitle(),
+                    [this]() { return new RelocsWidget(this); }),
+        addLazyDock(resourcesDock, "ResourcesWidget", ResourcesWidget::getDockTitle(),
+                    [this]() { return new ResourcesWidget(this); }),
+        addLazyDock(sdbDock, "SdbWidget", SdbWidget::getDockTitle(),
+                    [this]() { return new SdbWidget(this); }),
+        addLazyDock(sectionsDock, "SectionsWidget", SectionsWidget::getDockTitle(),
+                    [this]() { return new SectionsWidget(this); }),
+        addLazyDock(segmentsDock, "SegmentsWidget", SegmentsWidget::getDockTitle(),
+                    [this]() { return new SegmentsWidget(this); }),
+        addLazyDock(symbolsDock, "SymbolsWidget", SymbolsWidget::getDockTitle(),
+                    [this]() { return new SymbolsWidget(this); }),
+        addLazyDock(globalsDock, "GlobalsWidget", GlobalsWidget::getDockTitle(),
+                    [this]() { return new GlobalsWidget(this); }),
+        addLazyDock(vTablesDock, "VTablesWidget", VTablesWidget::getDockTitle(),
+                    [this]() { return new VTablesWidget(this); }),
+        addLazyDock(flirtDock, "FlirtWidget", FlirtWidget::getDockTitle(),
+                    [this]() { return new FlirtWidget(this); }),
+        addLazyDock(rzGraphDock, "RizinGraphWidget", RizinGraphWidget::getDockTitle(),
+                    [this]() { return new RizinGraphWidget(this); }),
+        addLazyDock(callGraphDock, CallGraphWidget::getWidgetType(false),
+                    CallGraphWidget::getDockTitle(false),
+                    [this]() { return new CallGraphWidget(this, false); }),
+        addLazyDock(globalCallGraphDock, CallGraphWidget::getWidgetType(true),
+                    CallGraphWidget::getDockTitle(true),
+                    [this]() { return new CallGraphWidget(this, true); }),
+        addLazyDock(binaryDiffDock, "BinaryDiffWidget", BinaryDiffWidget::getDockTitle(),
+                    [this]() { return new BinaryDiffWidget(this); }),
     };
 
     auto makeActionList = [this](QList<CutterDockWidget *> docks) {
@@ -447,6 +472,76 @@ void MainWindow::initDocks()
     }
 }
 
+CutterDockWidget *MainWindow::addLazyDock(CutterDockWidget *&slot, const QString &name,
+                                          const QString &title, LazyDockWidget::Factory factory)
+{
+    CutterDockWidget **slotPtr = &slot;
+    auto placeholder = new LazyDockWidget(this, name, title, [slotPtr, factory]() {
+        *slotPtr = factory();
+        return *slotPtr;
+    });
+    connect(placeholder, &LazyDockWidget::materializeRequested, this,
+            [this, placeholder]() { materializeDock(placeholder); });
+    slot = placeholder;
+    return placeholder;
+}
+
+void MainWindow::materializeDock(LazyDockWidget *placeholder)
+{
+    CutterDockWidget *dock = placeholder->create();
+    dock->setObjectName(placeholder->objectName());
+    dock->deserializeViewProperties(placeholder->serializeViewProprties());
+
+    // Take over the place of the placeholder in the layout and the menus
+    if (placeholder->isFloating()) {
+        addDockWidget(dockWidgetArea(placeholder), dock);
+        dock->setFloating(true);
+        dock->setGeometry(placeholder->geometry());
+    } else {
+        tabifyDockWidget(placeholder, dock);
+    }
+    QAction *placeholderAction = placeholder->toggleViewAction();
+    for (QMenu *menu : { ui->menuWindows, ui->menuAddInfoWidgets, ui->menuAddDebugWidgets }) {
+        if (menu->actions().contains(placeholderAction)) {
+            menu->insertAction(placeholderAction, dock->toggleViewAction());
+            menu->removeAction(placeholderAction);
+        }
+    }
+    dock->toggleViewAction()->setEnabled(placeholderAction->isEnabled());
+    int index = dockWidgets.indexOf(placeholder);
+    if (index >= 0) {
+        dockWidgets[index] = dock;
+    }
+
+    removeDockWidget(placeholder);
+    placeholder->deleteLater();
+    dock->show();
+    dock->raise();
+}
+
+void MainWindow::setupPluginInterfaces()
+{
+    const auto &plugins = Plugins()->getPlugins();
+    for (auto &plugin : plugins) {
+        plugin->setupInterface(this);
+    }
+
+    // Check if plugins are loaded and display tooltips accordingly
+    if (plugins.empty()) {
+        ui->menuPlugins->menuAction()->setToolTip(
+                tr("No plugins are installed. Check the plugins section on Cutter documentation to "
+                   "learn more."));
+        ui->menuPlugins->setEnabled(false);
+    } else if (ui->menuPlugins->isEmpty()) {
+        ui->menuPlugins->menuAction()->setToolTip(
+                tr("The installed plugins didn't add entries to this menu."));
+        ui->menuPlugins->setEnabled(false);
+    } else {
+        ui->menuPlugins->menuAction()->setToolTip(QString());
+        ui->menuPlugins->setEnabled(true);
+    }
+}
+
 void MainWindow::toggleOverview(bool visibility, GraphWidget *targetGraph)
 {
     if (!overviewDock) {
@@ -522,7 +617,18 @@ void MainWindow::addPluginDockWidget(CutterDockWidget *dockWidget)
 {
     addWidget(dockWidget);
     ui->menuPlugins->addAction(dockWidget->toggleViewAction());
-    addDockWidget(Qt::DockWidgetArea::TopDockWidgetArea, dockWidget);
+    // Plugins are loaded after the layout was restored, so put the dock back where the layout
+    // had it, with its visibility and view properties
+    if (restoreDockWidget(dockWidget)) {
+        CutterLayout layout =
+                getViewLayout(Core()->currentlyDebugging ? LAYOUT_DEBUG : LAYOUT_DEFAULT);
+        auto properties = layout.viewProperties.find(dockWidget->objectName());
+        if (properties != layout.viewProperties.end()) {
+            dockWidget->deserializeViewProperties(*properties);
+        }
+    } else {
+        addDockWidget(Qt::DockWidgetArea::TopDockWidgetArea, dockWidget);
+    }
     pluginDocks.push_back(dockWidget);
 }
 
@@ -753,11 +859,6 @@ void MainWindow::showProjectSaveError(RzProjectErr err)
                           tr("Failed to save project: %1").arg(QString::fromUtf8(s)));
 }
 
-void MainWindow::refreshOmniBar(const QStringList &flags)
-{
-    omnibar->refresh(flags);
-}
-
 void MainWindow::setFilename(const QString &fn)
 {
     // Add file name to window title
@@ -919,6 +1020,7 @@ void MainWindow::restoreDocks()
     tabifyDockWidget(dashboardDock, rzGraphDock);
     tabifyDockWidget(dashboardDock, callGraphDock);
     tabifyDockWidget(dashboardDock, globalCallGraphDock);
+    tabifyDockWidget(dashboardDock, binaryDiffDock);
     for (const auto &it : dockWidgets) {
         // Check whether or not current widgets is graph, hexdump or disasm
         if (isExtraMemoryWidget(it)) {
@@ -1530,8 +1632,7 @@ void MainWindow::on_actionDefault_triggered()
  */
 void MainWindow::on_actionNew_triggered()
 {
-    // Create a new Cutter process
-    static_cast<CutterApplication *>(qApp)->launchNewInstance();
+    static_cast<CutterApplication *>(qApp)->createSession();
 }
 
 void MainWindow::on_actionSave_triggered()
@@ -1711,6 +1812,71 @@ void MainWindow::on_actionImportPDB_triggered()
     }
 }
 
+void MainWindow::on_actionLoadCoverage_triggered()
+{
+    QFileDialog dialog(this);
+    dialog.setWindowTitle(tr("Select coverage file"));
+    QStringList filters = { tr("Detect format (*)"), tr("drcov log (*.log *.drcov)"),
+                            tr("Address list (*.txt *.log)"),
+                            tr("Binary trace of 64 bit addresses (*)") };
+    dialog.setNameFilters(filters);
+    if (!dialog.exec() || dialog.selectedFiles().isEmpty()) {
+        return;
+    }
+    const Coverage::Format formats[] = { Coverage::Format::Auto, Coverage::Format::Drcov,
+                                         Coverage::Format::AddressList, Coverage::Format::Binary };
+    const int filterIndex = filters.indexOf(dialog.selectedNameFilter());
+    const Coverage::Format format = formats[std::max(0, filterIndex)];
+
+    RVA moduleBase;
+    {
+        RzCoreLocked core(Core());
+        moduleBase = rz_bin_get_baddr(core->bin);
+    }
+    const QString moduleName = QFileInfo(Core()->getConfig("file.path")).fileName();
+
+    auto *coverageTask = new CoverageLoadTask(dialog.selectedFiles().first(), format, moduleBase,
+                                              moduleName);
+    AsyncTask::Ptr coverageTaskPtr(coverageTask);
+    auto *taskDialog = new AsyncTaskDialog(coverageTaskPtr, this);
+    taskDialog->setInterruptOnClose(true);
+    taskDialog->setAttribute(Qt::WA_DeleteOnClose);
+    taskDialog->show();
+    QWeakPointer<AsyncTask> weakTask = coverageTaskPtr;
+    connect(
+            coverageTask, &CoverageLoadTask::finished, this,
+            [this, weakTask]() {
+                AsyncTask::Ptr task = weakTask.toStrongRef();
+                if (!task) {
+                    return;
+                }
+                auto coverageTask = static_cast<CoverageLoadTask *>(task.data());
+                std::shared_ptr<Coverage> coverage = coverageTask->getCoverage();
+                if (!coverage) {
+                    // The dialog interrupts the task when it closes on finishing, so only a
+                    // cancellation while loading is not an error
+                    if (!coverageTask->wasCanceled()) {
+                        QMessageBox::critical(this, tr("Load Coverage"), coverageTask->getError());
+                    }
+                    return;
+                }
+                Core()->message(tr("Coverage loaded: %1 addresses, %2 hits.")
+                                        .arg(coverage->getEntries().size())
+                                        .arg(coverage->getTotalHits()));
+                Core()->setCoverage(coverage);
+                ui->actionClearCoverage->setEnabled(true);
+            },
+            Qt::QueuedConnection);
+
+    Core()->getAsyncTaskManager()->start(coverageTaskPtr);
+}
+
+void MainWindow::on_actionClearCoverage_triggered()
+{
+    Core()->setCoverage(nullptr);
+    ui->actionClearCoverage->setEnabled(false);
+}
+
 #define TYPE_BIG_ENDIAN(type, big_endian) big_endian ? type##_BE : type##_LE
 
 void MainWindow::on_actionExport_as_code_triggered()
@@ -1910,6 +2076,9 @@ bool MainWindow::eventFilter(QObject *obj, QEvent *event)
 
 bool MainWindow::event(QEvent *event)
 {
+    if (event->type() == QEvent::WindowActivate) {
+        CutterCore::setActiveSession(core);
+    }
     if (event->type() == QEvent::FontChange || event->type() == QEvent::StyleChange
         || event->type() == QEvent::PaletteChange) {
 #if QT_VERSION < QT_VERSION_CHECK(5, 10, 0)
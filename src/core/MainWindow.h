@@ -9,6 +9,7 @@
 #include "common/IOModesController.h"
 #include "common/CutterLayout.h"
 #include "MemoryDockWidget.h"
+#include "widgets/LazyDockWidget.h"
 
 #include <memory>
 
@@ -71,6 +72,16 @@ public:
     explicit MainWindow(QWidget *parent = nullptr);
     ~MainWindow() override;
 
+    /**
+     * @brief The session this window was created for, Core() at the time of construction.
+     */
+    CutterCore *getSession() const { return core; }
+
+    /**
+     * @brief Let all loaded plugins add their docks and menu entries to this window.
+     */
+    void setupPluginInterfaces();
+
     void openNewFile(InitialOptions &options, bool skipOptionsDialog = false);
     void displayNewFileDialog();
     void displayWelcomeDialog();
@@ -86,7 +97,6 @@ public:
     void readSettings();
     void saveSettings();
     void setFilename(const QString &fn);
-    void refreshOmniBar(const QStringList &flags);
 
     void addWidget(CutterDockWidget *widget);
     void addMemoryDockWidget(MemoryDockWidget *widget);
@@ -190,6 +200,10 @@ private slots:
 
     void on_actionImportPDB_triggered();
 
+    void on_actionLoadCoverage_triggered();
+
+    void on_actionClearCoverage_triggered();
+
     void on_actionExport_as_code_triggered();
 
     void on_actionApplySigFromFile_triggered();
@@ -233,28 +247,28 @@ private:
     QList<CutterDockWidget *> pluginDocks;
     OverviewWidget *overviewDock = nullptr;
     QAction *actionOverview = nullptr;
-    EntrypointWidget *entrypointDock = nullptr;
+    CutterDockWidget *entrypointDock = nullptr;
     FunctionsWidget *functionsDock = nullptr;
-    ImportsWidget *importsDock = nullptr;
-    ExportsWidget *exportsDock = nullptr;
-    HeadersWidget *headersDock = nullptr;
+    CutterDockWidget *importsDock = nullptr;
+    CutterDockWidget *exportsDock = nullptr;
+    CutterDockWidget *headersDock = nullptr;
     TypesWidget *typesDock = nullptr;
     SearchWidget *searchDock = nullptr;
-    SymbolsWidget *symbolsDock = nullptr;
-    GlobalsWidget *globalsDock = nullptr;
-    RelocsWidget *relocsDock = nullptr;
+    CutterDockWidget *symbolsDock = nullptr;
+    CutterDockWidget *globalsDock = nullptr;
+    CutterDockWidget *relocsDock = nullptr;
     CommentsWidget *commentsDock = nullptr;
     StringsWidget *stringsDock = nullptr;
-    FlagsWidget *flagsDock = nullptr;
+    CutterDockWidget *flagsDock = nullptr;
     Dashboard *dashboardDock = nullptr;
-    SdbWidget *sdbDock = nullptr;
-    SectionsWidget *sectionsDock = nullptr;
-    SegmentsWidget *segmentsDock = nullptr;
-    FlirtWidget *flirtDock = nullptr;
+    CutterDockWidget *sdbDock = nullptr;
+    CutterDockWidget *sectionsDock = nullptr;
+    CutterDockWidget *segmentsDock = nullptr;
+    CutterDockWidget *flirtDock = nullptr;
     ConsoleWidget *consoleDock = nullptr;
-    ClassesWidget *classesDock = nullptr;
-    ResourcesWidget *resourcesDock = nullptr;
-    VTablesWidget *vTablesDock = nullptr;
+    CutterDockWidget *classesDock = nullptr;
+    CutterDockWidget *resourcesDock = nullptr;
+    CutterDockWidget *vTablesDock = nullptr;
     CutterDockWidget *stackDock = nullptr;
     CutterDockWidget *threadsDock = nullptr;
     CutterDockWidget *processesDock = nullptr;
@@ -264,9 +278,10 @@ private:
     NewFileDialog *newFileDialog = nullptr;
     CutterDockWidget *breakpointDock = nullptr;
     CutterDockWidget *registerRefsDock = nullptr;
-    RizinGraphWidget *rzGraphDock = nullptr;
-    CallGraphWidget *callGraphDock = nullptr;
-    CallGraphWidget *globalCallGraphDock = nullptr;
+    CutterDockWidget *rzGraphDock = nullptr;
+    CutterDockWidget *callGraphDock = nullptr;
+    CutterDockWidget *globalCallGraphDock = nullptr;
+    CutterDockWidget *binaryDiffDock = nullptr;
     CutterDockWidget *heapDock = nullptr;
 
     QMenu *disassemblyContextMenuExtensions = nullptr;
@@ -277,6 +292,9 @@ private:
     void initUI();
     void initToolBar();
     void initDocks();
+    CutterDockWidget *addLazyDock(CutterDockWidget *&slot, const QString &name,
+                                  const QString &title, LazyDockWidget::Factory factory);
+    void materializeDock(LazyDockWidget *placeholder);
     void initBackForwardMenu();
     void displayInitialOptionsDialog(const InitialOptions &options = InitialOptions(),
                                      bool skipOptionsDialog = false);
@@ -1,6 +1,7 @@
 
 #include "AsyncTaskDialog.h"
 #include "common/AsyncTask.h"
+#include "core/Cutter.h"
 
 #include "ui_AsyncTaskDialog.h"
 
@@ -19,6 +20,9 @@ AsyncTaskDialog::AsyncTaskDialog(AsyncTask::Ptr task, QWidget *parent)
 
     updateLog(task->getLog());
 
+    connect(Core()->getAsyncTaskManager(), &AsyncTaskManager::tasksChanged, this,
+            &AsyncTaskDialog::updateTasksInspector);
+
     connect(&timer, &QTimer::timeout, this, &AsyncTaskDialog::updateProgressTimer);
     timer.setInterval(1000);
     timer.setSingleShot(false);
@@ -34,13 +38,13 @@ void AsyncTaskDialog::updateLog(const QString &log)
     ui->logTextEdit->setPlainText(log);
 }
 
-void AsyncTaskDialog::updateProgressTimer()
+QString AsyncTaskDialog::formatDuration(qint64 ms)
 {
-    int secondsElapsed = (task->getElapsedTime() + 500) / 1000;
+    int secondsElapsed = (ms + 500) / 1000;
     int minutesElapsed = secondsElapsed / 60;
     int hoursElapsed = minutesElapsed / 60;
 
-    QString label = tr("Running for") + " ";
+    QString label;
     if (hoursElapsed) {
         label += tr("%n hour", "%n hours", hoursElapsed);
         label += " ";
@@ -50,7 +54,43 @@ void AsyncTaskDialog::updateProgressTimer()
         label += " ";
     }
     label += tr("%n seconds", "%n second", secondsElapsed % 60);
-    ui->timeLabel->setText(label);
+    return label;
+}
+
+void AsyncTaskDialog::updateProgressTimer()
+{
+    if (task->getQueueWaitTime() < 0) {
+        ui->timeLabel->setText(tr("Waiting in queue for") + " "
+                               + formatDuration(task->getElapsedTime()));
+    } else {
+        ui->timeLabel->setText(tr("Running for") + " " + formatDuration(task->getRunTime()));
+    }
+    updateTasksInspector();
+}
+
+void AsyncTaskDialog::updateTasksInspector()
+{
+    const QList<AsyncTask::Ptr> &tasks = Core()->getAsyncTaskManager()->getTasks();
+    ui->tasksTreeWidget->setVisible(tasks.size() > 1);
+    ui->tasksTreeWidget->clear();
+    for (const AsyncTask::Ptr &t : tasks) {
+        auto item = new QTreeWidgetItem(ui->tasksTreeWidget);
+        QString title = t->getTitle();
+        item->setText(0, title.isEmpty() ? tr("Unnamed task") : title);
+        item->setText(1,
+                      t->getPriority() == AsyncTask::Priority::Interactive ? tr("Interactive")
+                                                                           : tr("Background"));
+        qint64 queueWait = t->getQueueWaitTime();
+        item->setText(2, formatDuration(queueWait < 0 ? t->getElapsedTime() : queueWait));
+        item->setText(3, queueWait < 0 ? tr("Queued") : formatDuration(t->getRunTime()));
+        if (t == task) {
+            QFont font = item->font(0);
+            font.setBold(true);
+            for (int i = 0; i < ui->tasksTreeWidget->columnCount(); i++) {
+                item->setFont(i, font);
+            }
+        }
+    }
 }
 
 void AsyncTaskDialog::closeEvent(QCloseEvent *event)
@@ -30,6 +30,10 @@ public slots:
 private slots:
     void updateLog(const QString &log);
     void updateProgressTimer();
+    /**
+     * @brief Show queue wait and run time of all tasks, to tell why this one didn't finish yet
+     */
+    void updateTasksInspector();
 
 protected:
     void closeEvent(QCloseEvent *event) override;
@@ -40,6 +44,8 @@ private:
     QTimer timer;
 
     bool interruptOnClose = false;
+
+    QString formatDuration(qint64 ms);
 };
 
 #endif // ASYNCTASKDIALOG_H
@@ -2,6 +2,7 @@
 #include "ui_TypesInteractionDialog.h"
 
 #include "core/Cutter.h"
+#include "common/ChangeTracker.h"
 #include "common/Configuration.h"
 #include "common/SyntaxHighlighter.h"
 #include "widgets/TypesWidget.h"
@@ -80,6 +81,7 @@ void TypesInteractionDialog::done(int r)
             }
         }
         if (success) {
+            Core()->getChangeTracker()->notifyChanged(ChangeTracker::Types);
             emit newTypesLoaded();
             QDialog::done(r);
             return;
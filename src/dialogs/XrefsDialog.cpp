@@ -3,6 +3,7 @@
 
 #include "common/TempConfig.h"
 #include "common/Helpers.h"
+#include "common/XrefIndex.h"
 
 #include "core/MainWindow.h"
 
@@ -229,7 +230,29 @@ void XrefModel::readForOffset(RVA offset, bool to, bool whole_function)
 {
     beginResetModel();
     this->to = to;
-    xrefs = Core()->getXRefs(offset, to, whole_function);
+    xrefs.clear();
+
+    // Rizin only reports xrefs originating at exactly the given address, so whole_function
+    // doesn't change the result of the index lookup.
+    Q_UNUSED(whole_function)
+    XrefIndex *index = Core()->getXrefIndex();
+    const QVector<XrefIndex::Xref> found = to ? index->xrefsTo(offset) : index->xrefsFrom(offset);
+    QVector<RVA> targets;
+    targets.reserve(found.size());
+    for (const XrefIndex::Xref &xref : found) {
+        targets.append(xref.to);
+    }
+    const QHash<RVA, QString> names = Core()->flagsAt(targets);
+    xrefs.reserve(found.size());
+    for (const XrefIndex::Xref &xref : found) {
+        XrefDescription xd;
+        xd.from = xref.from;
+        xd.to = xref.to;
+        xd.type = rz_analysis_xrefs_type_tostring(xref.type);
+        xd.from_str = RzAddressString(xd.from);
+        xd.to_str = names.value(xd.to);
+        xrefs << xd;
+    }
     endResetModel();
 }
 
@@ -33,6 +33,7 @@ PluginManager::~PluginManager() {}
 void PluginManager::loadPlugins(bool enablePlugins)
 {
     assert(plugins.empty());
+    loaded = true;
 
     if (!enablePlugins) {
         // [#2159] list but don't enable the plugins
@@ -38,12 +38,17 @@ public:
     void destroyPlugins();
 
     const std::vector<PluginPtr> &getPlugins() { return plugins; }
+    /**
+     * @brief Whether loadPlugins() has been called yet
+     */
+    bool isLoaded() const { return loaded; }
 
     QVector<QDir> getPluginDirectories() const;
     QString getUserPluginsDirectory() const;
 
 private:
     std::vector<PluginPtr> plugins;
+    bool loaded = false;
 
     void loadNativePlugins(const QDir &directory);
     void loadPluginsFromDir(const QDir &pluginsDir, bool writable = false);
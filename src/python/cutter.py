@@ -1,4 +1,5 @@
 import json
+import struct
 from _cutter import *
 
 try:
@@ -15,3 +16,26 @@ def cmdj(command):
     return json.loads(cmd(command))
 
 
+def iter_functions():
+    """Iterate (address, size, basic block count, instruction count, name) of all functions"""
+    records, names = functions()
+    for record, name in zip(struct.iter_unpack(FUNCTION_FORMAT, records), names):
+        yield record + (name,)
+
+
+def iter_basic_blocks(function=None):
+    """Iterate (function, address, size, jump, fail) of the basic blocks of one or all functions"""
+    records = basic_blocks() if function is None else basic_blocks(function)
+    return struct.iter_unpack(BLOCK_FORMAT, records)
+
+
+def iter_xrefs():
+    """Iterate (from, to, type) of all xrefs, type is a RzAnalysisXRefType value"""
+    return struct.iter_unpack(XREF_FORMAT, xrefs())
+
+
+def iter_flags():
+    """Iterate (offset, size, name) of all flags"""
+    records, names = flags()
+    for record, name in zip(struct.iter_unpack(FLAG_FORMAT, records), names):
+        yield record + (name,)
@@ -77,6 +77,11 @@ ut32 BaseFindDialog::getMinScore() const
     return ui->minScoreEdit->value();
 }
 
+bool BaseFindDialog::getStopEarly() const
+{
+    return ui->stopEarlyCheckBox->isChecked();
+}
+
 void BaseFindDialog::on_buttonBox_accepted()
 {
     RzBaseFindOpt options = {};
@@ -91,7 +96,7 @@ void BaseFindDialog::on_buttonBox_accepted()
     options.user = nullptr;
 
     BaseFindSearchDialog *bfs = new BaseFindSearchDialog(parentWidget());
-    bfs->show(&options);
+    bfs->show(&options, getStopEarly());
 }
 
 void BaseFindDialog::on_buttonBox_rejected() {}
@@ -26,6 +26,7 @@ public:
     RVA getAlignment() const;
     ut32 getMinStrLen() const;
     ut32 getMinScore() const;
+    bool getStopEarly() const;
 
 private slots:
     void on_buttonBox_accepted();
@@ -100,6 +100,13 @@ BaseFindResultsDialog::BaseFindResultsDialog(QList<BasefindResultDescription> re
     addActions(blockMenu->actions());
 }
 
+void BaseFindResultsDialog::setResults(const QList<BasefindResultDescription> &results)
+{
+    model->beginResetModel();
+    list = results;
+    model->endResetModel();
+}
+
 void BaseFindResultsDialog::showItemContextMenu(const QPoint &pt)
 {
     auto index = ui->tableView->currentIndex();
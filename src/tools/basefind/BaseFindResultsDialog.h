@@ -44,6 +44,11 @@ public:
                                    QWidget *parent = nullptr);
     ~BaseFindResultsDialog();
 
+    /**
+     * @brief Replace the shown candidates, used to show the best ones while the search runs
+     */
+    void setResults(const QList<BasefindResultDescription> &results);
+
 public slots:
     void showItemContextMenu(const QPoint &pt);
 
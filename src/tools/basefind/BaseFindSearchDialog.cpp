@@ -18,7 +18,7 @@ BaseFindSearchDialog::BaseFindSearchDialog(QWidget *parent)
 
 BaseFindSearchDialog::~BaseFindSearchDialog() {}
 
-void BaseFindSearchDialog::show(RzBaseFindOpt *opts)
+void BaseFindSearchDialog::show(RzBaseFindOpt *opts, bool stopEarly)
 {
     RzThreadNCores n_cores = rz_th_physical_core_number();
     if (opts->max_threads > n_cores || opts->max_threads < 1) {
@@ -27,8 +27,9 @@ void BaseFindSearchDialog::show(RzBaseFindOpt *opts)
 
     QFormLayout *layout = new QFormLayout();
     ui->scrollAreaWidgetContents->setLayout(layout);
-    for (ut32 i = 0; i < opts->max_threads; ++i) {
-        QString label = QString::asprintf("Core %u", i);
+    const QStringList stages = { tr("Strings and pointers"),
+                                 tr("Candidates (%1 cores)").arg(opts->max_threads) };
+    for (const QString &label : stages) {
         QProgressBar *pbar = new QProgressBar(nullptr);
         layout->addRow(label, pbar);
         pbar->setRange(0, 100);
@@ -38,11 +39,19 @@ void BaseFindSearchDialog::show(RzBaseFindOpt *opts)
     if (!basefind->setOptions(opts)) {
         return;
     }
+    basefind->setStopEarly(stopEarly);
 
     connect(this, &BaseFindSearchDialog::cancelSearch, basefind.get(), &Basefind::cancel);
     connect(basefind.get(), &Basefind::progress, this, &BaseFindSearchDialog::onProgress);
+    connect(basefind.get(), &Basefind::resultsChanged, this,
+            &BaseFindSearchDialog::onResultsChanged);
     connect(basefind.get(), &Basefind::complete, this, &BaseFindSearchDialog::onCompletion);
 
+    // The best candidates are shown as soon as they are found
+    resultsDialog = new BaseFindResultsDialog({}, parentWidget());
+    resultsDialog->setAttribute(Qt::WA_DeleteOnClose);
+    resultsDialog->show();
+
     basefind->start();
     this->QDialog::show();
 }
@@ -52,11 +61,21 @@ void BaseFindSearchDialog::onProgress(BasefindCoreStatusDescription status)
     bars[status.index]->setValue(status.percentage);
 }
 
+void BaseFindSearchDialog::onResultsChanged()
+{
+    if (resultsDialog) {
+        resultsDialog->setResults(basefind->topResults(LiveResultCount));
+    }
+}
+
 void BaseFindSearchDialog::onCompletion()
 {
-    auto results = basefind->results();
-    BaseFindResultsDialog *table = new BaseFindResultsDialog(results, parentWidget());
-    table->show();
+    if (!resultsDialog) {
+        resultsDialog = new BaseFindResultsDialog({}, parentWidget());
+        resultsDialog->setAttribute(Qt::WA_DeleteOnClose);
+    }
+    resultsDialog->setResults(basefind->results());
+    resultsDialog->show();
     this->close();
 }
 
@@ -3,11 +3,14 @@
 
 #include <QDialog>
 #include <QListWidgetItem>
+#include <QPointer>
 #include <QProgressBar>
 #include <memory>
 
 #include <core/Cutter.h>
 
+class BaseFindResultsDialog;
+
 namespace Ui {
 class BaseFindSearchDialog;
 }
@@ -20,10 +23,11 @@ public:
     explicit BaseFindSearchDialog(QWidget *parent = nullptr);
     ~BaseFindSearchDialog();
 
-    void show(RzBaseFindOpt *opts);
+    void show(RzBaseFindOpt *opts, bool stopEarly);
 
 public slots:
     void onProgress(BasefindCoreStatusDescription status);
+    void onResultsChanged();
     void onCompletion();
 
 signals:
@@ -33,7 +37,13 @@ private slots:
     void on_buttonBox_rejected();
 
 private:
+    /**
+     * Number of best candidates shown while the search is running
+     */
+    static constexpr int LiveResultCount = 100;
+
     std::vector<QProgressBar *> bars;
+    QPointer<BaseFindResultsDialog> resultsDialog;
     std::unique_ptr<Basefind> basefind;
     std::unique_ptr<Ui::BaseFindSearchDialog> ui;
 };
@@ -5,10 +5,16 @@
 
 #include "core/MainWindow.h"
 
+QString BacktraceWidget::getDockTitle()
+{
+    return tr("Backtrace");
+}
+
 BacktraceWidget::BacktraceWidget(MainWindow *main)
     : CutterDockWidget(main), ui(new Ui::BacktraceWidget)
 {
     ui->setupUi(this);
+    setWindowTitle(getDockTitle());
 
     // setup backtrace model
     QString PC = Core()->getRegisterName("PC");
@@ -20,6 +20,11 @@ class BacktraceWidget : public CutterDockWidget
 
 public:
     explicit BacktraceWidget(MainWindow *main);
+
+    /**
+     * @brief Title of the dock, also shown before it is constructed
+     */
+    static QString getDockTitle();
     ~BacktraceWidget();
 
 private slots:
@@ -0,0 +1,364 @@
+#include "BinaryDiffWidget.h"
+
+#include "core/MainWindow.h"
+#include "common/Configuration.h"
+#include "common/Helpers.h"
+#include "widgets/CutterTreeView.h"
+#include "widgets/HexWidget.h"
+
+#include <QComboBox>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QSplitter>
+#include <QVBoxLayout>
+
+BinaryDiffModel::BinaryDiffModel(QObject *parent) : AddressableItemModel(parent) {}
+
+void BinaryDiffModel::setMatches(const QVector<BinaryDiff::Match> &matches)
+{
+    beginResetModel();
+    this->matches = matches;
+    endResetModel();
+}
+
+int BinaryDiffModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : matches.count();
+}
+
+int BinaryDiffModel::columnCount(const QModelIndex &) const
+{
+    return BinaryDiffModel::ColumnCount;
+}
+
+QString BinaryDiffModel::statusName(BinaryDiff::Status status)
+{
+    switch (status) {
+    case BinaryDiff::Status::Identical:
+        return tr("Identical");
+    case BinaryDiff::Status::Changed:
+        return tr("Changed");
+    case BinaryDiff::Status::Removed:
+        return tr("Removed");
+    case BinaryDiff::Status::Added:
+        return tr("Added");
+    }
+    return QString();
+}
+
+QVariant BinaryDiffModel::data(const QModelIndex &index, int role) const
+{
+    if (index.row() >= matches.count()) {
+        return QVariant();
+    }
+    const BinaryDiff::Match &match = matches.at(index.row());
+
+    switch (role) {
+    case Qt::DisplayRole:
+        switch (index.column()) {
+        case StatusColumn:
+            return statusName(match.status);
+        case AddressColumn:
+            return match.primary != RVA_INVALID ? RzAddressString(match.primary) : QString();
+        case NameColumn:
+            return match.primaryName;
+        case OtherAddressColumn:
+            return match.secondary != RVA_INVALID ? RzAddressString(match.secondary) : QString();
+        case OtherNameColumn:
+            return match.secondaryName;
+        case SimilarityColumn:
+            if (match.primary == RVA_INVALID || match.secondary == RVA_INVALID) {
+                return QString();
+            }
+            return QString::number(match.similarity, 'f', 2);
+        default:
+            return QVariant();
+        }
+    case Qt::ForegroundRole:
+        switch (match.status) {
+        case BinaryDiff::Status::Changed:
+            return Config()->getColor("graph.diff.unmatch");
+        case BinaryDiff::Status::Removed:
+        case BinaryDiff::Status::Added:
+            return Config()->getColor("graph.diff.new");
+        default:
+            return QVariant();
+        }
+    case MatchRole:
+        return QVariant::fromValue(match);
+    default:
+        return QVariant();
+    }
+}
+
+QVariant BinaryDiffModel::headerData(int section, Qt::Orientation, int role) const
+{
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    switch (section) {
+    case StatusColumn:
+        return tr("Status");
+    case AddressColumn:
+        return tr("Address");
+    case NameColumn:
+        return tr("Name");
+    case OtherAddressColumn:
+        return tr("Other Address");
+    case OtherNameColumn:
+        return tr("Other Name");
+    case SimilarityColumn:
+        return tr("Similarity");
+    default:
+        return QVariant();
+    }
+}
+
+RVA BinaryDiffModel::address(const QModelIndex &index) const
+{
+    return matches.at(index.row()).primary;
+}
+
+QString BinaryDiffModel::name(const QModelIndex &index) const
+{
+    return matches.at(index.row()).primaryName;
+}
+
+BinaryDiffProxyModel::BinaryDiffProxyModel(BinaryDiffModel *sourceModel, QObject *parent)
+    : AddressableFilterProxyModel(sourceModel, parent)
+{
+    setFilterCaseSensitivity(Qt::CaseInsensitive);
+    setSortCaseSensitivity(Qt::CaseInsensitive);
+}
+
+void BinaryDiffProxyModel::setStatusFilter(int statuses)
+{
+    this->statuses = statuses;
+    invalidateFilter();
+}
+
+bool BinaryDiffProxyModel::filterAcceptsRow(int row, const QModelIndex &parent) const
+{
+    QModelIndex index = sourceModel()->index(row, 0, parent);
+    auto match = index.data(BinaryDiffModel::MatchRole).value<BinaryDiff::Match>();
+    if (!(statuses & (1 << static_cast<int>(match.status)))) {
+        return false;
+    }
+    return qhelpers::filterStringContains(match.primaryName, this)
+            || qhelpers::filterStringContains(match.secondaryName, this);
+}
+
+bool BinaryDiffProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    auto leftMatch = left.data(BinaryDiffModel::MatchRole).value<BinaryDiff::Match>();
+    auto rightMatch = right.data(BinaryDiffModel::MatchRole).value<BinaryDiff::Match>();
+
+    switch (left.column()) {
+    case BinaryDiffModel::StatusColumn:
+        return leftMatch.status < rightMatch.status;
+    case BinaryDiffModel::AddressColumn:
+        return leftMatch.primary < rightMatch.primary;
+    case BinaryDiffModel::NameColumn:
+        return leftMatch.primaryName < rightMatch.primaryName;
+    case BinaryDiffModel::OtherAddressColumn:
+        return leftMatch.secondary < rightMatch.secondary;
+    case BinaryDiffModel::OtherNameColumn:
+        return leftMatch.secondaryName < rightMatch.secondaryName;
+    case BinaryDiffModel::SimilarityColumn:
+        return leftMatch.similarity < rightMatch.similarity;
+    default:
+        return false;
+    }
+}
+
+QString BinaryDiffWidget::getDockTitle()
+{
+    return tr("Binary Diff");
+}
+
+BinaryDiffWidget::BinaryDiffWidget(MainWindow *main)
+    : CutterDockWidget(main), primary(main->getSession())
+{
+    setObjectName("BinaryDiffWidget");
+    setWindowTitle(getDockTitle());
+
+    auto container = new QWidget(this);
+    auto layout = new QVBoxLayout(container);
+    layout->setContentsMargins(0, 0, 0, 0);
+
+    auto toolbar = new QHBoxLayout();
+    auto compareButton = new QPushButton(tr("Compare with..."), container);
+    statusCombo = new QComboBox(container);
+    statusCombo->addItem(tr("All functions"), ~0);
+    statusCombo->addItem(tr("Changed"), 1 << static_cast<int>(BinaryDiff::Status::Changed));
+    statusCombo->addItem(tr("Unmatched"),
+                         (1 << static_cast<int>(BinaryDiff::Status::Removed))
+                                 | (1 << static_cast<int>(BinaryDiff::Status::Added)));
+    statusCombo->addItem(tr("Identical"), 1 << static_cast<int>(BinaryDiff::Status::Identical));
+    filterEdit = new QLineEdit(container);
+    filterEdit->setPlaceholderText(tr("Filter by name"));
+    filterEdit->setClearButtonEnabled(true);
+    statusLabel = new QLabel(container);
+    toolbar->addWidget(compareButton);
+    toolbar->addWidget(statusCombo);
+    toolbar->addWidget(filterEdit, 1);
+    toolbar->addWidget(statusLabel);
+    layout->addLayout(toolbar);
+
+    model = new BinaryDiffModel(this);
+    proxyModel = new BinaryDiffProxyModel(model, this);
+    treeView = new CutterTreeView(container);
+    treeView->setModel(proxyModel);
+    treeView->setSortingEnabled(true);
+    treeView->sortByColumn(BinaryDiffModel::AddressColumn, Qt::AscendingOrder);
+
+    primaryHex = new HexWidget(container);
+    secondaryHex = new HexWidget(container);
+    primaryHex->setSession(primary);
+    hexArea = new QSplitter(Qt::Horizontal, container);
+    hexArea->addWidget(primaryHex);
+    hexArea->addWidget(secondaryHex);
+    hexArea->hide();
+
+    auto splitter = new QSplitter(Qt::Vertical, container);
+    splitter->addWidget(treeView);
+    splitter->addWidget(hexArea);
+    layout->addWidget(splitter, 1);
+    setWidget(container);
+
+    connect(compareButton, &QPushButton::clicked, this, &BinaryDiffWidget::compareWith);
+    connect<void (QComboBox::*)(int)>(
+            statusCombo, &QComboBox::currentIndexChanged, this,
+            [this](int i) { proxyModel->setStatusFilter(statusCombo->itemData(i).toInt()); });
+    connect(filterEdit, &QLineEdit::textChanged, proxyModel,
+            &QSortFilterProxyModel::setFilterWildcard);
+    connect(treeView->selectionModel(), &QItemSelectionModel::currentRowChanged, this,
+            &BinaryDiffWidget::showMatch);
+    connect(treeView, &QTreeView::doubleClicked, this, [this](const QModelIndex &index) {
+        RVA addr = proxyModel->address(index);
+        if (addr != RVA_INVALID) {
+            primary->seekAndShow(addr);
+        }
+    });
+
+    // The cursors follow each other, relative to the start of the shown pair
+    connect(primaryHex, &HexWidget::positionChanged, this, [this](RVA addr) {
+        if (!syncingCursors && secondary) {
+            syncingCursors = true;
+            secondaryHex->seek(addr + delta);
+            syncingCursors = false;
+        }
+    });
+    connect(secondaryHex, &HexWidget::positionChanged, this, [this](RVA addr) {
+        if (!syncingCursors) {
+            syncingCursors = true;
+            primaryHex->seek(addr - delta);
+            syncingCursors = false;
+        }
+    });
+}
+
+BinaryDiffWidget::~BinaryDiffWidget()
+{
+    stopDiff();
+}
+
+void BinaryDiffWidget::stopDiff()
+{
+    if (secondary) {
+        model->setMatches({});
+        hexArea->hide();
+        primaryHex->setDiffReference(nullptr, 0);
+        secondaryHex->setDiffReference(nullptr, 0);
+        secondaryHex->setSession(primary);
+    }
+    if (diffTask) {
+        // Stops after the analysis of the second binary at the latest, which can take long, so
+        // the task frees the session itself instead of being waited for
+        diffTask->interrupt();
+        disconnect(diffTask.data(), nullptr, this, nullptr);
+        if (secondary) {
+            secondary->setParent(nullptr);
+            diffTask->adoptSecondary();
+            secondary = nullptr;
+        }
+        diffTask.clear();
+    }
+    delete secondary;
+    secondary = nullptr;
+}
+
+void BinaryDiffWidget::compareWith()
+{
+    QString path = QFileDialog::getOpenFileName(this, tr("Select file to compare with"),
+                                                Config()->getRecentFolder());
+    if (path.isEmpty()) {
+        return;
+    }
+    stopDiff();
+
+    secondary = new CutterCore(this);
+    {
+        SessionScope scope(secondary);
+        secondary->initialize(false);
+        secondary->setSettings();
+    }
+    secondaryHex->setSession(secondary);
+
+    diffTask.reset(new BinaryDiffTask(secondary, path));
+    connect(diffTask.data(), &BinaryDiffTask::resultReady, this, &BinaryDiffWidget::setMatches);
+    connect(diffTask.data(), &BinaryDiffTask::failed, this,
+            [this](const QString &message) { statusLabel->setText(message); });
+    BinaryDiffTask *task = diffTask.data();
+    connect(task, &AsyncTask::finished, this, [this, task]() {
+        if (diffTask.data() == task) {
+            diffTask.clear();
+        }
+    });
+    statusLabel->setText(tr("Comparing with %1...").arg(QFileInfo(path).fileName()));
+    primary->getAsyncTaskManager()->start(diffTask);
+}
+
+void BinaryDiffWidget::setMatches(const QVector<BinaryDiff::Match> &matches)
+{
+    model->setMatches(matches);
+    treeView->resizeColumnToContents(BinaryDiffModel::StatusColumn);
+    treeView->resizeColumnToContents(BinaryDiffModel::AddressColumn);
+
+    int counts[4] = {};
+    for (const BinaryDiff::Match &match : matches) {
+        counts[static_cast<int>(match.status)]++;
+    }
+    statusLabel->setText(tr("%1 identical, %2 changed, %3 removed, %4 added")
+                                 .arg(counts[static_cast<int>(BinaryDiff::Status::Identical)])
+                                 .arg(counts[static_cast<int>(BinaryDiff::Status::Changed)])
+                                 .arg(counts[static_cast<int>(BinaryDiff::Status::Removed)])
+                                 .arg(counts[static_cast<int>(BinaryDiff::Status::Added)]));
+}
+
+void BinaryDiffWidget::showMatch(const QModelIndex &index)
+{
+    if (!index.isValid() || !secondary) {
+        hexArea->hide();
+        return;
+    }
+    auto match = index.data(BinaryDiffModel::MatchRole).value<BinaryDiff::Match>();
+    if (match.primary == RVA_INVALID || match.secondary == RVA_INVALID) {
+        hexArea->hide();
+        return;
+    }
+    delta = static_cast<int64_t>(match.secondary - match.primary);
+    primaryHex->setDiffReference(secondary, delta);
+    secondaryHex->setDiffReference(primary, -delta);
+    hexArea->show();
+
+    syncingCursors = true;
+    primaryHex->seek(match.primary);
+    secondaryHex->seek(match.secondary);
+    syncingCursors = false;
+}
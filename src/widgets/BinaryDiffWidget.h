@@ -0,0 +1,128 @@
+#ifndef BINARYDIFFWIDGET_H
+#define BINARYDIFFWIDGET_H
+
+#include "core/Cutter.h"
+#include "common/AddressableItemModel.h"
+#include "common/BinaryDiff.h"
+#include "CutterDockWidget.h"
+
+#include <QAbstractListModel>
+
+class MainWindow;
+class HexWidget;
+class QComboBox;
+class QLabel;
+class QLineEdit;
+class QSplitter;
+class QTreeView;
+
+class BinaryDiffModel : public AddressableItemModel<QAbstractListModel>
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        StatusColumn = 0,
+        AddressColumn,
+        NameColumn,
+        OtherAddressColumn,
+        OtherNameColumn,
+        SimilarityColumn,
+        ColumnCount
+    };
+    enum Role { MatchRole = Qt::UserRole };
+
+    explicit BinaryDiffModel(QObject *parent = nullptr);
+
+    void setMatches(const QVector<BinaryDiff::Match> &matches);
+    const BinaryDiff::Match &match(const QModelIndex &index) const
+    {
+        return matches.at(index.row());
+    }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    QVariant data(const QModelIndex &index, int role) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+    RVA address(const QModelIndex &index) const override;
+    QString name(const QModelIndex &index) const override;
+
+    static QString statusName(BinaryDiff::Status status);
+
+private:
+    QVector<BinaryDiff::Match> matches;
+};
+
+class BinaryDiffProxyModel : public AddressableFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    BinaryDiffProxyModel(BinaryDiffModel *sourceModel, QObject *parent = nullptr);
+
+    /**
+     * @param statuses bit i set shows the matches with status i
+     */
+    void setStatusFilter(int statuses);
+
+protected:
+    bool filterAcceptsRow(int row, const QModelIndex &parent) const override;
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+
+private:
+    int statuses = ~0;
+};
+
+/**
+ * @brief Compares the functions of the current binary with those of a second binary
+ *
+ * The second binary is loaded into a session of its own, which lives as long as the widget or
+ * until another binary is chosen. Selecting a pair of functions shows both side by side in hex
+ * views with synchronized cursors, bytes which differ are highlighted.
+ */
+class BinaryDiffWidget : public CutterDockWidget
+{
+    Q_OBJECT
+
+public:
+    explicit BinaryDiffWidget(MainWindow *main);
+
+    /**
+     * @brief Title of the dock, also shown before it is constructed
+     */
+    static QString getDockTitle();
+    ~BinaryDiffWidget() override;
+
+private slots:
+    void compareWith();
+    void setMatches(const QVector<BinaryDiff::Match> &matches);
+    void showMatch(const QModelIndex &index);
+
+private:
+    CutterCore *primary;
+    CutterCore *secondary = nullptr;
+    QSharedPointer<BinaryDiffTask> diffTask;
+
+    BinaryDiffModel *model;
+    BinaryDiffProxyModel *proxyModel;
+    QTreeView *treeView;
+    QComboBox *statusCombo;
+    QLineEdit *filterEdit;
+    QLabel *statusLabel;
+    HexWidget *primaryHex;
+    HexWidget *secondaryHex;
+    QSplitter *hexArea;
+
+    /**
+     * Offset from addresses in the primary to the ones in the secondary binary of the shown pair
+     */
+    int64_t delta = 0;
+    bool syncingCursors = false;
+
+    void stopDiff();
+};
+
+#endif // BINARYDIFFWIDGET_H
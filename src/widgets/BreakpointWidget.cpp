@@ -177,10 +177,16 @@ BreakpointProxyModel::BreakpointProxyModel(BreakpointModel *sourceModel, QObject
     this->setSortRole(Qt::EditRole);
 }
 
+QString BreakpointWidget::getDockTitle()
+{
+    return tr("Breakpoints");
+}
+
 BreakpointWidget::BreakpointWidget(MainWindow *main)
     : CutterDockWidget(main), ui(new Ui::BreakpointWidget)
 {
     ui->setupUi(this);
+    setWindowTitle(getDockTitle());
 
     ui->breakpointTreeView->setMainWindow(mainWindow);
     breakpointModel = new BreakpointModel(this);
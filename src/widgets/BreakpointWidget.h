@@ -71,6 +71,11 @@ class BreakpointWidget : public CutterDockWidget
 
 public:
     explicit BreakpointWidget(MainWindow *main);
+
+    /**
+     * @brief Title of the dock, also shown before it is constructed
+     */
+    static QString getDockTitle();
     ~BreakpointWidget();
 
 private slots:
@@ -1,11 +1,14 @@
 #include "CallGraph.h"
 
 #include "MainWindow.h"
+#include "common/XrefIndex.h"
 
 #include <QJsonValue>
 #include <QJsonArray>
 #include <QJsonObject>
 
+#include <algorithm>
+
 CallGraphWidget::CallGraphWidget(MainWindow *main, bool global)
     : MemoryDockWidget(MemoryWidgetType::CallGraph, main),
       graphView(new CallGraphView(this, main, global)),
@@ -22,12 +25,17 @@ CallGraphWidget::~CallGraphWidget() {}
 
 QString CallGraphWidget::getWindowTitle() const
 {
-    return global ? tr("Global Callgraph") : tr("Callgraph");
+    return getDockTitle(global);
+}
+
+QString CallGraphWidget::getWidgetType(bool global)
+{
+    return global ? QStringLiteral("GlobalCallgraph") : QStringLiteral("Callgraph");
 }
 
-QString CallGraphWidget::getWidgetType() const
+QString CallGraphWidget::getDockTitle(bool global)
 {
-    return global ? tr("GlobalCallgraph") : tr("Callgraph");
+    return global ? tr("Global Callgraph") : tr("Callgraph");
 }
 
 void CallGraphWidget::onSeekChanged(RVA address)
@@ -91,21 +99,20 @@ void CallGraphView::loadCurrentGraph()
     const ut64 to = Core()->getConfigi("graph.to");
     const bool usenames = Core()->getConfigb("graph.json.usenames");
 
+    // Call edges come from the xref index, which is built once for all functions instead of
+    // querying the xrefs of every function separately.
+    XrefIndex *index = Core()->getXrefIndex();
     auto edges = std::unordered_set<ut64> {};
+    QVector<RVA> unknownTargets;
     auto addFunction = [&](RzAnalysisFunction *fcn) {
         GraphLayout::GraphBlock block;
         block.entry = fcn->addr;
 
-        auto xrefs = fromOwned(rz_analysis_function_get_xrefs_from(fcn));
-        auto calls = std::unordered_set<ut64>();
-        for (const auto &xref : CutterRzList<RzAnalysisXRef>(xrefs.get())) {
-            const auto x = xref->to;
-            if (!(xref->type == RZ_ANALYSIS_XREF_TYPE_CALL && calls.find(x) == calls.end())) {
-                continue;
-            }
-            calls.insert(x);
+        for (RVA x : index->callees(fcn->addr)) {
             block.edges.emplace_back(x);
-            edges.insert(x);
+            if (edges.insert(x).second) {
+                unknownTargets.append(x);
+            }
         }
 
         QString name = usenames ? fcn->name : RzAddressString(fcn->addr);
@@ -113,7 +120,8 @@ void CallGraphView::loadCurrentGraph()
     };
 
     if (global) {
-        for (const auto &fcn : CutterRzList<RzAnalysisFunction>(Core()->core()->analysis->fcns)) {
+        RzCoreLocked core(Core());
+        for (const auto &fcn : CutterRzList<RzAnalysisFunction>(core->analysis->fcns)) {
             if (!isBetween(from, fcn->addr, to)) {
                 continue;
             }
@@ -126,13 +134,17 @@ void CallGraphView::loadCurrentGraph()
         }
     }
 
-    for (const auto &x : edges) {
-        if (blockContent.find(x) != blockContent.end()) {
-            continue;
-        }
+    // Targets which are not functions themselves get a block named by their flag
+    unknownTargets.erase(
+            std::remove_if(unknownTargets.begin(), unknownTargets.end(),
+                           [this](RVA x) { return blockContent.find(x) != blockContent.end(); }),
+            unknownTargets.end());
+    const QHash<RVA, QString> flagNames =
+            usenames ? Core()->flagsAt(unknownTargets) : QHash<RVA, QString>();
+    for (RVA x : unknownTargets) {
         GraphLayout::GraphBlock block;
         block.entry = x;
-        QString flagName = Core()->flagAt(x);
+        QString flagName = flagNames.value(x);
         QString name = usenames
                 ? (!flagName.isEmpty() ? flagName : QString("unk.%0").arg(RzAddressString(x)))
                 : RzAddressString(x);
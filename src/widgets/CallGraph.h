@@ -38,7 +38,12 @@ public:
     explicit CallGraphWidget(MainWindow *main, bool global);
     ~CallGraphWidget();
 
-    QString getWidgetType() const;
+    /**
+     * @brief Prefix of the object names, part of saved layouts and therefore not translated
+     */
+    static QString getWidgetType(bool global);
+    static QString getDockTitle(bool global);
+    QString getWidgetType() const { return getWidgetType(global); }
 
 protected:
     QString getWindowTitle() const override;
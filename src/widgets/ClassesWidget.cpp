@@ -227,8 +227,12 @@ AnalysisClassesModel::AnalysisClassesModel(CutterDockWidget *parent)
     // refresh everything later.
     refreshDeferrer = parent->createRefreshDeferrer([this]() { this->refreshAll(); });
 
-    connect(Core(), &CutterCore::refreshAll, this, &AnalysisClassesModel::refreshAll);
-    connect(Core(), &CutterCore::codeRebased, this, &AnalysisClassesModel::refreshAll);
+    connect(Core()->getChangeTracker(), &ChangeTracker::changed, this,
+            [this](ChangeTracker::Domains domains) {
+                if (domains.testFlag(ChangeTracker::Classes)) {
+                    refreshAll();
+                }
+            });
     connect(Core(), &CutterCore::classNew, this, &AnalysisClassesModel::classNew);
     connect(Core(), &CutterCore::classDeleted, this, &AnalysisClassesModel::classDeleted);
     connect(Core(), &CutterCore::classRenamed, this, &AnalysisClassesModel::classRenamed);
@@ -239,9 +243,10 @@ AnalysisClassesModel::AnalysisClassesModel(CutterDockWidget *parent)
 
 void AnalysisClassesModel::refreshAll()
 {
-    if (!refreshDeferrer->attemptRefresh(nullptr)) {
+    if (!classesWatcher.isOutdated() || !refreshDeferrer->attemptRefresh(nullptr)) {
         return;
     }
+    classesWatcher.markSeen();
 
     beginResetModel();
     attrs->clear();
@@ -594,6 +599,11 @@ bool ClassesSortFilterProxyModel::hasChildren(const QModelIndex &parent) const
     return !parent.isValid() || !parent.parent().isValid();
 }
 
+QString ClassesWidget::getDockTitle()
+{
+    return tr("Classes");
+}
+
 ClassesWidget::ClassesWidget(MainWindow *main)
     : ListDockWidget(main),
       seekToVTableAction(tr("Seek to VTable"), this),
@@ -603,7 +613,7 @@ ClassesWidget::ClassesWidget(MainWindow *main)
       renameClassAction(tr("Rename Class"), this),
       deleteClassAction(tr("Delete Class"), this)
 {
-    setWindowTitle(tr("Classes"));
+    setWindowTitle(getDockTitle());
     setObjectName("ClassesWidget");
 
     ui->treeView->setIconSize(QSize(10, 10));
@@ -4,6 +4,7 @@
 #include <memory>
 
 #include "core/Cutter.h"
+#include "common/ChangeTracker.h"
 #include "CutterDockWidget.h"
 #include "widgets/ListDockWidget.h"
 
@@ -131,6 +132,7 @@ private:
     QList<QString> classes;
 
     RefreshDeferrer *refreshDeferrer;
+    ChangeWatcher classesWatcher { ChangeTracker::Classes };
 
     /**
      * @brief Cache for class attributes
@@ -186,6 +188,11 @@ class ClassesWidget : public ListDockWidget
 
 public:
     explicit ClassesWidget(MainWindow *main);
+
+    /**
+     * @brief Title of the dock, also shown before it is constructed
+     */
+    static QString getDockTitle();
     ~ClassesWidget();
 
 private slots:
@@ -8,7 +8,10 @@
 #include <QSettings>
 #include <QDir>
 #include <QUuid>
+#include <QInputDialog>
+#include <QTextCursor>
 #include <iostream>
+#include <climits>
 #include "core/Cutter.h"
 #include "ConsoleWidget.h"
 #include "ui_ConsoleWidget.h"
@@ -39,6 +42,10 @@ static const int invalidHistoryPos = -1;
 
 static const char *consoleWrapSettingsKey = "console.wrap";
 
+// Command output is appended in small pieces so that the UI stays responsive for huge outputs
+static const int outputChunkLines = 250;
+static const int outputLinesPerFlush = 1000;
+
 ConsoleWidget::ConsoleWidget(MainWindow *main)
     : CutterDockWidget(main),
       ui(new Ui::ConsoleWidget),
@@ -74,7 +81,10 @@ ConsoleWidget::ConsoleWidget(MainWindow *main)
     });
 
     QAction *actionClear = new QAction(tr("Clear Output"), this);
-    connect(actionClear, &QAction::triggered, ui->outputTextEdit, &QPlainTextEdit::clear);
+    connect(actionClear, &QAction::triggered, this, [this]() {
+        pendingOutput.clear();
+        ui->outputTextEdit->clear();
+    });
     addAction(actionClear);
 
     // Ctrl+l to clear the output
@@ -88,6 +98,32 @@ ConsoleWidget::ConsoleWidget(MainWindow *main)
     connect(actionWrapLines, &QAction::triggered, this, [this](bool checked) { setWrap(checked); });
     actions.append(actionWrapLines);
 
+    QAction *actionScrollback = new QAction(tr("Scrollback Limit..."), this);
+    connect(actionScrollback, &QAction::triggered, this, [this]() {
+        bool ok;
+        int lines = QInputDialog::getInt(this, tr("Scrollback Limit"),
+                                         tr("Lines to keep (0 for no limit):"),
+                                         Config()->getConsoleScrollback(), 0, INT_MAX, 1000, &ok);
+        if (ok) {
+            Config()->setConsoleScrollback(lines);
+            setScrollback(lines);
+        }
+    });
+    actions.append(actionScrollback);
+    setScrollback(Config()->getConsoleScrollback());
+
+    // Interrupts the running command, the input line is disabled meanwhile so this can't be a
+    // shortcut of it
+    QAction *actionCancel = new QAction(tr("Cancel Command"), this);
+    actionCancel->setShortcut(Qt::CTRL | Qt::Key_Period);
+    actionCancel->setShortcutContext(Qt::WidgetWithChildrenShortcut);
+    connect(actionCancel, &QAction::triggered, this, &ConsoleWidget::cancelCommand);
+    addAction(actionCancel);
+    actions.append(actionCancel);
+
+    outputFlushTimer = new QTimer(this);
+    connect(outputFlushTimer, &QTimer::timeout, this, &ConsoleWidget::flushPendingOutput);
+
     // Completion
     completionActive = false;
     completer = new QCompleter(&completionModel, this);
@@ -222,7 +258,10 @@ void ConsoleWidget::executeCommand(const QString &command)
     if (!commandTask.isNull()) {
         return;
     }
-    ui->rzInputLineEdit->setEnabled(false);
+    setCommandRunning(true);
+    while (!pendingOutput.isEmpty()) {
+        flushPendingOutput();
+    }
 
     QString cmd_line = "[" + RzAddressString(Core()->getOffset()) + "]> " + command;
     addOutput(cmd_line);
@@ -230,23 +269,69 @@ void ConsoleWidget::executeCommand(const QString &command)
     RVA oldOffset = Core()->getOffset();
     commandTask =
             QSharedPointer<CommandTask>(new CommandTask(command, CommandTask::ColorMode::MODE_16M));
-    connect(commandTask.data(), &CommandTask::finished, this,
-            [this, cmd_line, command, oldOffset](const QString &result) {
-                ui->outputTextEdit->appendHtml(CutterCore::ansiEscapeToHtml(result));
-                scrollOutputToEnd();
-                historyAdd(command);
-                commandTask.clear();
-                ui->rzInputLineEdit->setEnabled(true);
-                ui->rzInputLineEdit->setFocus();
-
-                if (oldOffset != Core()->getOffset()) {
-                    Core()->updateSeek();
+    commandTask->setChunkedOutput(outputChunkLines, ui->outputTextEdit->maximumBlockCount());
+    connect(commandTask.data(), &CommandTask::outputChunk, this,
+            [this](const QStringList &htmlLines) {
+                pendingOutput.append(htmlLines);
+                if (!outputFlushTimer->isActive()) {
+                    outputFlushTimer->start(0);
                 }
             });
+    connect(commandTask.data(), &CommandTask::finished, this, [this, command, oldOffset]() {
+        if (commandTask->isInterrupted()) {
+            pendingOutput.append(tr("[interrupted]"));
+            outputFlushTimer->start(0);
+        }
+        historyAdd(command);
+        commandTask.clear();
+        setCommandRunning(false);
+        ui->rzInputLineEdit->setFocus();
+
+        if (oldOffset != Core()->getOffset()) {
+            Core()->updateSeek();
+        }
+    });
 
     Core()->getAsyncTaskManager()->start(commandTask);
 }
 
+void ConsoleWidget::cancelCommand()
+{
+    if (commandTask) {
+        commandTask->interrupt();
+    }
+}
+
+void ConsoleWidget::setCommandRunning(bool running)
+{
+    ui->rzInputLineEdit->setEnabled(!running);
+    ui->execButton->setIcon(QIcon(running ? ":/img/icons/media-stop_light.svg"
+                                          : ":/img/icons/arrow_right.svg"));
+    ui->execButton->setToolTip(running ? tr("Cancel command") : tr("Execute command"));
+}
+
+void ConsoleWidget::flushPendingOutput()
+{
+    // Every line becomes its own block, so that the scrollback limit of the document counts lines
+    QTextCursor cursor(ui->outputTextEdit->document());
+    cursor.movePosition(QTextCursor::End);
+    cursor.beginEditBlock();
+    int count = qMin(outputLinesPerFlush, pendingOutput.size());
+    for (int i = 0; i < count; i++) {
+        if (!ui->outputTextEdit->document()->isEmpty()) {
+            cursor.insertBlock();
+        }
+        cursor.insertHtml(pendingOutput.at(i));
+    }
+    cursor.endEditBlock();
+    pendingOutput.erase(pendingOutput.begin(), pendingOutput.begin() + count);
+
+    if (pendingOutput.isEmpty()) {
+        outputFlushTimer->stop();
+    }
+    scrollOutputToEnd();
+}
+
 void ConsoleWidget::sendToStdin(const QString &input)
 {
 #ifndef Q_OS_WIN
@@ -281,6 +366,13 @@ void ConsoleWidget::setWrap(bool wrap)
                                              : QPlainTextEdit::NoWrap);
 }
 
+void ConsoleWidget::setScrollback(int lines)
+{
+    // QPlainTextEdit drops the oldest blocks once the limit is reached and only lays out the
+    // visible ones, so the document works as a ring buffer of lines
+    ui->outputTextEdit->setMaximumBlockCount(lines);
+}
+
 void ConsoleWidget::on_rzInputLineEdit_returnPressed()
 {
     QString input = ui->rzInputLineEdit->text();
@@ -303,6 +395,10 @@ void ConsoleWidget::on_debugeeInputLineEdit_returnPressed()
 
 void ConsoleWidget::on_execButton_clicked()
 {
+    if (commandTask) {
+        cancelCommand();
+        return;
+    }
     on_rzInputLineEdit_returnPressed();
 }
 
@@ -432,7 +528,7 @@ void ConsoleWidget::processQueuedOutput()
         // Get the last segment that wasn't overwritten by carriage return
         output = output.trimmed();
         output = output.remove(0, output.lastIndexOf('\r')).trimmed();
-        ui->outputTextEdit->appendHtml(CutterCore::ansiEscapeToHtml(output));
+        ui->outputTextEdit->appendHtml(pipeHtmlConverter.lineToHtml(output));
         scrollOutputToEnd();
     }
 }
@@ -14,6 +14,7 @@
 
 class QCompleter;
 class QShortcut;
+class QTimer;
 
 namespace Ui {
 class ConsoleWidget;
@@ -62,6 +63,11 @@ private slots:
 
     void clear();
 
+    /**
+     * @brief Appends a few of the pending output chunks of the running command
+     */
+    void flushPendingOutput();
+
     /**
      * @brief Passes redirected output from the pipe to the terminal and console
      */
@@ -75,6 +81,9 @@ private:
     void executeCommand(const QString &command);
     void sendToStdin(const QString &input);
     void setWrap(bool wrap);
+    void setScrollback(int lines);
+    void cancelCommand();
+    void setCommandRunning(bool running);
 
     /**
      * @brief Redirects stderr and stdout to the output pipe which is handled by
@@ -83,6 +92,8 @@ private:
     void redirectOutput();
 
     QSharedPointer<CommandTask> commandTask;
+    QStringList pendingOutput;
+    QTimer *outputFlushTimer;
 
     std::unique_ptr<Ui::ConsoleWidget> ui;
     QAction *actionWrapLines;
@@ -100,6 +111,7 @@ private:
     FILE *origStdout = nullptr;
     FILE *origStdin = nullptr;
     QLocalSocket *pipeSocket = nullptr;
+    AnsiHtmlConverter pipeHtmlConverter;
 #ifdef Q_OS_WIN
     HANDLE hRead;
     HANDLE hWrite;
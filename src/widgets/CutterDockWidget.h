@@ -6,6 +6,9 @@
 
 #include <QDockWidget>
 
+#include <memory>
+#include <type_traits>
+
 class MainWindow;
 
 class CUTTER_EXPORT CutterDockWidget : public QDockWidget
@@ -62,6 +65,29 @@ public:
                 });
         return deferrer;
     }
+
+    /**
+     * @brief Convenience method for creating and registering an AsyncRefreshDeferrer
+     * @param computeFunc lambda taking no parameters and returning the data for the refresh,
+     * called on a worker thread. It must only use thread safe functions like the ones of
+     * CutterCore and not touch the widget.
+     * @param applyFunc lambda taking the computed data as a single parameter, called on the GUI
+     * thread
+     */
+    template<typename ComputeFunc, typename ApplyFunc>
+    AsyncRefreshDeferrer *createAsyncRefreshDeferrer(ComputeFunc computeFunc, ApplyFunc applyFunc)
+    {
+        using Result = typename std::decay<decltype(computeFunc())>::type;
+        auto *deferrer = new AsyncRefreshDeferrer(
+                [computeFunc, applyFunc]() -> AsyncRefreshDeferrer::ApplyFunction {
+                    auto result = std::make_shared<Result>(computeFunc());
+                    return [applyFunc, result]() { applyFunc(*result); };
+                },
+                this);
+        deferrer->registerFor(this);
+        return deferrer;
+    }
+
     /**
      * @brief Serialize dock properties for saving as part of layout.
      *
@@ -9,6 +9,7 @@
 
 #include <QStandardPaths>
 #include <QActionGroup>
+#include <QProgressDialog>
 
 static const qhelpers::KeyComb KEY_ZOOM_IN = Qt::Key_Plus | Qt::ControlModifier;
 static const qhelpers::KeyComb KEY_ZOOM_IN2 =
@@ -38,6 +39,10 @@ CutterGraphView::CutterGraphView(QWidget *parent)
     updateColors();
 
     connect(&actionExportGraph, &QAction::triggered, this, &CutterGraphView::showExportDialog);
+    connect(this, &GraphView::placementFinished, this, [this]() {
+        restoreCurrentBlock();
+        emit viewRefreshed();
+    });
 
     layoutMenu = new QMenu(tr("Layout"), this);
     horizontalLayoutAction = layoutMenu->addAction(tr("Horizontal"));
@@ -333,6 +338,18 @@ void CutterGraphView::exportGraph(QString filePath, GraphExportType exportType,
     case GraphExportType::Svg:
         this->saveAsSvg(filePath);
         break;
+    case GraphExportType::Dzi: {
+        QProgressDialog progressDialog(tr("Exporting graph tiles..."), tr("Cancel"), 0, 0, this);
+        progressDialog.setWindowModality(Qt::WindowModal);
+        progressDialog.setMinimumDuration(500);
+        this->saveAsTiles(filePath, graphScaleFactor, graphTransparent,
+                          [&progressDialog](int done, int total) {
+                              progressDialog.setMaximum(total);
+                              progressDialog.setValue(done);
+                              return !progressDialog.wasCanceled();
+                          });
+        break;
+    }
 
     case GraphExportType::GVDot:
         exportRzTextGraph(filePath, graphType, RZ_CORE_GRAPH_FORMAT_DOT, address);
@@ -408,7 +425,8 @@ void CutterGraphView::showExportGraphDialog(QString defaultName, RzCoreGraphType
     QVector<MultitypeFileSaveDialog::TypeDescription> types = {
         { tr("PNG (*.png)"), "png", QVariant::fromValue(GraphExportType::Png) },
         { tr("JPEG (*.jpg)"), "jpg", QVariant::fromValue(GraphExportType::Jpeg) },
-        { tr("SVG (*.svg)"), "svg", QVariant::fromValue(GraphExportType::Svg) }
+        { tr("SVG (*.svg)"), "svg", QVariant::fromValue(GraphExportType::Svg) },
+        { tr("Deep Zoom tiles (*.dzi)"), "dzi", QVariant::fromValue(GraphExportType::Dzi) }
     };
 
     types.append({
@@ -457,7 +475,8 @@ void CutterGraphView::showExportGraphDialog(QString defaultName, RzCoreGraphType
             auto answer =
                     QMessageBox::question(this, tr("Graph Export"),
                                           tr("Do you really want to export %1 x %2 = %3 pixel "
-                                             "bitmap image? Consider using different format.")
+                                             "bitmap image? Consider using different format, "
+                                             "Deep Zoom tiles work for any graph size.")
                                                   .arg(width)
                                                   .arg(height)
                                                   .arg(bitmapSize));
@@ -25,6 +25,7 @@ public:
         Png,
         Jpeg,
         Svg,
+        Dzi,
         GVDot,
         GVJson,
         GVGif,
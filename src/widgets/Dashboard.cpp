@@ -24,13 +24,20 @@ Dashboard::Dashboard(MainWindow *main) : CutterDockWidget(main), ui(new Ui::Dash
 {
     ui->setupUi(this);
 
-    connect(Core(), &CutterCore::refreshAll, this, &Dashboard::updateContents);
+    refreshDeferrer = createRefreshDeferrer([this]() { updateContents(); });
+    connect(Core()->getChangeTracker(), &ChangeTracker::changed, this,
+            &Dashboard::updateContents);
 }
 
 Dashboard::~Dashboard() {}
 
 void Dashboard::updateContents()
 {
+    if (!contentsWatcher.isOutdated() || !refreshDeferrer->attemptRefresh(nullptr)) {
+        return;
+    }
+    contentsWatcher.markSeen();
+
     RzCoreLocked core(Core());
     int fd = rz_io_fd_get_current(core->io);
     RzIODesc *desc = rz_io_desc_get(core->io, fd);
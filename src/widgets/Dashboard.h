@@ -4,6 +4,7 @@
 #include <QFormLayout>
 #include <memory>
 #include "core/Cutter.h"
+#include "common/ChangeTracker.h"
 #include "CutterDockWidget.h"
 
 QT_BEGIN_NAMESPACE
@@ -37,6 +38,11 @@ private:
     const char *setBoolText(bool value);
 
     QWidget *hashesWidget = nullptr;
+
+    RefreshDeferrer *refreshDeferrer;
+    /// The file info only changes together with the memory layout, the rest are analysis counts
+    ChangeWatcher contentsWatcher { ChangeTracker::Functions | ChangeTracker::Flags
+                                    | ChangeTracker::Xrefs | ChangeTracker::Memory };
 };
 
 #endif // DASHBOARD_H
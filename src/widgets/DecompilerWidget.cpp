@@ -19,6 +19,7 @@
 #include <QTextBlockUserData>
 #include <QScrollBar>
 #include <QAbstractSlider>
+#include <QSignalBlocker>
 
 DecompilerWidget::DecompilerWidget(MainWindow *main)
     : MemoryDockWidget(MemoryWidgetType::Decompiler, main),
@@ -50,23 +51,14 @@ DecompilerWidget::DecompilerWidget(MainWindow *main)
 
     refreshDeferrer = createRefreshDeferrer([this]() { doRefresh(); });
 
-    auto decompilers = Core()->getDecompilers();
-    QString selectedDecompilerId = Config()->getSelectedDecompiler();
-    if (selectedDecompilerId.isEmpty()) {
-        // If no decompiler was previously chosen. set rz-ghidra as default decompiler
-        selectedDecompilerId = "ghidra";
-    }
-    for (Decompiler *dec : decompilers) {
-        ui->decompilerComboBox->addItem(dec->getName(), dec->getId());
-        if (dec->getId() == selectedDecompilerId) {
-            ui->decompilerComboBox->setCurrentIndex(ui->decompilerComboBox->count() - 1);
+    ui->progressLabel->setVisible(false);
+    updateDecompilers();
+    // Plugin decompilers are registered after the first window is shown
+    connect(Core(), &CutterCore::decompilersChanged, this, [this]() {
+        if (updateDecompilers()) {
+            doRefresh();
         }
-    }
-    decompilerSelectionEnabled = decompilers.size() > 1;
-    ui->decompilerComboBox->setEnabled(decompilerSelectionEnabled);
-    if (decompilers.isEmpty()) {
-        ui->textEdit->setPlainText(tr("No Decompiler available."));
-    }
+    });
 
     connect(ui->decompilerComboBox,
             static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this,
@@ -82,7 +74,6 @@ DecompilerWidget::DecompilerWidget(MainWindow *main)
     mCtxMenu->addAction(&syncAction);
     addActions(mCtxMenu->actions());
 
-    ui->progressLabel->setVisible(false);
     doRefresh();
 
     connect(Core(), &CutterCore::refreshAll, this, &DecompilerWidget::doRefresh);
@@ -110,6 +101,36 @@ QString DecompilerWidget::getWidgetType()
     return "DecompilerWidget";
 }
 
+bool DecompilerWidget::updateDecompilers()
+{
+    const QString previousId = ui->decompilerComboBox->currentData().toString();
+    auto decompilers = Core()->getDecompilers();
+    QString selectedDecompilerId = Config()->getSelectedDecompiler();
+    if (selectedDecompilerId.isEmpty()) {
+        // If no decompiler was previously chosen. set rz-ghidra as default decompiler
+        selectedDecompilerId = "ghidra";
+    }
+    {
+        QSignalBlocker blocker(ui->decompilerComboBox);
+        ui->decompilerComboBox->clear();
+        for (Decompiler *dec : decompilers) {
+            ui->decompilerComboBox->addItem(dec->getName(), dec->getId());
+            if (dec->getId() == selectedDecompilerId) {
+                ui->decompilerComboBox->setCurrentIndex(ui->decompilerComboBox->count() - 1);
+            }
+        }
+    }
+    decompilerSelectionEnabled = decompilers.size() > 1;
+    // Selection stays disabled while a decompilation is in progress
+    if (ui->progressLabel->isHidden()) {
+        ui->decompilerComboBox->setEnabled(decompilerSelectionEnabled);
+    }
+    if (decompilers.isEmpty()) {
+        ui->textEdit->setPlainText(tr("No Decompiler available."));
+    }
+    return ui->decompilerComboBox->currentData().toString() != previousId;
+}
+
 Decompiler *DecompilerWidget::getCurrentDecompiler()
 {
     return Core()->getDecompilerById(ui->decompilerComboBox->currentData().toString());
@@ -59,6 +59,12 @@ private slots:
 private:
     std::unique_ptr<Ui::DecompilerWidget> ui;
 
+    /**
+     * @brief Fill the decompiler selection with the registered decompilers
+     * @return true if the selected decompiler changed
+     */
+    bool updateDecompilers();
+
     RefreshDeferrer *refreshDeferrer;
 
     bool usingAnnotationBasedHighlighting = false;
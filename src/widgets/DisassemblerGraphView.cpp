@@ -11,6 +11,7 @@
 #include "common/BasicBlockHighlighter.h"
 #include "common/BasicInstructionHighlighter.h"
 #include "common/Helpers.h"
+#include "common/CachedFontMetrics.h"
 
 #include <QColorDialog>
 #include <QPainter>
@@ -27,9 +28,99 @@
 #include <QClipboard>
 #include <QApplication>
 #include <QAction>
+#include <QTimer>
 
+#include <algorithm>
 #include <cmath>
 
+namespace {
+
+/**
+ * @brief Finds every occurrence of a token in the text of the graph blocks
+ *
+ * Works on a copy of the text, so the blocks can be reloaded while it runs.
+ */
+class TokenIndexTask : public AsyncTask
+{
+public:
+    struct Line
+    {
+        RVA addr;
+        int y;
+        QString text;
+    };
+
+    struct Block
+    {
+        ut64 entry;
+        int width;
+        std::vector<Line> lines;
+    };
+
+    struct Occurrence
+    {
+        RVA addr;
+        ut64 block;
+        QRectF rect;
+    };
+
+    QString token;
+    QFont font;
+    qreal textOffset = 0;
+    qreal rightMargin = 0;
+    int lineHeight = 0;
+    std::vector<Block> blocks;
+
+    std::vector<Occurrence> occurrences;
+
+    QString getTitle() override { return tr("Indexing highlighted token"); }
+
+protected:
+    void runTask() override
+    {
+        // The metrics of the view cache widths without locking, use a separate instance
+        CachedFontMetrics<qreal> metrics(font);
+        const qreal tokenWidth = metrics.width(token);
+        for (const Block &block : blocks) {
+            if (isInterrupted()) {
+                return;
+            }
+            const qreal maxX = block.width - rightMargin;
+            for (const Line &line : block.lines) {
+                const QString &text = line.text;
+                int pos = -1;
+                int measured = 0;
+                qreal widthBefore = 0;
+                while ((pos = text.indexOf(token, pos + 1)) != -1) {
+                    int tokenEnd = pos + token.length();
+                    if ((pos > 0 && text[pos - 1].isLetterOrNumber())
+                        || (tokenEnd < text.length() && text[tokenEnd].isLetterOrNumber())) {
+                        continue;
+                    }
+                    widthBefore += metrics.width(text.mid(measured, pos - measured));
+                    measured = pos;
+                    if (textOffset + widthBefore > maxX) {
+                        break;
+                    }
+                    qreal highlightWidth = tokenWidth;
+                    if (textOffset + widthBefore + tokenWidth >= maxX) {
+                        highlightWidth = maxX - textOffset - widthBefore;
+                    }
+                    occurrences.push_back({ line.addr, block.entry,
+                                            QRectF(textOffset + widthBefore, line.y,
+                                                   highlightWidth, lineHeight) });
+                }
+            }
+        }
+        std::sort(occurrences.begin(), occurrences.end(),
+                  [](const Occurrence &a, const Occurrence &b) {
+                      return a.addr != b.addr ? a.addr < b.addr : a.rect.x() < b.rect.x();
+                  });
+    }
+};
+
+}
+
 DisassemblerGraphView::DisassemblerGraphView(QWidget *parent, CutterSeekable *seekable,
                                              MainWindow *mainWindow,
                                              QList<QAction *> additionalMenuActions)
@@ -49,17 +140,21 @@ DisassemblerGraphView::DisassemblerGraphView(QWidget *parent, CutterSeekable *se
             &DisassemblerGraphView::setTooltipStylesheet);
 
     connect(Core(), &CutterCore::refreshAll, this, &DisassemblerGraphView::refreshView);
-    connect(Core(), &CutterCore::commentsChanged, this, &DisassemblerGraphView::refreshView);
-    connect(Core(), &CutterCore::functionRenamed, this, &DisassemblerGraphView::refreshView);
     connect(Core(), &CutterCore::flagsChanged, this, &DisassemblerGraphView::refreshView);
     connect(Core(), &CutterCore::globalVarsChanged, this, &DisassemblerGraphView::refreshView);
     connect(Core(), &CutterCore::varsChanged, this, &DisassemblerGraphView::refreshView);
-    connect(Core(), &CutterCore::instructionChanged, this, &DisassemblerGraphView::refreshView);
     connect(Core(), &CutterCore::breakpointsChanged, this, &DisassemblerGraphView::refreshView);
     connect(Core(), &CutterCore::functionsChanged, this, &DisassemblerGraphView::refreshView);
     connect(Core(), &CutterCore::asmOptionsChanged, this, &DisassemblerGraphView::refreshView);
     connect(Core(), &CutterCore::refreshCodeViews, this, &DisassemblerGraphView::refreshView);
 
+    // Edits which usually only touch a few blocks
+    connect(Core(), &CutterCore::commentsChanged, this, &DisassemblerGraphView::onCommentsChanged);
+    connect(Core(), &CutterCore::functionRenamed, this, &DisassemblerGraphView::onFunctionRenamed);
+    connect(Core(), &CutterCore::instructionChanged, this,
+            &DisassemblerGraphView::onInstructionChanged);
+    connect(Core(), &CutterCore::coverageChanged, this, [this]() { viewport()->update(); });
+
     connectSeekChanged(false);
 
     // ESC for previous
@@ -82,9 +177,19 @@ DisassemblerGraphView::DisassemblerGraphView(QWidget *parent, CutterSeekable *se
     QShortcut *shortcut_prev_instr = new QShortcut(QKeySequence(Qt::Key_K), this);
     shortcut_prev_instr->setContext(Qt::WidgetShortcut);
     connect(shortcut_prev_instr, &QShortcut::activated, this, &DisassemblerGraphView::prevInstr);
+    QShortcut *shortcut_next_token = new QShortcut(QKeySequence(Qt::Key_BracketRight), this);
+    shortcut_next_token->setContext(Qt::WidgetShortcut);
+    connect(shortcut_next_token, &QShortcut::activated, this,
+            &DisassemblerGraphView::nextTokenOccurrence);
+    QShortcut *shortcut_prev_token = new QShortcut(QKeySequence(Qt::Key_BracketLeft), this);
+    shortcut_prev_token->setContext(Qt::WidgetShortcut);
+    connect(shortcut_prev_token, &QShortcut::activated, this,
+            &DisassemblerGraphView::prevTokenOccurrence);
     shortcuts.append(shortcut_escape);
     shortcuts.append(shortcut_next_instr);
     shortcuts.append(shortcut_prev_instr);
+    shortcuts.append(shortcut_next_token);
+    shortcuts.append(shortcut_prev_token);
 
     // Context menu that applies to everything
     contextMenu->addAction(&actionExportGraph);
@@ -163,6 +268,10 @@ void DisassemblerGraphView::connectSeekChanged(bool disconn)
 
 DisassemblerGraphView::~DisassemblerGraphView()
 {
+    if (tokenIndexTask) {
+        tokenIndexTask->interrupt();
+        tokenIndexTask->wait();
+    }
     qDeleteAll(shortcuts);
     shortcuts.clear();
 }
@@ -175,21 +284,148 @@ void DisassemblerGraphView::refreshView()
     emit viewRefreshed();
 }
 
-void DisassemblerGraphView::loadCurrentGraph()
+void DisassemblerGraphView::setDisassemblyConfig(TempConfig &tempConfig)
 {
-    TempConfig tempConfig;
     tempConfig.set("scr.color", COLOR_MODE_16M)
             .set("asm.bb.line", false)
             .set("asm.lines", false)
             .set("asm.lines.fcn", false);
+}
+
+void DisassemblerGraphView::onInstructionChanged(RVA offset, ut64 size)
+{
+    if (size > MaxInstructionSize) {
+        // Long edits may change many blocks or the shape of the graph, including unknown sizes
+        refreshView();
+        return;
+    }
+    // A patch can shift the boundaries of the instructions following it
+    scheduleBlockUpdate(offset, MaxInstructionSize);
+}
+
+void DisassemblerGraphView::onCommentsChanged(RVA offset)
+{
+    scheduleBlockUpdate(offset, 1);
+}
 
+void DisassemblerGraphView::onFunctionRenamed(RVA offset, const QString &newName)
+{
+    Q_UNUSED(newName)
+    if (offset == currentFcnAddr) {
+        // Window title and the first block header
+        refreshView();
+        return;
+    }
+    // Only references from the shown function can display the name. Asking its own xrefs keeps
+    // renames away from the global xref index.
+    RzCoreLocked core(Core());
+    RzAnalysisFunction *fcn = rz_analysis_get_function_at(core->analysis, currentFcnAddr);
+    if (!fcn) {
+        return;
+    }
+    auto xrefs = fromOwned(rz_analysis_function_get_xrefs_from(fcn));
+    for (const auto &xref : CutterRzList<RzAnalysisXRef>(xrefs.get())) {
+        if (xref->to == offset) {
+            scheduleBlockUpdate(xref->from, 1);
+        }
+    }
+}
+
+void DisassemblerGraphView::scheduleBlockUpdate(RVA addr, ut64 size)
+{
+    if (emptyGraph) {
+        return;
+    }
+    // Several edits in a row, like a comment on every line of a selection, get a single update
+    if (changedRanges.empty()) {
+        QTimer::singleShot(0, this, &DisassemblerGraphView::updateChangedBlocks);
+    }
+    changedRanges.push_back({ addr, size });
+}
+
+void DisassemblerGraphView::updateChangedBlocks()
+{
+    std::vector<std::pair<RVA, ut64>> ranges;
+    ranges.swap(changedRanges);
+    if (ranges.empty() || emptyGraph) {
+        return;
+    }
+
+    RzAnalysisFunction *fcn = Core()->functionIn(seekable->getOffset());
+    if (!fcn || fcn->addr != currentFcnAddr) {
+        refreshView();
+        return;
+    }
+    std::unordered_map<ut64, RzAnalysisBlock *> analysisBlocks;
+    for (const auto &bbi : CutterPVector<RzAnalysisBlock>(fcn->bbs)) {
+        analysisBlocks[bbi->addr] = bbi;
+    }
+    if (analysisBlocks.size() != disassembly_blocks.size()) {
+        refreshView();
+        return;
+    }
+
+    std::vector<ut64> changed;
+    for (auto &it : disassembly_blocks) {
+        const DisassemblyBlock &db = it.second;
+        const ut64 end = db.entry + db.size;
+        for (const auto &range : ranges) {
+            if (range.first < end
+                && (db.entry <= range.first || db.entry - range.first < range.second)) {
+                changed.push_back(db.entry);
+                break;
+            }
+        }
+    }
+    if (changed.empty()) {
+        return;
+    }
+
+    TempConfig tempConfig;
+    setDisassemblyConfig(tempConfig);
+
+    // Tokens point into the instructions which are about to be replaced
+    setHighlightToken(nullptr);
+
+    bool resized = false;
+    for (ut64 entry : changed) {
+        auto bbi = analysisBlocks.find(entry);
+        DisassemblyBlock &db = disassembly_blocks[entry];
+        if (bbi == analysisBlocks.end() || bbi->second->size != db.size
+            || bbi->second->jump != db.jump || bbi->second->fail != db.fail
+            || !disassembleBlock(bbi->second, db)) {
+            // The edit changed the control flow, the whole layout has to be redone
+            refreshView();
+            return;
+        }
+        GraphBlock &gb = blocks[entry];
+        const int oldWidth = gb.width;
+        const int oldHeight = gb.height;
+        prepareGraphNode(gb);
+        resized |= gb.width != oldWidth || gb.height != oldHeight;
+        thumbnails.erase(entry);
+    }
+
+    if (resized) {
+        computeGraphPlacement();
+    } else {
+        setCacheDirty();
+        viewport()->update();
+    }
+    emit viewRefreshed();
+}
+
+void DisassemblerGraphView::loadCurrentGraph()
+{
+    TempConfig tempConfig;
+    setDisassemblyConfig(tempConfig);
+
+    changedRanges.clear();
     disassembly_blocks.clear();
     blocks.clear();
+    thumbnails.clear();
 
-    if (highlight_token) {
-        delete highlight_token;
-        highlight_token = nullptr;
-    }
+    setHighlightToken(nullptr);
 
     RzAnalysisFunction *fcn = Core()->functionIn(seekable->getOffset());
 
@@ -260,67 +496,81 @@ void DisassemblerGraphView::loadCurrentGraph()
                 gb.edges.emplace_back(caseOp->jump);
             }
         }
+        db.terminal = gb.edges.empty();
 
-        RzCoreLocked core(Core());
-        std::unique_ptr<ut8[]> buf { new ut8[bbi->size] };
-        if (!buf) {
+        if (!disassembleBlock(bbi, db)) {
             break;
         }
-        rz_io_read_at(core->io, bbi->addr, buf.get(), (int)bbi->size);
+        disassembly_blocks[db.entry] = db;
+        prepareGraphNode(gb);
+        addBlock(gb);
+    }
+    cleanupEdges(blocks);
+    computeGraphPlacement();
+}
 
-        auto vec = fromOwned(
-                rz_pvector_new(reinterpret_cast<RzPVectorFree>(rz_analysis_disasm_text_free)));
-        if (!vec) {
-            break;
-        }
+bool DisassemblerGraphView::disassembleBlock(RzAnalysisBlock *bbi, DisassemblyBlock &db)
+{
+    db.instrs.clear();
+    db.size = bbi->size;
+    db.jump = bbi->jump;
+    db.fail = bbi->fail;
+
+    RzCoreLocked core(Core());
+    std::unique_ptr<ut8[]> buf { new ut8[bbi->size] };
+    if (!buf) {
+        return false;
+    }
+    rz_io_read_at(core->io, bbi->addr, buf.get(), (int)bbi->size);
 
-        RzCoreDisasmOptions options = {};
-        options.vec = vec.get();
-        options.cbytes = 1;
-        rz_core_print_disasm(core, bbi->addr, buf.get(), (int)bbi->size, (int)bbi->size, NULL,
-                             &options);
-
-        auto vecVisitor = CutterPVector<RzAnalysisDisasmText>(vec.get());
-        auto iter = vecVisitor.begin();
-        while (iter != vecVisitor.end()) {
-            RzAnalysisDisasmText *op = *iter;
-            Instr instr;
-            instr.addr = op->offset;
-
-            ++iter;
-            if (iter != vecVisitor.end()) {
-                // get instruction size from distance to next instruction ...
-                RVA nextOffset = (*iter)->offset;
-                instr.size = nextOffset - instr.addr;
-            } else {
-                // or to the end of the block.
-                instr.size = (bbi->addr + bbi->size) - instr.addr;
-            }
+    auto vec = fromOwned(
+            rz_pvector_new(reinterpret_cast<RzPVectorFree>(rz_analysis_disasm_text_free)));
+    if (!vec) {
+        return false;
+    }
 
-            QTextDocument textDoc;
-            textDoc.setHtml(CutterCore::ansiEscapeToHtml(op->text));
+    RzCoreDisasmOptions options = {};
+    options.vec = vec.get();
+    options.cbytes = 1;
+    rz_core_print_disasm(core, bbi->addr, buf.get(), (int)bbi->size, (int)bbi->size, NULL,
+                         &options);
+
+    auto vecVisitor = CutterPVector<RzAnalysisDisasmText>(vec.get());
+    auto iter = vecVisitor.begin();
+    while (iter != vecVisitor.end()) {
+        RzAnalysisDisasmText *op = *iter;
+        Instr instr;
+        instr.addr = op->offset;
+
+        ++iter;
+        if (iter != vecVisitor.end()) {
+            // get instruction size from distance to next instruction ...
+            RVA nextOffset = (*iter)->offset;
+            instr.size = nextOffset - instr.addr;
+        } else {
+            // or to the end of the block.
+            instr.size = (bbi->addr + bbi->size) - instr.addr;
+        }
 
-            instr.plainText = textDoc.toPlainText();
+        QTextDocument textDoc;
+        textDoc.setHtml(CutterCore::ansiEscapeToHtml(op->text));
 
-            RichTextPainter::List richText = RichTextPainter::fromTextDocument(textDoc);
-            // Colors::colorizeAssembly(richText, textDoc.toPlainText(), 0);
+        instr.plainText = textDoc.toPlainText();
 
-            bool cropped;
-            int blockLength = Config()->getGraphBlockMaxChars()
-                    + Core()->getConfigb("asm.bytes") * 24 + Core()->getConfigb("asm.emu") * 10;
-            instr.text = Text(RichTextPainter::cropped(richText, blockLength, "...", &cropped));
-            if (cropped)
-                instr.fullText = richText;
-            else
-                instr.fullText = Text();
-            db.instrs.push_back(instr);
-        }
-        disassembly_blocks[db.entry] = db;
-        prepareGraphNode(gb);
-        addBlock(gb);
+        RichTextPainter::List richText = RichTextPainter::fromTextDocument(textDoc);
+        // Colors::colorizeAssembly(richText, textDoc.toPlainText(), 0);
+
+        bool cropped;
+        int blockLength = Config()->getGraphBlockMaxChars()
+                + Core()->getConfigb("asm.bytes") * 24 + Core()->getConfigb("asm.emu") * 10;
+        instr.text = Text(RichTextPainter::cropped(richText, blockLength, "...", &cropped));
+        if (cropped)
+            instr.fullText = richText;
+        else
+            instr.fullText = Text();
+        db.instrs.push_back(instr);
     }
-    cleanupEdges(blocks);
-    computeGraphPlacement();
+    return true;
 }
 
 DisassemblerGraphView::EdgeConfigurationMapping DisassemblerGraphView::getEdgeConfigurations()
@@ -364,106 +614,189 @@ void DisassemblerGraphView::prepareGraphNode(GraphBlock &block)
     block.height = (height * charHeight) + extra;
 }
 
-void DisassemblerGraphView::drawBlock(QPainter &p, GraphView::GraphBlock &block, bool interactive)
+void DisassemblerGraphView::prepareFrame(QPainter &p, bool interactive)
 {
-    QRectF blockRect(block.x, block.y, block.width, block.height);
+    frame.interactive = interactive;
+    frame.seekAddr = interactive ? seekable->getOffset() : RVA_INVALID;
+    frame.pcAddr = Core()->getProgramCounterValue();
+    frame.font = Config()->getFont();
+    frame.wordHighlightColor = ConfigColor("wordHighlight");
+    frame.breakpointColor = ConfigColor("gui.breakpoint_background");
+    frame.bbHighlighter = Core()->getBBHighlighter();
+    frame.biHighlighter = Core()->getBIHighlighter();
+    frame.coverage = Core()->getCoverage();
+
+    // Text is only drawn when it's legible, thumbnails only when the lines can be told apart
+    QRect screenChar = p.combinedTransform().mapRect(QRect(0, 0, ACharWidth, charHeight));
+    if (screenChar.width() >= Config()->getGraphMinFontSize()) {
+        frame.detail = DetailLevel::Full;
+    } else if (screenChar.height() >= ThumbnailMinLineHeight) {
+        frame.detail = DetailLevel::Thumbnail;
+    } else {
+        frame.detail = DetailLevel::Outline;
+    }
+}
 
-    p.setPen(Qt::black);
-    p.setBrush(Qt::gray);
-    p.setFont(Config()->getFont());
-    p.drawRect(blockRect);
+bool DisassemblerGraphView::blockContains(const DisassemblyBlock &db, RVA addr) const
+{
+    if (db.instrs.empty() || addr == RVA_INVALID) {
+        return false;
+    }
+    const Instr &last = db.instrs.back();
+    return db.instrs.front().addr <= addr && (addr < last.addr || addr - last.addr < last.size);
+}
 
-    // Render node
+void DisassemblerGraphView::drawBlock(QPainter &p, GraphView::GraphBlock &block, bool interactive)
+{
+    Q_UNUSED(interactive)
     DisassemblyBlock &db = disassembly_blocks[block.entry];
-    bool block_selected = false;
-    RVA selected_instruction = RVA_INVALID;
-
-    // Figure out if the current block is selected
-    RVA addr = seekable->getOffset();
-    RVA PCAddr = Core()->getProgramCounterValue();
-    for (const Instr &instr : db.instrs) {
-        if (instr.contains(addr) && interactive) {
-            block_selected = true;
-            selected_instruction = instr.addr;
-        }
-
-        // TODO: L219
+    if (frame.detail == DetailLevel::Outline) {
+        drawBlockOutline(p, block, db);
+        return;
     }
 
-    p.setPen(QColor(0, 0, 0, 0));
-    if (db.terminal) {
-        p.setBrush(retShadowColor);
-    } else if (db.indirectcall) {
-        p.setBrush(indirectcallShadowColor);
-    } else {
-        p.setBrush(QColor(0, 0, 0, 100));
-    }
+    QRectF blockRect(block.x, block.y, block.width, block.height);
+    bool block_selected = frame.interactive && blockContains(db, frame.seekAddr);
 
+    // Draw basic block background
     p.setPen(QPen(graphNodeColor, 1));
-
     if (block_selected) {
         p.setBrush(disassemblySelectedBackgroundColor);
     } else {
         p.setBrush(disassemblyBackgroundColor);
     }
-
-    // Draw basic block background
     p.drawRect(blockRect);
-    auto bb = Core()->getBBHighlighter()->getBasicBlock(block.entry);
-    if (bb) {
-        QColor color(bb->color);
-        p.setBrush(color);
+    if (auto bb = frame.bbHighlighter->getBasicBlock(block.entry)) {
+        p.setBrush(QColor(bb->color));
         p.drawRect(blockRect);
     }
 
-    const int firstInstructionY = block.y + getInstructionOffset(db, 0).y();
-
-    // Stop rendering text when it's too small
-    auto transform = p.combinedTransform();
-    QRect screenChar = transform.mapRect(QRect(0, 0, ACharWidth, charHeight));
-
-    if (screenChar.width() < Config()->getGraphMinFontSize()) {
+    if (frame.detail == DetailLevel::Thumbnail) {
+        // Instructions can't be told apart, show the heat of the whole block instead
+        QColor heat = blockHeatColor(db);
+        if (heat.isValid()) {
+            p.fillRect(blockRect, heat);
+        }
+        p.drawImage(blockRect, blockThumbnail(block, db));
         return;
     }
+    drawBlockText(p, block, db);
+}
 
-    qreal indent = ACharWidth;
-
-    // Highlight selected tokens
-    if (interactive && highlight_token != nullptr) {
-        int y = firstInstructionY;
-        qreal tokenWidth = mFontMetrics->width(highlight_token->content);
-
-        for (const Instr &instr : db.instrs) {
-            int pos = -1;
+void DisassemblerGraphView::drawBlockOutline(QPainter &p, GraphView::GraphBlock &block,
+                                             const DisassemblyBlock &db)
+{
+    QColor color = disassemblyBackgroundColor;
+    if (frame.interactive && blockContains(db, frame.seekAddr)) {
+        color = disassemblySelectedBackgroundColor;
+    } else if (auto bb = frame.bbHighlighter->getBasicBlock(block.entry)) {
+        color = bb->color;
+    } else if (db.terminal) {
+        // Tint blocks which leave the function, so the exits stand out in the overview
+        color = QColor::fromRgbF((color.redF() + brfalseColor.redF()) / 2,
+                                 (color.greenF() + brfalseColor.greenF()) / 2,
+                                 (color.blueF() + brfalseColor.blueF()) / 2);
+    }
+    p.setPen(QPen(graphNodeColor, 0));
+    p.setBrush(color);
+    p.drawRect(QRectF(block.x, block.y, block.width, block.height));
+    QColor heat = blockHeatColor(db);
+    if (heat.isValid()) {
+        p.fillRect(QRectF(block.x, block.y, block.width, block.height), heat);
+    }
+}
 
-            while ((pos = instr.plainText.indexOf(highlight_token->content, pos + 1)) != -1) {
-                int tokenEnd = pos + highlight_token->content.length();
+QColor DisassemblerGraphView::blockHeatColor(const DisassemblyBlock &db) const
+{
+    if (!frame.coverage || db.instrs.empty()) {
+        return QColor();
+    }
+    const Instr &last = db.instrs.back();
+    return frame.coverage->heatColor(frame.coverage->maxHitsIn(
+            db.instrs.front().addr, last.addr + std::max<ut64>(last.size, 1)));
+}
 
-                if ((pos > 0 && instr.plainText[pos - 1].isLetterOrNumber())
-                    || (tokenEnd < instr.plainText.length()
-                        && instr.plainText[tokenEnd].isLetterOrNumber())) {
-                    continue;
-                }
+const QImage &DisassemblerGraphView::blockThumbnail(GraphView::GraphBlock &block,
+                                                    const DisassemblyBlock &db)
+{
+    auto it = thumbnails.find(block.entry);
+    if (it != thumbnails.end()) {
+        return it->second;
+    }
 
-                qreal widthBefore = mFontMetrics->width(instr.plainText.left(pos));
-                qreal textOffset = padding + indent;
-                if (textOffset + widthBefore > block.width - (10 + padding)) {
-                    continue;
+    // Every word becomes a bar in the color of its text, which at this size is what the text
+    // looks like anyway and much cheaper to rasterize than glyphs
+    QSize size(std::max(1, qRound(block.width * ThumbnailScale)),
+               std::max(1, qRound(block.height * ThumbnailScale)));
+    QImage image(size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    painter.scale(ThumbnailScale, ThumbnailScale);
+    painter.setPen(Qt::NoPen);
+
+    const qreal barHeight = charHeight * 0.6;
+    const qreal right = block.width - padding;
+    auto paintLine = [&](const RichTextPainter::List &line, qreal x, qreal y) {
+        int column = 0;
+        for (const RichTextPainter::CustomRichText_t &run : line) {
+            int wordStart = -1;
+            for (int i = 0; i <= run.text.length(); i++) {
+                bool space = i == run.text.length() || run.text[i].isSpace();
+                if (!space && wordStart < 0) {
+                    wordStart = i;
+                } else if (space && wordStart >= 0) {
+                    qreal left = x + (column + wordStart) * ACharWidth;
+                    qreal width = std::min((i - wordStart) * ACharWidth, right - left);
+                    if (width > 0) {
+                        painter.fillRect(QRectF(left, y + (charHeight - barHeight) / 2, width,
+                                                barHeight),
+                                         run.textColor);
+                    }
+                    wordStart = -1;
                 }
+            }
+            column += run.text.length();
+        }
+    };
 
-                qreal highlightWidth = tokenWidth;
-                if (textOffset + widthBefore + tokenWidth >= block.width - (10 + padding)) {
-                    highlightWidth = block.width - widthBefore - (10 + 2 * padding);
-                }
+    int y = getTextOffset(0).y();
+    for (const auto &line : db.header_text.lines) {
+        paintLine(line, padding, y);
+        y += charHeight;
+    }
+    for (const Instr &instr : db.instrs) {
+        for (const auto &line : instr.text.lines) {
+            paintLine(line, padding + ACharWidth, y);
+            y += charHeight;
+        }
+    }
+    painter.end();
+    return thumbnails.emplace(block.entry, std::move(image)).first->second;
+}
 
-                QColor selectionColor = ConfigColor("wordHighlight");
+void DisassemblerGraphView::drawBlockText(QPainter &p, GraphView::GraphBlock &block,
+                                          DisassemblyBlock &db)
+{
+    p.setFont(frame.font);
 
-                p.fillRect(
-                        QRectF(block.x + textOffset + widthBefore, y, highlightWidth, charHeight),
-                        selectionColor);
+    RVA selected_instruction = RVA_INVALID;
+    if (frame.interactive) {
+        for (const Instr &instr : db.instrs) {
+            if (instr.contains(frame.seekAddr)) {
+                selected_instruction = instr.addr;
             }
+        }
+    }
 
-            y += int(instr.text.lines.size()) * charHeight;
+    qreal indent = ACharWidth;
+
+    // Highlight selected tokens
+    if (frame.interactive && highlight_token != nullptr) {
+        auto rects = tokenRects.find(block.entry);
+        if (rects != tokenRects.end()) {
+            for (const QRectF &rect : rects->second) {
+                p.fillRect(rect.translated(block.x, block.y), frame.wordHighlightColor);
+            }
         }
     }
 
@@ -476,7 +809,6 @@ void DisassemblerGraphView::drawBlock(QPainter &p, GraphView::GraphBlock &block,
         y += charHeight;
     }
 
-    auto bih = Core()->getBIHighlighter();
     for (const Instr &instr : db.instrs) {
         const QRect instrRect = QRect(static_cast<int>(block.x + indent), y,
                                       static_cast<int>(block.width - (10 + padding)),
@@ -484,15 +816,20 @@ void DisassemblerGraphView::drawBlock(QPainter &p, GraphView::GraphBlock &block,
 
         QColor instrColor;
         if (Core()->isBreakpoint(breakpoints, instr.addr)) {
-            instrColor = ConfigColor("gui.breakpoint_background");
-        } else if (instr.addr == PCAddr) {
+            instrColor = frame.breakpointColor;
+        } else if (instr.addr == frame.pcAddr) {
             instrColor = PCSelectionColor;
-        } else if (auto background = bih->getBasicInstruction(instr.addr)) {
+        } else if (auto background = frame.biHighlighter->getBasicInstruction(instr.addr)) {
             instrColor = background->color;
         }
 
         if (instrColor.isValid()) {
             p.fillRect(instrRect, instrColor);
+        } else if (frame.coverage) {
+            QColor heat = frame.coverage->heatColor(frame.coverage->hitsAt(instr.addr));
+            if (heat.isValid()) {
+                p.fillRect(instrRect, heat);
+            }
         }
 
         if (selected_instruction != RVA_INVALID && selected_instruction == instr.addr) {
@@ -812,6 +1149,102 @@ void DisassemblerGraphView::seekLocal(RVA addr, bool update_viewport)
     }
 }
 
+void DisassemblerGraphView::setHighlightToken(Token *token)
+{
+    delete highlight_token;
+    highlight_token = token;
+
+    tokenOccurrences.clear();
+    tokenRects.clear();
+    tokenCursor = -1;
+    if (tokenIndexTask) {
+        // Finishes in the background, tokenIndexFinished() ignores its result
+        tokenIndexTask->interrupt();
+        tokenIndexTask.clear();
+    }
+    if (!token) {
+        return;
+    }
+
+    auto task = QSharedPointer<TokenIndexTask>::create();
+    task->token = token->content;
+    task->font = font();
+    task->textOffset = padding + ACharWidth;
+    task->rightMargin = 10 + padding;
+    task->lineHeight = charHeight;
+    task->blocks.reserve(disassembly_blocks.size());
+    for (const auto &it : disassembly_blocks) {
+        const DisassemblyBlock &db = it.second;
+        TokenIndexTask::Block block;
+        block.entry = db.entry;
+        block.width = blocks[db.entry].width;
+        int y = getInstructionOffset(db, 0).y();
+        for (const Instr &instr : db.instrs) {
+            block.lines.push_back({ instr.addr, y, instr.plainText });
+            y += int(instr.text.lines.size()) * charHeight;
+        }
+        task->blocks.push_back(std::move(block));
+    }
+
+    tokenIndexTask = task;
+    connect(task.data(), &AsyncTask::finished, this, &DisassemblerGraphView::tokenIndexFinished,
+            Qt::QueuedConnection);
+    Core()->getAsyncTaskManager()->start(tokenIndexTask);
+}
+
+void DisassemblerGraphView::tokenIndexFinished()
+{
+    if (!tokenIndexTask || sender() != tokenIndexTask.data()) {
+        return;
+    }
+    auto task = static_cast<TokenIndexTask *>(tokenIndexTask.data());
+    for (const TokenIndexTask::Occurrence &occurrence : task->occurrences) {
+        tokenOccurrences.push_back({ occurrence.addr, occurrence.block, occurrence.rect });
+        tokenRects[occurrence.block].push_back(occurrence.rect);
+    }
+    tokenIndexTask.clear();
+    setCacheDirty();
+    viewport()->update();
+}
+
+void DisassemblerGraphView::seekTokenOccurrence(bool previous)
+{
+    if (tokenOccurrences.empty()) {
+        return;
+    }
+    const int count = static_cast<int>(tokenOccurrences.size());
+    const RVA addr = seekable->getOffset();
+    if (tokenCursor >= 0 && tokenCursor < count && tokenOccurrences[tokenCursor].addr == addr) {
+        tokenCursor = (tokenCursor + (previous ? count - 1 : 1)) % count;
+    } else {
+        auto before = [](const TokenOccurrence &occurrence, RVA addr) {
+            return occurrence.addr < addr;
+        };
+        auto it = std::lower_bound(tokenOccurrences.begin(), tokenOccurrences.end(), addr, before);
+        int index = static_cast<int>(it - tokenOccurrences.begin());
+        if (previous) {
+            tokenCursor = (index + count - 1) % count;
+        } else {
+            // Skip the occurrences at the current address
+            while (index < count && tokenOccurrences[index].addr == addr) {
+                index++;
+            }
+            tokenCursor = index % count;
+        }
+    }
+    seekable->seek(tokenOccurrences[tokenCursor].addr);
+}
+
+void DisassemblerGraphView::nextTokenOccurrence()
+{
+    seekTokenOccurrence(false);
+}
+
+void DisassemblerGraphView::prevTokenOccurrence()
+{
+    seekTokenOccurrence(true);
+}
+
 void DisassemblerGraphView::copySelection()
 {
     if (!highlight_token)
@@ -868,7 +1301,7 @@ void DisassemblerGraphView::blockClicked(GraphView::GraphBlock &block, QMouseEve
 
     currentBlockAddress = block.entry;
 
-    highlight_token = getToken(instr, pos.x());
+    setHighlightToken(getToken(instr, pos.x()));
 
     RVA addr = instr->addr;
     seekLocal(addr);
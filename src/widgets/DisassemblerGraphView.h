@@ -12,9 +12,14 @@
 #include "menus/DisassemblyContextMenu.h"
 #include "common/RichTextPainter.h"
 #include "common/CutterSeekable.h"
+#include "common/AsyncTask.h"
+#include "common/Coverage.h"
 
 class QTextEdit;
+class TempConfig;
 class FallbackSyntaxHighlighter;
+class BasicBlockHighlighter;
+class BasicInstructionHighlighter;
 
 class DisassemblerGraphView : public CutterGraphView
 {
@@ -86,6 +91,11 @@ class DisassemblerGraphView : public CutterGraphView
         ut64 false_path = 0;
         bool terminal = false;
         bool indirectcall = false;
+        // Analysis state the block was disassembled with, to tell apart edits of the
+        // instructions from changes to the shape of the function
+        ut64 size = 0;
+        ut64 jump = RVA_INVALID;
+        ut64 fail = RVA_INVALID;
     };
 
 public:
@@ -93,6 +103,7 @@ public:
                           QList<QAction *> additionalMenuAction);
     ~DisassemblerGraphView() override;
     std::unordered_map<ut64, DisassemblyBlock> disassembly_blocks;
+    virtual void prepareFrame(QPainter &p, bool interactive) override;
     virtual void drawBlock(QPainter &p, GraphView::GraphBlock &block, bool interactive) override;
     virtual void blockClicked(GraphView::GraphBlock &block, QMouseEvent *event,
                               QPoint pos) override;
@@ -131,6 +142,9 @@ public slots:
     void nextInstr();
     void prevInstr();
 
+    void nextTokenOccurrence();
+    void prevTokenOccurrence();
+
     void copySelection();
 
 protected:
@@ -143,12 +157,104 @@ protected:
 
 private slots:
     void showExportDialog() override;
+    void onInstructionChanged(RVA offset, ut64 size);
+    void onCommentsChanged(RVA offset);
+    void onFunctionRenamed(RVA offset, const QString &newName);
+    void updateChangedBlocks();
+    void tokenIndexFinished();
     void onActionHighlightBITriggered();
     void onActionUnhighlightBITriggered();
     void setTooltipStylesheet();
 
 private:
+    /**
+     * @brief How much of a block is drawn, depending on how large the text is on screen
+     */
+    enum class DetailLevel {
+        /// Flat rectangle tinted by block type or highlight
+        Outline,
+        /// Pre-rasterized thumbnail of the block text
+        Thumbnail,
+        /// Text with per instruction highlighting
+        Full
+    };
+
+    /**
+     * @brief State which is the same for every block of one paint
+     */
+    struct FrameState
+    {
+        DetailLevel detail = DetailLevel::Full;
+        bool interactive = true;
+        RVA seekAddr = RVA_INVALID;
+        RVA pcAddr = RVA_INVALID;
+        QFont font;
+        QColor wordHighlightColor;
+        QColor breakpointColor;
+        BasicBlockHighlighter *bbHighlighter = nullptr;
+        BasicInstructionHighlighter *biHighlighter = nullptr;
+        std::shared_ptr<const Coverage> coverage;
+    };
+
+    /**
+     * Text lines narrower than this on screen are not worth a thumbnail
+     */
+    static constexpr int ThumbnailMinLineHeight = 2;
+    /**
+     * Scale at which thumbnails are rasterized, once per block for all zoom levels drawn with
+     * DetailLevel::Thumbnail. Closer to the zoom at which text is drawn they are scaled up and
+     * look blurry, which is fine since only the shape of the lines matters there.
+     */
+    static constexpr qreal ThumbnailScale = 0.25;
+
+    /**
+     * Bytes after an edited address which may belong to a different instruction afterwards
+     */
+    static constexpr ut64 MaxInstructionSize = 16;
+
     bool transition_dont_seek = false;
+    FrameState frame;
+    std::unordered_map<ut64, QImage> thumbnails;
+
+    void drawBlockOutline(QPainter &p, GraphView::GraphBlock &block, const DisassemblyBlock &db);
+    /**
+     * @brief Heat of the hottest instruction of the block, invalid without coverage
+     */
+    QColor blockHeatColor(const DisassemblyBlock &db) const;
+    void drawBlockText(QPainter &p, GraphView::GraphBlock &block, DisassemblyBlock &db);
+    const QImage &blockThumbnail(GraphView::GraphBlock &block, const DisassemblyBlock &db);
+    bool blockContains(const DisassemblyBlock &db, RVA addr) const;
+
+    /**
+     * Address ranges edited since the last update, blocks touching them get disassembled again
+     */
+    std::vector<std::pair<RVA, ut64>> changedRanges;
+
+    void setDisassemblyConfig(TempConfig &tempConfig);
+    bool disassembleBlock(RzAnalysisBlock *bbi, DisassemblyBlock &db);
+    void scheduleBlockUpdate(RVA addr, ut64 size);
+
+    /**
+     * @brief Where the highlighted token appears, relative to the origin of its block
+     */
+    struct TokenOccurrence
+    {
+        RVA addr;
+        ut64 block;
+        QRectF rect;
+    };
+
+    /**
+     * Occurrences of highlight_token sorted by address, computed in the background whenever the
+     * highlight changes so that painting and navigation don't have to search the text
+     */
+    std::vector<TokenOccurrence> tokenOccurrences;
+    std::unordered_map<ut64, std::vector<QRectF>> tokenRects;
+    AsyncTask::Ptr tokenIndexTask;
+    int tokenCursor = -1;
+
+    void setHighlightToken(Token *token);
+    void seekTokenOccurrence(bool previous);
 
     Token *highlight_token;
     bool emptyGraph;
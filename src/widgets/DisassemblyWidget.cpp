@@ -6,6 +6,7 @@
 #include "common/TempConfig.h"
 #include "common/SelectionHighlight.h"
 #include "common/BinaryTrees.h"
+#include "common/Coverage.h"
 #include "core/MainWindow.h"
 
 #include <QApplication>
@@ -136,6 +137,10 @@ DisassemblyWidget::DisassemblyWidget(MainWindow *main)
     connect(Core(), &CutterCore::instructionChanged, this, &DisassemblyWidget::instructionChanged);
     connect(Core(), &CutterCore::breakpointsChanged, this, &DisassemblyWidget::refreshIfInRange);
     connect(Core(), SIGNAL(refreshCodeViews()), this, SLOT(refreshDisasm()));
+    connect(Core(), &CutterCore::coverageChanged, this, [this]() {
+        highlightCurrentLine();
+        highlightPCLine();
+    });
 
     connect(Config(), &Configuration::fontsUpdated, this, &DisassemblyWidget::fontsUpdatedSlot);
     connect(Config(), &Configuration::colorsUpdated, this, &DisassemblyWidget::colorsUpdatedSlot);
@@ -350,9 +355,36 @@ bool DisassemblyWidget::updateMaxLines()
     return false;
 }
 
+QList<QTextEdit::ExtraSelection> DisassemblyWidget::coverageSelections()
+{
+    QList<QTextEdit::ExtraSelection> selections;
+    std::shared_ptr<const Coverage> coverage = Core()->getCoverage();
+    if (!coverage) {
+        return selections;
+    }
+    for (QTextBlock block = mDisasTextEdit->document()->begin(); block.isValid();
+         block = block.next()) {
+        QTextCursor cursor(block);
+        RVA lineOffset = DisassemblyPreview::readDisassemblyOffset(cursor);
+        if (lineOffset == RVA_INVALID) {
+            continue;
+        }
+        QColor heat = coverage->heatColor(coverage->hitsAt(lineOffset));
+        if (!heat.isValid()) {
+            continue;
+        }
+        QTextEdit::ExtraSelection selection;
+        selection.cursor = cursor;
+        selection.format.setBackground(heat);
+        selection.format.setProperty(QTextFormat::FullWidthSelection, true);
+        selections.append(selection);
+    }
+    return selections;
+}
+
 void DisassemblyWidget::highlightCurrentLine()
 {
-    QList<QTextEdit::ExtraSelection> extraSelections;
+    QList<QTextEdit::ExtraSelection> extraSelections = coverageSelections();
     QColor highlightColor = ConfigColor("lineHighlight");
 
     // Highlight the current word
@@ -465,7 +497,8 @@ void DisassemblyWidget::updateCursorPosition()
     if (offset < topOffset || (offset > bottomOffset && bottomOffset != RVA_INVALID)) {
         mDisasTextEdit->moveCursor(QTextCursor::Start);
         mDisasTextEdit->setExtraSelections(
-                createSameWordsSelections(mDisasTextEdit, curHighlightedWord));
+                coverageSelections()
+                + createSameWordsSelections(mDisasTextEdit, curHighlightedWord));
     } else {
         RVA currentCursorOffset = readCurrentDisassemblyOffset();
         QTextCursor originalCursor = mDisasTextEdit->textCursor();
@@ -491,7 +524,7 @@ void DisassemblyWidget::updateCursorPosition()
                 break;
             } else if (lineOffset != RVA_INVALID && lineOffset > offset) {
                 mDisasTextEdit->moveCursor(QTextCursor::Start);
-                mDisasTextEdit->setExtraSelections({});
+                mDisasTextEdit->setExtraSelections(coverageSelections());
                 break;
             }
 
@@ -84,6 +84,11 @@ private:
     RefreshDeferrer *disasmRefresh;
 
     RVA readCurrentDisassemblyOffset();
+    /**
+     * @brief Backgrounds of the shown instructions which were executed according to the loaded
+     * coverage
+     */
+    QList<QTextEdit::ExtraSelection> coverageSelections();
     bool eventFilter(QObject *obj, QEvent *event) override;
     void keyPressEvent(QKeyEvent *event) override;
     QString getWindowTitle() const override;
@@ -11,10 +11,16 @@
  * Entrypoint Widget
  */
 
+QString EntrypointWidget::getDockTitle()
+{
+    return tr("Entry Points");
+}
+
 EntrypointWidget::EntrypointWidget(MainWindow *main)
     : CutterDockWidget(main), ui(new Ui::EntrypointWidget)
 {
     ui->setupUi(this);
+    setWindowTitle(getDockTitle());
 
     setScrollMode();
 
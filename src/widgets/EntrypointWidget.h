@@ -20,6 +20,11 @@ class EntrypointWidget : public CutterDockWidget
 
 public:
     explicit EntrypointWidget(MainWindow *main);
+
+    /**
+     * @brief Title of the dock, also shown before it is constructed
+     */
+    static QString getDockTitle();
     ~EntrypointWidget();
 
 private slots:
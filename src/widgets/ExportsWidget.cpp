@@ -133,9 +133,14 @@ bool ExportsProxyModel::lessThan(const QModelIndex &left, const QModelIndex &rig
     return leftExp.vaddr < rightExp.vaddr;
 }
 
+QString ExportsWidget::getDockTitle()
+{
+    return tr("Exports");
+}
+
 ExportsWidget::ExportsWidget(MainWindow *main) : ListDockWidget(main)
 {
-    setWindowTitle(tr("Exports"));
+    setWindowTitle(getDockTitle());
     setObjectName("ExportsWidget");
 
     exportsModel = new ExportsModel(&exports, this);
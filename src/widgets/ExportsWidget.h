@@ -69,6 +69,11 @@ class ExportsWidget : public ListDockWidget
 
 public:
     explicit ExportsWidget(MainWindow *main);
+
+    /**
+     * @brief Title of the dock, also shown before it is constructed
+     */
+    static QString getDockTitle();
     ~ExportsWidget();
 
 private slots:
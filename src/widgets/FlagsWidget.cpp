@@ -2,6 +2,7 @@
 #include "ui_FlagsWidget.h"
 #include "core/MainWindow.h"
 #include "common/Helpers.h"
+#include "common/ChangeTracker.h"
 
 #include <QComboBox>
 #include <QMenu>
@@ -142,10 +143,16 @@ bool FlagsSortFilterProxyModel::lessThan(const QModelIndex &left, const QModelIn
     return left_flag->offset < right_flag->offset;
 }
 
+QString FlagsWidget::getDockTitle()
+{
+    return tr("Flags");
+}
+
 FlagsWidget::FlagsWidget(MainWindow *main)
     : CutterDockWidget(main), ui(new Ui::FlagsWidget), main(main), tree(new CutterTreeWidget(this))
 {
     ui->setupUi(this);
+    setWindowTitle(getDockTitle());
 
     // Add Status Bar footer
     tree->addStatusBar(ui->verticalLayout);
@@ -180,9 +187,12 @@ FlagsWidget::FlagsWidget(MainWindow *main)
 
     setScrollMode();
 
-    connect(Core(), &CutterCore::flagsChanged, this, &FlagsWidget::flagsChanged);
-    connect(Core(), &CutterCore::codeRebased, this, &FlagsWidget::flagsChanged);
-    connect(Core(), &CutterCore::refreshAll, this, &FlagsWidget::refreshFlagspaces);
+    connect(Core()->getChangeTracker(), &ChangeTracker::changed, this,
+            [this](ChangeTracker::Domains domains) {
+                if (domains.testFlag(ChangeTracker::Flags)) {
+                    flagsChanged();
+                }
+            });
     connect(Core(), &CutterCore::commentsChanged, this,
             [this]() { qhelpers::emitColumnChanged(flags_model, FlagsModel::COMMENT); });
 
@@ -270,12 +280,6 @@ void FlagsWidget::refreshFlags()
     flags_model->endResetModel();
 
     tree->showItemsNumber(flags_proxy_model->rowCount());
-
-    // TODO: this is not a very good place for the following:
-    QStringList flagNames;
-    for (const FlagDescription &i : flags)
-        flagNames.append(i.name);
-    main->refreshOmniBar(flagNames);
 }
 
 void FlagsWidget::setScrollMode()
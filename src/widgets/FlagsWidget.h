@@ -65,6 +65,11 @@ class FlagsWidget : public CutterDockWidget
 
 public:
     explicit FlagsWidget(MainWindow *main);
+
+    /**
+     * @brief Title of the dock, also shown before it is constructed
+     */
+    static QString getDockTitle();
     ~FlagsWidget();
 
 private slots:
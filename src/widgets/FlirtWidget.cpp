@@ -121,12 +121,18 @@ bool FlirtProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right
     return leftEntry.bin_name < rightEntry.bin_name;
 }
 
+QString FlirtWidget::getDockTitle()
+{
+    return tr("Signatures");
+}
+
 FlirtWidget::FlirtWidget(MainWindow *main)
     : CutterDockWidget(main),
       ui(new Ui::FlirtWidget),
       blockMenu(new FlirtContextMenu(this, mainWindow))
 {
     ui->setupUi(this);
+    setWindowTitle(getDockTitle());
 
     model = new FlirtModel(&sigdb, this);
     proxyModel = new FlirtProxyModel(model, this);
@@ -67,6 +67,11 @@ class FlirtWidget : public CutterDockWidget
 
 public:
     explicit FlirtWidget(MainWindow *main);
+
+    /**
+     * @brief Title of the dock, also shown before it is constructed
+     */
+    static QString getDockTitle();
     ~FlirtWidget();
 
 private slots:
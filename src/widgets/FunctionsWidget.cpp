@@ -4,6 +4,8 @@
 #include "core/MainWindow.h"
 #include "common/DisassemblyPreview.h"
 #include "common/Helpers.h"
+#include "common/ChangeTracker.h"
+#include "common/Coverage.h"
 #include "common/FunctionsTask.h"
 #include "common/TempConfig.h"
 #include "menus/AddressableItemContextMenu.h"
@@ -50,6 +52,7 @@ FunctionModel::FunctionModel(QList<FunctionDescription> *functions, QSet<RVA> *i
 {
     connect(Core(), &CutterCore::seekChanged, this, &FunctionModel::seekChanged);
     connect(Core(), &CutterCore::functionRenamed, this, &FunctionModel::functionRenamed);
+    connect(Core(), &CutterCore::coverageChanged, this, &FunctionModel::coverageChanged);
 }
 
 QModelIndex FunctionModel::index(int row, int column, const QModelIndex &parent) const
@@ -103,6 +106,21 @@ bool FunctionModel::functionIsMain(ut64 addr) const
     return *mainAdress == addr;
 }
 
+QColor FunctionModel::functionHeatColor(const FunctionDescription &function) const
+{
+    auto it = coverageHeat.constFind(function.offset);
+    if (it != coverageHeat.constEnd()) {
+        return *it;
+    }
+    QColor heat;
+    if (std::shared_ptr<const Coverage> coverage = Core()->getCoverage()) {
+        heat = coverage->heatColor(coverage->maxHitsIn(
+                function.offset, function.offset + std::max<RVA>(function.linearSize, 1)));
+    }
+    coverageHeat.insert(function.offset, heat);
+    return heat;
+}
+
 QVariant FunctionModel::data(const QModelIndex &index, int role) const
 {
     if (!index.isValid())
@@ -287,6 +305,11 @@ QVariant FunctionModel::data(const QModelIndex &index, int role) const
 
         return QVariant(this->property("color"));
 
+    case Qt::BackgroundRole: {
+        QColor heat = functionHeatColor(function);
+        return heat.isValid() ? QVariant(heat) : QVariant();
+    }
+
     case FunctionDescriptionRole:
         return QVariant::fromValue(function);
 
@@ -403,6 +426,15 @@ void FunctionModel::functionRenamed(const RVA offset, const QString &new_name)
     }
 }
 
+void FunctionModel::coverageChanged()
+{
+    coverageHeat.clear();
+    if (!functions->isEmpty()) {
+        emit dataChanged(index(0, 0), index(functions->count() - 1, columnCount() - 1),
+                         { Qt::BackgroundRole });
+    }
+}
+
 FunctionSortFilterProxyModel::FunctionSortFilterProxyModel(FunctionModel *source_model,
                                                            QObject *parent)
     : AddressableFilterProxyModel(source_model, parent)
@@ -545,9 +577,12 @@ FunctionsWidget::FunctionsWidget(MainWindow *main)
     connect(this, &QWidget::customContextMenuRequested, this,
             &FunctionsWidget::showTitleContextMenu);
 
-    connect(Core(), &CutterCore::functionsChanged, this, &FunctionsWidget::refreshTree);
-    connect(Core(), &CutterCore::codeRebased, this, &FunctionsWidget::refreshTree);
-    connect(Core(), &CutterCore::refreshAll, this, &FunctionsWidget::refreshTree);
+    connect(Core()->getChangeTracker(), &ChangeTracker::changed, this,
+            [this](ChangeTracker::Domains domains) {
+                if (domains.testFlag(ChangeTracker::Functions)) {
+                    refreshTree();
+                }
+            });
     connect(Core(), &CutterCore::commentsChanged, this,
             [this]() { qhelpers::emitColumnChanged(functionModel, FunctionModel::CommentColumn); });
 }
@@ -556,16 +591,19 @@ FunctionsWidget::~FunctionsWidget() {}
 
 void FunctionsWidget::refreshTree()
 {
-    if (task) {
-        task->wait();
-    }
-
+    // A still running fetch is superseded through the shared key instead of waiting for it
     task = QSharedPointer<FunctionsTask>(new FunctionsTask());
-    connect(task.data(), &FunctionsTask::fetchFinished, this,
-            [this](const QList<FunctionDescription> &functions) {
+    task->setKey(QStringLiteral("FunctionsWidget/%1").arg(reinterpret_cast<quintptr>(this)));
+    FunctionsTask *taskPtr = task.data();
+    connect(taskPtr, &FunctionsTask::fetchFinished, this,
+            [this, taskPtr](const QList<FunctionDescription> &functions) {
+                if (task.data() != taskPtr) {
+                    return;
+                }
                 functionModel->beginResetModel();
 
                 this->functions = functions;
+                functionModel->coverageHeat.clear();
 
                 importAddresses.clear();
                 for (const ImportDescription &import : Core()->getAllImports()) {
@@ -35,8 +35,15 @@ private:
     QIcon iconFuncDark;
     QIcon iconFuncLight;
 
+    /**
+     * Heat of the functions by offset, filled as rows are shown until the coverage changes
+     */
+    mutable QHash<RVA, QColor> coverageHeat;
+
     bool functionIsImport(ut64 addr) const;
 
+    QColor functionHeatColor(const FunctionDescription &function) const;
+
     bool functionIsMain(ut64 addr) const;
 
 public:
@@ -86,6 +93,7 @@ public:
 private slots:
     void seekChanged(RVA addr);
     void functionRenamed(const RVA offset, const QString &new_name);
+    void coverageChanged();
 };
 
 class FunctionSortFilterProxyModel : public AddressableFilterProxyModel
@@ -32,6 +32,8 @@ GlibcHeapWidget::GlibcHeapWidget(MainWindow *main, QWidget *parent)
     connect(viewHeap, &QAbstractItemView::doubleClicked, this, &GlibcHeapWidget::onDoubleClicked);
     connect<void (QComboBox::*)(int)>(arenaSelectorView, &QComboBox::currentIndexChanged, this,
                                       &GlibcHeapWidget::onArenaSelected);
+    connect<void (QComboBox::*)(int)>(ui->diffSelector, &QComboBox::currentIndexChanged, this,
+                                      &GlibcHeapWidget::onDiffBaseSelected);
     connect(viewHeap, &QWidget::customContextMenuRequested, this,
             &GlibcHeapWidget::customMenuRequested);
     connect(viewHeap->selectionModel(), &QItemSelectionModel::currentChanged, this,
@@ -62,6 +64,8 @@ void GlibcHeapWidget::updateArenas()
 
     // store the currently selected arena's index
     int currentIndex = arenaSelectorView->currentIndex();
+    // the chunks are updated by the caller, don't walk the heap once more for every change
+    QSignalBlocker blocker(arenaSelectorView);
     arenaSelectorView->clear();
 
     // add the new arenas to the arena selector
@@ -75,6 +79,7 @@ void GlibcHeapWidget::updateArenas()
         currentIndex = 0;
     }
     arenaSelectorView->setCurrentIndex(currentIndex);
+    modelHeap->arena_addr = arenas.isEmpty() ? 0 : arenas[currentIndex].offset;
 }
 
 void GlibcHeapWidget::onArenaSelected(int index)
@@ -100,7 +105,91 @@ void GlibcHeapWidget::updateContents()
 
 void GlibcHeapWidget::updateChunks()
 {
-    modelHeap->reload();
+    // Only the main arena is a single contiguous heap which can be walked incrementally
+    bool contiguous = false;
+    for (const Arena &arena : arenas) {
+        if (arena.offset == modelHeap->arena_addr || !modelHeap->arena_addr) {
+            contiguous = arena.type == QLatin1String("Main");
+            break;
+        }
+    }
+    if (walkTask) {
+        // The walker keeps state between walks, only one of them may run at a time
+        walkPending = true;
+        return;
+    }
+    walkPending = false;
+    // Reading and hashing a big heap takes a while, don't block the interface on every stop
+    walkTask = QSharedPointer<HeapWalkTask>::create(walker, modelHeap->arena_addr, contiguous);
+    connect(walkTask.data(), &AsyncTask::finished, this, &GlibcHeapWidget::walkFinished,
+            Qt::QueuedConnection);
+    Core()->getAsyncTaskManager()->start(walkTask);
+}
+
+void GlibcHeapWidget::walkFinished()
+{
+    if (!walkTask || sender() != walkTask.data()) {
+        return;
+    }
+    auto snapshot = walkTask->getSnapshot();
+    walkTask.clear();
+    if (walkPending) {
+        updateChunks();
+    }
+    if (!snapshot) {
+        return;
+    }
+    if (!snapshots.isEmpty() && snapshots.last()->arena != snapshot->arena) {
+        snapshots.clear();
+    }
+    snapshots.append(snapshot);
+    size_t totalBytes = 0;
+    for (const auto &kept : snapshots) {
+        totalBytes += kept->memoryUsage();
+    }
+    while (snapshots.size() > 1 && totalBytes > MaxSnapshotBytes) {
+        totalBytes -= snapshots.first()->memoryUsage();
+        snapshots.removeFirst();
+    }
+    updateDiffSelector();
+    showSnapshot();
+}
+
+void GlibcHeapWidget::updateDiffSelector()
+{
+    QSignalBlocker blocker(ui->diffSelector);
+    ui->diffSelector->clear();
+    ui->diffSelector->addItem(tr("Current chunks"), 0);
+    int selected = 0;
+    for (int i = snapshots.size() - 2; i >= 0; i--) {
+        const auto &snapshot = snapshots[i];
+        ui->diffSelector->addItem(tr("Changes since stop %1 (%2)")
+                                          .arg(snapshot->id)
+                                          .arg(snapshot->time.toString("HH:mm:ss")),
+                                  snapshot->id);
+        if (snapshot->id == diffBaseId) {
+            selected = ui->diffSelector->count() - 1;
+        }
+    }
+    ui->diffSelector->setCurrentIndex(selected);
+    diffBaseId = ui->diffSelector->itemData(selected).toInt();
+}
+
+void GlibcHeapWidget::onDiffBaseSelected(int index)
+{
+    diffBaseId = index < 0 ? 0 : ui->diffSelector->itemData(index).toInt();
+    showSnapshot();
+}
+
+void GlibcHeapWidget::showSnapshot()
+{
+    std::shared_ptr<const HeapSnapshot> base;
+    for (const auto &snapshot : snapshots) {
+        if (snapshot->id == diffBaseId) {
+            base = snapshot;
+        }
+    }
+    modelHeap->setSnapshot(snapshots.isEmpty() ? nullptr : snapshots.last(), base);
     viewHeap->resizeColumnsToContents();
 }
 
@@ -109,43 +198,95 @@ void GlibcHeapWidget::customMenuRequested(QPoint pos)
     addressableItemContextMenu.exec(viewHeap->viewport()->mapToGlobal(pos));
 }
 
-void GlibcHeapModel::reload()
+void GlibcHeapModel::setSnapshot(std::shared_ptr<const HeapSnapshot> snapshot,
+                                 std::shared_ptr<const HeapSnapshot> base)
 {
     beginResetModel();
-    values.clear();
-    values = Core()->getHeapChunks(arena_addr);
+    this->snapshot = std::move(snapshot);
+    showDiff = base && this->snapshot;
+    diff = showDiff ? diffHeapSnapshots(*base, *this->snapshot) : std::vector<HeapDiffEntry>();
+    fetchedRows = qMin(availableRows(), FetchBatchSize);
     endResetModel();
 }
 
+int GlibcHeapModel::availableRows() const
+{
+    if (showDiff) {
+        return static_cast<int>(diff.size());
+    }
+    return snapshot ? static_cast<int>(snapshot->chunks.size()) : 0;
+}
+
+bool GlibcHeapModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && fetchedRows < availableRows();
+}
+
+void GlibcHeapModel::fetchMore(const QModelIndex &parent)
+{
+    if (parent.isValid()) {
+        return;
+    }
+    int count = qMin(availableRows() - fetchedRows, FetchBatchSize);
+    if (count <= 0) {
+        return;
+    }
+    beginInsertRows(QModelIndex(), fetchedRows, fetchedRows + count - 1);
+    fetchedRows += count;
+    endInsertRows();
+}
+
 int GlibcHeapModel::columnCount(const QModelIndex &) const
 {
     return ColumnCount;
 }
 
-int GlibcHeapModel::rowCount(const QModelIndex &) const
+int GlibcHeapModel::rowCount(const QModelIndex &parent) const
 {
-    return this->values.size();
+    return parent.isValid() ? 0 : fetchedRows;
 }
 
 QVariant GlibcHeapModel::data(const QModelIndex &index, int role) const
 {
-    if (!index.isValid() || index.row() >= values.count())
+    if (!index.isValid() || index.row() >= fetchedRows || role != Qt::DisplayRole)
         return QVariant();
 
-    const auto &item = values.at(index.row());
-
-    switch (role) {
-    case Qt::DisplayRole:
+    if (showDiff) {
+        const HeapDiffEntry &entry = diff[index.row()];
         switch (index.column()) {
         case OffsetColumn:
-            return RzAddressString(item.offset);
+            return RzAddressString(entry.offset);
         case SizeColumn:
-            return RzHexString(item.size);
+            if (entry.kind == HeapDiffEntry::Resized) {
+                return RzHexString(entry.oldSize) + " -> " + RzHexString(entry.newSize);
+            }
+            return RzHexString(entry.newSize ? entry.newSize : entry.oldSize);
         case StatusColumn:
-            return item.status;
+            switch (entry.kind) {
+            case HeapDiffEntry::Allocated:
+                return tr("allocated");
+            case HeapDiffEntry::Freed:
+                return tr("freed");
+            case HeapDiffEntry::Resized:
+                return tr("resized");
+            }
+            return QVariant();
         default:
             return QVariant();
         }
+    }
+
+    const HeapSnapshot::Chunk &item = snapshot->chunks[index.row()];
+    switch (index.column()) {
+    case OffsetColumn:
+        return RzAddressString(item.offset);
+    case SizeColumn:
+        return RzHexString(item.size);
+    case StatusColumn:
+        if (item.flags & HeapSnapshot::Top) {
+            return tr("top");
+        }
+        return item.flags & HeapSnapshot::Free ? tr("free") : tr("allocated");
     default:
         return QVariant();
     }
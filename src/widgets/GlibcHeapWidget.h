@@ -4,10 +4,13 @@
 #include <QDockWidget>
 #include "CutterDockWidget.h"
 #include "core/Cutter.h"
+#include "common/HeapSnapshot.h"
 #include <QTableView>
 #include <QComboBox>
 #include <AddressableItemContextMenu.h>
 
+#include <memory>
+
 namespace Ui {
 class GlibcHeapWidget;
 }
@@ -18,15 +21,31 @@ class GlibcHeapModel : public QAbstractTableModel
 public:
     explicit GlibcHeapModel(QObject *parent = nullptr);
     enum Column { OffsetColumn = 0, SizeColumn, StatusColumn, ColumnCount };
-    void reload();
+    /**
+     * @brief Show the chunks of snapshot, or the chunks which changed since base if it is set
+     */
+    void setSnapshot(std::shared_ptr<const HeapSnapshot> snapshot,
+                     std::shared_ptr<const HeapSnapshot> base);
     int rowCount(const QModelIndex &parent) const override;
     int columnCount(const QModelIndex &parent) const override;
     QVariant data(const QModelIndex &index, int role) const override;
     QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
     RVA arena_addr = 0;
 
 private:
-    QVector<Chunk> values;
+    static constexpr int FetchBatchSize = 10000;
+
+    std::shared_ptr<const HeapSnapshot> snapshot;
+    std::vector<HeapDiffEntry> diff;
+    bool showDiff = false;
+    /**
+     * Rows exposed to the view so far, the rest is added by fetchMore() while scrolling
+     */
+    int fetchedRows = 0;
+
+    int availableRows() const;
 };
 
 class GlibcHeapWidget : public QWidget
@@ -40,6 +59,7 @@ private slots:
     void updateContents();
     void onDoubleClicked(const QModelIndex &index);
     void onArenaSelected(int index);
+    void onDiffBaseSelected(int index);
     void customMenuRequested(QPoint pos);
     void onCurrentChanged(const QModelIndex &current, const QModelIndex &previous);
     void viewChunkInfo();
@@ -49,11 +69,36 @@ private slots:
 private:
     void updateArenas();
     void updateChunks();
+    void walkFinished();
+    void updateDiffSelector();
+    void showSnapshot();
     Ui::GlibcHeapWidget *ui;
     QTableView *viewHeap;
     QComboBox *arenaSelectorView;
     GlibcHeapModel *modelHeap = new GlibcHeapModel(this);
     QVector<Arena> arenas;
+    /**
+     * Older snapshots are dropped once all of them together take more memory, the current one is
+     * always kept
+     */
+    static constexpr size_t MaxSnapshotBytes = 64 * 1024 * 1024;
+    /**
+     * Shared with the walk task, which may outlive the widget
+     */
+    std::shared_ptr<HeapWalker> walker = std::make_shared<HeapWalker>();
+    QSharedPointer<HeapWalkTask> walkTask;
+    /**
+     * Another stop happened while walking, walk again once the task finished
+     */
+    bool walkPending = false;
+    /**
+     * Snapshots of the selected arena taken at the last stops, oldest first
+     */
+    QVector<std::shared_ptr<const HeapSnapshot>> snapshots;
+    /**
+     * Id of the snapshot the diff is shown against, 0 to show the current chunks
+     */
+    int diffBaseId = 0;
     QAction *chunkInfoAction;
     QAction *binInfoAction;
     AddressableItemContextMenu addressableItemContextMenu;
@@ -146,13 +146,18 @@ void GlobalsWidget::deleteGlobal()
     Core()->delGlobalVariable(globalVariableAddress);
 }
 
+QString GlobalsWidget::getDockTitle()
+{
+    return tr("Globals");
+}
+
 GlobalsWidget::GlobalsWidget(MainWindow *main)
     : CutterDockWidget(main), ui(new Ui::GlobalsWidget), tree(new CutterTreeWidget(this))
 {
     ui->setupUi(this);
     ui->quickFilterView->setLabelText(tr("Category"));
 
-    setWindowTitle(tr("Globals"));
+    setWindowTitle(getDockTitle());
     setObjectName("GlobalsWidget");
 
     // Add status bar which displays the count
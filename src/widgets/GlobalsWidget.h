@@ -64,6 +64,11 @@ class GlobalsWidget : public CutterDockWidget
 
 public:
     explicit GlobalsWidget(MainWindow *main);
+
+    /**
+     * @brief Title of the dock, also shown before it is constructed
+     */
+    static QString getDockTitle();
     ~GlobalsWidget();
 
 private slots:
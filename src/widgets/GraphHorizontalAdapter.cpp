@@ -49,6 +49,13 @@ void GraphHorizontalAdapter::setLayoutConfig(const GraphLayout::LayoutConfig &co
     layout->setLayoutConfig(config);
 }
 
+std::unique_ptr<GraphLayout> GraphHorizontalAdapter::clone() const
+{
+    std::unique_ptr<GraphHorizontalAdapter> result(new GraphHorizontalAdapter(layout->clone()));
+    result->layoutConfig = layoutConfig;
+    return result;
+}
+
 void GraphHorizontalAdapter::swapLayoutConfigDirection()
 {
     std::swap(layoutConfig.edgeVerticalSpacing, layoutConfig.edgeHorizontalSpacing);
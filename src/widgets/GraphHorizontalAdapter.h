@@ -16,6 +16,8 @@ public:
     virtual void CalculateLayout(GraphLayout::Graph &blocks, ut64 entry, int &width,
                                  int &height) const override;
     void setLayoutConfig(const LayoutConfig &config) override;
+    std::unique_ptr<GraphLayout> clone() const override;
+    bool runsInBackground() const override { return layout->runsInBackground(); }
 
 private:
     std::unique_ptr<GraphLayout> layout;
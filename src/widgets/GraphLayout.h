@@ -3,6 +3,7 @@
 
 #include "core/Cutter.h"
 
+#include <memory>
 #include <unordered_map>
 
 class GraphLayout
@@ -41,8 +42,24 @@ public:
 
     GraphLayout(const LayoutConfig &layout_config) : layoutConfig(layout_config) {}
     virtual ~GraphLayout() {}
+    /**
+     * @brief Place the blocks and route the edges of the graph
+     *
+     * Must only touch blocks and the layout itself, so that it can run on a worker thread on a copy
+     * of the graph made by clone().
+     */
     virtual void CalculateLayout(Graph &blocks, ut64 entry, int &width, int &height) const = 0;
     virtual void setLayoutConfig(const LayoutConfig &config) { this->layoutConfig = config; };
+    const LayoutConfig &getLayoutConfig() const { return layoutConfig; }
+    /**
+     * @brief Independent copy with the same settings, for computing a layout in the background
+     */
+    virtual std::unique_ptr<GraphLayout> clone() const = 0;
+    /**
+     * @brief Whether the layout can take long enough on big graphs that it should not block the
+     * GUI thread
+     */
+    virtual bool runsInBackground() const { return false; }
 
 protected:
     LayoutConfig layoutConfig;
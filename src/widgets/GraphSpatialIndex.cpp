@@ -0,0 +1,223 @@
+#include "GraphSpatialIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr qreal MinCellSize = 32;
+constexpr qint64 MaxCells = 1 << 20;
+
+/**
+ * Unlike QRectF::intersects this also works for the zero width or height bounding boxes of
+ * horizontal and vertical segments
+ */
+bool touches(const QRectF &a, const QRectF &b)
+{
+    return a.left() <= b.right() && b.left() <= a.right() && a.top() <= b.bottom()
+            && b.top() <= a.bottom();
+}
+
+}
+
+void GraphSpatialIndex::clear()
+{
+    blockItems.clear();
+    edgeItems.clear();
+    segmentItems.clear();
+    blockGrid = Grid();
+    segmentGrid = Grid();
+    blockSeen.clear();
+    edgeSeen.clear();
+    edgeSlot.clear();
+    bounds = QRectF();
+    columns = 0;
+    rows = 0;
+}
+
+void GraphSpatialIndex::build(const GraphLayout::Graph &graph)
+{
+    clear();
+
+    blockItems.reserve(graph.size());
+    for (const auto &blockIt : graph) {
+        const GraphLayout::GraphBlock &block = blockIt.second;
+        QRect rect(block.x, block.y, block.width, block.height);
+        blockItems.push_back({ block.entry, rect });
+        bounds = bounds.united(QRectF(rect));
+
+        for (size_t i = 0; i < block.edges.size(); i++) {
+            const QPolygonF &polyline = block.edges[i].polyline;
+            if (polyline.size() < 2) {
+                continue;
+            }
+            auto edgeId = static_cast<quint32>(edgeItems.size());
+            edgeItems.push_back({ block.entry, static_cast<int>(i) });
+            for (int segment = 0; segment + 1 < polyline.size(); segment++) {
+                QRectF segmentRect = QRectF(polyline[segment], polyline[segment + 1]).normalized();
+                segmentItems.push_back({ edgeId, segment, segmentRect });
+                bounds = bounds.united(segmentRect.adjusted(0, 0, 1, 1));
+            }
+        }
+    }
+    if (blockItems.empty()) {
+        return;
+    }
+
+    // Roughly a couple of items per cell, but not more cells than makes sense to keep around
+    qreal itemCount = blockItems.size() + segmentItems.size();
+    cellSize = std::max(MinCellSize, std::sqrt(bounds.width() * bounds.height() / itemCount) * 2);
+    for (;;) {
+        columns = static_cast<int>(std::ceil(bounds.width() / cellSize)) + 1;
+        rows = static_cast<int>(std::ceil(bounds.height() / cellSize)) + 1;
+        if (static_cast<qint64>(columns) * rows <= MaxCells) {
+            break;
+        }
+        cellSize *= 2;
+    }
+
+    fillGrid(blockGrid, blockItems);
+    fillGrid(segmentGrid, segmentItems);
+    blockSeen.assign(blockItems.size(), 0);
+    edgeSeen.assign(edgeItems.size(), 0);
+    edgeSlot.assign(edgeItems.size(), 0);
+    generation = 0;
+}
+
+template<typename Item>
+void GraphSpatialIndex::fillGrid(Grid &grid, const std::vector<Item> &items)
+{
+    const size_t cellCount = static_cast<size_t>(columns) * rows;
+    grid.cellStart.assign(cellCount + 1, 0);
+
+    // Count the items per cell first, so all of them fit into one array
+    int left, top, right, bottom;
+    for (const Item &item : items) {
+        if (!cellRange(QRectF(item.rect), left, top, right, bottom)) {
+            continue;
+        }
+        for (int y = top; y <= bottom; y++) {
+            for (int x = left; x <= right; x++) {
+                grid.cellStart[y * columns + x + 1]++;
+            }
+        }
+    }
+    for (size_t i = 0; i < cellCount; i++) {
+        grid.cellStart[i + 1] += grid.cellStart[i];
+    }
+
+    grid.items.resize(grid.cellStart[cellCount]);
+    std::vector<quint32> fill(grid.cellStart.begin(), grid.cellStart.end() - 1);
+    for (size_t i = 0; i < items.size(); i++) {
+        if (!cellRange(QRectF(items[i].rect), left, top, right, bottom)) {
+            continue;
+        }
+        for (int y = top; y <= bottom; y++) {
+            for (int x = left; x <= right; x++) {
+                grid.items[fill[y * columns + x]++] = static_cast<quint32>(i);
+            }
+        }
+    }
+}
+
+bool GraphSpatialIndex::cellRange(const QRectF &rect, int &left, int &top, int &right,
+                                  int &bottom) const
+{
+    if (!columns || !touches(rect, bounds)) {
+        return false;
+    }
+    auto cell = [this](qreal value, qreal origin, int count) {
+        return std::max(0, std::min(count - 1, static_cast<int>((value - origin) / cellSize)));
+    };
+    left = cell(rect.left(), bounds.left(), columns);
+    right = cell(rect.right(), bounds.left(), columns);
+    top = cell(rect.top(), bounds.top(), rows);
+    bottom = cell(rect.bottom(), bounds.top(), rows);
+    return true;
+}
+
+quint32 GraphSpatialIndex::nextGeneration()
+{
+    if (++generation == 0) {
+        std::fill(blockSeen.begin(), blockSeen.end(), 0);
+        std::fill(edgeSeen.begin(), edgeSeen.end(), 0);
+        generation = 1;
+    }
+    return generation;
+}
+
+std::vector<ut64> GraphSpatialIndex::blocksIn(const QRectF &rect)
+{
+    std::vector<ut64> result;
+    int left, top, right, bottom;
+    if (!cellRange(rect, left, top, right, bottom)) {
+        return result;
+    }
+    const quint32 current = nextGeneration();
+    for (int y = top; y <= bottom; y++) {
+        for (int x = left; x <= right; x++) {
+            const int cell = y * columns + x;
+            for (quint32 i = blockGrid.cellStart[cell]; i < blockGrid.cellStart[cell + 1]; i++) {
+                quint32 item = blockGrid.items[i];
+                if (blockSeen[item] == current) {
+                    continue;
+                }
+                blockSeen[item] = current;
+                if (QRectF(blockItems[item].rect).intersects(rect)) {
+                    result.push_back(blockItems[item].entry);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+bool GraphSpatialIndex::blockAt(QPoint p, ut64 &entry)
+{
+    int left, top, right, bottom;
+    if (!cellRange(QRectF(p, p), left, top, right, bottom)) {
+        return false;
+    }
+    const int cell = top * columns + left;
+    for (quint32 i = blockGrid.cellStart[cell]; i < blockGrid.cellStart[cell + 1]; i++) {
+        const BlockItem &item = blockItems[blockGrid.items[i]];
+        if (item.rect.contains(p)) {
+            entry = item.entry;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<GraphSpatialIndex::EdgeRange> GraphSpatialIndex::edgesIn(const QRectF &rect)
+{
+    std::vector<EdgeRange> result;
+    int left, top, right, bottom;
+    if (!cellRange(rect, left, top, right, bottom)) {
+        return result;
+    }
+    const quint32 current = nextGeneration();
+    for (int y = top; y <= bottom; y++) {
+        for (int x = left; x <= right; x++) {
+            const int cell = y * columns + x;
+            for (quint32 i = segmentGrid.cellStart[cell]; i < segmentGrid.cellStart[cell + 1];
+                 i++) {
+                const SegmentItem &segment = segmentItems[segmentGrid.items[i]];
+                if (!touches(segment.rect, rect)) {
+                    continue;
+                }
+                if (edgeSeen[segment.edge] != current) {
+                    edgeSeen[segment.edge] = current;
+                    edgeSlot[segment.edge] = static_cast<quint32>(result.size());
+                    const EdgeItem &edge = edgeItems[segment.edge];
+                    result.push_back({ edge.block, edge.edge, segment.segment, segment.segment });
+                    continue;
+                }
+                EdgeRange &range = result[edgeSlot[segment.edge]];
+                range.firstSegment = std::min(range.firstSegment, segment.segment);
+                range.lastSegment = std::max(range.lastSegment, segment.segment);
+            }
+        }
+    }
+    return result;
+}
@@ -0,0 +1,110 @@
+#ifndef GRAPHSPATIALINDEX_H
+#define GRAPHSPATIALINDEX_H
+
+#include "widgets/GraphLayout.h"
+
+#include <QRectF>
+
+#include <vector>
+
+/**
+ * @brief Uniform grid over the blocks and edge segments of a laid out graph
+ *
+ * Every block rectangle and every segment of an edge polyline is registered in all grid cells its
+ * bounding box touches, so that painting and hit testing only look at the items near the area of
+ * interest instead of the whole graph. Items are referred to by block entry and edge index, the
+ * index has to be rebuilt whenever the graph or its layout changes.
+ */
+class GraphSpatialIndex
+{
+public:
+    /**
+     * @brief Consecutive range of visible segments of one edge
+     *
+     * Segment i goes from point i to point i + 1 of the polyline.
+     */
+    struct EdgeRange
+    {
+        ut64 block;
+        int edge;
+        int firstSegment;
+        int lastSegment;
+    };
+
+    void build(const GraphLayout::Graph &graph);
+    void clear();
+
+    /**
+     * @brief Entries of the blocks whose rectangle intersects rect
+     */
+    std::vector<ut64> blocksIn(const QRectF &rect);
+
+    /**
+     * @brief Entry of a block containing p
+     * @return false if p is outside all blocks
+     */
+    bool blockAt(QPoint p, ut64 &entry);
+
+    /**
+     * @brief Edges with at least one segment intersecting rect
+     *
+     * Segments between the first and the last one intersecting rect are included as well, so the
+     * range can be drawn as a single polyline.
+     */
+    std::vector<EdgeRange> edgesIn(const QRectF &rect);
+
+private:
+    struct BlockItem
+    {
+        ut64 entry;
+        QRect rect;
+    };
+
+    struct EdgeItem
+    {
+        ut64 block;
+        int edge;
+    };
+
+    struct SegmentItem
+    {
+        quint32 edge;
+        int segment;
+        QRectF rect;
+    };
+
+    /**
+     * Items of every cell in one array, the items of cell i are at [cellStart[i], cellStart[i+1])
+     */
+    struct Grid
+    {
+        std::vector<quint32> cellStart;
+        std::vector<quint32> items;
+    };
+
+    QRectF bounds;
+    qreal cellSize = 1;
+    int columns = 0;
+    int rows = 0;
+
+    std::vector<BlockItem> blockItems;
+    std::vector<EdgeItem> edgeItems;
+    std::vector<SegmentItem> segmentItems;
+    Grid blockGrid;
+    Grid segmentGrid;
+
+    /**
+     * Query generation at which an item was last seen, to report every item once
+     */
+    std::vector<quint32> blockSeen;
+    std::vector<quint32> edgeSeen;
+    std::vector<quint32> edgeSlot;
+    quint32 generation = 0;
+
+    bool cellRange(const QRectF &rect, int &left, int &top, int &right, int &bottom) const;
+    template<typename Item>
+    void fillGrid(Grid &grid, const std::vector<Item> &items);
+    quint32 nextGeneration();
+};
+
+#endif // GRAPHSPATIALINDEX_H
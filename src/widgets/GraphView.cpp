@@ -6,13 +6,28 @@
 #endif
 #include "GraphHorizontalAdapter.h"
 #include "Helpers.h"
+#include "common/ParallelFor.h"
 
+#include <atomic>
+#include <cmath>
 #include <vector>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFrame>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QTimer>
+#include <QFile>
+#include <QFileInfo>
 #include <QPainter>
 #include <QMouseEvent>
 #include <QKeyEvent>
 #include <QPropertyAnimation>
+#include <QPointer>
+#include <QRunnable>
 #include <QSvgGenerator>
+#include <QThreadPool>
 
 #ifndef CUTTER_NO_OPENGL_GRAPH
 #    include <QOpenGLContext>
@@ -41,10 +56,95 @@ GraphView::GraphView(QWidget *parent)
     setGraphLayout(makeGraphLayout(Layout::GridMedium));
 }
 
-GraphView::~GraphView() {}
+GraphView::~GraphView()
+{
+    cancelGraphPlacement();
+}
+
+/**
+ * @brief Runs a layout on its own copy of the graph and of the layout object
+ *
+ * Jobs don't use the AsyncTaskManager of the session. Graphviz cannot be interrupted, so an
+ * abandoned layout may keep going for minutes and must not hold a pool thread that other tasks
+ * of the session wait for. They run on a pool of their own instead, see layoutPool().
+ */
+class GraphLayoutJob : public QObject
+{
+public:
+    GraphLayoutJob(std::unique_ptr<GraphLayout> layout, GraphLayout::Graph graph, ut64 entry)
+        : layout(std::move(layout)), graph(std::move(graph)), entry(entry)
+    {
+    }
+
+    std::unique_ptr<GraphLayout> layout;
+    GraphLayout::Graph graph;
+    ut64 entry;
+    int width = 0;
+    int height = 0;
+    std::atomic<bool> cancelled { false };
+    /**
+     * Only accessed on the GUI thread
+     */
+    QPointer<GraphView> view;
+
+    static void start(QSharedPointer<GraphLayoutJob> job) { layoutPool()->start(new Runner(job)); }
+
+private:
+    class Runner : public QRunnable
+    {
+    public:
+        explicit Runner(QSharedPointer<GraphLayoutJob> job) : job(std::move(job)) {}
+
+        void run() override
+        {
+            // Canceled jobs queued behind a long one leave without running
+            if (!job->cancelled) {
+                job->layout->CalculateLayout(job->graph, job->entry, job->width, job->height);
+            }
+            QSharedPointer<GraphLayoutJob> finished = job;
+            QMetaObject::invokeMethod(
+                    finished.data(),
+                    [finished]() {
+                        if (finished->view) {
+                            finished->view->layoutTaskFinished(finished.data());
+                        }
+                    },
+                    Qt::QueuedConnection);
+        }
+
+    private:
+        QSharedPointer<GraphLayoutJob> job;
+    };
+
+    /**
+     * @brief Single thread shared by all graph views, Graphviz keeps global state and runs one
+     * layout at a time anyway.
+     *
+     * The pool belongs to the application. Queued layouts are dropped when it quits, and its
+     * destruction waits for a running one, so no layout is left running during static
+     * destruction.
+     */
+    static QThreadPool *layoutPool()
+    {
+        static QPointer<QThreadPool> pool;
+        if (!pool) {
+            pool = new QThreadPool(QCoreApplication::instance());
+            pool->setMaxThreadCount(1);
+            QObject::connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, pool,
+                             []() { pool->clear(); });
+        }
+        return pool;
+    }
+};
 
 // Callbacks
 
+void GraphView::prepareFrame(QPainter &p, bool interactive)
+{
+    Q_UNUSED(p);
+    Q_UNUSED(interactive);
+}
+
 void GraphView::blockClicked(GraphView::GraphBlock &block, QMouseEvent *event, QPoint pos)
 {
     Q_UNUSED(block);
@@ -129,12 +229,136 @@ void GraphView::contextMenuEvent(QContextMenuEvent *event)
 
 void GraphView::computeGraphPlacement()
 {
-    graphLayoutSystem->CalculateLayout(blocks, entry, width, height);
+    cancelGraphPlacement();
+    if (!graphLayoutSystem->runsInBackground() || blocks.empty()) {
+        graphLayoutSystem->CalculateLayout(blocks, entry, width, height);
+        fallbackPlacementShown = false;
+        placementUpdated();
+        return;
+    }
+
+    if (placementStale) {
+        placeWithFallbackLayout();
+    }
+    // The job may outlive the view and finish on the pool, deleteLater() is safe from there
+    layoutTask = QSharedPointer<GraphLayoutJob>(
+            new GraphLayoutJob(graphLayoutSystem->clone(), blocks, entry), &QObject::deleteLater);
+    layoutTask->view = this;
+    GraphLayoutJob::start(layoutTask);
+
+    if (!layoutBudgetTimer) {
+        layoutBudgetTimer = new QTimer(this);
+        layoutBudgetTimer->setSingleShot(true);
+        connect(layoutBudgetTimer, &QTimer::timeout, this, &GraphView::layoutBudgetExceeded);
+    }
+    layoutBudgetTimer->start(LayoutTimeBudget);
+    setLayoutProgressVisible(true);
+}
+
+void GraphView::cancelGraphPlacement()
+{
+    if (layoutBudgetTimer) {
+        layoutBudgetTimer->stop();
+    }
+    if (layoutTask) {
+        // The job owns copies of everything it uses. If it is running, it is left to finish.
+        layoutTask->cancelled = true;
+        layoutTask.clear();
+    }
+    setLayoutProgressVisible(false);
+}
+
+void GraphView::placementUpdated()
+{
+    placementStale = false;
+    spatialIndex.build(blocks);
+    spatialIndexDirty = false;
     setCacheDirty();
     clampViewOffset();
     viewport()->update();
 }
 
+void GraphView::placeWithFallbackLayout()
+{
+    GraphGridLayout fallback(GraphGridLayout::LayoutType::Medium);
+    fallback.setLayoutConfig(graphLayoutSystem->getLayoutConfig());
+    fallback.CalculateLayout(blocks, entry, width, height);
+    fallbackPlacementShown = true;
+    placementUpdated();
+}
+
+void GraphView::layoutTaskFinished(GraphLayoutJob *job)
+{
+    if (!layoutTask || job != layoutTask.data()) {
+        return;
+    }
+    QSharedPointer<GraphLayoutJob> task = layoutTask;
+    layoutTask.clear();
+    layoutBudgetTimer->stop();
+    setLayoutProgressVisible(false);
+
+    // Blocks are not supposed to change without a new placement, but never apply a layout made
+    // for a different graph
+    bool matches = task->graph.size() == blocks.size();
+    for (auto it = task->graph.begin(); matches && it != task->graph.end(); ++it) {
+        auto block = blocks.find(it->first);
+        matches = block != blocks.end() && block->second.width == it->second.width
+                && block->second.height == it->second.height;
+    }
+    if (!matches) {
+        return;
+    }
+    for (auto &it : task->graph) {
+        GraphBlock &block = blocks[it.first];
+        block.x = it.second.x;
+        block.y = it.second.y;
+        block.edges = std::move(it.second.edges);
+    }
+    width = task->width;
+    height = task->height;
+    fallbackPlacementShown = false;
+    placementUpdated();
+    emit placementFinished();
+}
+
+void GraphView::layoutBudgetExceeded()
+{
+    if (!layoutTask) {
+        return;
+    }
+    qWarning() << tr("Graph layout did not finish within %1 seconds, using the grid layout")
+                          .arg(LayoutTimeBudget / 1000);
+    cancelGraphPlacement();
+    if (!fallbackPlacementShown) {
+        placeWithFallbackLayout();
+    }
+    emit placementFinished();
+}
+
+void GraphView::setLayoutProgressVisible(bool visible)
+{
+    if (!layoutProgress) {
+        if (!visible) {
+            return;
+        }
+        auto frame = new QFrame(this);
+        frame->setFrameShape(QFrame::StyledPanel);
+        frame->setAutoFillBackground(true);
+        auto layout = new QHBoxLayout(frame);
+        layout->addWidget(new QLabel(tr("Computing layout..."), frame));
+        auto cancelButton = new QPushButton(tr("Cancel"), frame);
+        connect(cancelButton, &QPushButton::clicked, this, &GraphView::cancelGraphPlacement);
+        layout->addWidget(cancelButton);
+        frame->adjustSize();
+        frame->move(8, 8);
+        layoutProgress = frame;
+    }
+    layoutProgress->setVisible(visible);
+    if (visible) {
+        layoutProgress->raise();
+    }
+}
+
 void GraphView::cleanupEdges(GraphLayout::Graph &graph)
 {
     for (auto &blockIt : graph) {
@@ -335,81 +559,83 @@ void GraphView::paint(QPainter &p, QPoint offset, QRect viewport, qreal scale, b
     p.setWindow(window);
     QRectF windowF(window.x(), window.y(), window.width(), window.height());
 
-    for (auto &blockIt : blocks) {
-        GraphBlock &block = blockIt.second;
-
-        QRectF blockRect(block.x, block.y, block.width, block.height);
-
-        // Check if block is visible by checking if block intersects with view area
-        if (blockRect.intersects(windowF)) {
-            drawBlock(p, block, interactive);
+    prepareFrame(p, interactive);
+    updateSpatialIndex();
+    for (ut64 entry : spatialIndex.blocksIn(windowF)) {
+        auto blockIt = blocks.find(entry);
+        if (blockIt != blocks.end()) {
+            drawBlock(p, blockIt->second, interactive);
         }
+    }
 
-        p.setBrush(Qt::gray);
-
-        // Always draw edges
-        // TODO: Only draw edges if they are actually visible ...
-        // Draw edges
-        for (GraphEdge &edge : block.edges) {
-            if (edge.polyline.empty()) {
-                continue;
-            }
-            QPolygonF polyline = edge.polyline;
-            EdgeConfiguration ec = edgeConfiguration(block, &blocks[edge.target], interactive);
-            QPen pen(ec.color);
-            pen.setStyle(ec.lineStyle);
-            pen.setWidthF(pen.width() * ec.width_scale);
-            if (scale_thickness_multiplier && ec.width_scale > 1.01 && pen.widthF() * scale < 2) {
-                pen.setWidthF(ec.width_scale / scale);
-            }
-            if (pen.widthF() * scale < 2) {
-                pen.setWidth(0);
-            }
-            p.setPen(pen);
-            p.setBrush(ec.color);
-            p.drawPolyline(polyline);
-            pen.setStyle(Qt::SolidLine);
+    // Only the part of an edge between its first and last visible segment is drawn, the margin
+    // keeps arrows and wide pens of segments just outside the window
+    const qreal edgeMargin = 10 / scale;
+    const QRectF edgeWindow = windowF.adjusted(-edgeMargin, -edgeMargin, edgeMargin, edgeMargin);
+    for (const GraphSpatialIndex::EdgeRange &range : spatialIndex.edgesIn(edgeWindow)) {
+        auto blockIt = blocks.find(range.block);
+        if (blockIt == blocks.end() || range.edge >= int(blockIt->second.edges.size())) {
+            continue;
+        }
+        GraphBlock &block = blockIt->second;
+        GraphEdge &edge = block.edges[range.edge];
+        if (range.lastSegment + 1 >= edge.polyline.size()) {
+            continue;
+        }
+        QPolygonF polyline =
+                edge.polyline.mid(range.firstSegment, range.lastSegment - range.firstSegment + 2);
+        EdgeConfiguration ec = edgeConfiguration(block, &blocks[edge.target], interactive);
+        QPen pen(ec.color);
+        pen.setStyle(ec.lineStyle);
+        pen.setWidthF(pen.width() * ec.width_scale);
+        if (scale_thickness_multiplier && ec.width_scale > 1.01 && pen.widthF() * scale < 2) {
+            pen.setWidthF(ec.width_scale / scale);
+        }
+        if (pen.widthF() * scale < 2) {
+            pen.setWidth(0);
+        }
+        p.setPen(pen);
+        p.setBrush(ec.color);
+        p.drawPolyline(polyline);
+        pen.setStyle(Qt::SolidLine);
+        p.setPen(pen);
+
+        auto drawArrow = [&](QPointF tip, QPointF dir) {
+            pen.setWidth(0);
             p.setPen(pen);
-
-            auto drawArrow = [&](QPointF tip, QPointF dir) {
-                pen.setWidth(0);
-                p.setPen(pen);
-                QPolygonF arrow;
-                arrow << tip;
-                QPointF dy(-dir.y(), dir.x());
-                QPointF base = tip - dir * 6;
-                arrow << base + 3 * dy;
-                arrow << base - 3 * dy;
-                p.drawConvexPolygon(arrow);
-            };
-
-            if (!polyline.empty()) {
-                if (ec.start_arrow) {
-                    auto firstPt = edge.polyline.first();
-                    drawArrow(firstPt, QPointF(0, 1));
-                }
-                if (ec.end_arrow) {
-                    auto lastPt = edge.polyline.last();
-                    QPointF dir(0, -1);
-                    switch (edge.arrow) {
-                    case GraphLayout::GraphEdge::Down:
-                        dir = QPointF(0, 1);
-                        break;
-                    case GraphLayout::GraphEdge::Up:
-                        dir = QPointF(0, -1);
-                        break;
-                    case GraphLayout::GraphEdge::Left:
-                        dir = QPointF(-1, 0);
-                        break;
-                    case GraphLayout::GraphEdge::Right:
-                        dir = QPointF(1, 0);
-                        break;
-                    default:
-                        break;
-                    }
-                    drawArrow(lastPt, dir);
-                }
+            QPolygonF arrow;
+            arrow << tip;
+            QPointF dy(-dir.y(), dir.x());
+            QPointF base = tip - dir * 6;
+            arrow << base + 3 * dy;
+            arrow << base - 3 * dy;
+            p.drawConvexPolygon(arrow);
+        };
+
+        if (ec.start_arrow && range.firstSegment == 0) {
+            auto firstPt = edge.polyline.first();
+            drawArrow(firstPt, QPointF(0, 1));
+        }
+        if (ec.end_arrow && range.lastSegment + 2 == edge.polyline.size()) {
+            auto lastPt = edge.polyline.last();
+            QPointF dir(0, -1);
+            switch (edge.arrow) {
+            case GraphLayout::GraphEdge::Down:
+                dir = QPointF(0, 1);
+                break;
+            case GraphLayout::GraphEdge::Up:
+                dir = QPointF(0, -1);
+                break;
+            case GraphLayout::GraphEdge::Left:
+                dir = QPointF(-1, 0);
+                break;
+            case GraphLayout::GraphEdge::Right:
+                dir = QPointF(1, 0);
+                break;
+            default:
+                break;
             }
+            drawArrow(lastPt, dir);
         }
     }
 }
@@ -444,6 +670,107 @@ void GraphView::saveAsSvg(QString path)
     p.end();
 }
 
+bool GraphView::saveAsTiles(QString path, double scaler, bool transparent,
+                            const std::function<bool(int, int)> &progress)
+{
+    const int tileSize = 256;
+    const qint64 fullWidth = std::max<qint64>(1, static_cast<qint64>(std::ceil(width * scaler)));
+    const qint64 fullHeight = std::max<qint64>(1, static_cast<qint64>(std::ceil(height * scaler)));
+    int maxLevel = 0;
+    while ((qint64(1) << maxLevel) < std::max(fullWidth, fullHeight)) {
+        maxLevel++;
+    }
+
+    QFile descriptor(path);
+    if (!descriptor.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Could not save image";
+        return false;
+    }
+    descriptor.write(QString("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                             "<Image xmlns=\"http://schemas.microsoft.com/deepzoom/2008\" "
+                             "Format=\"png\" Overlap=\"0\" TileSize=\"%1\">\n"
+                             "  <Size Width=\"%2\" Height=\"%3\"/>\n"
+                             "</Image>\n")
+                             .arg(tileSize)
+                             .arg(fullWidth)
+                             .arg(fullHeight)
+                             .toUtf8());
+    descriptor.close();
+
+    // Level 0 is a single pixel, every following level doubles the size up to the full one
+    struct Tile
+    {
+        int level;
+        int column;
+        int row;
+        QSize size;
+    };
+    std::vector<Tile> tiles;
+    QFileInfo info(path);
+    QDir filesDir(info.dir().filePath(info.completeBaseName() + "_files"));
+    for (int level = 0; level <= maxLevel; level++) {
+        const int shift = maxLevel - level;
+        const qint64 levelWidth = (fullWidth + (qint64(1) << shift) - 1) >> shift;
+        const qint64 levelHeight = (fullHeight + (qint64(1) << shift) - 1) >> shift;
+        if (!filesDir.mkpath(QString::number(level))) {
+            qWarning() << "Could not create directory for image tiles";
+            return false;
+        }
+        for (qint64 row = 0; row * tileSize < levelHeight; row++) {
+            for (qint64 column = 0; column * tileSize < levelWidth; column++) {
+                QSize size(static_cast<int>(std::min<qint64>(tileSize,
+                                                             levelWidth - column * tileSize)),
+                           static_cast<int>(std::min<qint64>(tileSize,
+                                                             levelHeight - row * tileSize)));
+                tiles.push_back({ level, static_cast<int>(column), static_cast<int>(row), size });
+            }
+        }
+    }
+
+    // Painting goes through the view and has to stay on this thread, encoding is what takes time
+    const int batchSize = 2 * std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    const int total = static_cast<int>(tiles.size());
+    std::vector<QImage> images(batchSize);
+    std::atomic<bool> failed(false);
+    for (int first = 0; first < total; first += batchSize) {
+        const int count = std::min(batchSize, total - first);
+        for (int i = 0; i < count; i++) {
+            const Tile &tile = tiles[first + i];
+            const qreal levelScale = scaler / qreal(qint64(1) << (maxLevel - tile.level));
+            QImage &image = images[i];
+            image = QImage(tile.size, QImage::Format_ARGB32);
+            if (transparent) {
+                image.fill(qRgba(0, 0, 0, 0));
+            } else {
+                image.fill(backgroundColor);
+            }
+            QPainter p(&image);
+            QPoint tileOffset(qRound(tile.column * tileSize / levelScale),
+                              qRound(tile.row * tileSize / levelScale));
+            paint(p, tileOffset, image.rect(), levelScale, false);
+        }
+        parallelFor(
+                count,
+                [&](int i) {
+                    const Tile &tile = tiles[first + i];
+                    QString name = QString("%1/%2_%3.png").arg(tile.level).arg(tile.column).arg(
+                            tile.row);
+                    if (!images[i].save(filesDir.filePath(name), "png")) {
+                        failed = true;
+                    }
+                },
+                1);
+        if (failed) {
+            qWarning() << "Could not save image";
+            return false;
+        }
+        if (progress && !progress(first + count, total)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void GraphView::center()
 {
     centerX(false);
@@ -508,16 +835,26 @@ void GraphView::showRectangle(const QRect &block, bool anywhere)
 
 GraphView::GraphBlock *GraphView::getBlockContaining(QPoint p)
 {
-    // Check if a block was clicked
-    for (auto &blockIt : blocks) {
-        GraphBlock &block = blockIt.second;
+    updateSpatialIndex();
+    ut64 entry;
+    if (!spatialIndex.blockAt(p, entry)) {
+        return nullptr;
+    }
+    auto blockIt = blocks.find(entry);
+    if (blockIt == blocks.end()) {
+        return nullptr;
+    }
+    GraphBlock &block = blockIt->second;
+    QRect rec(block.x, block.y, block.width, block.height);
+    return rec.contains(p) ? &block : nullptr;
+}
 
-        QRect rec(block.x, block.y, block.width, block.height);
-        if (rec.contains(p)) {
-            return &block;
-        }
+void GraphView::updateSpatialIndex()
+{
+    if (spatialIndexDirty) {
+        spatialIndex.build(blocks);
+        spatialIndexDirty = false;
     }
-    return nullptr;
 }
 
 QPoint GraphView::viewToLogicalCoordinates(QPoint p)
@@ -532,6 +869,7 @@ QPoint GraphView::logicalToViewCoordinates(QPoint p)
 
 void GraphView::setGraphLayout(std::unique_ptr<GraphLayout> layout)
 {
+    cancelGraphPlacement();
     graphLayoutSystem = std::move(layout);
     if (!graphLayoutSystem) {
         graphLayoutSystem = makeGraphLayout(Layout::GridMedium);
@@ -612,6 +950,8 @@ std::unique_ptr<GraphLayout> GraphView::makeGraphLayout(GraphView::Layout layout
 void GraphView::addBlock(GraphView::GraphBlock block)
 {
     blocks[block.entry] = block;
+    spatialIndexDirty = true;
+    placementStale = true;
 }
 
 void GraphView::setEntry(ut64 e)
@@ -651,24 +991,29 @@ void GraphView::mousePressEvent(QMouseEvent *event)
 
     // Check if a line beginning/end  was clicked
     if (event->button() == Qt::LeftButton) {
-        for (auto &blockIt : blocks) {
-            GraphBlock &block = blockIt.second;
-            for (GraphEdge &edge : block.edges) {
-                if (edge.polyline.length() < 2) {
-                    continue;
-                }
-                QPointF start = edge.polyline.first();
-                QPointF end = edge.polyline.last();
-                if (checkPointClicked(start, pos.x(), pos.y())) {
-                    showBlock(blocks[edge.target]);
-                    // TODO: Callback to child
-                    return;
-                }
-                if (checkPointClicked(end, pos.x(), pos.y(), true)) {
-                    showBlock(block);
-                    // TODO: Callback to child
-                    return;
-                }
+        updateSpatialIndex();
+        const QRectF target(pos.x() - 15, pos.y() - 15, 30, 30);
+        for (const GraphSpatialIndex::EdgeRange &range : spatialIndex.edgesIn(target)) {
+            auto blockIt = blocks.find(range.block);
+            if (blockIt == blocks.end() || range.edge >= int(blockIt->second.edges.size())) {
+                continue;
+            }
+            GraphBlock &block = blockIt->second;
+            GraphEdge &edge = block.edges[range.edge];
+            if (edge.polyline.length() < 2) {
+                continue;
+            }
+            QPointF start = edge.polyline.first();
+            QPointF end = edge.polyline.last();
+            if (checkPointClicked(start, pos.x(), pos.y())) {
+                showBlock(blocks[edge.target]);
+                // TODO: Callback to child
+                return;
+            }
+            if (checkPointClicked(end, pos.x(), pos.y(), true)) {
+                showBlock(block);
+                // TODO: Callback to child
+                return;
             }
         }
     }
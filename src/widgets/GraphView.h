@@ -13,10 +13,13 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <queue>
+#include <functional>
 #include <memory>
+#include <QSharedPointer>
 
 #include "core/Cutter.h"
 #include "widgets/GraphLayout.h"
+#include "widgets/GraphSpatialIndex.h"
 
 #if defined(QT_NO_OPENGL) || QT_VERSION < QT_VERSION_CHECK(5, 6, 0)
 // QOpenGLExtraFunctions were introduced in 5.6
@@ -27,6 +30,9 @@
 class QOpenGLWidget;
 #endif
 
+class QTimer;
+class GraphLayoutJob;
+
 class GraphView : public QAbstractScrollArea
 {
     Q_OBJECT
@@ -34,6 +40,11 @@ class GraphView : public QAbstractScrollArea
 signals:
     void viewOffsetChanged(QPoint offset);
     void viewScaleChanged(qreal scale);
+    /**
+     * @brief A layout computed in the background has been applied, or replaced by the fallback
+     * layout because it took too long
+     */
+    void placementFinished();
 
 public:
     using GraphBlock = GraphLayout::GraphBlock;
@@ -100,8 +111,33 @@ public:
     void saveAsBitmap(QString path, const char *format = nullptr, double scaler = 1.0,
                       bool transparent = false);
     void saveAsSvg(QString path);
+    /**
+     * @brief Save the graph as a Deep Zoom image pyramid for web based viewers
+     *
+     * Writes the descriptor to path and the tiles of every zoom level to the "_files" directory
+     * next to it. Tiles are rendered a few at a time and encoded on all cores, so memory use does
+     * not depend on the size of the graph.
+     * @param scaler scale of the most detailed level
+     * @param progress called with the number of tiles written and the total, returning false
+     * cancels the export
+     * @return false if the export failed or was canceled
+     */
+    bool saveAsTiles(QString path, double scaler = 1.0, bool transparent = false,
+                     const std::function<bool(int, int)> &progress = nullptr);
 
+    /**
+     * @brief Lay out the blocks with the current layout
+     *
+     * Layouts which can be slow are computed on a thread of their own. Until they finish the
+     * previous placement stays visible, or a grid placement if blocks were added since, and
+     * placementFinished() is emitted once the result is in.
+     */
     void computeGraphPlacement();
+    /**
+     * @brief Stop waiting for a layout running in the background and keep the current placement
+     */
+    void cancelGraphPlacement();
+    bool isPlacementRunning() const { return !layoutTask.isNull(); }
 
     /**
      * @brief Remove duplicate edges and edges without target in graph.
@@ -123,6 +159,15 @@ protected:
     void setEntry(ut64 e);
 
     // Callbacks that should be overridden
+    /**
+     * @brief Called once per paint before any block is drawn
+     *
+     * Override to capture state which is the same for all blocks of the frame, such as colors or
+     * the level of detail for the current scale, instead of querying it in drawBlock.
+     * @param p painter with the window of the frame already set up
+     * @param interactive - same as for drawBlock
+     */
+    virtual void prepareFrame(QPainter &p, bool interactive);
     /**
      * @brief drawBlock
      * @param p painter object, not necesarily current widget
@@ -189,6 +234,34 @@ private:
 
     std::unique_ptr<GraphLayout> graphLayoutSystem;
 
+    /**
+     * Time after which a background layout is abandoned in favor of the grid layout
+     */
+    static constexpr int LayoutTimeBudget = 15000;
+
+    QSharedPointer<GraphLayoutJob> layoutTask;
+    QTimer *layoutBudgetTimer = nullptr;
+    QWidget *layoutProgress = nullptr;
+    /**
+     * Blocks were added since the last placement, their positions are meaningless
+     */
+    bool placementStale = true;
+    bool fallbackPlacementShown = false;
+
+    void placementUpdated();
+    void placeWithFallbackLayout();
+    friend class GraphLayoutJob;
+    void layoutTaskFinished(GraphLayoutJob *job);
+    void layoutBudgetExceeded();
+    void setLayoutProgressVisible(bool visible);
+
+    /**
+     * @brief Blocks and edges by position, rebuilt after layout and when blocks are added
+     */
+    GraphSpatialIndex spatialIndex;
+    bool spatialIndexDirty = true;
+    void updateSpatialIndex();
+
     QPoint scrollBase;
     bool scroll_mode = false;
 
@@ -8,6 +8,7 @@
 #include <sstream>
 #include <iomanip>
 #include <set>
+#include <mutex>
 
 #include <gvc.h>
 
@@ -85,6 +86,11 @@ static std::set<std::pair<ut64, ut64>> SelectLoopEdges(const GraphLayout::Graph
 void GraphvizLayout::CalculateLayout(std::unordered_map<ut64, GraphBlock> &blocks, ut64 entry,
                                      int &width, int &height) const
 {
+    // Layouts run on worker threads and graphviz keeps global state, only one at a time. The mutex
+    // is never destroyed because an abandoned layout may still hold it when the process exits.
+    static std::mutex *graphvizMutex = new std::mutex;
+    std::lock_guard<std::mutex> lock(*graphvizMutex);
+
     // https://gitlab.com/graphviz/graphviz/issues/1441
 #define STR(v) const_cast<char *>(v)
 
@@ -19,6 +19,11 @@ public:
     GraphvizLayout(LayoutType layoutType, Direction direction = Direction::TB);
     virtual void CalculateLayout(std::unordered_map<ut64, GraphBlock> &blocks, ut64 entry,
                                  int &width, int &height) const override;
+    std::unique_ptr<GraphLayout> clone() const override
+    {
+        return std::unique_ptr<GraphLayout>(new GraphvizLayout(*this));
+    }
+    bool runsInBackground() const override { return true; }
 
 private:
     Direction direction;
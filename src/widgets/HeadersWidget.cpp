@@ -115,9 +115,14 @@ bool HeadersProxyModel::lessThan(const QModelIndex &left, const QModelIndex &rig
     return leftHeader.vaddr < rightHeader.vaddr;
 }
 
+QString HeadersWidget::getDockTitle()
+{
+    return tr("Headers");
+}
+
 HeadersWidget::HeadersWidget(MainWindow *main) : ListDockWidget(main)
 {
-    setWindowTitle(tr("Headers"));
+    setWindowTitle(getDockTitle());
     setObjectName("HeadersWidget");
 
     headersModel = new HeadersModel(&headers, this);
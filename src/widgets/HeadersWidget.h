@@ -64,6 +64,11 @@ class HeadersWidget : public ListDockWidget
 
 public:
     explicit HeadersWidget(MainWindow *main);
+
+    /**
+     * @brief Title of the dock, also shown before it is constructed
+     */
+    static QString getDockTitle();
     ~HeadersWidget();
 
 private slots:
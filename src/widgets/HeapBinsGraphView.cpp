@@ -35,26 +35,30 @@ void HeapBinsGraphView::loadCurrentGraph()
     bool singleLinkedBin = QString(heapBin->type) == QString("Fast")
             || QString(heapBin->type) == QString("Tcache");
 
-    // store info about the chunks in a vector for easy access
-    CutterRzListForeach (heapBin->chunks, iter, RzHeapChunkListItem, item) {
-        GraphHeapChunk graphHeapChunk;
-        graphHeapChunk.addr = item->addr;
-        RzHeapChunkSimple *chunkInfo = Core()->getHeapChunk(item->addr);
-        if (!chunkInfo) {
-            break;
-        }
-        QString content = "Chunk @ " + RzAddressString(chunkInfo->addr) + "\nSize: "
-                + RzHexString(chunkInfo->size) + "\nFd: " + RzAddressString(chunkInfo->fd);
+    // store info about the chunks in a vector for easy access, all chunks are read under a
+    // single lock instead of one per chunk
+    {
+        RzCoreLocked core(Core());
+        CutterRzListForeach (heapBin->chunks, iter, RzHeapChunkListItem, item) {
+            GraphHeapChunk graphHeapChunk;
+            graphHeapChunk.addr = item->addr;
+            RzHeapChunkSimple *chunkInfo = rz_heap_chunk(core, item->addr);
+            if (!chunkInfo) {
+                break;
+            }
+            QString content = "Chunk @ " + RzAddressString(chunkInfo->addr) + "\nSize: "
+                    + RzHexString(chunkInfo->size) + "\nFd: " + RzAddressString(chunkInfo->fd);
 
-        // fastbins lack bk pointer
-        if (!singleLinkedBin) {
-            content += "\nBk: " + RzAddressString(chunkInfo->bk);
+            // fastbins lack bk pointer
+            if (!singleLinkedBin) {
+                content += "\nBk: " + RzAddressString(chunkInfo->bk);
+            }
+            graphHeapChunk.fd = chunkInfo->fd;
+            graphHeapChunk.bk = chunkInfo->bk;
+            graphHeapChunk.content = content;
+            chunks.append(graphHeapChunk);
+            free(chunkInfo);
         }
-        graphHeapChunk.fd = chunkInfo->fd;
-        graphHeapChunk.bk = chunkInfo->bk;
-        graphHeapChunk.content = content;
-        chunks.append(graphHeapChunk);
-        free(chunkInfo);
     }
 
     // fast and tcache bins have single linked list and other bins have double linked list
@@ -2,10 +2,16 @@
 #include "ui_HeapDockWidget.h"
 #include "widgets/GlibcHeapWidget.h"
 
+QString HeapDockWidget::getDockTitle()
+{
+    return tr("Heap");
+}
+
 HeapDockWidget::HeapDockWidget(MainWindow *main)
     : CutterDockWidget(main), ui(new Ui::HeapDockWidget), main(main)
 {
     ui->setupUi(this);
+    setWindowTitle(getDockTitle());
 
     ui->allocatorSelector->addItem("Glibc Heap");
     ui->verticalLayout->setContentsMargins(0, 0, 0, 0);
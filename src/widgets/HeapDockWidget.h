@@ -14,6 +14,11 @@ class HeapDockWidget : public CutterDockWidget
 
 public:
     explicit HeapDockWidget(MainWindow *main);
+
+    /**
+     * @brief Title of the dock, also shown before it is constructed
+     */
+    static QString getDockTitle();
     ~HeapDockWidget();
 private slots:
     void onAllocatorSelected(int index);
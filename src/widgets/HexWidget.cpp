@@ -303,6 +303,20 @@ void HexWidget::setItemGroupSize(int size)
  */
 bool HexWidget::isItemDifferentAt(uint64_t address)
 {
+    if (referenceData) {
+        uint64_t offset = address - startAddress;
+        uint64_t screenSize = static_cast<uint64_t>(screenBytes.size());
+        if (address < startAddress || offset + static_cast<uint64_t>(itemByteLen) > screenSize) {
+            return false;
+        }
+        if (!differingChunks[offset / DiffChunkSize]
+            && !differingChunks[(offset + itemByteLen - 1) / DiffChunkSize]) {
+            return false;
+        }
+        return memcmp(screenBytes.constData() + offset, referenceBytes.constData() + offset,
+                      static_cast<size_t>(itemByteLen))
+                != 0;
+    }
     char oldItem[sizeof(uint64_t)] = {};
     char newItem[sizeof(uint64_t)] = {};
     if (data->copy(newItem, address, static_cast<size_t>(itemByteLen))
@@ -2439,6 +2453,50 @@ void HexWidget::fetchData()
 {
     data.swap(oldData);
     data->fetch(startAddress, bytesPerScreen());
+    if (referenceData) {
+        referenceData->fetch(startAddress + referenceDelta, bytesPerScreen());
+        updateReferenceDiff();
+    }
+}
+
+void HexWidget::updateReferenceDiff()
+{
+    const int len = bytesPerScreen();
+    screenBytes.resize(len);
+    referenceBytes.resize(len);
+    data->copy(screenBytes.data(), startAddress, static_cast<size_t>(len));
+    referenceData->copy(referenceBytes.data(), startAddress + referenceDelta,
+                        static_cast<size_t>(len));
+
+    // Most of the screen is usually equal, memcmp of whole chunks is vectorized and leaves only
+    // the differing chunks to be compared item by item while painting.
+    differingChunks.assign((len + DiffChunkSize - 1) / DiffChunkSize, false);
+    if (memcmp(screenBytes.constData(), referenceBytes.constData(), len) == 0) {
+        return;
+    }
+    for (int chunk = 0; chunk * DiffChunkSize < len; chunk++) {
+        int offset = chunk * DiffChunkSize;
+        differingChunks[chunk] = memcmp(screenBytes.constData() + offset,
+                                        referenceBytes.constData() + offset,
+                                        std::min(DiffChunkSize, len - offset))
+                != 0;
+    }
+}
+
+void HexWidget::setSession(CutterCore *session)
+{
+    this->session = session;
+    setProperty("cutterSession", QVariant::fromValue<QObject *>(session));
+    data.reset(new MemoryData(session));
+    oldData.reset(new MemoryData(session));
+    refresh();
+}
+
+void HexWidget::setDiffReference(CutterCore *session, int64_t delta)
+{
+    referenceData.reset(session ? new MemoryData(session) : nullptr);
+    referenceDelta = delta;
+    refresh();
 }
 
 BasicCursor HexWidget::screenPosToAddr(const QPoint &point, bool middle, int *wordOffset) const
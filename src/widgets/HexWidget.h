@@ -9,6 +9,7 @@
 #include <QTimer>
 #include <QMenu>
 #include <memory>
+#include <vector>
 
 struct BasicCursor
 {
@@ -140,7 +141,10 @@ private:
 class MemoryData : public AbstractData
 {
 public:
-    MemoryData() = default;
+    /**
+     * @param session session to read from, nullptr for the one Core() resolves to
+     */
+    explicit MemoryData(CutterCore *session = nullptr) : session(session) {}
     ~MemoryData() override = default;
     static constexpr size_t BLOCK_SIZE = 4096;
 
@@ -160,7 +164,7 @@ public:
         m_blocks.clear();
         uint64_t addr = alignedAddr;
         for (ut64 i = 0; i < len / blockSize; ++i, addr += blockSize) {
-            m_blocks.append(Core()->ioRead(addr, blockSize));
+            m_blocks.append(core()->ioRead(addr, blockSize));
         }
     }
 
@@ -219,10 +223,12 @@ public:
 
     bool write(const uint8_t *in, uint64_t adr, size_t len) override
     {
-        RzCoreLocked core(Core());
-        rz_core_write_at(core, adr, in, len);
+        {
+            RzCoreLocked locked(core());
+            rz_core_write_at(locked, adr, in, len);
+        }
         writeToCache(in, adr, len);
-        emit Core()->instructionChanged(adr);
+        emit core()->instructionChanged(adr, len);
         return true;
     }
 
@@ -231,6 +237,10 @@ public:
     uint64_t minIndex() override { return m_firstBlockAddr; }
 
 private:
+    CutterCore *session;
+
+    CutterCore *core() const { return session ? session : Core(); }
+
     QVector<QByteArray> m_blocks;
     uint64_t m_firstBlockAddr = 0;
     uint64_t m_lastValidAddr = 0;
@@ -355,6 +365,21 @@ public:
         RVA endAddress;
     };
     Selection getSelection();
+
+    /**
+     * @brief Show the memory of another session than the one of the window.
+     *
+     * Events of the widget are delivered inside a SessionScope of the session, so comments,
+     * flags and writes also apply to it.
+     */
+    void setSession(CutterCore *session);
+    /**
+     * @brief Highlight items which differ from the memory of another session instead of items
+     * changed since the last refresh.
+     * @param session session to compare with, nullptr to go back to highlighting changes
+     * @param delta added to addresses of this widget to get the address in session
+     */
+    void setDiffReference(CutterCore *session, int64_t delta);
 public slots:
     void seek(uint64_t address);
     void refresh();
@@ -419,6 +444,7 @@ private:
     void updateCursorMeta();
     void setCursorOnAscii(bool ascii);
     bool isItemDifferentAt(uint64_t address);
+    void updateReferenceDiff();
     QColor itemColor(uint8_t byte);
     QVariant readItem(int offset, QColor *color = nullptr);
     QString renderItem(int offset, QColor *color = nullptr);
@@ -584,6 +610,18 @@ private:
 
     std::unique_ptr<AbstractData> oldData;
     std::unique_ptr<AbstractData> data;
+    CutterCore *session = nullptr;
+
+    static constexpr int DiffChunkSize = 64;
+    std::unique_ptr<AbstractData> referenceData;
+    int64_t referenceDelta = 0;
+    QByteArray screenBytes;
+    QByteArray referenceBytes;
+    /**
+     * Whether screenBytes and referenceBytes differ somewhere in each chunk of DiffChunkSize
+     * bytes
+     */
+    std::vector<bool> differingChunks;
     IOModesController ioModesController;
 
     int editWordPos = 0;
@@ -5,6 +5,7 @@
 #include "common/Configuration.h"
 #include "common/TempConfig.h"
 #include "common/SyntaxHighlighter.h"
+#include "common/SelectionHashTask.h"
 #include "core/MainWindow.h"
 
 #include <QJsonObject>
@@ -54,6 +55,7 @@ HexdumpWidget::HexdumpWidget(MainWindow *main)
     ui->bytesSHA256->setPlaceholderText(placeholder);
     ui->bytesCRC32->setPlaceholderText(placeholder);
     ui->hexDisasTextEdit->setPlaceholderText(placeholder);
+    ui->hashProgressBar->hide();
 
     setupFonts();
 
@@ -75,6 +77,17 @@ HexdumpWidget::HexdumpWidget(MainWindow *main)
     this->ui->hexTextView->addAction(&syncAction);
 
     connect(Config(), &Configuration::fontsUpdated, this, &HexdumpWidget::fontsUpdated);
+
+    // Cached block hashes are only valid as long as memory doesn't change. These connections
+    // must come before the refreshes below, which hash the selection again.
+    hashCache = std::make_shared<SelectionHashCache>();
+    auto clearHashCache = [this]() { hashCache->clear(); };
+    connect(Core(), &CutterCore::refreshAll, this, clearHashCache);
+    connect(Core(), &CutterCore::instructionChanged, this, clearHashCache);
+    connect(Core(), &CutterCore::registersChanged, this, clearHashCache);
+    connect(Core(), &CutterCore::ioCacheChanged, this, clearHashCache);
+    connect(Core(), &CutterCore::ioModeChanged, this, clearHashCache);
+
     connect(Core(), &CutterCore::refreshAll, this, [this]() { refresh(); });
     connect(Core(), &CutterCore::refreshCodeViews, this, [this]() { refresh(); });
     connect(Core(), &CutterCore::instructionChanged, this, [this]() { refresh(); });
@@ -110,7 +123,10 @@ void HexdumpWidget::onSeekChanged(RVA addr)
     refresh(addr);
 }
 
-HexdumpWidget::~HexdumpWidget() {}
+HexdumpWidget::~HexdumpWidget()
+{
+    cancelSelectionHash();
+}
 
 QString HexdumpWidget::getWidgetType()
 {
@@ -196,6 +212,7 @@ void HexdumpWidget::fontsUpdated()
 
 void HexdumpWidget::clearParseWindow()
 {
+    cancelSelectionHash();
     ui->hexDisasTextEdit->setPlainText("");
     ui->bytesEntropy->setText("");
     ui->bytesMD5->setText("");
@@ -218,7 +235,7 @@ QString HexdumpWidget::getWindowTitle() const
     return tr("Hexdump");
 }
 
-void HexdumpWidget::updateParseWindow(RVA start_address, int size)
+void HexdumpWidget::updateParseWindow(RVA start_address, ut64 size)
 {
     if (!ui->hexSideTab_2->isVisible()) {
         return;
@@ -243,37 +260,67 @@ void HexdumpWidget::updateParseWindow(RVA start_address, int size)
                                       : "");
     } else {
         // Fill the information tab hashes and entropy
-        RzHashSize digest_size = 0;
-        RzCoreLocked core(Core());
-        ut64 old_offset = core->offset;
-        rz_core_seek(core, start_address, true);
-        ut8 *block = core->block;
-        char *digest = rz_hash_cfg_calculate_small_block_string(core->hash, "md5", block, size,
-                                                                &digest_size, false);
-        ui->bytesMD5->setText(QString(digest));
-        free(digest);
-        digest = rz_hash_cfg_calculate_small_block_string(core->hash, "sha1", block, size,
-                                                          &digest_size, false);
-        ui->bytesSHA1->setText(QString(digest));
-        free(digest);
-        digest = rz_hash_cfg_calculate_small_block_string(core->hash, "sha256", block, size,
-                                                          &digest_size, false);
-        ui->bytesSHA256->setText(QString(digest));
-        free(digest);
-        digest = rz_hash_cfg_calculate_small_block_string(core->hash, "crc32", block, size,
-                                                          &digest_size, false);
-        ui->bytesCRC32->setText(QString(digest));
-        free(digest);
-        digest = rz_hash_cfg_calculate_small_block_string(core->hash, "entropy", block, size,
-                                                          &digest_size, false);
-        ui->bytesEntropy->setText(QString(digest));
-        free(digest);
-        rz_core_seek(core, old_offset, true);
-        ui->bytesMD5->setCursorPosition(0);
-        ui->bytesSHA1->setCursorPosition(0);
-        ui->bytesSHA256->setCursorPosition(0);
-        ui->bytesCRC32->setCursorPosition(0);
+        startSelectionHash(start_address, size);
+    }
+}
+
+void HexdumpWidget::startSelectionHash(RVA start, ut64 size)
+{
+    cancelSelectionHash();
+
+    QLineEdit *const outputs[] = { ui->bytesMD5, ui->bytesSHA1, ui->bytesSHA256, ui->bytesCRC32,
+                                   ui->bytesEntropy };
+    for (QLineEdit *output : outputs) {
+        output->clear();
+    }
+    ui->hashProgressBar->setValue(0);
+    ui->hashProgressBar->show();
+
+    hashTask.reset(new SelectionHashTask(start, size, hashCache));
+    hashTask->setKey(QString("HexdumpWidget/%1").arg(reinterpret_cast<quintptr>(this)));
+
+    // Results of a task are ignored once a newer selection replaced it
+    SelectionHashTask *task = hashTask.data();
+    connect(task, &SelectionHashTask::progress, this, [this, task](int percent) {
+        if (hashTask.data() == task) {
+            ui->hashProgressBar->setValue(percent);
+        }
+    });
+    connect(task, &SelectionHashTask::partialResultReady, this,
+            [this, task](const QString &crc32, const QString &entropy) {
+                if (hashTask.data() != task) {
+                    return;
+                }
+                ui->bytesCRC32->setText(crc32);
+                ui->bytesEntropy->setText(entropy);
+            });
+    connect(task, &SelectionHashTask::resultReady, this,
+            [this, task](const SelectionHashTask::Result &result) {
+                if (hashTask.data() != task) {
+                    return;
+                }
+                ui->bytesMD5->setText(result.md5);
+                ui->bytesSHA1->setText(result.sha1);
+                ui->bytesSHA256->setText(result.sha256);
+                ui->bytesCRC32->setText(result.crc32);
+                ui->bytesEntropy->setText(result.entropy);
+                ui->bytesMD5->setCursorPosition(0);
+                ui->bytesSHA1->setCursorPosition(0);
+                ui->bytesSHA256->setCursorPosition(0);
+                ui->bytesCRC32->setCursorPosition(0);
+                ui->hashProgressBar->hide();
+                hashTask.clear();
+            });
+    Core()->getAsyncTaskManager()->start(hashTask);
+}
+
+void HexdumpWidget::cancelSelectionHash()
+{
+    if (hashTask) {
+        hashTask->interrupt();
+        hashTask.clear();
     }
+    ui->hashProgressBar->hide();
 }
 
 void HexdumpWidget::on_parseTypeComboBox_currentTextChanged(const QString &)
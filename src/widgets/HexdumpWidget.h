@@ -15,6 +15,7 @@
 #include "common/Highlighter.h"
 #include "common/SvgIconEngine.h"
 #include "HexWidget.h"
+#include "common/SelectionHashTask.h"
 
 #include "Dashboard.h"
 
@@ -50,6 +51,9 @@ private:
     RefreshDeferrer *refreshDeferrer;
     QSyntaxHighlighter *syntaxHighLighter;
 
+    std::shared_ptr<SelectionHashCache> hashCache;
+    QSharedPointer<SelectionHashTask> hashTask;
+
     void refresh();
     void refresh(RVA addr);
     void selectHexPreview();
@@ -57,8 +61,13 @@ private:
     void setupFonts();
 
     void refreshSelectionInfo();
-    void updateParseWindow(RVA start_address, int size);
+    void updateParseWindow(RVA start_address, ut64 size);
     void clearParseWindow();
+    /**
+     * @brief Hash the selection on a worker, replacing any hash computation still running.
+     */
+    void startSelectionHash(RVA start, ut64 size);
+    void cancelSelectionHash();
     void showSidePanel(bool show);
 
     QString getWindowTitle() const override;
@@ -164,12 +164,17 @@ bool ImportsProxyModel::lessThan(const QModelIndex &left, const QModelIndex &rig
  * Imports Widget
  */
 
+QString ImportsWidget::getDockTitle()
+{
+    return tr("Imports");
+}
+
 ImportsWidget::ImportsWidget(MainWindow *main)
     : ListDockWidget(main),
       importsModel(new ImportsModel(this)),
       importsProxyModel(new ImportsProxyModel(importsModel, this))
 {
-    setWindowTitle(tr("Imports"));
+    setWindowTitle(getDockTitle());
     setObjectName("ImportsWidget");
 
     setModels(importsProxyModel);
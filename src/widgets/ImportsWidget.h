@@ -99,6 +99,11 @@ class ImportsWidget : public ListDockWidget
 
 public:
     explicit ImportsWidget(MainWindow *main);
+
+    /**
+     * @brief Title of the dock, also shown before it is constructed
+     */
+    static QString getDockTitle();
     ~ImportsWidget();
 
 private slots:
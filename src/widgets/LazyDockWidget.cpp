@@ -0,0 +1,32 @@
+#include "LazyDockWidget.h"
+
+#include <QTimer>
+
+#include <cassert>
+
+LazyDockWidget::LazyDockWidget(MainWindow *main, const QString &name, const QString &title,
+                               Factory factory)
+    : CutterDockWidget(main), factory(std::move(factory))
+{
+    setObjectName(name);
+    setWindowTitle(title);
+    setWidget(new QWidget(this));
+
+    // Replacing a dock from within its own visibility change confuses the dock layout, wait for
+    // the event loop
+    connect(this, &CutterDockWidget::becameVisibleToUser, this, [this]() {
+        QTimer::singleShot(0, this, [this]() {
+            if (this->factory && isVisibleToUser()) {
+                emit materializeRequested();
+            }
+        });
+    });
+}
+
+CutterDockWidget *LazyDockWidget::create()
+{
+    assert(factory);
+    Factory f;
+    std::swap(f, factory);
+    return f();
+}
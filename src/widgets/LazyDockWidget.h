@@ -0,0 +1,44 @@
+#ifndef LAZYDOCKWIDGET_H
+#define LAZYDOCKWIDGET_H
+
+#include "CutterDockWidget.h"
+
+#include <functional>
+
+/**
+ * @brief Stand-in for a dock that is only constructed once the user first sees it
+ *
+ * The placeholder carries the object name and title of the real dock, so saved layouts place it
+ * and the Windows menu lists it like the real one. When it becomes visible to the user,
+ * materializeRequested() asks the MainWindow to construct the real dock and put it in the place
+ * of the placeholder. View properties from a layout are kept until then.
+ */
+class CUTTER_EXPORT LazyDockWidget : public CutterDockWidget
+{
+    Q_OBJECT
+
+public:
+    using Factory = std::function<CutterDockWidget *()>;
+
+    LazyDockWidget(MainWindow *main, const QString &name, const QString &title, Factory factory);
+
+    /**
+     * @brief Construct the real dock. Must be called at most once.
+     */
+    CutterDockWidget *create();
+
+    QVariantMap serializeViewProprties() override { return properties; }
+    void deserializeViewProperties(const QVariantMap &properties) override
+    {
+        this->properties = properties;
+    }
+
+signals:
+    void materializeRequested();
+
+private:
+    Factory factory;
+    QVariantMap properties;
+};
+
+#endif // LAZYDOCKWIDGET_H
@@ -117,10 +117,15 @@ bool MemoryProxyModel::lessThan(const QModelIndex &left, const QModelIndex &righ
     return leftMemMap.addrStart < rightMemMap.addrStart;
 }
 
+QString MemoryMapWidget::getDockTitle()
+{
+    return tr("Memory Map");
+}
+
 MemoryMapWidget::MemoryMapWidget(MainWindow *main)
     : ListDockWidget(main, ListDockWidget::SearchBarPolicy::HideByDefault)
 {
-    setWindowTitle(tr("Memory Map"));
+    setWindowTitle(getDockTitle());
     setObjectName("MemoryMapWidget");
 
     memoryModel = new MemoryMapModel(&memoryMaps, this);
@@ -128,10 +133,16 @@ MemoryMapWidget::MemoryMapWidget(MainWindow *main)
     setModels(memoryProxyModel);
     ui->treeView->sortByColumn(MemoryMapModel::AddrStartColumn, Qt::AscendingOrder);
 
-    refreshDeferrer = createRefreshDeferrer([this]() { refreshMemoryMap(); });
+    refreshDeferrer = createAsyncRefreshDeferrer(
+            []() { return Core()->getMemoryMap(); },
+            [this](const QList<MemoryMapDescription> &result) { setMemoryMap(result); });
 
-    connect(Core(), &CutterCore::refreshAll, this, &MemoryMapWidget::refreshMemoryMap);
-    connect(Core(), &CutterCore::registersChanged, this, &MemoryMapWidget::refreshMemoryMap);
+    connect(Core()->getChangeTracker(), &ChangeTracker::changed, this,
+            [this](ChangeTracker::Domains domains) {
+                if (domains.testFlag(ChangeTracker::Memory)) {
+                    refreshMemoryMap();
+                }
+            });
     connect(Core(), &CutterCore::commentsChanged, this,
             [this]() { qhelpers::emitColumnChanged(memoryModel, MemoryMapModel::CommentColumn); });
 
@@ -142,15 +153,17 @@ MemoryMapWidget::~MemoryMapWidget() = default;
 
 void MemoryMapWidget::refreshMemoryMap()
 {
-    if (!refreshDeferrer->attemptRefresh(nullptr)) {
+    if (!memoryMapWatcher.isOutdated() || Core()->currentlyEmulating) {
         return;
     }
+    memoryMapWatcher.markSeen();
+    refreshDeferrer->requestRefresh();
+}
 
-    if (Core()->currentlyEmulating) {
-        return;
-    }
+void MemoryMapWidget::setMemoryMap(const QList<MemoryMapDescription> &newMemoryMaps)
+{
     memoryModel->beginResetModel();
-    memoryMaps = Core()->getMemoryMap();
+    memoryMaps = newMemoryMaps;
     memoryModel->endResetModel();
 
     ui->treeView->resizeColumnToContents(0);
@@ -3,6 +3,7 @@
 #include <memory>
 
 #include "core/Cutter.h"
+#include "common/ChangeTracker.h"
 #include "CutterDockWidget.h"
 #include "ListDockWidget.h"
 
@@ -70,16 +71,23 @@ class MemoryMapWidget : public ListDockWidget
 
 public:
     explicit MemoryMapWidget(MainWindow *main);
+
+    /**
+     * @brief Title of the dock, also shown before it is constructed
+     */
+    static QString getDockTitle();
     ~MemoryMapWidget();
 
 private slots:
 
     void refreshMemoryMap();
+    void setMemoryMap(const QList<MemoryMapDescription> &newMemoryMaps);
 
 private:
     MemoryMapModel *memoryModel;
     MemoryProxyModel *memoryProxyModel;
     QList<MemoryMapDescription> memoryMaps;
 
-    RefreshDeferrer *refreshDeferrer;
+    AsyncRefreshDeferrer *refreshDeferrer;
+    ChangeWatcher memoryMapWatcher { ChangeTracker::Memory };
 };
@@ -1,13 +1,17 @@
 #include "Omnibar.h"
 #include "core/MainWindow.h"
+#include "common/ChangeTracker.h"
 #include "CutterSeekable.h"
 
-#include <QStringListModel>
 #include <QCompleter>
 #include <QShortcut>
 #include <QAbstractItemView>
 
-Omnibar::Omnibar(MainWindow *main, QWidget *parent) : QLineEdit(parent), main(main)
+/// Maximum number of names shown in the completer popup
+static const int maxCompletions = 200;
+
+Omnibar::Omnibar(MainWindow *main, QWidget *parent)
+    : QLineEdit(parent), main(main), index(std::make_shared<NavigationIndex>())
 {
     // QLineEdit basic features
     this->setMinimumHeight(16);
@@ -18,45 +22,113 @@ Omnibar::Omnibar(MainWindow *main, QWidget *parent) : QLineEdit(parent), main(ma
     this->setClearButtonEnabled(true);
 
     connect(this, &QLineEdit::returnPressed, this, &Omnibar::on_gotoEntry_returnPressed);
+    connect(this, &QLineEdit::textEdited, this, &Omnibar::updateCompletion);
 
     // Esc clears omnibar
     QShortcut *clear_shortcut = new QShortcut(QKeySequence(Qt::Key_Escape), this);
     connect(clear_shortcut, &QShortcut::activated, this, &Omnibar::clear);
     clear_shortcut->setContext(Qt::WidgetWithChildrenShortcut);
+
+    setupCompleter();
+
+    // The index follows the core incrementally instead of being rebuilt by the flags widget
+    connect(Core()->getChangeTracker(), &ChangeTracker::changed, this,
+            [this](ChangeTracker::Domains domains) {
+                quint8 kinds = 0;
+                if (domains.testFlag(ChangeTracker::Flags)) {
+                    kinds |= NavigationIndex::Flag | NavigationIndex::Symbol;
+                }
+                if (domains.testFlag(ChangeTracker::Functions)) {
+                    kinds |= NavigationIndex::Function;
+                }
+                syncIndex(kinds);
+            });
+    connect(Core(), &CutterCore::functionRenamed, this,
+            [this](RVA offset, const QString &newName) {
+                index->renameFunction(offset, newName);
+            });
+    syncIndex(NavigationIndex::AllKinds);
+}
+
+Omnibar::~Omnibar()
+{
+    if (queryTask) {
+        queryTask->interrupt();
+    }
 }
 
 void Omnibar::setupCompleter()
 {
-    // Set gotoEntry completer for jump history
-    QCompleter *completer = new QCompleter(flags, this);
+    // Matching and ranking is done by the navigation index, the completer only shows the result
+    completer = new QCompleter(&completionModel, this);
     completer->setMaxVisibleItems(20);
-    completer->setCompletionMode(QCompleter::PopupCompletion);
-    completer->setModelSorting(QCompleter::CaseSensitivelySortedModel);
+    completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
     completer->setCaseSensitivity(Qt::CaseInsensitive);
-    completer->setFilterMode(Qt::MatchContains);
 
     this->setCompleter(completer);
 }
 
-void Omnibar::refresh(const QStringList &flagList)
+void Omnibar::syncIndex(quint8 kinds)
 {
-    flags = flagList;
+    if (!kinds) {
+        return;
+    }
+    AsyncTask::Ptr task(new NavigationIndexSyncTask(index, kinds));
+    task->setPriority(AsyncTask::Priority::Background);
+    task->setKey(QString("Omnibar/%1/sync/%2").arg(reinterpret_cast<quintptr>(this)).arg(kinds));
+    Core()->getAsyncTaskManager()->start(task);
+}
 
-    setupCompleter();
+void Omnibar::updateCompletion(const QString &text)
+{
+    if (queryTask) {
+        queryTask->interrupt();
+        queryTask.clear();
+    }
+    if (text.isEmpty()) {
+        completionModel.setStringList({});
+        completionOffsets.clear();
+        return;
+    }
+
+    queryTask.reset(new NavigationQueryTask(index, text, maxCompletions));
+    queryTask->setKey(QString("Omnibar/%1/query").arg(reinterpret_cast<quintptr>(this)));
+    NavigationQueryTask *task = queryTask.data();
+    connect(task, &NavigationQueryTask::matchesReady, this,
+            [this, task](const QString &text, const QVector<NavigationIndex::Match> &matches,
+                         bool complete) {
+                matchesReady(text, matches);
+                // A newer query may have been started since this one sent its matches
+                if (complete && queryTask.data() == task) {
+                    queryTask.clear();
+                }
+            });
+    Core()->getAsyncTaskManager()->start(queryTask);
 }
 
-void Omnibar::restoreCompleter()
+void Omnibar::matchesReady(const QString &text, const QVector<NavigationIndex::Match> &matches)
 {
-    QCompleter *completer = this->completer();
-    if (!completer) {
+    // Results of a superseded query
+    if (text != this->text()) {
         return;
     }
-    completer->setFilterMode(Qt::MatchContains);
+    QStringList names;
+    names.reserve(matches.size());
+    completionOffsets.clear();
+    for (const NavigationIndex::Match &match : matches) {
+        names.append(match.name);
+        completionOffsets.insert(match.name, match.offset);
+    }
+    completionModel.setStringList(names);
+    if (hasFocus()) {
+        completer->complete();
+    }
 }
 
 void Omnibar::clear()
 {
     QLineEdit::clear();
+    updateCompletion(QString());
 
     // Close the potential shown completer popup
     clearFocus();
@@ -66,7 +138,18 @@ void Omnibar::clear()
 void Omnibar::on_gotoEntry_returnPressed()
 {
     QString str = this->text();
-    if (!str.isEmpty()) {
+    auto completion = completionOffsets.constFind(str);
+    if (!str.isEmpty() && completion != completionOffsets.constEnd()
+        && completion.value() != RVA_INVALID) {
+        // Names of symbols and functions are not necessarily flags, use the indexed address
+        index->noteVisited(str);
+        if (auto memoryWidget = main->getLastMemoryWidget()) {
+            memoryWidget->getSeekable()->seek(completion.value());
+            memoryWidget->raiseMemoryWidget();
+        } else {
+            Core()->seekAndShow(completion.value());
+        }
+    } else if (!str.isEmpty()) {
         if (auto memoryWidget = main->getLastMemoryWidget()) {
             RVA offset = Core()->math(str);
             memoryWidget->getSeekable()->seek(offset);
@@ -78,5 +161,5 @@ void Omnibar::on_gotoEntry_returnPressed()
 
     this->setText("");
     this->clearFocus();
-    this->restoreCompleter();
+    updateCompletion(QString());
 }
@@ -1,31 +1,44 @@
 #ifndef OMNIBAR_H
 #define OMNIBAR_H
 
+#include "common/NavigationIndex.h"
+
 #include <QLineEdit>
+#include <QStringListModel>
+
+#include <memory>
 
 class MainWindow;
+class QCompleter;
 
 class Omnibar : public QLineEdit
 {
     Q_OBJECT
 public:
     explicit Omnibar(MainWindow *main, QWidget *parent = nullptr);
-
-    void refresh(const QStringList &flagList);
+    ~Omnibar() override;
 
 private slots:
     void on_gotoEntry_returnPressed();
 
-    void restoreCompleter();
+    void updateCompletion(const QString &text);
+    void matchesReady(const QString &text, const QVector<NavigationIndex::Match> &matches);
 
 public slots:
     void clear();
 
 private:
     void setupCompleter();
+    void syncIndex(quint8 kinds);
 
     MainWindow *main;
-    QStringList flags;
+    QCompleter *completer;
+    QStringListModel completionModel;
+
+    std::shared_ptr<NavigationIndex> index;
+    QSharedPointer<NavigationQueryTask> queryTask;
+    /// Offsets of the names currently offered by the completer
+    QHash<QString, RVA> completionOffsets;
 };
 
 #endif // OMNIBAR_H
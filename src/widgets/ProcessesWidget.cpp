@@ -9,10 +9,16 @@
 
 #define DEBUGGED_PID (-1)
 
+QString ProcessesWidget::getDockTitle()
+{
+    return tr("Processes");
+}
+
 ProcessesWidget::ProcessesWidget(MainWindow *main)
     : CutterDockWidget(main), ui(new Ui::ProcessesWidget)
 {
     ui->setupUi(this);
+    setWindowTitle(getDockTitle());
 
     // Setup processes model
     modelProcesses = new QStandardItemModel(1, 4, this);
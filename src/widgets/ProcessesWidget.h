@@ -39,6 +39,11 @@ public:
     };
 
     explicit ProcessesWidget(MainWindow *main);
+
+    /**
+     * @brief Title of the dock, also shown before it is constructed
+     */
+    static QString getDockTitle();
     ~ProcessesWidget();
 
 private slots:
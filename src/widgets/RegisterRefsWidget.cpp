@@ -117,6 +117,11 @@ bool RegisterRefProxyModel::lessThan(const QModelIndex &left, const QModelIndex
     return leftRegRef.reg < rightRegRef.reg;
 }
 
+QString RegisterRefsWidget::getDockTitle()
+{
+    return tr("Register References");
+}
+
 RegisterRefsWidget::RegisterRefsWidget(MainWindow *main)
     : CutterDockWidget(main),
       ui(new Ui::RegisterRefsWidget),
@@ -124,6 +129,7 @@ RegisterRefsWidget::RegisterRefsWidget(MainWindow *main)
       addressableItemContextMenu(this, main)
 {
     ui->setupUi(this);
+    setWindowTitle(getDockTitle());
 
     // Add Status Bar footer
     tree->addStatusBar(ui->verticalLayout);
@@ -69,6 +69,11 @@ class RegisterRefsWidget : public CutterDockWidget
 
 public:
     explicit RegisterRefsWidget(MainWindow *main);
+
+    /**
+     * @brief Title of the dock, also shown before it is constructed
+     */
+    static QString getDockTitle();
     ~RegisterRefsWidget();
 
 private slots:
@@ -8,20 +8,34 @@
 #include <QLabel>
 #include <QLineEdit>
 
+QString RegistersWidget::getDockTitle()
+{
+    return tr("Registers");
+}
+
 RegistersWidget::RegistersWidget(MainWindow *main)
     : CutterDockWidget(main), ui(new Ui::RegistersWidget), addressContextMenu(this, main)
 {
     ui->setupUi(this);
+    setWindowTitle(getDockTitle());
 
     // setup register layout
     registerLayout->setVerticalSpacing(0);
     registerLayout->setAlignment(Qt::AlignLeft | Qt::AlignTop);
     ui->verticalLayout->addLayout(registerLayout);
 
-    refreshDeferrer = createRefreshDeferrer([this]() { updateContents(); });
+    refreshDeferrer = createAsyncRefreshDeferrer(
+            []() { return Core()->getRegisterRefValues(); },
+            [this](const QVector<RegisterRefValueDescription> &registerRefs) {
+                setRegisterGrid(registerRefs);
+            });
 
-    connect(Core(), &CutterCore::refreshAll, this, &RegistersWidget::updateContents);
-    connect(Core(), &CutterCore::registersChanged, this, &RegistersWidget::updateContents);
+    connect(Core()->getChangeTracker(), &ChangeTracker::changed, this,
+            [this](ChangeTracker::Domains domains) {
+                if (domains.testFlag(ChangeTracker::Registers)) {
+                    updateContents();
+                }
+            });
 
     // Hide shortcuts because there is no way of selecting an item and triger them
     for (auto &action : addressContextMenu.actions()) {
@@ -34,20 +48,20 @@ RegistersWidget::~RegistersWidget() = default;
 
 void RegistersWidget::updateContents()
 {
-    if (!refreshDeferrer->attemptRefresh(nullptr)) {
+    if (!registersWatcher.isOutdated()) {
         return;
     }
-    setRegisterGrid();
+    registersWatcher.markSeen();
+    refreshDeferrer->requestRefresh();
 }
 
-void RegistersWidget::setRegisterGrid()
+void RegistersWidget::setRegisterGrid(const QVector<RegisterRefValueDescription> &registerRefs)
 {
     int i = 0;
     int col = 0;
     QString regValue;
     QLabel *registerLabel;
     QLineEdit *registerEditValue;
-    const auto registerRefs = Core()->getRegisterRefValues();
 
     registerLen = registerRefs.size();
     for (auto &reg : registerRefs) {
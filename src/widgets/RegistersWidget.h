@@ -7,6 +7,7 @@
 #include <memory>
 
 #include "core/Cutter.h"
+#include "common/ChangeTracker.h"
 #include "CutterDockWidget.h"
 #include "menus/AddressableItemContextMenu.h"
 
@@ -22,11 +23,16 @@ class RegistersWidget : public CutterDockWidget
 
 public:
     explicit RegistersWidget(MainWindow *main);
+
+    /**
+     * @brief Title of the dock, also shown before it is constructed
+     */
+    static QString getDockTitle();
     ~RegistersWidget();
 
 private slots:
     void updateContents();
-    void setRegisterGrid();
+    void setRegisterGrid(const QVector<RegisterRefValueDescription> &registerRefs);
     void openContextMenu(QPoint point, QString address);
 
 private:
@@ -35,5 +41,6 @@ private:
     AddressableItemContextMenu addressContextMenu;
     int numCols = 2;
     int registerLen = 0;
-    RefreshDeferrer *refreshDeferrer;
+    AsyncRefreshDeferrer *refreshDeferrer;
+    ChangeWatcher registersWatcher { ChangeTracker::Registers };
 };
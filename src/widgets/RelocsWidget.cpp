@@ -123,12 +123,17 @@ bool RelocsProxyModel::lessThan(const QModelIndex &left, const QModelIndex &righ
     return false;
 }
 
+QString RelocsWidget::getDockTitle()
+{
+    return tr("Relocs");
+}
+
 RelocsWidget::RelocsWidget(MainWindow *main)
     : ListDockWidget(main),
       relocsModel(new RelocsModel(this)),
       relocsProxyModel(new RelocsProxyModel(relocsModel, this))
 {
-    setWindowTitle(tr("Relocs"));
+    setWindowTitle(getDockTitle());
     setObjectName("RelocsWidget");
 
     setModels(relocsProxyModel);
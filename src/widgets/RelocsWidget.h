@@ -57,6 +57,11 @@ class RelocsWidget : public ListDockWidget
 
 public:
     explicit RelocsWidget(MainWindow *main);
+
+    /**
+     * @brief Title of the dock, also shown before it is constructed
+     */
+    static QString getDockTitle();
     ~RelocsWidget();
 
 private slots:
@@ -100,6 +100,11 @@ RVA ResourcesModel::address(const QModelIndex &index) const
     return res.vaddr;
 }
 
+QString ResourcesWidget::getDockTitle()
+{
+    return tr("Resources");
+}
+
 ResourcesWidget::ResourcesWidget(MainWindow *main)
     : ListDockWidget(main, ListDockWidget::SearchBarPolicy::HideByDefault)
 {
@@ -115,7 +120,7 @@ ResourcesWidget::ResourcesWidget(MainWindow *main)
     showCount(false);
 
     // Configure widget
-    this->setWindowTitle(tr("Resources"));
+    setWindowTitle(getDockTitle());
 
     connect(Core(), &CutterCore::refreshAll, this, &ResourcesWidget::refreshResources);
     connect(Core(), &CutterCore::commentsChanged, this,
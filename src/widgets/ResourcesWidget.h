@@ -45,6 +45,11 @@ private:
 public:
     explicit ResourcesWidget(MainWindow *main);
 
+    /**
+     * @brief Title of the dock, also shown before it is constructed
+     */
+    static QString getDockTitle();
+
 private slots:
     void refreshResources();
 };
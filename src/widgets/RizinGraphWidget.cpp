@@ -5,12 +5,18 @@
 #include <QJsonArray>
 #include <QJsonObject>
 
+QString RizinGraphWidget::getDockTitle()
+{
+    return tr("Rizin graphs");
+}
+
 RizinGraphWidget::RizinGraphWidget(MainWindow *main)
     : CutterDockWidget(main),
       ui(new Ui::RizinGraphWidget),
       graphView(new GenericRizinGraphView(this, main))
 {
     ui->setupUi(this);
+    setWindowTitle(getDockTitle());
     ui->verticalLayout->addWidget(graphView);
     connect(ui->refreshButton, &QPushButton::pressed, this, [this]() { graphView->refreshView(); });
     struct GraphType
@@ -88,39 +94,82 @@ void GenericRizinGraphView::refreshView()
     SimpleTextGraphView::refreshView();
 }
 
-void GenericRizinGraphView::loadCurrentGraph()
+void GenericRizinGraphView::addNode(ut64 id, const QString &title, const QString &body,
+                                    GraphLayout::GraphBlock block)
 {
-    blockContent.clear();
-    blocks.clear();
+    QString content;
+    if (!title.isEmpty() && !body.isEmpty()) {
+        content = title + "/n" + body;
+    } else {
+        content = title + body;
+    }
+    block.entry = id;
+    addBlock(std::move(block), content);
+}
 
-    if (graphCommand.isEmpty()) {
-        return;
+bool GenericRizinGraphView::loadNativeGraph()
+{
+    struct NativeGraph
+    {
+        const char *command;
+        RzCoreGraphType type;
+        bool global;
+    };
+    static const NativeGraph nativeGraphs[] = {
+        { "aga", RZ_CORE_GRAPH_TYPE_DATAREF, false }, { "agA", RZ_CORE_GRAPH_TYPE_DATAREF, true },
+        { "agi", RZ_CORE_GRAPH_TYPE_IMPORT, true },   { "agr", RZ_CORE_GRAPH_TYPE_REF, false },
+        { "agR", RZ_CORE_GRAPH_TYPE_REF, true },      { "agx", RZ_CORE_GRAPH_TYPE_XREF, false },
+        { "agI", RZ_CORE_GRAPH_TYPE_IL, false },
+    };
+
+    const QString command = graphCommand.trimmed();
+    for (const NativeGraph &graph : nativeGraphs) {
+        if (command != QLatin1String(graph.command)) {
+            continue;
+        }
+        RVA address = graph.global ? RVA_INVALID : Core()->getOffset();
+        for (GraphNodeDescription &node : Core()->getGraphNodes(graph.type, address)) {
+            GraphLayout::GraphBlock layoutBlock;
+            layoutBlock.edges.reserve(node.edges.size());
+            for (ut64 targetId : node.edges) {
+                layoutBlock.edges.emplace_back(targetId);
+            }
+            addNode(node.id, node.title, node.body, std::move(layoutBlock));
+        }
+        return true;
     }
+    return false;
+}
 
+void GenericRizinGraphView::loadJsonGraph()
+{
     CutterJson functionsDoc = Core()->cmdj(QString("%1 json").arg(graphCommand));
     auto nodes = functionsDoc["nodes"];
 
     for (CutterJson block : nodes) {
-        uint64_t id = block["id"].toUt64();
-
-        QString content;
-        QString title = block["title"].toString();
-        QString body = block["body"].toString();
-        if (!title.isEmpty() && !body.isEmpty()) {
-            content = title + "/n" + body;
-        } else {
-            content = title + body;
-        }
-
         auto edges = block["out_nodes"];
         GraphLayout::GraphBlock layoutBlock;
-        layoutBlock.entry = id;
         for (auto edge : edges) {
             auto targetId = edge.toUt64();
             layoutBlock.edges.emplace_back(targetId);
         }
 
-        addBlock(std::move(layoutBlock), content);
+        addNode(block["id"].toUt64(), block["title"].toString(), block["body"].toString(),
+                std::move(layoutBlock));
+    }
+}
+
+void GenericRizinGraphView::loadCurrentGraph()
+{
+    blockContent.clear();
+    blocks.clear();
+
+    if (graphCommand.isEmpty()) {
+        return;
+    }
+
+    if (!loadNativeGraph()) {
+        loadJsonGraph();
     }
 
     cleanupEdges(blocks);
@@ -33,6 +33,9 @@ class RizinGraphWidget;
  * Id don't have to be sequential. Simple text label is displayed containing concatenation of
  * label and body. No rizin builtin graph uses both. Duplicate edges and edges with target id
  * not present in the list of nodes are removed.
+ *
+ * The builtin graphs that rz_core_graph() can create are read from the RzGraph directly instead of
+ * going through the json output, other commands use the json format above.
  */
 class GenericRizinGraphView : public SimpleTextGraphView
 {
@@ -46,6 +49,10 @@ protected:
     void loadCurrentGraph() override;
 
 private:
+    void addNode(ut64 id, const QString &title, const QString &body, GraphLayout::GraphBlock block);
+    bool loadNativeGraph();
+    void loadJsonGraph();
+
     RefreshDeferrer refreshDeferrer;
     QString graphCommand;
     QString lastShownCommand;
@@ -57,6 +64,11 @@ class RizinGraphWidget : public CutterDockWidget
 
 public:
     explicit RizinGraphWidget(MainWindow *main);
+
+    /**
+     * @brief Title of the dock, also shown before it is constructed
+     */
+    static QString getDockTitle();
     ~RizinGraphWidget();
 
 private:
@@ -7,9 +7,15 @@
 #include <QDebug>
 #include <QTreeWidget>
 
+QString SdbWidget::getDockTitle()
+{
+    return tr("SDB Browser");
+}
+
 SdbWidget::SdbWidget(MainWindow *main) : CutterDockWidget(main), ui(new Ui::SdbWidget)
 {
     ui->setupUi(this);
+    setWindowTitle(getDockTitle());
 
     path.clear();
 
@@ -34,6 +34,11 @@ class SdbWidget : public CutterDockWidget
 
 public:
     explicit SdbWidget(MainWindow *main);
+
+    /**
+     * @brief Title of the dock, also shown before it is constructed
+     */
+    static QString getDockTitle();
     ~SdbWidget() override;
 
 private slots:
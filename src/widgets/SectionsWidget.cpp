@@ -68,6 +68,16 @@ QVariant SectionsModel::data(const QModelIndex &index, int role) const
             return section.perm;
         case SectionsModel::EntropyColumn:
             return section.entropy;
+        case SectionsModel::ByteClassesColumn: {
+            ByteMap::Summary summary = byteClassSummary(index.row());
+            if (!summary.size) {
+                return QVariant();
+            }
+            ByteMap::ByteClass dominant = summary.dominantClass();
+            return QStringLiteral("%1 (%2%)")
+                    .arg(ByteMap::className(dominant))
+                    .arg(summary.classBytes[static_cast<int>(dominant)] * 100 / summary.size);
+        }
         case SectionsModel::CommentColumn:
             return Core()->getCommentAt(section.vaddr);
         default:
@@ -76,7 +86,33 @@ QVariant SectionsModel::data(const QModelIndex &index, int role) const
     case Qt::DecorationRole:
         if (index.column() == 0)
             return colors[index.row() % colors.size()];
+        if (index.column() == SectionsModel::ByteClassesColumn) {
+            ByteMap::Summary summary = byteClassSummary(index.row());
+            QColor color = ByteMap::color(summary.dominantClass(), summary.entropy);
+            if (summary.size && color.isValid()) {
+                return color;
+            }
+        }
         return QVariant();
+    case Qt::ToolTipRole: {
+        if (index.column() != SectionsModel::ByteClassesColumn) {
+            return QVariant();
+        }
+        ByteMap::Summary summary = byteClassSummary(index.row());
+        if (!summary.size) {
+            return QVariant();
+        }
+        QStringList lines;
+        lines << tr("Average entropy: %1").arg(summary.entropy, 0, 'f', 2);
+        for (int i = 0; i < static_cast<int>(ByteMap::ByteClass::Count); i++) {
+            if (summary.classBytes[i]) {
+                lines << QStringLiteral("%1: %2%")
+                                 .arg(ByteMap::className(static_cast<ByteMap::ByteClass>(i)))
+                                 .arg(summary.classBytes[i] * 100.0 / summary.size, 0, 'f', 1);
+            }
+        }
+        return lines.join(QLatin1Char('\n'));
+    }
     case SectionsModel::SectionDescriptionRole:
         return QVariant::fromValue(section);
     default:
@@ -103,6 +139,8 @@ QVariant SectionsModel::headerData(int section, Qt::Orientation, int role) const
             return tr("Permissions");
         case SectionsModel::EntropyColumn:
             return tr("Entropy");
+        case SectionsModel::ByteClassesColumn:
+            return tr("Byte Classes");
         case SectionsModel::CommentColumn:
             return tr("Comment");
         default:
@@ -125,6 +163,32 @@ QString SectionsModel::name(const QModelIndex &index) const
     return section.name;
 }
 
+ByteMap::Summary SectionsModel::byteClassSummary(int row) const
+{
+    // Computing the byte map scans all of the memory, only do it for users of the entropy layer
+    if (!Config()->getNavbarEntropy()) {
+        return ByteMap::Summary();
+    }
+    auto it = byteClassSummaries.constFind(row);
+    if (it != byteClassSummaries.constEnd()) {
+        return it.value();
+    }
+    std::shared_ptr<const ByteMap> byteMap = Core()->getByteMap();
+    if (!byteMap) {
+        return ByteMap::Summary();
+    }
+    const SectionDescription &section = sections->at(row);
+    ByteMap::Summary summary = byteMap->summarize(section.vaddr, section.vaddr + section.vsize);
+    byteClassSummaries.insert(row, summary);
+    return summary;
+}
+
+void SectionsModel::byteMapChanged()
+{
+    byteClassSummaries.clear();
+    qhelpers::emitColumnChanged(this, ByteClassesColumn);
+}
+
 SectionsProxyModel::SectionsProxyModel(SectionsModel *sourceModel, QObject *parent)
     : AddressableFilterProxyModel(sourceModel, parent)
 {
@@ -156,18 +220,30 @@ bool SectionsProxyModel::lessThan(const QModelIndex &left, const QModelIndex &ri
         return leftSection.perm < rightSection.perm;
     case SectionsModel::EntropyColumn:
         return leftSection.entropy < rightSection.entropy;
+    case SectionsModel::ByteClassesColumn: {
+        auto model = static_cast<SectionsModel *>(sourceModel());
+        return model->byteClassSummary(left.row()).entropy
+                < model->byteClassSummary(right.row()).entropy;
+    }
     case SectionsModel::CommentColumn:
         return Core()->getCommentAt(leftSection.vaddr) < Core()->getCommentAt(rightSection.vaddr);
     }
 }
 
+QString SectionsWidget::getDockTitle()
+{
+    return tr("Sections");
+}
+
 SectionsWidget::SectionsWidget(MainWindow *main) : ListDockWidget(main)
 {
     setObjectName("SectionsWidget");
-    setWindowTitle(tr("Sections"));
+    setWindowTitle(getDockTitle());
     setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Preferred);
 
-    sectionsRefreshDeferrer = createRefreshDeferrer([this]() { refreshSections(); });
+    sectionsRefreshDeferrer = createAsyncRefreshDeferrer(
+            []() { return Core()->getAllSections(); },
+            [this](const QList<SectionDescription> &result) { setSections(result); });
     dockRefreshDeferrer = createRefreshDeferrer([this]() { refreshDocks(); });
 
     initSectionsTable();
@@ -185,6 +261,7 @@ void SectionsWidget::initSectionsTable()
     setModels(proxyModel);
 
     ui->treeView->sortByColumn(SectionsModel::AddressColumn, Qt::AscendingOrder);
+    ui->treeView->setColumnHidden(SectionsModel::ByteClassesColumn, !Config()->getNavbarEntropy());
 }
 
 void SectionsWidget::initQuickFilter()
@@ -226,15 +303,22 @@ void SectionsWidget::initAddrMapDocks()
 
 void SectionsWidget::initConnects()
 {
-    connect(Core(), &CutterCore::refreshAll, this, &SectionsWidget::refreshSections);
-    connect(Core(), &CutterCore::codeRebased, this, &SectionsWidget::refreshSections);
+    connect(Core()->getChangeTracker(), &ChangeTracker::changed, this,
+            [this](ChangeTracker::Domains domains) {
+                if (domains.testFlag(ChangeTracker::Memory)) {
+                    refreshSections();
+                }
+            });
     connect(this, &QDockWidget::visibilityChanged, this, [=](bool visibility) {
         if (visibility) {
             refreshSections();
         }
     });
     connect(Core(), &CutterCore::seekChanged, this, &SectionsWidget::refreshDocks);
-    connect(Config(), &Configuration::colorsUpdated, this, &SectionsWidget::refreshSections);
+    connect(Config(), &Configuration::colorsUpdated, this, [this]() {
+        sectionsWatcher.invalidate();
+        refreshSections();
+    });
     connect(toggleButton, &QToolButton::clicked, this, [=] {
         toggleButton->hide();
         addrDockWidget->show();
@@ -247,15 +331,28 @@ void SectionsWidget::initConnects()
     });
     connect(Core(), &CutterCore::commentsChanged, this,
             [this]() { qhelpers::emitColumnChanged(sectionsModel, SectionsModel::CommentColumn); });
+    connect(Core(), &CutterCore::byteMapChanged, sectionsModel, &SectionsModel::byteMapChanged);
+    connect(Config(), &Configuration::navbarEntropyChanged, this, [this]() {
+        ui->treeView->setColumnHidden(SectionsModel::ByteClassesColumn,
+                                      !Config()->getNavbarEntropy());
+        sectionsModel->byteMapChanged();
+    });
 }
 
 void SectionsWidget::refreshSections()
 {
-    if (!sectionsRefreshDeferrer->attemptRefresh(nullptr) || Core()->isDebugTaskInProgress()) {
+    if (!sectionsWatcher.isOutdated() || Core()->isDebugTaskInProgress()) {
         return;
     }
+    sectionsWatcher.markSeen();
+    sectionsRefreshDeferrer->requestRefresh();
+}
+
+void SectionsWidget::setSections(const QList<SectionDescription> &newSections)
+{
     sectionsModel->beginResetModel();
-    sections = Core()->getAllSections();
+    sections = newSections;
+    sectionsModel->byteClassSummaries.clear();
     sectionsModel->endResetModel();
     qhelpers::adjustColumns(ui->treeView, SectionsModel::ColumnCount, 0);
     refreshDocks();
@@ -12,11 +12,14 @@
 #include <QHash>
 
 #include "core/Cutter.h"
+#include "common/ChangeTracker.h"
+#include "common/ByteMap.h"
 #include "CutterDockWidget.h"
 #include "widgets/ListDockWidget.h"
 
 class QAbstractItemView;
 class SectionsWidget;
+class SectionsProxyModel;
 class AbstractAddrDock;
 class AddrDockScene;
 class QGraphicsSceneMouseEvent;
@@ -31,9 +34,20 @@ class SectionsModel : public AddressableItemModel<QAbstractListModel>
     Q_OBJECT
 
     friend SectionsWidget;
+    friend SectionsProxyModel;
 
 private:
     QList<SectionDescription> *sections;
+    /**
+     * Byte classes of the sections by row, summarizing a big section walks many blocks
+     */
+    mutable QHash<int, ByteMap::Summary> byteClassSummaries;
+
+    /**
+     * @return summary of the section in row, with size 0 while the byte map isn't available or
+     * the entropy layer is off
+     */
+    ByteMap::Summary byteClassSummary(int row) const;
 
 public:
     enum Column {
@@ -44,6 +58,7 @@ public:
         VirtualSizeColumn,
         PermissionsColumn,
         EntropyColumn,
+        ByteClassesColumn,
         CommentColumn,
         ColumnCount
     };
@@ -60,6 +75,9 @@ public:
 
     RVA address(const QModelIndex &index) const override;
     QString name(const QModelIndex &index) const override;
+
+public slots:
+    void byteMapChanged();
 };
 
 class SectionsProxyModel : public AddressableFilterProxyModel
@@ -79,10 +97,16 @@ class SectionsWidget : public ListDockWidget
 
 public:
     explicit SectionsWidget(MainWindow *main);
+
+    /**
+     * @brief Title of the dock, also shown before it is constructed
+     */
+    static QString getDockTitle();
     ~SectionsWidget();
 
 private slots:
     void refreshSections();
+    void setSections(const QList<SectionDescription> &newSections);
     void refreshDocks();
 
 protected:
@@ -99,9 +123,15 @@ private:
     QToolButton *toggleButton;
 
     /**
-     * RefreshDeferrer for loading the section data
+     * RefreshDeferrer for loading the section data, which includes computing the entropy of
+     * every section and is therefore done in the background
+     */
+    AsyncRefreshDeferrer *sectionsRefreshDeferrer;
+
+    /**
+     * Skips reloading the section data if the memory layout didn't change
      */
-    RefreshDeferrer *sectionsRefreshDeferrer;
+    ChangeWatcher sectionsWatcher { ChangeTracker::Memory };
 
     /**
      * RefreshDeferrer for updating the visualization docks
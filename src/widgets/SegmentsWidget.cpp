@@ -1,6 +1,7 @@
 #include "SegmentsWidget.h"
 #include "core/MainWindow.h"
 #include "common/Helpers.h"
+#include "common/ChangeTracker.h"
 #include "ui_ListDockWidget.h"
 
 #include <QVBoxLayout>
@@ -137,10 +138,15 @@ bool SegmentsProxyModel::lessThan(const QModelIndex &left, const QModelIndex &ri
     return false;
 }
 
+QString SegmentsWidget::getDockTitle()
+{
+    return tr("Segments");
+}
+
 SegmentsWidget::SegmentsWidget(MainWindow *main) : ListDockWidget(main)
 {
     setObjectName("SegmentsWidget");
-    setWindowTitle(QStringLiteral("Segments"));
+    setWindowTitle(getDockTitle());
 
     segmentsModel = new SegmentsModel(&segments, this);
     auto proxyModel = new SegmentsProxyModel(segmentsModel, this);
@@ -151,8 +157,12 @@ SegmentsWidget::SegmentsWidget(MainWindow *main) : ListDockWidget(main)
     ui->quickFilterView->closeFilter();
     showCount(false);
 
-    connect(Core(), &CutterCore::refreshAll, this, &SegmentsWidget::refreshSegments);
-    connect(Core(), &CutterCore::codeRebased, this, &SegmentsWidget::refreshSegments);
+    connect(Core()->getChangeTracker(), &ChangeTracker::changed, this,
+            [this](ChangeTracker::Domains domains) {
+                if (domains.testFlag(ChangeTracker::Memory)) {
+                    refreshSegments();
+                }
+            });
     connect(Core(), &CutterCore::commentsChanged, this,
             [this]() { qhelpers::emitColumnChanged(segmentsModel, SegmentsModel::CommentColumn); });
 }
@@ -63,6 +63,11 @@ class SegmentsWidget : public ListDockWidget
 
 public:
     explicit SegmentsWidget(MainWindow *main);
+
+    /**
+     * @brief Title of the dock, also shown before it is constructed
+     */
+    static QString getDockTitle();
     ~SegmentsWidget();
 
 private slots:
@@ -8,6 +8,11 @@
 #include "QHeaderView"
 #include "QMenu"
 
+QString StackWidget::getDockTitle()
+{
+    return tr("Stack");
+}
+
 StackWidget::StackWidget(MainWindow *main)
     : CutterDockWidget(main),
       ui(new Ui::StackWidget),
@@ -15,6 +20,7 @@ StackWidget::StackWidget(MainWindow *main)
       addressableItemContextMenu(this, main)
 {
     ui->setupUi(this);
+    setWindowTitle(getDockTitle());
 
     // Setup stack model
     viewStack->setFont(Config()->getFont());
@@ -54,6 +54,11 @@ class StackWidget : public CutterDockWidget
 
 public:
     explicit StackWidget(MainWindow *main);
+
+    /**
+     * @brief Title of the dock, also shown before it is constructed
+     */
+    static QString getDockTitle();
     ~StackWidget();
 
 private slots:
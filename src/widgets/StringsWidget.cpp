@@ -224,13 +224,17 @@ StringsWidget::~StringsWidget() {}
 
 void StringsWidget::refreshStrings()
 {
-    if (task) {
-        task->wait();
-    }
-
+    // A still running search is superseded through the shared key instead of waiting for it
     task = QSharedPointer<StringsTask>(new StringsTask());
-    connect(task.data(), &StringsTask::stringSearchFinished, this,
-            &StringsWidget::stringSearchFinished);
+    task->setPriority(AsyncTask::Priority::Background);
+    task->setKey(QStringLiteral("StringsWidget/%1").arg(reinterpret_cast<quintptr>(this)));
+    StringsTask *taskPtr = task.data();
+    connect(taskPtr, &StringsTask::stringSearchFinished, this,
+            [this, taskPtr](const QList<StringDescription> &strings) {
+                if (task.data() == taskPtr) {
+                    stringSearchFinished(strings);
+                }
+            });
     Core()->getAsyncTaskManager()->start(task);
 
     refreshSectionCombo();
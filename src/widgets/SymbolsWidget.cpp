@@ -118,9 +118,14 @@ bool SymbolsProxyModel::lessThan(const QModelIndex &left, const QModelIndex &rig
     return false;
 }
 
+QString SymbolsWidget::getDockTitle()
+{
+    return tr("Symbols");
+}
+
 SymbolsWidget::SymbolsWidget(MainWindow *main) : ListDockWidget(main)
 {
-    setWindowTitle(tr("Symbols"));
+    setWindowTitle(getDockTitle());
     setObjectName("SymbolsWidget");
 
     symbolsModel = new SymbolsModel(&symbols, this);
@@ -57,6 +57,11 @@ class SymbolsWidget : public ListDockWidget
 
 public:
     explicit SymbolsWidget(MainWindow *main);
+
+    /**
+     * @brief Title of the dock, also shown before it is constructed
+     */
+    static QString getDockTitle();
     ~SymbolsWidget();
 
 private slots:
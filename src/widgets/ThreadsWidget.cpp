@@ -9,9 +9,15 @@
 
 #define DEBUGGED_PID (-1)
 
+QString ThreadsWidget::getDockTitle()
+{
+    return tr("Threads");
+}
+
 ThreadsWidget::ThreadsWidget(MainWindow *main) : CutterDockWidget(main), ui(new Ui::ThreadsWidget)
 {
     ui->setupUi(this);
+    setWindowTitle(getDockTitle());
 
     // Setup threads model
     modelThreads = new QStandardItemModel(1, 3, this);
@@ -38,6 +38,11 @@ public:
     };
 
     explicit ThreadsWidget(MainWindow *main);
+
+    /**
+     * @brief Title of the dock, also shown before it is constructed
+     */
+    static QString getDockTitle();
     ~ThreadsWidget();
 
 private slots:
@@ -188,7 +188,15 @@ TypesWidget::TypesWidget(MainWindow *main)
             &ComboQuickFilterView::clearFilter);
     clearShortcut->setContext(Qt::WidgetWithChildrenShortcut);
 
-    connect(Core(), &CutterCore::refreshAll, this, &TypesWidget::refreshTypes);
+    refreshDeferrer = createAsyncRefreshDeferrer(
+            []() { return Core()->getAllTypes(); },
+            [this](const QList<TypeDescription> &result) { setTypes(result); });
+    connect(Core()->getChangeTracker(), &ChangeTracker::changed, this,
+            [this](ChangeTracker::Domains domains) {
+                if (domains.testFlag(ChangeTracker::Types)) {
+                    refreshTypes();
+                }
+            });
 
     connect(ui->quickFilterView->comboBox(), &QComboBox::currentTextChanged, this, [this]() {
         types_proxy_model->setCategory(ui->quickFilterView->comboBox()->currentData().toString());
@@ -207,9 +215,18 @@ TypesWidget::TypesWidget(MainWindow *main)
 TypesWidget::~TypesWidget() {}
 
 void TypesWidget::refreshTypes()
+{
+    if (!typesWatcher.isOutdated()) {
+        return;
+    }
+    typesWatcher.markSeen();
+    refreshDeferrer->requestRefresh();
+}
+
+void TypesWidget::setTypes(const QList<TypeDescription> &newTypes)
 {
     types_model->beginResetModel();
-    types = Core()->getAllTypes();
+    types = newTypes;
     types_model->endResetModel();
 
     QStringList categories;
@@ -304,7 +321,6 @@ void TypesWidget::on_actionLoad_New_Types_triggered()
     TypeDescription t = index.data(TypesModel::TypeDescriptionRole).value<TypeDescription>();
 
     TypesInteractionDialog dialog(this);
-    connect(&dialog, &TypesInteractionDialog::newTypesLoaded, this, &TypesWidget::refreshTypes);
     dialog.setWindowTitle(tr("Load New Types"));
     dialog.exec();
 }
@@ -322,7 +338,6 @@ void TypesWidget::viewType(bool readOnly)
     TypeDescription t = index.data(TypesModel::TypeDescriptionRole).value<TypeDescription>();
     if (!readOnly) {
         dialog.setWindowTitle(tr("Edit Type: ") + t.type);
-        connect(&dialog, &TypesInteractionDialog::newTypesLoaded, this, &TypesWidget::refreshTypes);
     } else {
         dialog.setWindowTitle(tr("View Type: ") + t.type + tr(" (Read Only)"));
     }
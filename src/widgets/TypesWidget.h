@@ -4,6 +4,7 @@
 #include <memory>
 
 #include "core/Cutter.h"
+#include "common/ChangeTracker.h"
 #include "CutterDockWidget.h"
 #include "CutterTreeWidget.h"
 
@@ -76,6 +77,7 @@ public:
 
 private slots:
     void refreshTypes();
+    void setTypes(const QList<TypeDescription> &newTypes);
 
     /**
      * @brief Show custom context menu
@@ -125,6 +127,8 @@ private:
     CutterTreeWidget *tree;
     QAction *actionViewType;
     QAction *actionEditType;
+    AsyncRefreshDeferrer *refreshDeferrer;
+    ChangeWatcher typesWatcher { ChangeTracker::Types };
 
     void setScrollMode();
 
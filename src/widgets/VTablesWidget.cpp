@@ -126,10 +126,16 @@ bool VTableSortFilterProxyModel::filterAcceptsRow(int source_row,
     return false;
 }
 
+QString VTablesWidget::getDockTitle()
+{
+    return tr("&VTable");
+}
+
 VTablesWidget::VTablesWidget(MainWindow *main)
     : CutterDockWidget(main), ui(new Ui::VTablesWidget), tree(new CutterTreeWidget(this))
 {
     ui->setupUi(this);
+    setWindowTitle(getDockTitle());
 
     // Add Status Bar footer
     tree->addStatusBar(ui->verticalLayout);
@@ -57,6 +57,11 @@ class VTablesWidget : public CutterDockWidget
 
 public:
     explicit VTablesWidget(MainWindow *main);
+
+    /**
+     * @brief Title of the dock, also shown before it is constructed
+     */
+    static QString getDockTitle();
     ~VTablesWidget();
 
 private slots:
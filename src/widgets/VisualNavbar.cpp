@@ -1,27 +1,191 @@
 #include "VisualNavbar.h"
 #include "core/MainWindow.h"
-#include "common/TempConfig.h"
-
-#include <QGraphicsView>
-#include <QComboBox>
-#include <QGraphicsScene>
-#include <QGraphicsRectItem>
-#include <QJsonDocument>
-#include <QJsonObject>
-#include <QJsonArray>
-#include <QJsonParseError>
+#include "common/Coverage.h"
+#include "common/ByteMap.h"
+
+#include <QContextMenuEvent>
+#include <QLabel>
+#include <QMenu>
+#include <QPainter>
+#include <QPixmap>
 #include <QToolTip>
 #include <QMouseEvent>
+#include <QWheelEvent>
 
+#include <rz_core.h>
+
+#include <algorithm>
 #include <array>
 #include <cmath>
 
+namespace {
+
+/**
+ * Finest blocks over all mapped regions together
+ */
+constexpr ut64 FinestBlockCount = 1 << 15;
+/**
+ * Zoom factor of one wheel step while hovering the bar
+ */
+constexpr double WheelZoomStep = 1.5;
+/**
+ * Width in pixels of the finest blocks at the deepest zoom
+ */
+constexpr ut64 MaxBlockWidth = 8;
+
+enum class DataType : int { Empty, Code, String, Symbol, Count };
+
+DataType blockType(const NavbarStats::Block &block)
+{
+    if (block.functions) {
+        return DataType::Code;
+    } else if (block.strings) {
+        return DataType::String;
+    } else if (block.symbols) {
+        return DataType::Symbol;
+    } else if (block.inFunctions) {
+        return DataType::Code;
+    }
+    return DataType::Empty;
+}
+
+/**
+ * @brief Collects the analysis stats of all mapped regions and builds their coarser levels
+ */
+class NavbarStatsTask : public AsyncTask
+{
+public:
+    std::shared_ptr<NavbarStats> stats;
+
+    QString getTitle() override { return tr("Fetching navigation bar stats"); }
+
+protected:
+    void runTask() override
+    {
+        auto result = std::make_shared<NavbarStats>();
+        {
+            RzCoreLocked core(Core());
+            auto list = fromOwned(rz_core_get_boundaries_prot(core, -1, NULL, "search"));
+            if (!list) {
+                return;
+            }
+            RzListIter *iter;
+            RzIOMap *map;
+            CutterRzListForeach (list.get(), iter, RzIOMap, map) {
+                ut64 from = rz_itv_begin(map->itv);
+                ut64 to = rz_itv_end(map->itv);
+                if (to > from) {
+                    result->regions.push_back({ from, to, 0 });
+                }
+            }
+        }
+        if (result->regions.empty()) {
+            return;
+        }
+
+        // Overlapping and adjacent maps become one region, the gaps between regions are dropped
+        std::sort(result->regions.begin(), result->regions.end(),
+                  [](const NavbarStats::Region &a, const NavbarStats::Region &b) {
+                      return a.from < b.from;
+                  });
+        std::vector<NavbarStats::Region> regions;
+        for (const NavbarStats::Region &region : result->regions) {
+            if (!regions.empty() && region.from <= regions.back().to) {
+                regions.back().to = std::max(regions.back().to, region.to);
+            } else {
+                regions.push_back(region);
+            }
+        }
+        for (NavbarStats::Region &region : regions) {
+            region.position = result->totalSize;
+            result->totalSize += region.to - region.from;
+        }
+        result->regions = std::move(regions);
+        const ut64 totalSize = result->totalSize;
+        result->blockSize = std::max<ut64>(
+                1, totalSize / FinestBlockCount + (totalSize % FinestBlockCount != 0));
+
+        // The core is locked per region, so the interface isn't blocked for the whole scan
+        std::vector<NavbarStats::Block> blocks;
+        for (const NavbarStats::Region &region : result->regions) {
+            if (isInterrupted()) {
+                return;
+            }
+            RzCoreLocked core(Core());
+            UniquePtrC<RzCoreAnalysisStats, &rz_core_analysis_stats_free> regionStats(
+                    rz_core_analysis_get_stats(core, region.from, region.to - 1,
+                                               result->blockSize));
+            if (!regionStats) {
+                continue;
+            }
+            for (size_t i = 0; i < rz_vector_len(&regionStats->blocks); i++) {
+                auto item = reinterpret_cast<RzCoreAnalysisStatsItem *>(
+                        rz_vector_index_ptr(&regionStats->blocks, i));
+                ut64 from = rz_core_analysis_stats_get_block_from(regionStats.get(), i);
+                ut64 to = std::min<ut64>(
+                        rz_core_analysis_stats_get_block_to(regionStats.get(), i) + 1, region.to);
+                if (from < region.from || to <= from) {
+                    continue;
+                }
+                blocks.push_back({ region.position + (from - region.from), to - from,
+                                   item->functions, item->in_functions, item->strings,
+                                   item->symbols });
+            }
+        }
+
+        result->levels.push_back(std::move(blocks));
+        while (result->levels.back().size() > 1) {
+            const std::vector<NavbarStats::Block> &fine = result->levels.back();
+            std::vector<NavbarStats::Block> coarse;
+            coarse.reserve(fine.size() / 2 + 1);
+            for (size_t i = 0; i < fine.size(); i += 2) {
+                NavbarStats::Block block = fine[i];
+                if (i + 1 < fine.size()) {
+                    const NavbarStats::Block &next = fine[i + 1];
+                    block.size = next.position + next.size - block.position;
+                    block.functions += next.functions;
+                    block.inFunctions += next.inFunctions;
+                    block.strings += next.strings;
+                    block.symbols += next.symbols;
+                }
+                coarse.push_back(block);
+            }
+            result->levels.push_back(std::move(coarse));
+        }
+        stats = std::move(result);
+    }
+};
+
+}
+
+RVA NavbarStats::positionToAddress(ut64 position) const
+{
+    auto it = std::upper_bound(
+            regions.begin(), regions.end(), position,
+            [](ut64 position, const Region &region) { return position < region.position; });
+    if (it == regions.begin()) {
+        return RVA_INVALID;
+    }
+    --it;
+    RVA address = it->from + (position - it->position);
+    return address < it->to ? address : RVA_INVALID;
+}
+
+bool NavbarStats::addressToPosition(RVA address, ut64 &position) const
+{
+    auto it = std::upper_bound(regions.begin(), regions.end(), address,
+                               [](RVA address, const Region &region) {
+                                   return address < region.from;
+                               });
+    if (it == regions.begin() || address >= (--it)->to) {
+        return false;
+    }
+    position = it->position + (address - it->from);
+    return true;
+}
+
 VisualNavbar::VisualNavbar(MainWindow *main, QWidget *parent)
-    : QToolBar(main),
-      graphicsView(new QGraphicsView),
-      seekGraphicsItem(nullptr),
-      PCGraphicsItem(nullptr),
-      main(main)
+    : QToolBar(main), canvas(new QLabel), main(main)
 {
     Q_UNUSED(parent);
 
@@ -31,246 +195,202 @@ VisualNavbar::VisualNavbar(MainWindow *main, QWidget *parent)
     setWindowTitle(tr("Visual navigation bar"));
     //    setMovable(false);
     setContentsMargins(0, 0, 0, 0);
-    // If line below is used, with the dark theme the paintEvent is not called
-    // and the result is wrong. Something to do with overwriting the style sheet :/
-    // setStyleSheet("QToolBar { border: 0px; border-bottom: 0px; border-top: 0px; border-width:
-    // 0px;}");
-
-    /*
-    QComboBox *addsCombo = new QComboBox();
-    addsCombo->addItem("");
-    addsCombo->addItem("Entry points");
-    addsCombo->addItem("Marks");
-    */
-    addWidget(this->graphicsView);
-    // addWidget(addsCombo);
+
+    // The stats are rendered once into an image, seeking only draws the cursors on a copy of it
+    canvas->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+    canvas->setMinimumSize(1, 15);
+    canvas->setMaximumHeight(15);
+    // So the canvas doesn't intercept mouse events.
+    canvas->setAttribute(Qt::WA_TransparentForMouseEvents);
+    canvas->installEventFilter(this);
+    addWidget(canvas);
 
     connect(Core(), &CutterCore::seekChanged, this, &VisualNavbar::on_seekChanged);
-    connect(Core(), &CutterCore::registersChanged, this, &VisualNavbar::drawPCCursor);
-    connect(Core(), &CutterCore::refreshAll, this, &VisualNavbar::fetchAndPaintData);
-    connect(Core(), &CutterCore::functionsChanged, this, &VisualNavbar::fetchAndPaintData);
-    connect(Core(), &CutterCore::flagsChanged, this, &VisualNavbar::fetchAndPaintData);
-    connect(Core(), &CutterCore::globalVarsChanged, this, &VisualNavbar::fetchAndPaintData);
-
-    graphicsScene = new QGraphicsScene(this);
-
-    const QBrush bg = QBrush(QColor(74, 74, 74));
-
-    graphicsScene->setBackgroundBrush(bg);
-
-    this->graphicsView->setAlignment(Qt::AlignLeft);
-    this->graphicsView->setMinimumHeight(15);
-    this->graphicsView->setMaximumHeight(15);
-    this->graphicsView->setFrameShape(QFrame::NoFrame);
-    this->graphicsView->setRenderHints({});
-    this->graphicsView->setScene(graphicsScene);
-    this->graphicsView->setRenderHints(QPainter::Antialiasing);
-    this->graphicsView->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    this->graphicsView->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-    // So the graphicsView doesn't intercept mouse events.
-    this->graphicsView->setEnabled(false);
-    this->graphicsView->setMouseTracking(true);
+    connect(Core(), &CutterCore::registersChanged, this, [this]() {
+        pcAddress = Core()->getProgramCounterValue();
+        updateCursors();
+    });
+    connect(Core(), &CutterCore::refreshAll, this, &VisualNavbar::fetchStats);
+    connect(Core(), &CutterCore::functionsChanged, this, &VisualNavbar::fetchStats);
+    connect(Core(), &CutterCore::flagsChanged, this, &VisualNavbar::fetchStats);
+    connect(Core(), &CutterCore::globalVarsChanged, this, &VisualNavbar::fetchStats);
+    connect(Core(), &CutterCore::coverageChanged, this, &VisualNavbar::updateImage);
+    connect(Core(), &CutterCore::byteMapChanged, this, [this]() {
+        if (Config()->getNavbarEntropy()) {
+            updateImage();
+        }
+    });
+
     setMouseTracking(true);
 }
 
-unsigned int nextPow2(unsigned int n)
+VisualNavbar::~VisualNavbar()
 {
-    unsigned int b = 0;
-    while (n) {
-        n >>= 1;
-        b++;
+    if (statsTask) {
+        statsTask->interrupt();
+        statsTask->wait();
     }
-    return (1u << b);
 }
 
-void VisualNavbar::paintEvent(QPaintEvent *event)
+void VisualNavbar::fetchStats()
 {
-    Q_UNUSED(event);
-
-    QPainter painter(this);
-
-    auto w = static_cast<unsigned int>(width());
-    bool fetch = false;
-    if (statsWidth < w) {
-        statsWidth = nextPow2(w);
-        fetch = true;
-    } else if (statsWidth > w * 4) {
-        statsWidth = statsWidth > 0 ? statsWidth / 2 : 0;
-        fetch = true;
-    }
-
-    if (fetch) {
-        fetchAndPaintData();
-    } else if (previousWidth != w) {
-        this->previousWidth = w;
-        updateGraphicsScene();
+    if (statsTask) {
+        // Finishes in the background, statsFetched() ignores its result
+        statsTask->interrupt();
     }
+    auto task = QSharedPointer<NavbarStatsTask>::create();
+    task->setKey(QStringLiteral("VisualNavbar/%1").arg(reinterpret_cast<quintptr>(this)));
+    statsTask = task;
+    connect(task.data(), &AsyncTask::finished, this, &VisualNavbar::statsFetched,
+            Qt::QueuedConnection);
+    Core()->getAsyncTaskManager()->start(statsTask);
 }
 
-void VisualNavbar::fetchAndPaintData()
+void VisualNavbar::statsFetched()
 {
-    fetchStats();
-    updateGraphicsScene();
-}
-
-void VisualNavbar::fetchStats()
-{
-    static const ut64 blocksCount = 2048;
-
-    RzCoreLocked core(Core());
-    stats.reset(nullptr);
-    auto list = fromOwned(rz_core_get_boundaries_prot(core, -1, NULL, "search"));
-    if (!list) {
+    if (!statsTask || sender() != statsTask.data()) {
         return;
     }
-    RzListIter *iter;
-    RzIOMap *map;
-    ut64 from = UT64_MAX;
-    ut64 to = 0;
-    CutterRzListForeach (list.get(), iter, RzIOMap, map) {
-        ut64 f = rz_itv_begin(map->itv);
-        ut64 t = rz_itv_end(map->itv);
-        if (f < from) {
-            from = f;
-        }
-        if (t > to) {
-            to = t;
-        }
-    }
-    to--; // rz_core_analysis_get_stats takes inclusive ranges
-    if (to < from) {
+    auto task = static_cast<NavbarStatsTask *>(statsTask.data());
+    if (task->isInterrupted()) {
         return;
     }
-    stats.reset(
-            rz_core_analysis_get_stats(core, from, to, RZ_MAX(1, (to + 1 - from) / blocksCount)));
+    stats = task->stats;
+    statsTask.clear();
+    resetZoom();
+    updateImage();
 }
 
-enum class DataType : int { Empty, Code, String, Symbol, Count };
-
-void VisualNavbar::updateGraphicsScene()
+void VisualNavbar::resetZoom()
 {
-    graphicsScene->clear();
-    xToAddress.clear();
-    seekGraphicsItem = nullptr;
-    PCGraphicsItem = nullptr;
-    graphicsScene->setBackgroundBrush(QBrush(Config()->getColor("gui.navbar.empty")));
+    viewStart = 0;
+    viewSize = stats ? stats->totalSize : 0;
+}
 
-    if (!stats) {
+void VisualNavbar::updateImage()
+{
+    const int w = std::max(1, canvas->width());
+    const int h = canvas->height();
+    const QColor emptyColor = Config()->getColor("gui.navbar.empty");
+    image = QImage(w, h, QImage::Format_RGB32);
+    image.fill(emptyColor);
+
+    if (!stats || stats->levels.empty() || !viewSize) {
+        updateCursors();
         return;
     }
 
-    int w = graphicsView->width();
-    int h = graphicsView->height();
+    // The coarsest level whose blocks still fit into a pixel
+    const double bytesPerPixel = static_cast<double>(viewSize) / w;
+    size_t level = 0;
+    while (level + 1 < stats->levels.size()
+           && std::ldexp(static_cast<double>(stats->blockSize), static_cast<int>(level) + 1)
+                   <= bytesPerPixel) {
+        level++;
+    }
+    const std::vector<NavbarStats::Block> &blocks = stats->levels[level];
 
-    RVA totalSize = stats->to - stats->from + 1;
-    RVA beginAddr = stats->from;
+    std::array<QColor, static_cast<int>(DataType::Count)> dataTypeColors;
+    dataTypeColors[static_cast<int>(DataType::Code)] = Config()->getColor("gui.navbar.code");
+    dataTypeColors[static_cast<int>(DataType::String)] = Config()->getColor("gui.navbar.str");
+    dataTypeColors[static_cast<int>(DataType::Symbol)] = Config()->getColor("gui.navbar.sym");
 
-    double widthPerByte = (double)w
-            / (double)(totalSize ? totalSize : pow(2.0, 64.0)); // account for overflow on 2^64
-    auto xFromAddr = [widthPerByte, beginAddr](RVA addr) -> double {
-        return (addr - beginAddr) * widthPerByte;
+    std::shared_ptr<const Coverage> coverage = Core()->getCoverage();
+    std::shared_ptr<const ByteMap> byteMap;
+    if (Config()->getNavbarEntropy()) {
+        byteMap = Core()->getByteMap();
+    }
+    const qreal stripHeight = std::max(2, h / 3);
+    auto xFromPosition = [this, bytesPerPixel](ut64 position) {
+        return (static_cast<double>(position) - static_cast<double>(viewStart)) / bytesPerPixel;
     };
 
-    std::array<QBrush, static_cast<int>(DataType::Count)> dataTypeBrushes;
-    dataTypeBrushes[static_cast<int>(DataType::Code)] =
-            QBrush(Config()->getColor("gui.navbar.code"));
-    dataTypeBrushes[static_cast<int>(DataType::String)] =
-            QBrush(Config()->getColor("gui.navbar.str"));
-    dataTypeBrushes[static_cast<int>(DataType::Symbol)] =
-            QBrush(Config()->getColor("gui.navbar.sym"));
-
-    DataType lastDataType = DataType::Empty;
-    QGraphicsRectItem *dataItem = nullptr;
-    QRectF dataItemRect(0.0, 0.0, 0.0, h);
-    for (size_t i = 0; i < rz_vector_len(&stats->blocks); i++) {
-        RzCoreAnalysisStatsItem *block =
-                reinterpret_cast<RzCoreAnalysisStatsItem *>(rz_vector_index_ptr(&stats->blocks, i));
-        ut64 from = rz_core_analysis_stats_get_block_from(stats.get(), i);
-        ut64 to = rz_core_analysis_stats_get_block_to(stats.get(), i) + 1;
-        // Keep track of where which memory segment is mapped so we are able to convert from
-        // address to X coordinate and vice versa.
-        XToAddress x2a;
-        x2a.x_start = xFromAddr(from);
-        x2a.x_end = xFromAddr(to);
-        x2a.address_from = from;
-        x2a.address_to = to;
-        xToAddress.append(x2a);
-
-        DataType dataType;
-        if (block->functions) {
-            dataType = DataType::Code;
-        } else if (block->strings) {
-            dataType = DataType::String;
-        } else if (block->symbols) {
-            dataType = DataType::Symbol;
-        } else if (block->in_functions) {
-            dataType = DataType::Code;
-        } else {
-            lastDataType = DataType::Empty;
-            continue;
+    QPainter painter(&image);
+    const ut64 viewEnd = viewStart + viewSize;
+    auto it = std::upper_bound(blocks.begin(), blocks.end(), viewStart,
+                               [](ut64 position, const NavbarStats::Block &block) {
+                                   return position < block.position;
+                               });
+    if (it != blocks.begin()) {
+        --it;
+    }
+    for (; it != blocks.end() && it->position < viewEnd; ++it) {
+        const double left = xFromPosition(it->position);
+        const double width = std::max(1.0, xFromPosition(it->position + it->size) - left);
+        DataType dataType = blockType(*it);
+        if (dataType != DataType::Empty) {
+            painter.fillRect(QRectF(left, 0, width, h),
+                             dataTypeColors[static_cast<int>(dataType)]);
         }
-
-        if (dataType == lastDataType) {
-            double r = xFromAddr(to);
-            if (r > dataItemRect.right()) {
-                dataItemRect.setRight(r);
-                dataItem->setRect(dataItemRect);
+        if (byteMap) {
+            // Strip along the top with the byte class covering most of the block
+            RVA from = stats->positionToAddress(it->position);
+            RVA last = stats->positionToAddress(it->position + it->size - 1);
+            if (from != RVA_INVALID && last != RVA_INVALID) {
+                ByteMap::Summary summary = byteMap->summarize(from, last + 1);
+                QColor color = ByteMap::color(summary.dominantClass(), summary.entropy);
+                if (summary.size && color.isValid()) {
+                    painter.fillRect(QRectF(left, 0, width, stripHeight), color);
+                }
+            }
+        }
+        if (coverage) {
+            // Strip along the bottom with the heat of the hottest address of the block
+            RVA from = stats->positionToAddress(it->position);
+            RVA last = stats->positionToAddress(it->position + it->size - 1);
+            if (from != RVA_INVALID && last != RVA_INVALID) {
+                QColor heat = coverage->heatColor(coverage->maxHitsIn(from, last + 1));
+                if (heat.isValid()) {
+                    heat.setAlpha(255);
+                    painter.fillRect(QRectF(left, h - stripHeight, width, stripHeight), heat);
+                }
             }
-            dataItem->setRect(dataItemRect);
-            continue;
         }
-
-        dataItemRect.setX(xFromAddr(from));
-        dataItemRect.setRight(xFromAddr(to));
-
-        dataItem = new QGraphicsRectItem();
-        dataItem->setPen(Qt::NoPen);
-        dataItem->setBrush(dataTypeBrushes[static_cast<int>(dataType)]);
-        graphicsScene->addItem(dataItem);
-
-        lastDataType = dataType;
     }
 
-    // Update scene width
-    graphicsScene->setSceneRect(0, 0, w, h);
-
-    drawSeekCursor();
-}
-
-void VisualNavbar::drawCursor(RVA addr, QColor color, QGraphicsRectItem *&graphicsItem)
-{
-    double cursor_x = addressToLocalX(addr);
-    if (graphicsItem != nullptr) {
-        graphicsScene->removeItem(graphicsItem);
-        delete graphicsItem;
-        graphicsItem = nullptr;
-    }
-    if (std::isnan(cursor_x)) {
-        return;
+    // Mark where unmapped gaps were left out
+    const QColor gapColor =
+            emptyColor.lightness() > 127 ? emptyColor.darker(160) : emptyColor.lighter(160);
+    for (size_t i = 1; i < stats->regions.size(); i++) {
+        const ut64 position = stats->regions[i].position;
+        if (position > viewStart && position < viewEnd) {
+            painter.fillRect(QRectF(xFromPosition(position), 0, 1, h), gapColor);
+        }
     }
-    int h = this->graphicsView->height();
-    graphicsItem = new QGraphicsRectItem(cursor_x, 0, 2, h);
-    graphicsItem->setPen(Qt::NoPen);
-    graphicsItem->setBrush(QBrush(color));
-    graphicsScene->addItem(graphicsItem);
-}
+    painter.end();
 
-void VisualNavbar::drawPCCursor()
-{
-    drawCursor(Core()->getProgramCounterValue(), Config()->getColor("gui.navbar.pc"),
-               PCGraphicsItem);
+    updateCursors();
 }
 
-void VisualNavbar::drawSeekCursor()
+void VisualNavbar::updateCursors()
 {
-    drawCursor(Core()->getOffset(), Config()->getColor("gui.navbar.seek"), seekGraphicsItem);
+    QPixmap pixmap = QPixmap::fromImage(image);
+    QPainter painter(&pixmap);
+    auto drawCursor = [&](RVA addr, const QColor &color) {
+        double x = addressToLocalX(addr);
+        if (!std::isnan(x)) {
+            painter.fillRect(QRectF(x, 0, 2, pixmap.height()), color);
+        }
+    };
+    drawCursor(pcAddress, Config()->getColor("gui.navbar.pc"));
+    drawCursor(Core()->getOffset(), Config()->getColor("gui.navbar.seek"));
+    painter.end();
+    canvas->setPixmap(pixmap);
 }
 
 void VisualNavbar::on_seekChanged(RVA addr)
 {
     Q_UNUSED(addr);
     // Update cursor
-    this->drawSeekCursor();
+    this->updateCursors();
+}
+
+bool VisualNavbar::eventFilter(QObject *object, QEvent *event)
+{
+    if (object == canvas && event->type() == QEvent::Resize) {
+        updateImage();
+    }
+    return QToolBar::eventFilter(object, event);
 }
 
 void VisualNavbar::mousePressEvent(QMouseEvent *event)
@@ -278,7 +398,7 @@ void VisualNavbar::mousePressEvent(QMouseEvent *event)
     if (blockTooltip) {
         return;
     }
-    qreal x = qhelpers::mouseEventPos(event).x();
+    qreal x = canvas->mapFrom(this, qhelpers::mouseEventPos(event).toPoint()).x();
     RVA address = localXToAddress(x);
     if (address != RVA_INVALID) {
         auto tooltipPos = qhelpers::mouseEventGlobalPos(event);
@@ -299,29 +419,90 @@ void VisualNavbar::mouseMoveEvent(QMouseEvent *event)
     mousePressEvent(event);
 }
 
-RVA VisualNavbar::localXToAddress(double x)
+void VisualNavbar::wheelEvent(QWheelEvent *event)
 {
-    for (const XToAddress &x2a : xToAddress) {
-        if ((x2a.x_start <= x) && (x <= x2a.x_end)) {
-            double offset = (x - x2a.x_start) / (x2a.x_end - x2a.x_start);
-            double size = x2a.address_to - x2a.address_from;
-            return x2a.address_from + (offset * size);
-        }
+    const int steps = event->angleDelta().y() / 120;
+    if (!stats || !stats->totalSize || !steps) {
+        event->ignore();
+        return;
     }
-    return RVA_INVALID;
+    event->accept();
+
+    // Zoom around the hovered position, down to the finest level without scanning again
+#if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
+    QPoint pos = event->pos();
+#else
+    QPoint pos = event->position().toPoint();
+#endif
+    const int w = std::max(1, canvas->width());
+    const double x = canvas->mapFrom(this, pos).x();
+    const double fraction = std::max(0.0, std::min(1.0, x / w));
+    const double anchor = viewStart + fraction * viewSize;
+    const double minSize = std::max<double>(1, stats->blockSize * w / MaxBlockWidth);
+    const double size = std::max(minSize,
+                                 std::min<double>(stats->totalSize,
+                                                  viewSize * std::pow(WheelZoomStep, -steps)));
+    const double start =
+            std::max(0.0, std::min(anchor - fraction * size, stats->totalSize - size));
+    viewStart = static_cast<ut64>(start);
+    viewSize = std::min(static_cast<ut64>(size), stats->totalSize - viewStart);
+    updateImage();
 }
 
-double VisualNavbar::addressToLocalX(RVA address)
+void VisualNavbar::leaveEvent(QEvent *event)
 {
-    for (const XToAddress &x2a : xToAddress) {
-        if ((x2a.address_from <= address) && (address < x2a.address_to)) {
-            double offset = (double)(address - x2a.address_from)
-                    / (double)(x2a.address_to - x2a.address_from);
-            double size = x2a.x_end - x2a.x_start;
-            return x2a.x_start + (offset * size);
-        }
+    QToolBar::leaveEvent(event);
+    if (stats && viewSize != stats->totalSize) {
+        resetZoom();
+        updateImage();
+    }
+}
+
+void VisualNavbar::contextMenuEvent(QContextMenuEvent *event)
+{
+    // Keep the toolbar toggles of the main window and add the layers of the bar
+    QMenu *menu = main->createPopupMenu();
+    if (!menu) {
+        menu = new QMenu(this);
+    } else {
+        menu->addSeparator();
+    }
+    QAction *entropyAction = menu->addAction(tr("Show entropy"));
+    entropyAction->setCheckable(true);
+    entropyAction->setChecked(Config()->getNavbarEntropy());
+    connect(entropyAction, &QAction::toggled, this, [this](bool checked) {
+        Config()->setNavbarEntropy(checked);
+        updateImage();
+    });
+    menu->setAttribute(Qt::WA_DeleteOnClose);
+    menu->popup(event->globalPos());
+    event->accept();
+}
+
+ut64 VisualNavbar::localXToPosition(double x) const
+{
+    if (!stats || !viewSize || x < 0 || x >= canvas->width()) {
+        return UT64_MAX;
     }
-    return nan("");
+    ut64 position = viewStart + static_cast<ut64>(x * viewSize / canvas->width());
+    return position < stats->totalSize ? position : UT64_MAX;
+}
+
+RVA VisualNavbar::localXToAddress(double x) const
+{
+    ut64 position = localXToPosition(x);
+    return position == UT64_MAX ? RVA_INVALID : stats->positionToAddress(position);
+}
+
+double VisualNavbar::addressToLocalX(RVA address) const
+{
+    ut64 position;
+    if (!stats || !viewSize || address == RVA_INVALID
+        || !stats->addressToPosition(address, position) || position < viewStart
+        || position - viewStart >= viewSize) {
+        return nan("");
+    }
+    return static_cast<double>(position - viewStart) * canvas->width() / viewSize;
 }
 
 QList<QString> VisualNavbar::sectionsForAddress(RVA address)
@@ -345,6 +526,19 @@ QString VisualNavbar::toolTipForAddress(RVA address)
         return ret;
     }
 
+    if (Config()->getNavbarEntropy()) {
+        std::shared_ptr<const ByteMap> byteMap = Core()->getByteMap();
+        ByteMap::Summary summary;
+        if (byteMap) {
+            summary = byteMap->summarize(address, address + 1);
+        }
+        if (summary.size) {
+            ret += QStringLiteral("\nEntropy: %1 (%2)")
+                           .arg(summary.entropy, 0, 'f', 2)
+                           .arg(ByteMap::className(summary.dominantClass()));
+        }
+    }
+
     auto sections = sectionsForAddress(address);
     if (sections.count()) {
         ret += "\nSections: \n";
@@ -2,65 +2,111 @@
 #define VISUALNAVBAR_H
 
 #include <QToolBar>
-#include <QGraphicsScene>
+#include <QImage>
 
 #include "core/Cutter.h"
-
-#include <rz_core.h>
+#include "common/AsyncTask.h"
 
 #include <memory>
+#include <vector>
 
 class MainWindow;
-class QGraphicsView;
-
-class VisualNavbar : public QToolBar
+class QLabel;
+
+/**
+ * @brief Analysis stats of the mapped regions at several resolutions
+ *
+ * The regions are laid out next to each other with the gaps between them removed, positions are
+ * offsets into this compressed space. Level 0 has the finest blocks, every further level merges
+ * pairs of neighbouring blocks of the level before, so any zoom can be drawn from the level
+ * whose blocks are about a pixel wide.
+ */
+struct NavbarStats
 {
-    Q_OBJECT
+    struct Region
+    {
+        RVA from;
+        RVA to;
+        ut64 position;
+    };
 
-    struct XToAddress
+    struct Block
     {
-        double x_start;
-        double x_end;
-        RVA address_from;
-        RVA address_to;
+        ut64 position;
+        ut64 size;
+        ut32 functions;
+        ut32 inFunctions;
+        ut32 strings;
+        ut32 symbols;
     };
 
+    std::vector<Region> regions;
+    std::vector<std::vector<Block>> levels;
+    ut64 totalSize = 0;
+    ut64 blockSize = 1;
+
+    RVA positionToAddress(ut64 position) const;
+    /**
+     * @return false if address is not mapped
+     */
+    bool addressToPosition(RVA address, ut64 &position) const;
+};
+
+class VisualNavbar : public QToolBar
+{
+    Q_OBJECT
+
 public:
     explicit VisualNavbar(MainWindow *main, QWidget *parent = nullptr);
+    ~VisualNavbar() override;
 
 public slots:
-    void paintEvent(QPaintEvent *event) override;
-    void updateGraphicsScene();
+    /**
+     * @brief Render the cached image again from the last stats, e.g. after the colors changed
+     */
+    void updateImage();
 
 private slots:
-    void fetchAndPaintData();
     void fetchStats();
-    void drawSeekCursor();
-    void drawPCCursor();
-    void drawCursor(RVA addr, QColor color, QGraphicsRectItem *&graphicsItem);
+    void statsFetched();
+    void updateCursors();
     void on_seekChanged(RVA addr);
 
 private:
-    QGraphicsView *graphicsView;
-    QGraphicsScene *graphicsScene;
-    QGraphicsRectItem *seekGraphicsItem;
-    QGraphicsRectItem *PCGraphicsItem;
+    QLabel *canvas;
     MainWindow *main;
 
-    UniquePtrC<RzCoreAnalysisStats, &rz_core_analysis_stats_free> stats;
-    unsigned int statsWidth = 0;
-    unsigned int previousWidth = 0;
-
-    QList<XToAddress> xToAddress;
+    AsyncTask::Ptr statsTask;
+    std::shared_ptr<const NavbarStats> stats;
+    /**
+     * Stats rendered at the size of the canvas, without cursors
+     */
+    QImage image;
+
+    /**
+     * Shown part of the compressed address space, the whole of it unless zoomed in
+     */
+    ut64 viewStart = 0;
+    ut64 viewSize = 0;
+    RVA pcAddress = RVA_INVALID;
     bool blockTooltip;
 
-    RVA localXToAddress(double x);
-    double addressToLocalX(RVA address);
+    /**
+     * @return UT64_MAX if x is outside of the mapped regions
+     */
+    ut64 localXToPosition(double x) const;
+    RVA localXToAddress(double x) const;
+    double addressToLocalX(RVA address) const;
     QList<QString> sectionsForAddress(RVA address);
     QString toolTipForAddress(RVA address);
+    void resetZoom();
 
+    bool eventFilter(QObject *object, QEvent *event) override;
     void mousePressEvent(QMouseEvent *event) override;
     void mouseMoveEvent(QMouseEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void leaveEvent(QEvent *event) override;
+    void contextMenuEvent(QContextMenuEvent *event) override;
 };
 
 #endif // VISUALNAVBAR_H